@@ -1,21 +1,44 @@
 #ifndef S21_ALLOCATOR_H
 #define S21_ALLOCATOR_H
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace s21 {
 
+/**
+ * @brief Статистика использования памяти пул-аллокатором.
+ */
+struct pool_stats {
+  std::size_t bytes_reserved;     // Память всех фрагментов
+  std::size_t bytes_in_use;       // Ячейки, выданные и не возвращенные
+  std::size_t bytes_bookkeeping;  // Служебный массив описаний фрагментов
+  std::size_t chunk_count;        // Количество фрагментов
+  std::size_t free_list_length;   // Возвращенные ячейки в списке свободных
+  std::size_t high_water_mark;    // Наибольшее значение bytes_in_use
+};
+
 /**
  * @brief Аллокатор для контейнеров set, multiset, map. Актуален для случаев
  * обработки большого колличества элементов c базовым типом.
  * @tparam T Тип элементов, для которых выделяется память.
  * @note Позволяет получить прибавку к производительности около 30%, но
  * увеличивает расход памяти.
- * Память выделяется фрагментами. Стоит учитывать, что освобождение памяти
- * происходит
+ * Память выделяется фрагментами, каждый следующий вдвое больше предыдущего
+ * (до max_chunk_bytes). Ячейки фрагмента отдаются по одной сдвигом указателя,
+ * поэтому страницы памяти затрагиваются только по мере выдачи элементов.
+ * Стоит учитывать, что освобождение памяти происходит в деструкторе, а
+ * полностью свободные фрагменты можно вернуть системе раньше вызовом
+ * release() или автоматически, задав порог trim_threshold.
  */
 template <typename T>
 class pool_allocator {
@@ -23,44 +46,98 @@ class pool_allocator {
   using value_type = T;
   using size_type = std::size_t;
   using difference_type = std::ptrdiff_t;
+  // Ноды принадлежат пулу, поэтому пул всегда следует за ними.
+  using propagate_on_container_copy_assignment = std::true_type;
   using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
   using is_always_equal = std::false_type;  // Аллокаторы не взаимозаменяемы
 
-  explicit pool_allocator(size_type chunk_size = 1024)
-      : chunk_size_(chunk_size) {}
+  // Предельный размер фрагмента при геометрическом росте.
+  static constexpr size_type max_chunk_bytes = size_type{64} << 20;
+  // Размер большой страницы, которой выравниваются фрагменты в режиме
+  // huge_pages.
+  static constexpr size_type huge_page_size = size_type{2} << 20;
+
+  /**
+   * @param chunk_size Количество элементов в первом фрагменте.
+   * @param trim_threshold Объем свободной памяти в байтах, после превышения
+   * которого пустые фрагменты возвращаются системе автоматически. 0 отключает
+   * автоматическое освобождение.
+   * @param huge_pages Фрагменты от huge_page_size выравниваются по границе
+   * большой страницы и помечаются madvise(MADV_HUGEPAGE), что уменьшает
+   * промахи TLB для больших деревьев.
+   */
+  explicit pool_allocator(size_type chunk_size = 1024,
+                          size_type trim_threshold = 0,
+                          bool huge_pages = false) noexcept
+      : chunk_size_(chunk_size),
+        trim_threshold_(trim_threshold),
+        next_chunk_size_(chunk_size),
+        huge_pages_(huge_pages) {
+    trim_mark_ = trim_step();
+  }
 
   template <typename U>
   pool_allocator(const pool_allocator<U>& other) noexcept
-      : free_list_(nullptr), chunks_(), chunk_size_(other.chunk_size()) {
+      : free_list_(nullptr),
+        chunks_(),
+        chunk_size_(other.chunk_size()),
+        trim_threshold_(other.trim_threshold()),
+        next_chunk_size_(other.chunk_size()),
+        huge_pages_(other.huge_pages()) {
+    trim_mark_ = trim_step();
     if (chunk_size_ > 0) {
       allocate_new_chunk();
     }
   }
 
   pool_allocator(const pool_allocator& other) noexcept
-      : free_list_(nullptr), chunks_(), chunk_size_(other.chunk_size_) {
+      : free_list_(nullptr),
+        chunks_(),
+        chunk_size_(other.chunk_size_),
+        trim_threshold_(other.trim_threshold_),
+        next_chunk_size_(other.chunk_size_),
+        huge_pages_(other.huge_pages_) {
+    trim_mark_ = trim_step();
     if (other.chunk_size_ > 0) {
       allocate_new_chunk();
     }
   }
 
-  ~pool_allocator() {
-    for (void* chunk : chunks_) {
-      ::operator delete(chunk);
-    }
+  /**
+   * @brief Конструктор перемещения, забирает блоки other вместе с выданными
+   * из них нодами, поэтому контейнер перемещается без выделения памяти.
+   */
+  pool_allocator(pool_allocator&& other) noexcept
+      : free_list_(std::exchange(other.free_list_, nullptr)),
+        chunks_(std::move(other.chunks_)),
+        chunk_size_(other.chunk_size_),
+        trim_threshold_(other.trim_threshold_),
+        free_slots_(std::exchange(other.free_slots_, 0)),
+        trim_mark_(other.trim_mark_),
+        bump_(std::exchange(other.bump_, nullptr)),
+        bump_end_(std::exchange(other.bump_end_, nullptr)),
+        next_chunk_size_(other.next_chunk_size_),
+        huge_pages_(other.huge_pages_),
+        in_use_(std::exchange(other.in_use_, 0)),
+        peak_in_use_(std::exchange(other.peak_in_use_, 0)) {
+    other.chunks_.clear();
   }
 
+  ~pool_allocator() { free_chunks(); }
+
   pool_allocator& operator=(const pool_allocator& other) noexcept {
     if (this != &other) {
       // Освобождаем текущие блоки
-      for (void* chunk : chunks_) {
-        ::operator delete(chunk);
-      }
-      chunks_.clear();
-      free_list_ = nullptr;
+      free_chunks();
 
       // Копируем chunk_size_ и выделяем новый пул
       chunk_size_ = other.chunk_size_;
+      trim_threshold_ = other.trim_threshold_;
+      trim_mark_ = trim_step();
+      next_chunk_size_ = chunk_size_;
+      huge_pages_ = other.huge_pages_;
+      peak_in_use_ = 0;
       if (chunk_size_ > 0) {
         allocate_new_chunk();
       }
@@ -68,6 +145,32 @@ class pool_allocator {
     return *this;
   }
 
+  /**
+   * @brief Оператор присваивающего перемещения, освобождает свои блоки и
+   * забирает блоки other.
+   * @warning Память, выданная этим аллокатором, к моменту вызова должна быть
+   * возвращена.
+   */
+  pool_allocator& operator=(pool_allocator&& other) noexcept {
+    if (this != &other) {
+      free_chunks();
+      free_list_ = std::exchange(other.free_list_, nullptr);
+      chunks_ = std::move(other.chunks_);
+      other.chunks_.clear();
+      chunk_size_ = other.chunk_size_;
+      trim_threshold_ = other.trim_threshold_;
+      free_slots_ = std::exchange(other.free_slots_, 0);
+      trim_mark_ = other.trim_mark_;
+      bump_ = std::exchange(other.bump_, nullptr);
+      bump_end_ = std::exchange(other.bump_end_, nullptr);
+      next_chunk_size_ = other.next_chunk_size_;
+      huge_pages_ = other.huge_pages_;
+      in_use_ = std::exchange(other.in_use_, 0);
+      peak_in_use_ = std::exchange(other.peak_in_use_, 0);
+    }
+    return *this;
+  }
+
   /**
    * @brief Выделяет память для n элементов типа T.
    * @param n Количество элементов, для которых нужно выделить память.
@@ -82,13 +185,27 @@ class pool_allocator {
 
     // Если запрашивают один элемент — берем из пула
     if (n == 1) {
-      if (free_list_ == nullptr) {
-        allocate_new_chunk();
+      char* slot;
+      if (free_list_ != nullptr) {
+        slot = reinterpret_cast<char*>(free_list_);
+        free_list_ = free_list_->next;
+        --free_slots_;
+        // Метка следует за опустевшим списком: иначе после release(), не
+        // освободившего фрагментов, порог только растет и перестает
+        // срабатывать.
+        if (trim_threshold_ != 0) {
+          trim_mark_ = std::min(trim_mark_, free_slots_ + trim_step());
+        }
+      } else {
+        if (bump_ == bump_end_) {
+          allocate_new_chunk();
+        }
+        slot = bump_;
+        bump_ += slot_size;
       }
-      auto* ptr = free_list_;
-      free_list_ = free_list_->next;
+      if (++in_use_ > peak_in_use_) peak_in_use_ = in_use_;
       // Пирведение типов указателей на уровне битов.
-      return reinterpret_cast<T*>(ptr);
+      return reinterpret_cast<T*>(slot);
     }
     // Иначе — стандартное выделение (редкий случай для set)
     else {
@@ -106,12 +223,22 @@ class pool_allocator {
    * возвращает память системе.
    * @param p Указатель на память, которую нужно освободить.
    * @param n Количество элементов, для которых нужно освободить память.
+   * @note Если задан trim_threshold, при накоплении свободной памяти вызывает
+   * release().
    */
   void deallocate(T* p, size_type n) noexcept {
     if (n == 1) {
       auto* node = reinterpret_cast<FreeNode*>(p);
       node->next = free_list_;
       free_list_ = node;
+      --in_use_;
+      if (++free_slots_ >= trim_mark_ && trim_threshold_ != 0) {
+        release();
+        // Следующая проверка не раньше, чем свободных ячеек станет вдвое
+        // больше оставшихся, так что release() занимает в среднем O(1) на
+        // освобождение.
+        trim_mark_ = free_slots_ + std::max(trim_step(), free_slots_);
+      }
     } else {
       if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
         ::operator delete(p, n * sizeof(T), std::align_val_t{alignof(T)});
@@ -121,6 +248,66 @@ class pool_allocator {
     }
   }
 
+  /**
+   * @brief Возвращает системе фрагменты, в которых не осталось выданных
+   * элементов.
+   * @return Количество освобожденных байт.
+   * @note Работает за O(f log c), где f — число свободных ячеек, c — число
+   * фрагментов. Выданная память не перемещается.
+   */
+  size_type release() noexcept {
+    for (Chunk& chunk : chunks_) chunk.free = 0;
+    // Еще не выданные ячейки текущего фрагмента тоже свободны.
+    if (bump_ != bump_end_) {
+      chunk_of(bump_).free += (bump_end_ - bump_) / slot_size;
+    }
+    for (FreeNode* node = free_list_; node != nullptr; node = node->next) {
+      ++chunk_of(node).free;
+    }
+    auto is_empty = [](const Chunk& chunk) {
+      return chunk.free == chunk.slots;
+    };
+    if (std::none_of(chunks_.begin(), chunks_.end(), is_empty)) return 0;
+
+    // Исключаем из списка ячейки пустых фрагментов, порядок остальных
+    // сохраняется.
+    FreeNode** link = &free_list_;
+    while (*link != nullptr) {
+      if (is_empty(chunk_of(*link))) {
+        *link = (*link)->next;
+      } else {
+        link = &(*link)->next;
+      }
+    }
+
+    if (bump_ != bump_end_ && is_empty(chunk_of(bump_))) {
+      bump_ = bump_end_ = nullptr;
+    }
+
+    size_type released = 0;
+    auto kept = std::remove_if(chunks_.begin(), chunks_.end(),
+                               [&](const Chunk& chunk) {
+                                 if (!is_empty(chunk)) return false;
+                                 free_slots_ -= chunk.slots;
+                                 released += chunk.slots * slot_size;
+                                 free_chunk(chunk);
+                                 return true;
+                               });
+    chunks_.erase(kept, chunks_.end());
+    return released;
+  }
+
+  /**
+   * @brief Возвращает системе все фрагменты за O(c), где c — число
+   * фрагментов, включая выданные ячейки.
+   * @warning Все выданные аллокатором указатели становятся недействительными,
+   * объекты в них не уничтожаются.
+   */
+  void release_all() noexcept {
+    free_chunks();
+    next_chunk_size_ = chunk_size_;
+  }
+
   /**
    * @brief Возвращает максимально возможное колличество элементов.
    */
@@ -129,10 +316,46 @@ class pool_allocator {
   }
 
   /**
-   * @brief Возвращает размер одного блока.
+   * @brief Возвращает размер первого блока.
    */
   size_type chunk_size() const noexcept { return chunk_size_; }
 
+  /**
+   * @brief Возвращает true, если большие фрагменты размещаются на больших
+   * страницах.
+   */
+  bool huge_pages() const noexcept { return huge_pages_; }
+
+  /**
+   * @brief Возвращает статистику пула за O(c), где c — число фрагментов.
+   * @note Массивы из нескольких элементов выделяются в обход пула и не
+   * учитываются.
+   */
+  pool_stats stats() const noexcept {
+    size_type reserved = 0;
+    for (const Chunk& chunk : chunks_) reserved += chunk.slots * slot_size;
+    return {reserved,
+            in_use_ * slot_size,
+            chunks_.capacity() * sizeof(Chunk),
+            chunks_.size(),
+            free_slots_,
+            peak_in_use_ * slot_size};
+  }
+
+  /**
+   * @brief Возвращает порог автоматического освобождения памяти в байтах.
+   */
+  size_type trim_threshold() const noexcept { return trim_threshold_; }
+
+  /**
+   * @brief Задает порог автоматического освобождения памяти в байтах, 0
+   * отключает его.
+   */
+  void set_trim_threshold(size_type bytes) noexcept {
+    trim_threshold_ = bytes;
+    trim_mark_ = free_slots_ + trim_step();
+  }
+
   /**
    * @brief Создает объект типа U в выделенной памяти.
    * @tparam U Тип создаваемого объекта.
@@ -159,6 +382,15 @@ class pool_allocator {
     p->~U();
   }
 
+  /**
+   * @brief Аллокаторы равны, только если это один и тот же пул: память,
+   * выделенная одним пулом, не может быть возвращена в другой.
+   */
+  friend bool operator==(const pool_allocator& lhs,
+                         const pool_allocator& rhs) noexcept {
+    return &lhs == &rhs;
+  }
+
   /**
    * @brief Структура для перепривязки аллокатора к другому типу.
    * @tparam U Тип, для которого нужно создать аллокатор.
@@ -177,37 +409,117 @@ class pool_allocator {
   };
 
   /**
-   * @brief Выделение нового блока памяти.
+   * @brief Фрагмент памяти. Поле free заполняется только в release().
+   */
+  struct Chunk {
+    char* begin;
+    size_type slots;
+    size_type free;
+    size_type alignment;
+  };
+
+  static constexpr size_type slot_align = std::max(alignof(T),
+                                                   alignof(FreeNode));
+  // Ячейка вмещает и элемент, и указатель списка свободных ячеек.
+  static constexpr size_type slot_size =
+      (std::max(sizeof(T), sizeof(FreeNode)) + slot_align - 1) / slot_align *
+      slot_align;
+
+  /**
+   * @brief Количество свободных ячеек, соответствующее порогу освобождения.
+   */
+  size_type trim_step() const noexcept {
+    return trim_threshold_ == 0
+               ? std::numeric_limits<size_type>::max()
+               : std::max<size_type>(trim_threshold_ / slot_size, 1);
+  }
+
+  /**
+   * @brief Выделение нового блока памяти. Ячейки не размечаются заранее, а
+   * выдаются сдвигом bump_.
    */
   void allocate_new_chunk() {
-    const size_t node_size = std::max(sizeof(T), sizeof(FreeNode));
-    auto* chunk =
-        static_cast<FreeNode*>(::operator new(chunk_size_ * node_size));
-    chunks_.push_back(chunk);
+    chunks_.reserve(chunks_.size() + 1);
+    size_type bytes = std::max<size_type>(next_chunk_size_, 1) * slot_size;
+    size_type alignment = slot_align;
+    if (huge_pages_ && bytes >= huge_page_size) {
+      bytes = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+      alignment = huge_page_size;
+    }
+    char* chunk;
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      chunk = static_cast<char*>(
+          ::operator new(bytes, std::align_val_t{alignment}));
+    } else {
+      chunk = static_cast<char*>(::operator new(bytes));
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // Подсказка ядру, ошибка означает лишь работу на обычных страницах.
+    if (alignment == huge_page_size) madvise(chunk, bytes, MADV_HUGEPAGE);
+#endif
+    const size_type slots = bytes / slot_size;
+    // Фрагменты упорядочены по адресу для поиска фрагмента ячейки.
+    auto position = std::upper_bound(
+        chunks_.begin(), chunks_.end(), chunk,
+        [](const char* p, const Chunk& other) { return p < other.begin; });
+    chunks_.insert(position, Chunk{chunk, slots, 0, alignment});
 
-    // Формируем список свободных нод
-    for (size_type i = 0; i < chunk_size_ - 1; ++i) {
-      auto* current = reinterpret_cast<FreeNode*>(
-          reinterpret_cast<char*>(chunk) + i * sizeof(T));
-      auto* next = reinterpret_cast<FreeNode*>(reinterpret_cast<char*>(chunk) +
-                                               (i + 1) * sizeof(T));
-      current->next = next;
+    // Неиспользованный остаток прежнего фрагмента переходит в список.
+    for (; bump_ != bump_end_; bump_ += slot_size) {
+      auto* node = reinterpret_cast<FreeNode*>(bump_);
+      node->next = free_list_;
+      free_list_ = node;
+      ++free_slots_;
     }
+    bump_ = chunk;
+    bump_end_ = chunk + slots * slot_size;
+    next_chunk_size_ =
+        std::min(next_chunk_size_ * 2,
+                 std::max(max_chunk_bytes / slot_size, chunk_size_));
+  }
+
+  /**
+   * @brief Находит фрагмент, которому принадлежит ячейка.
+   */
+  Chunk& chunk_of(const void* slot) noexcept {
+    auto position = std::upper_bound(
+        chunks_.begin(), chunks_.end(), static_cast<const char*>(slot),
+        [](const char* p, const Chunk& chunk) { return p < chunk.begin; });
+    assert(position != chunks_.begin());
+    return *--position;
+  }
 
-    // Последний элемент указывает на nullptr
-    auto* last = reinterpret_cast<FreeNode*>(reinterpret_cast<char*>(chunk) +
-                                             (chunk_size_ - 1) * sizeof(T));
-    last->next = nullptr;
+  static void free_chunk(const Chunk& chunk) noexcept {
+    if (chunk.alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      ::operator delete(chunk.begin, std::align_val_t{chunk.alignment});
+    } else {
+      ::operator delete(chunk.begin);
+    }
+  }
 
-    // Обновляем free_list_
-    free_list_ = chunk;
+  void free_chunks() noexcept {
+    for (const Chunk& chunk : chunks_) free_chunk(chunk);
+    chunks_.clear();
+    free_list_ = nullptr;
+    free_slots_ = 0;
+    bump_ = bump_end_ = nullptr;
+    in_use_ = 0;
   }
 
   FreeNode* free_list_ = nullptr;  // Список свободных блоков
-  std::vector<void*> chunks_;      // Выделенные блоки памяти
+  std::vector<Chunk> chunks_;      // Выделенные блоки памяти
   size_type chunk_size_;           // Размер одного блока
+  size_type trim_threshold_ = 0;   // Порог освобождения в байтах
+  size_type free_slots_ = 0;       // Длина списка свободных блоков
+  size_type trim_mark_ = 0;  // Длина списка, при которой вызывается release()
+  char* bump_ = nullptr;      // Следующая невыданная ячейка фрагмента
+  char* bump_end_ = nullptr;  // Конец текущего фрагмента
+  size_type next_chunk_size_;  // Количество ячеек следующего фрагмента
+  bool huge_pages_ = false;    // Большие фрагменты на больших страницах
+  size_type in_use_ = 0;       // Выданные ячейки
+  size_type peak_in_use_ = 0;  // Наибольшее число выданных ячеек
 };  // class pool_allocator
 
 }  // namespace s21
 
-#endif  // S21_ALLOCATOR_H
\ No newline at end of file
+#endif  // S21_ALLOCATOR_H
@@ -0,0 +1,1199 @@
+#ifndef S21_BTREE_H
+#define S21_BTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_helpers.h"
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+template <typename V, std::size_t Slots>
+struct Btree_internal_node;
+
+/**
+ * @brief Пара map с константным ключом, std::pair<const K, T>.
+ */
+template <typename V>
+struct Const_key_pair : std::false_type {};
+
+template <typename K, typename T>
+struct Const_key_pair<std::pair<const K, T>> : std::true_type {};
+
+/**
+ * @brief Лист B-дерева: до Slots значений подряд в одном блоке памяти.
+ * @note Внутренние ноды (Btree_internal_node) дополнительно хранят Slots + 1
+ * указателей на потомков, листья выделяются без них.
+ */
+template <typename V, std::size_t Slots>
+struct Btree_node {
+  using value_type = V;
+
+  Btree_internal_node<V, Slots>* parent;
+  std::uint16_t position;  // Индекс ноды среди потомков родителя
+  std::uint16_t count;     // Количество значений в ноде
+  bool leaf;
+  union {
+    value_type values[Slots];
+    char no_values_;
+  };
+
+  explicit Btree_node(bool is_leaf) noexcept
+      : parent(nullptr), position(0), count(0), leaf(is_leaf), no_values_{} {}
+
+  ~Btree_node() {}
+};  // struct Btree_node
+
+/**
+ * @brief Внутренняя нода B-дерева: потомок children[i] содержит значения
+ * между values[i - 1] и values[i].
+ */
+template <typename V, std::size_t Slots>
+struct Btree_internal_node : Btree_node<V, Slots> {
+  Btree_node<V, Slots>* children[Slots + 1];
+
+  Btree_internal_node() noexcept : Btree_node<V, Slots>(false) {}
+};  // struct Btree_internal_node
+
+/**
+ * @brief B-дерево, в ноде которого хранится много значений подряд: поиск
+ * проходит несколько блоков памяти по NodeBytes байт вместо одной ноды на
+ * уровень, как у Rb_tree.
+ * @tparam K тип ключа.
+ * @tparam V тип значения.
+ * @tparam KeyOfValue функтор извлечения ключа из значения.
+ * @tparam Compare функтор для сравнения ключей.
+ * @tparam Alloc аллокатор.
+ * @tparam NodeBytes желаемый размер листа в байтах; в ноде помещается не
+ * меньше трех значений.
+ * @note Вставка и удаление сдвигают значения внутри ноды, поэтому в отличие
+ * от Rb_tree они делают недействительными итераторы и ссылки на другие
+ * элементы. Перемещение value_type не должно бросать исключений. Ключ пары
+ * map при сдвиге перемещается, а не копируется (см. move_out), поэтому
+ * подходят ключи вроде std::string.
+ */
+template <typename K, typename V, typename KeyOfValue = std::identity,
+          typename Compare = std::less<K>, typename Alloc = std::allocator<V>,
+          std::size_t NodeBytes = 256>
+class Btree {
+ public:
+  template <bool Const>
+  class Btree_iterator;
+
+  using key_type = K;
+  using value_type = V;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using iterator = Btree_iterator<false>;
+  using const_iterator = Btree_iterator<true>;
+
+  // Количество значений в ноде.
+  static constexpr size_type slots = std::max<size_type>(
+      3, (NodeBytes - 2 * sizeof(void*)) / sizeof(value_type));
+  static_assert(slots <= std::numeric_limits<std::uint16_t>::max());
+
+ private:
+  using node_type = Btree_node<V, slots>;
+  using internal_type = Btree_internal_node<V, slots>;
+  using leaf_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<node_type>;
+  using internal_allocator = typename std::allocator_traits<
+      Alloc>::template rebind_alloc<internal_type>;
+  using leaf_traits = std::allocator_traits<leaf_allocator>;
+  using internal_traits = std::allocator_traits<internal_allocator>;
+  static constexpr bool propagate_on_copy =
+      leaf_traits::propagate_on_container_copy_assignment::value;
+  static constexpr bool propagate_on_move =
+      leaf_traits::propagate_on_container_move_assignment::value;
+
+  // Наименьшее заполнение ноды, кроме корня, после удаления.
+  static constexpr size_type min_count = slots / 2;
+
+  // Небольшие арифметические ключи просматриваются в ноде подряд без
+  // ветвлений: такой цикл быстрее двоичного поиска и векторизуется.
+  static constexpr bool linear_search =
+      std::is_arithmetic_v<K> &&
+      (std::is_same_v<Compare, std::less<K>> ||
+       std::is_same_v<Compare, std::greater<K>> ||
+       std::is_same_v<Compare, std::less<>> ||
+       std::is_same_v<Compare, std::greater<>> ||
+       std::is_same_v<Compare, s21::less<K>>);
+
+  /**
+   * @brief Позиция значения: нода и индекс в ней. Для end() node == nullptr.
+   */
+  struct Position {
+    node_type* node;
+    size_type index;
+  };
+
+  node_type* root_;
+  size_type size_;
+  size_type leaf_count_;
+  size_type internal_count_;
+  // Функторы и аллокаторы обычно пустые и не должны увеличивать размер дерева.
+  [[no_unique_address]] KeyOfValue kov;
+  [[no_unique_address]] Compare comp;
+  [[no_unique_address]] leaf_allocator leaf_alloc_;
+  [[no_unique_address]] internal_allocator internal_alloc_;
+
+ public:
+  Btree() noexcept(std::is_nothrow_default_constructible_v<Compare> &&
+                   std::is_nothrow_default_constructible_v<leaf_allocator> &&
+                   std::is_nothrow_default_constructible_v<internal_allocator>)
+      : root_(nullptr),
+        size_(0),
+        leaf_count_(0),
+        internal_count_(0),
+        kov{},
+        comp{},
+        leaf_alloc_{},
+        internal_alloc_{} {}
+
+  /**
+   * @brief Создает пустое дерево, ноды которого выделяются копиями a.
+   */
+  explicit Btree(const Alloc& a)
+      : root_(nullptr),
+        size_(0),
+        leaf_count_(0),
+        internal_count_(0),
+        kov{},
+        comp{},
+        leaf_alloc_(a),
+        internal_alloc_(a) {}
+
+  Btree(const Btree& other)
+      : Btree(other, leaf_traits::select_on_container_copy_construction(
+                         other.leaf_alloc_)) {}
+
+  /**
+   * @brief Копирует other, выделяя ноды копиями a. Структура нод
+   * копируется без сравнения ключей.
+   */
+  Btree(const Btree& other, const Alloc& a) : Btree(a) {
+    comp = other.comp;
+    if (other.root_ != nullptr) root_ = copy_subtree(other.root_);
+    size_ = other.size_;
+  }
+
+  /**
+   * @brief Конструктор перемещения, забирает ноды и аллокаторы other за
+   * O(1).
+   */
+  Btree(Btree&& other) noexcept
+      : root_(std::exchange(other.root_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        leaf_count_(std::exchange(other.leaf_count_, 0)),
+        internal_count_(std::exchange(other.internal_count_, 0)),
+        kov(other.kov),
+        comp(other.comp),
+        leaf_alloc_(std::move(other.leaf_alloc_)),
+        internal_alloc_(std::move(other.internal_alloc_)) {}
+
+  /**
+   * @brief Конструктор перемещения с аллокатором. Если a не равен аллокатору
+   * other, значения перемещаются в новые ноды, а other очищается.
+   */
+  Btree(Btree&& other, const Alloc& a) : Btree(a) {
+    comp = other.comp;
+    if (same_allocator(other)) {
+      steal_nodes(other);
+    } else {
+      move_values_from(other);
+    }
+  }
+
+  ~Btree() { clear(); }
+
+  /**
+   * @brief Оператор присваивания копированием. Аллокатор other копируется,
+   * только если этого требует propagate_on_container_copy_assignment.
+   */
+  Btree& operator=(const Btree& other) {
+    if (this != &other) {
+      Btree temp(other, propagate_on_copy ? Alloc(other.leaf_alloc_)
+                                          : Alloc(leaf_alloc_));
+      clear();
+      comp = other.comp;
+      steal_nodes(temp);
+      if constexpr (propagate_on_copy) {
+        leaf_alloc_ = std::move(temp.leaf_alloc_);
+        internal_alloc_ = std::move(temp.internal_alloc_);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Оператор присваивания перемещением. Если аллокатор не
+   * передается и не равен аллокатору other, значения перемещаются в новые
+   * ноды.
+   */
+  Btree& operator=(Btree&& other) noexcept(
+      propagate_on_move || leaf_traits::is_always_equal::value) {
+    if (this != &other) {
+      clear();
+      comp = other.comp;
+      if constexpr (propagate_on_move) {
+        steal_nodes(other);
+        std::swap(leaf_alloc_, other.leaf_alloc_);
+        std::swap(internal_alloc_, other.internal_alloc_);
+      } else if (same_allocator(other)) {
+        steal_nodes(other);
+      } else {
+        move_values_from(other);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Обменивает содержимое деревьев за O(1).
+   */
+  void swap(Btree& other) noexcept {
+    if (this != &other) {
+      std::swap(root_, other.root_);
+      std::swap(size_, other.size_);
+      std::swap(leaf_count_, other.leaf_count_);
+      std::swap(internal_count_, other.internal_count_);
+      std::swap(comp, other.comp);
+      if constexpr (leaf_traits::propagate_on_container_swap::value) {
+        std::swap(leaf_alloc_, other.leaf_alloc_);
+        std::swap(internal_alloc_, other.internal_alloc_);
+      }
+    }
+  }
+
+  iterator begin() noexcept { return iterator(leftmost(), 0, this); }
+  const_iterator begin() const noexcept {
+    return const_iterator(leftmost(), 0, this);
+  }
+  iterator end() noexcept { return iterator(nullptr, 0, this); }
+  const_iterator end() const noexcept {
+    return const_iterator(nullptr, 0, this);
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(value_type);
+  }
+
+  /**
+   * @brief Возвращает копию аллокатора.
+   */
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(leaf_alloc_);
+  }
+
+  /**
+   * @brief Возвращает память, занятую нодами, и потери аллокаторов, если
+   * они ведут статистику (метод stats()).
+   * @note Свободные места в нодах входят в node_bytes.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage{leaf_count_ * sizeof(node_type) +
+                                internal_count_ * sizeof(internal_type),
+                            0};
+    if constexpr (requires(const leaf_allocator& a) { a.stats(); }) {
+      const auto leaves = leaf_alloc_.stats();
+      const auto internals = internal_alloc_.stats();
+      usage.overhead_bytes = leaves.bytes_reserved + leaves.bytes_bookkeeping +
+                             internals.bytes_reserved +
+                             internals.bytes_bookkeeping - usage.node_bytes;
+    }
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает системе память аллокаторов, не занятую нодами, если
+   * аллокатор это поддерживает (метод release()).
+   */
+  void shrink_to_fit() noexcept {
+    if constexpr (requires(leaf_allocator& a) { a.release(); }) {
+      leaf_alloc_.release();
+      internal_alloc_.release();
+    }
+  }
+
+  /**
+   * @brief Очистка дерева.
+   */
+  void clear() noexcept {
+    if (root_ != nullptr) destroy_subtree(root_);
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  /**
+   * @brief Ищет элемент с ключом, эквивалентным key.
+   * @return Итератор на первый такой элемент или end().
+   */
+  template <typename KT>
+  iterator find(const KT& key) {
+    return make_iterator(find_position(key));
+  }
+
+  template <typename KT>
+  const_iterator find(const KT& key) const {
+    return make_const_iterator(find_position(key));
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key, или end().
+   */
+  template <typename KT>
+  iterator lower_bound(const KT& key) {
+    return make_iterator(normalize(leaf_position(key, false)));
+  }
+
+  template <typename KT>
+  const_iterator lower_bound(const KT& key) const {
+    return make_const_iterator(normalize(leaf_position(key, false)));
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key,
+   * или end().
+   */
+  template <typename KT>
+  iterator upper_bound(const KT& key) {
+    return make_iterator(normalize(leaf_position(key, true)));
+  }
+
+  template <typename KT>
+  const_iterator upper_bound(const KT& key) const {
+    return make_const_iterator(normalize(leaf_position(key, true)));
+  }
+
+  /**
+   * @brief Добавление нового элемента по ключу за один спуск по дереву.
+   * @param key Ключ, по которому ищется место вставки.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Пара: итератор на элемент с таким ключом и флаг была ли
+   * выполнена вставка.
+   * @note Значение конструируется прямо в ноде и только если ключа еще нет,
+   * поэтому key может ссылаться на объект, перемещаемый в args.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_with_key(const K& key, bool unique_keys,
+                                             Args&&... args) {
+    Position pos{nullptr, 0};
+    if (root_ != nullptr) {
+      if (unique_keys) {
+        pos = unique_leaf_position(key);
+        if (!pos.node->leaf || (pos.index < pos.node->count &&
+                                !comp(key, kov(pos.node->values[pos.index])))) {
+          return {make_iterator(pos), false};
+        }
+      } else {
+        pos = leaf_position(key, true);
+      }
+    }
+    return {insert_at(pos, std::forward<Args>(args)...), true};
+  }
+
+  /**
+   * @brief Создает значение из аргументов и добавляет его в дерево.
+   * @return Пара как у emplace_with_key. Если ключ уже существует, созданное
+   * значение уничтожается.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(bool unique_keys, Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return emplace_with_key(kov(value), unique_keys, std::move(value));
+  }
+
+  /**
+   * @brief Аналог emplace_with_key с подсказкой позиции вставки.
+   * @param hint Итератор, перед которым ожидается вставка.
+   * @note Если ключ попадает между hint и её предшественником, место вставки
+   * находится без спуска от корня. Итератор другого дерева игнорируется.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_with_key(const_iterator hint,
+                                                  const K& key,
+                                                  bool unique_keys,
+                                                  Args&&... args) {
+    if (hint.is_same_iterator(this) && root_ != nullptr) {
+      Position at{const_cast<node_type*>(hint.node_), hint.index_};
+      if (at.node == nullptr || fits_before(at, key, unique_keys)) {
+        Position prev = previous(at);
+        if (prev.node == nullptr || comp(kov(value_at(prev)), key) ||
+            (!unique_keys && !comp(key, kov(value_at(prev))))) {
+          return {insert_at(leaf_before(at), std::forward<Args>(args)...),
+                  true};
+        }
+        if (unique_keys && !comp(key, kov(value_at(prev)))) {
+          return {make_iterator(prev), false};
+        }
+      }
+    }
+    return emplace_with_key(key, unique_keys, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Аналог emplace с подсказкой позиции вставки.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint(const_iterator hint, bool unique_keys,
+                                         Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return emplace_hint_with_key(hint, kov(value), unique_keys,
+                                 std::move(value));
+  }
+
+  /**
+   * @brief Добавляет элементы диапазона [first, last).
+   * @note Упорядоченный диапазон добавляется в конец без спуска от корня за
+   * амортизированное O(1) на элемент.
+   */
+  template <std::input_iterator InputIt>
+  void insert_range(InputIt first, InputIt last, bool unique_keys) {
+    for (; first != last; ++first) emplace_hint(end(), unique_keys, *first);
+  }
+
+  /**
+   * @brief Вставляет значения args по одному, при исключении удаляет уже
+   * вставленные.
+   * @tparam Iterator Тип итератора в результате.
+   * @return Пары итератор на элемент с таким ключом и флаг вставки.
+   * @note Вставка сдвигает значения в нодах, поэтому итераторы результата
+   * находятся заново по скопированным ключам после всех вставок.
+   */
+  template <typename Iterator, typename... Args>
+  std::vector<std::pair<Iterator, bool>> insert_many(bool unique_keys,
+                                                     Args&&... args) {
+    std::vector<K> keys;
+    std::vector<bool> inserted;
+    std::vector<std::pair<Iterator, bool>> res;
+    keys.reserve(sizeof...(Args));
+    inserted.reserve(sizeof...(Args));
+    res.reserve(sizeof...(Args));
+    try {
+      (insert_one(keys, inserted, unique_keys, std::forward<Args>(args)), ...);
+    } catch (...) {
+      for (size_type i = 0; i < inserted.size(); ++i) {
+        if (inserted[i]) erase_key(keys[i]);
+      }
+      throw;
+    }
+    for (size_type i = 0; i < keys.size(); ++i) {
+      res.emplace_back(Iterator(find(keys[i])), inserted[i]);
+    }
+    return res;
+  }
+
+  /**
+   * @brief Удаляет элемент.
+   * @param pos Итератор этого дерева, не end().
+   */
+  void erase(const_iterator pos) noexcept {
+    node_type* node = const_cast<node_type*>(pos.node_);
+    size_type index = pos.index_;
+    std::destroy_at(node->values + index);
+    if (node->leaf) {
+      move_values(node->values + index, node->values + index + 1,
+                  node->count - index - 1);
+    } else {
+      // Место значения занимает его предшественник из листа.
+      node_type* leaf = child(node, index);
+      while (!leaf->leaf) leaf = child(leaf, leaf->count);
+      relocate(node->values + index, leaf->values + leaf->count - 1);
+      node = leaf;
+    }
+    --node->count;
+    --size_;
+    rebalance(node);
+  }
+
+  /**
+   * @brief Удаляет один элемент с ключом key.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  template <typename KT>
+  size_type erase_key(const KT& key) {
+    const_iterator it = std::as_const(*this).find(key);
+    if (it == end()) return 0;
+    erase(it);
+    return 1;
+  }
+
+  /**
+   * @brief Перемещает в дерево элементы other.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @note Значения перемещаются по одному: ноды хранят много значений и
+   * не могут перейти в другое дерево целиком. Элементы, ключи которых уже
+   * есть, остаются в other.
+   * @throw При исключении перенесенные элементы остаются в дереве, а
+   * остальные в other: вставка выделяет место до перемещения значения, и
+   * перенесенное значение сразу удаляется из other.
+   */
+  void merge(Btree& other, bool unique_keys) {
+    if (this == &other) return;
+    iterator it = other.begin();
+    while (it != other.end()) {
+      auto res = emplace_with_key(kov(*it), unique_keys, move_out(*it));
+      if (!res.second) {
+        ++it;
+        continue;
+      }
+      // Удаление сдвигает значения other, следующий элемент ищется заново по
+      // уже перенесенному ключу.
+      other.erase(it);
+      it = unique_keys ? other.upper_bound(kov(*res.first)) : other.begin();
+    }
+  }
+
+ private:
+  /**
+   * @brief Шаг insert_many: ключ запоминается до вставки, чтобы при
+   * исключении удалить только вставленные значения.
+   */
+  template <typename Arg>
+  void insert_one(std::vector<K>& keys, std::vector<bool>& inserted,
+                  bool unique_keys, Arg&& arg) {
+    value_type value(std::forward<Arg>(arg));
+    keys.push_back(kov(value));
+    inserted.push_back(false);
+    inserted.back() =
+        emplace_with_key(keys.back(), unique_keys, std::move(value)).second;
+  }
+
+  /**
+   * @brief Индекс первого значения ноды с ключом не меньше key (upper ==
+   * false) или больше key (upper == true).
+   */
+  template <typename KT>
+  size_type index_in_node(const node_type* node, const KT& key,
+                          bool upper) const {
+    const size_type count = node->count;
+    if constexpr (linear_search) {
+      size_type index = 0;
+      if (upper) {
+        for (size_type i = 0; i < count; ++i) {
+          index += !comp(key, kov(node->values[i]));
+        }
+      } else {
+        for (size_type i = 0; i < count; ++i) {
+          index += comp(kov(node->values[i]), key);
+        }
+      }
+      return index;
+    } else {
+      size_type low = 0;
+      size_type high = count;
+      while (low < high) {
+        const size_type middle = (low + high) / 2;
+        const bool before = upper ? !comp(key, kov(node->values[middle]))
+                                  : comp(kov(node->values[middle]), key);
+        if (before) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      return low;
+    }
+  }
+
+  /**
+   * @brief Спуск до листа: позиция lower_bound (upper == false) или
+   * upper_bound (upper == true) внутри листа.
+   * @return Позиция может указывать за последнее значение листа.
+   */
+  template <typename KT>
+  Position leaf_position(const KT& key, bool upper) const {
+    if (root_ == nullptr) return {nullptr, 0};
+    node_type* node = root_;
+    while (true) {
+      const size_type index = index_in_node(node, key, upper);
+      if (node->leaf) return {node, index};
+      node = child(node, index);
+    }
+  }
+
+  /**
+   * @brief Спуск для уникальных ключей: останавливается на ноде с равным
+   * ключом или в листе на месте вставки.
+   */
+  template <typename KT>
+  Position unique_leaf_position(const KT& key) const {
+    node_type* node = root_;
+    while (true) {
+      const size_type index = index_in_node(node, key, false);
+      if (node->leaf ||
+          (index < node->count && !comp(key, kov(node->values[index])))) {
+        return {node, index};
+      }
+      node = child(node, index);
+    }
+  }
+
+  /**
+   * @brief Позиция первого значения с ключом key или {nullptr, 0}.
+   */
+  template <typename KT>
+  Position find_position(const KT& key) const {
+    Position pos = normalize(leaf_position(key, false));
+    if (pos.node != nullptr && !comp(key, kov(value_at(pos)))) return pos;
+    return {nullptr, 0};
+  }
+
+  /**
+   * @brief Переводит позицию за последним значением ноды к следующему
+   * значению в порядке обхода.
+   */
+  static Position normalize(Position pos) noexcept {
+    while (pos.node != nullptr && pos.index == pos.node->count) {
+      pos.index = pos.node->position;
+      pos.node = pos.node->parent;
+    }
+    return pos;
+  }
+
+  /**
+   * @brief Предыдущее значение или {nullptr, 0} для первого.
+   */
+  Position previous(Position pos) const noexcept {
+    if (pos.node == nullptr) {
+      node_type* node = rightmost();
+      return {node, node->count - 1u};
+    }
+    if (!pos.node->leaf) {
+      node_type* node = child(pos.node, pos.index);
+      while (!node->leaf) node = child(node, node->count);
+      return {node, node->count - 1u};
+    }
+    if (pos.index > 0) return {pos.node, pos.index - 1};
+    node_type* node = pos.node;
+    while (node->parent != nullptr && node->position == 0) {
+      node = node->parent;
+    }
+    if (node->parent == nullptr) return {nullptr, 0};
+    return {node->parent, node->position - 1u};
+  }
+
+  /**
+   * @brief Ключ помещается перед значением at: key < at (для повторяющихся
+   * ключей key <= at).
+   */
+  bool fits_before(Position at, const K& key, bool unique_keys) const {
+    return unique_keys ? comp(key, kov(value_at(at)))
+                       : !comp(kov(value_at(at)), key);
+  }
+
+  /**
+   * @brief Место в листе для вставки непосредственно перед at.
+   */
+  Position leaf_before(Position at) const noexcept {
+    if (root_ == nullptr) return {nullptr, 0};
+    if (at.node == nullptr) {
+      node_type* node = rightmost();
+      return {node, node->count};
+    }
+    if (at.node->leaf) return at;
+    node_type* node = child(at.node, at.index);
+    while (!node->leaf) node = child(node, node->count);
+    return {node, node->count};
+  }
+
+  /**
+   * @brief Конструирует значение в листе на позиции pos, разделяя лист, если
+   * он заполнен.
+   * @param pos Позиция в листе или {nullptr, 0} для пустого дерева.
+   */
+  template <typename... Args>
+  iterator insert_at(Position pos, Args&&... args) {
+    if (pos.node == nullptr) {
+      root_ = new_leaf();
+      pos = {root_, 0};
+    } else if (pos.node->count == slots) {
+      pos = split(pos.node, pos.index);
+    }
+    node_type* node = pos.node;
+    move_values(node->values + pos.index + 1, node->values + pos.index,
+                node->count - pos.index);
+    try {
+      std::construct_at(node->values + pos.index, std::forward<Args>(args)...);
+    } catch (...) {
+      move_values(node->values + pos.index, node->values + pos.index + 1,
+                  node->count - pos.index);
+      if (size_ == 0) clear();
+      throw;
+    }
+    ++node->count;
+    ++size_;
+    return iterator(node, pos.index, this);
+  }
+
+  /**
+   * @brief Делит заполненную ноду пополам, поднимая среднее значение в
+   * родителя, который при необходимости делится раньше.
+   * @param insert_index Место будущей вставки; при вставке в начало или конец
+   * ноды деление смещается, чтобы упорядоченная вставка заполняла ноды
+   * целиком.
+   * @return Позиция для вставки после деления.
+   */
+  Position split(node_type* node, size_type insert_index) {
+    node_type* right =
+        node->leaf ? new_leaf() : static_cast<node_type*>(new_internal());
+    try {
+      if (node->parent == nullptr) {
+        internal_type* new_root = new_internal();
+        set_child(new_root, 0, node);
+        root_ = new_root;
+      } else if (node->parent->count == slots) {
+        split(node->parent, node->position);
+      }
+    } catch (...) {
+      free_node(right);
+      throw;
+    }
+
+    const size_type count = node->count;
+    const size_type right_count = insert_index == 0       ? count - 1
+                                  : insert_index == count ? 0
+                                                          : count / 2;
+    const size_type left_count = count - right_count - 1;
+    move_values(right->values, node->values + left_count + 1, right_count);
+    if (!node->leaf) {
+      for (size_type i = 0; i <= right_count; ++i) {
+        set_child(right, i, child(node, left_count + 1 + i));
+      }
+    }
+    right->count = static_cast<std::uint16_t>(right_count);
+    node->count = static_cast<std::uint16_t>(left_count);
+
+    internal_type* parent = node->parent;
+    const size_type at = node->position;
+    move_values(parent->values + at + 1, parent->values + at,
+                parent->count - at);
+    relocate(parent->values + at, node->values + left_count);
+    for (size_type i = parent->count + 1; i > at + 1; --i) {
+      set_child(parent, i, child(parent, i - 1));
+    }
+    set_child(parent, at + 1, right);
+    ++parent->count;
+
+    if (insert_index <= left_count) return {node, insert_index};
+    return {right, insert_index - left_count - 1};
+  }
+
+  /**
+   * @brief Восстанавливает заполнение ноды после удаления: занимает значение
+   * у соседа или сливается с ним, поднимаясь к корню.
+   */
+  void rebalance(node_type* node) noexcept {
+    while (node != root_ && node->count < min_count) {
+      internal_type* parent = node->parent;
+      const size_type at = node->position;
+      node_type* left = at > 0 ? child(parent, at - 1) : nullptr;
+      node_type* right = at < parent->count ? child(parent, at + 1) : nullptr;
+      if (left != nullptr && left->count + node->count < slots) {
+        merge_children(parent, at - 1);
+      } else if (right != nullptr && node->count + right->count < slots) {
+        merge_children(parent, at);
+      } else if (left != nullptr) {
+        rotate_right(parent, at - 1);
+        return;
+      } else {
+        rotate_left(parent, at);
+        return;
+      }
+      node = parent;
+    }
+    if (root_->count == 0) {
+      node_type* old_root = root_;
+      root_ = old_root->leaf ? nullptr : child(old_root, 0);
+      if (root_ != nullptr) root_->parent = nullptr;
+      free_node(old_root);
+    }
+  }
+
+  /**
+   * @brief Сливает потомков at и at + 1 вместе с разделяющим их значением.
+   */
+  void merge_children(internal_type* parent, size_type at) noexcept {
+    node_type* left = child(parent, at);
+    node_type* right = child(parent, at + 1);
+    const size_type left_count = left->count;
+    relocate(left->values + left_count, parent->values + at);
+    move_values(left->values + left_count + 1, right->values, right->count);
+    if (!left->leaf) {
+      for (size_type i = 0; i <= right->count; ++i) {
+        set_child(left, left_count + 1 + i, child(right, i));
+      }
+    }
+    left->count = static_cast<std::uint16_t>(left_count + 1 + right->count);
+    right->count = 0;
+
+    move_values(parent->values + at, parent->values + at + 1,
+                parent->count - at - 1);
+    for (size_type i = at + 1; i < parent->count; ++i) {
+      set_child(parent, i, child(parent, i + 1));
+    }
+    --parent->count;
+    free_node(right);
+  }
+
+  /**
+   * @brief Переносит последнее значение потомка at через родителя в начало
+   * потомка at + 1.
+   */
+  void rotate_right(internal_type* parent, size_type at) noexcept {
+    node_type* left = child(parent, at);
+    node_type* node = child(parent, at + 1);
+    move_values(node->values + 1, node->values, node->count);
+    relocate(node->values, parent->values + at);
+    relocate(parent->values + at, left->values + left->count - 1);
+    if (!node->leaf) {
+      for (size_type i = node->count + 1; i > 0; --i) {
+        set_child(node, i, child(node, i - 1));
+      }
+      set_child(node, 0, child(left, left->count));
+    }
+    --left->count;
+    ++node->count;
+  }
+
+  /**
+   * @brief Переносит первое значение потомка at + 1 через родителя в конец
+   * потомка at.
+   */
+  void rotate_left(internal_type* parent, size_type at) noexcept {
+    node_type* node = child(parent, at);
+    node_type* right = child(parent, at + 1);
+    relocate(node->values + node->count, parent->values + at);
+    relocate(parent->values + at, right->values);
+    move_values(right->values, right->values + 1, right->count - 1);
+    if (!node->leaf) {
+      set_child(node, node->count + 1, child(right, 0));
+      for (size_type i = 0; i < right->count; ++i) {
+        set_child(right, i, child(right, i + 1));
+      }
+    }
+    ++node->count;
+    --right->count;
+  }
+
+  static node_type* child(const node_type* node, size_type index) noexcept {
+    return static_cast<const internal_type*>(node)->children[index];
+  }
+
+  static void set_child(node_type* parent, size_type index,
+                        node_type* node) noexcept {
+    static_cast<internal_type*>(parent)->children[index] = node;
+    node->parent = static_cast<internal_type*>(parent);
+    node->position = static_cast<std::uint16_t>(index);
+  }
+
+  static const value_type& value_at(Position pos) noexcept {
+    return pos.node->values[pos.index];
+  }
+
+  node_type* leftmost() const noexcept {
+    node_type* node = root_;
+    if (node != nullptr) {
+      while (!node->leaf) node = child(node, 0);
+    }
+    return node;
+  }
+
+  node_type* rightmost() const noexcept {
+    node_type* node = root_;
+    while (!node->leaf) node = child(node, node->count);
+    return node;
+  }
+
+  iterator make_iterator(Position pos) noexcept {
+    return iterator(pos.node, pos.index, this);
+  }
+
+  const_iterator make_const_iterator(Position pos) const noexcept {
+    return const_iterator(pos.node, pos.index, this);
+  }
+
+  /**
+   * @brief Возвращает значение для перемещения. У пары map ключ константный
+   * и при обычном перемещении копировался бы, поэтому, как в нодах std::map,
+   * он перемещается через const_cast: исходное значение сразу уничтожается
+   * или остается пустой оболочкой.
+   */
+  static decltype(auto) move_out(value_type& value) noexcept {
+    if constexpr (Const_key_pair<V>::value) {
+      using key = std::remove_const_t<typename V::first_type>;
+      using mapped = typename V::second_type;
+      return std::pair<key&&, mapped&&>(
+          std::move(const_cast<key&>(value.first)), std::move(value.second));
+    } else {
+      return std::move(value);
+    }
+  }
+
+  /**
+   * @brief Перемещает значение в неинициализированную память и уничтожает
+   * исходное.
+   */
+  static void relocate(value_type* dst, value_type* src) noexcept {
+    static_assert(std::is_nothrow_constructible_v<
+                      value_type, decltype(move_out(std::declval<V&>()))>,
+                  "Btree moves values between node slots in noexcept code, "
+                  "so the key and mapped types must be nothrow movable");
+    std::construct_at(dst, move_out(*src));
+    std::destroy_at(src);
+  }
+
+  /**
+   * @brief Перемещает n значений из src в неинициализированную память dst,
+   * области могут перекрываться.
+   */
+  static void move_values(value_type* dst, value_type* src,
+                          size_type n) noexcept {
+    if (n == 0) return;
+    if constexpr (std::is_trivially_copyable_v<value_type>) {
+      std::memmove(static_cast<void*>(dst), src, n * sizeof(value_type));
+    } else if (std::less<value_type*>()(dst, src)) {
+      for (size_type i = 0; i < n; ++i) relocate(dst + i, src + i);
+    } else {
+      for (size_type i = n; i-- > 0;) relocate(dst + i, src + i);
+    }
+  }
+
+  node_type* new_leaf() {
+    node_type* node = leaf_traits::allocate(leaf_alloc_, 1);
+    leaf_traits::construct(leaf_alloc_, node, true);
+    ++leaf_count_;
+    return node;
+  }
+
+  internal_type* new_internal() {
+    internal_type* node = internal_traits::allocate(internal_alloc_, 1);
+    internal_traits::construct(internal_alloc_, node);
+    ++internal_count_;
+    return node;
+  }
+
+  /**
+   * @brief Освобождает ноду, значения которой уже уничтожены или перемещены.
+   */
+  void free_node(node_type* node) noexcept {
+    if (node->leaf) {
+      leaf_traits::destroy(leaf_alloc_, node);
+      leaf_traits::deallocate(leaf_alloc_, node, 1);
+      --leaf_count_;
+    } else {
+      auto* internal = static_cast<internal_type*>(node);
+      internal_traits::destroy(internal_alloc_, internal);
+      internal_traits::deallocate(internal_alloc_, internal, 1);
+      --internal_count_;
+    }
+  }
+
+  /**
+   * @brief Уничтожает значения поддерева и освобождает его ноды.
+   */
+  void destroy_subtree(node_type* node) noexcept {
+    std::destroy_n(node->values, node->count);
+    if (!node->leaf) {
+      for (size_type i = 0; i <= node->count; ++i) {
+        destroy_subtree(child(node, i));
+      }
+    }
+    free_node(node);
+  }
+
+  /**
+   * @brief Копирует поддерево src.
+   * @throw При исключении уже созданные ноды копии удаляются.
+   */
+  node_type* copy_subtree(const node_type* src) {
+    if (src->leaf) {
+      node_type* node = new_leaf();
+      try {
+        for (; node->count < src->count; ++node->count) {
+          std::construct_at(node->values + node->count,
+                            src->values[node->count]);
+        }
+      } catch (...) {
+        destroy_subtree(node);
+        throw;
+      }
+      return node;
+    }
+
+    internal_type* node = new_internal();
+    try {
+      set_child(node, 0, copy_subtree(child(src, 0)));
+    } catch (...) {
+      free_node(node);
+      throw;
+    }
+    try {
+      for (; node->count < src->count; ++node->count) {
+        const size_type i = node->count;
+        std::construct_at(node->values + i, src->values[i]);
+        try {
+          set_child(node, i + 1, copy_subtree(child(src, i + 1)));
+        } catch (...) {
+          std::destroy_at(node->values + i);
+          throw;
+        }
+      }
+    } catch (...) {
+      destroy_subtree(node);
+      throw;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Забирает ноды other за O(1), аллокаторы должны быть равны.
+   */
+  void steal_nodes(Btree& other) noexcept {
+    root_ = std::exchange(other.root_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    leaf_count_ = std::exchange(other.leaf_count_, 0);
+    internal_count_ = std::exchange(other.internal_count_, 0);
+  }
+
+  /**
+   * @brief Перемещает значения other в ноды, выделенные своими
+   * аллокаторами, и очищает other. Дерево должно быть пустым.
+   */
+  void move_values_from(Btree& other) {
+    for (iterator it = other.begin(); it != other.end(); ++it) {
+      insert_at(leaf_before({nullptr, 0}), move_out(*it));
+    }
+    other.clear();
+  }
+
+  /**
+   * @brief Ноды, выделенные аллокаторами other, можно освобождать
+   * аллокаторами текущего дерева.
+   */
+  bool same_allocator(const Btree& other) const noexcept {
+    if constexpr (leaf_traits::is_always_equal::value) {
+      return true;
+    } else {
+      return leaf_alloc_ == other.leaf_alloc_ &&
+             internal_alloc_ == other.internal_alloc_;
+    }
+  }
+
+ public:
+  /**
+   * @brief Двунаправленный итератор: нода и индекс значения в ней.
+   * @note end() хранит нулевую ноду, его декремент переходит к последнему
+   * элементу.
+   */
+  template <bool Const>
+  class Btree_iterator {
+    friend class Btree;
+    friend class Btree_iterator<!Const>;
+
+    using node_pointer =
+        std::conditional_t<Const, const node_type*, node_type*>;
+    using tree_pointer = std::conditional_t<Const, const Btree*, Btree*>;
+
+    node_pointer node_ = nullptr;
+    size_type index_ = 0;
+    tree_pointer tree_ = nullptr;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = V;
+    using pointer = std::conditional_t<Const, const V*, V*>;
+    using reference = std::conditional_t<Const, const V&, V&>;
+
+    Btree_iterator() = default;
+
+    Btree_iterator(node_pointer node, size_type index, tree_pointer tree)
+        : node_(node), index_(index), tree_(tree) {}
+
+    /**
+     * @brief Неявное преобразование обычного итератора в константный.
+     */
+    template <bool IsConst = Const>
+      requires IsConst
+    Btree_iterator(const Btree_iterator<false>& it)
+        : node_(it.node_), index_(it.index_), tree_(it.tree_) {}
+
+    /**
+     * @brief Проверяет принадлежит ли итератор переданному дереву.
+     */
+    bool is_same_iterator(const Btree* other) const { return tree_ == other; }
+
+    reference operator*() const { return node_->values[index_]; }
+
+    pointer operator->() const { return node_->values + index_; }
+
+    Btree_iterator& operator++() {
+      increment();
+      return *this;
+    }
+
+    Btree_iterator operator++(int) {
+      Btree_iterator tmp = *this;
+      increment();
+      return tmp;
+    }
+
+    Btree_iterator& operator--() {
+      decrement();
+      return *this;
+    }
+
+    Btree_iterator operator--(int) {
+      Btree_iterator tmp = *this;
+      decrement();
+      return tmp;
+    }
+
+    friend bool operator==(const Btree_iterator& lhs,
+                           const Btree_iterator& rhs) {
+      return lhs.node_ == rhs.node_ && lhs.index_ == rhs.index_;
+    }
+
+   private:
+    void increment() {
+      Position pos{const_cast<node_type*>(node_), index_};
+      if (pos.node->leaf) {
+        ++pos.index;
+      } else {
+        pos.node = child(pos.node, pos.index + 1);
+        while (!pos.node->leaf) pos.node = child(pos.node, 0);
+        pos.index = 0;
+      }
+      pos = normalize(pos);
+      node_ = pos.node;
+      index_ = pos.index;
+    }
+
+    void decrement() {
+      Position pos = tree_->previous({const_cast<node_type*>(node_), index_});
+      node_ = pos.node;
+      index_ = pos.index;
+    }
+  };  // class Btree_iterator
+};  // class Btree
+
+}  // namespace s21
+
+#endif  // S21_BTREE_H
@@ -0,0 +1,428 @@
+#ifndef S21_BTREE_MAP_H
+#define S21_BTREE_MAP_H
+
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "s21_btree.h"
+
+namespace s21 {
+
+/**
+ * @brief Ассоциативный массив на B-дереве с интерфейсом s21::map. Пары
+ * хранятся по много в ноде размером около NodeBytes байт.
+ * @warning В отличие от s21::map вставка и удаление делают
+ * недействительными все итераторы и ссылки на элементы контейнера.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<const K, T>>,
+          std::size_t NodeBytes = 256>
+class btree_map {
+ public:
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = std::pair<const K, T>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree =
+      Btree<K, value_type, s21::Select1st, Compare, Alloc, NodeBytes>;
+  using iterator = typename BinaryTree::iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  btree_map() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  btree_map(std::initializer_list<value_type> const& items)
+      : btree_map(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон добавляется в конец дерева без спуска от
+   * корня. Из повторяющихся ключей остается первый.
+   */
+  template <std::input_iterator InputIt>
+  btree_map(InputIt first, InputIt last) : btree_map{} {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   */
+  template <std::input_iterator InputIt>
+  btree_map(sorted_range_t, InputIt first, InputIt last) : btree_map{} {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit btree_map(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  btree_map(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : btree_map(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  btree_map(InputIt first, InputIt last, const Alloc& alloc)
+      : btree_map(alloc) {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  btree_map(const btree_map& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  btree_map(btree_map&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
+  btree_map(const btree_map& other) : tree(other.tree) {}
+
+  btree_map(btree_map&& other) noexcept : tree(std::move(other.tree)) {}
+
+  ~btree_map() = default;
+
+  btree_map& operator=(const btree_map& other) {
+    tree = other.tree;
+    return *this;
+  }
+
+  btree_map& operator=(btree_map&& other) noexcept {
+    tree = std::move(other.tree);
+    return *this;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу. Если ключа нет, создается элемент со
+   * значением по умолчанию.
+   * @note Выполняет один спуск по дереву.
+   */
+  T& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  T& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  /**
+   * @brief Получает ссылку на значение по ключу.
+   * @throw std::out_of_range("btree_map::at") если такого ключа нет.
+   */
+  mapped_type& at(const key_type& key) {
+    auto it = tree.find(key);
+    if (it == tree.end()) throw std::out_of_range("btree_map::at");
+    return it->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    auto it = tree.find(key);
+    if (it == tree.end()) throw std::out_of_range("btree_map::at");
+    return it->second;
+  }
+
+  /**
+   * @brief Итераторы обходят пары в порядке возрастания ключей.
+   */
+  inline iterator begin() { return tree.begin(); }
+  inline const_iterator begin() const { return tree.begin(); }
+  inline iterator end() { return tree.end(); }
+  inline const_iterator end() const { return tree.end(); }
+
+  inline bool empty() const noexcept { return tree.empty(); }
+
+  inline size_type size() const noexcept { return tree.size(); }
+
+  inline size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы.
+   */
+  inline void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды вместе со
+   * свободными местами в них, потери аллокатора и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Добавляет пару, только если такого ключа еще нет.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree.emplace_with_key(value.first, true, value);
+  }
+
+  std::pair<iterator, bool> insert(const K& key, const T& obj) {
+    return tree.emplace_with_key(key, true, key, obj);
+  }
+
+  /**
+   * @brief Перемещает пару, только если такого ключа еще нет. Если ключ уже
+   * есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree.emplace_with_key(value.first, true, std::move(value));
+  }
+
+  /**
+   * @brief Конструирует пару из args и вставляет её, если такого ключа ещё
+   * нет.
+   * @note Пара создается до поиска места вставки. Чтобы не создавать
+   * значение зря, используйте try_emplace.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree.emplace(true, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Добавляет пару, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент с таким ключом.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree.emplace_hint_with_key(hint, value.first, true, value).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree
+        .emplace_hint_with_key(hint, value.first, true, std::move(value))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree.emplace_hint(hint, true, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Вставляет элемент с ключом key, значение которого конструируется
+   * из args, если такого ключа ещё нет.
+   * @note Если ключ уже существует, ни key, ни args не используются.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return tree.emplace_with_key(
+        key, true, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return tree.emplace_with_key(
+        key, true, std::piecewise_construct,
+        std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, const K& key, Args&&... args) {
+    return tree
+        .emplace_hint_with_key(
+            hint, key, true, std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, K&& key, Args&&... args) {
+    return tree
+        .emplace_hint_with_key(
+            hint, key, true, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...))
+        .first;
+  }
+
+  /**
+   * @brief Добавляет пару или заменяет значение существующего ключа.
+   * @return Пара итератор на элемент и флаг был ли создан элемент.
+   */
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    auto res = try_emplace(key, std::forward<M>(obj));
+    // try_emplace использует obj только при вставке.
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    auto res = try_emplace(std::move(key), std::forward<M>(obj));
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   */
+  void erase(iterator pos) {
+    if (pos.is_same_iterator(&tree) && pos != end()) tree.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const K& key) { return tree.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, const_iterator>)
+  size_type erase(const KT& key) {
+    return tree.erase_key(key);
+  }
+
+  void swap(btree_map& other) noexcept {
+    if (this != &other) tree.swap(other.tree);
+  }
+
+  /**
+   * @brief Перемещает элементы other, ключей которых ещё нет. Остальные
+   * элементы остаются в other.
+   */
+  void merge(btree_map& other) { tree.merge(other.tree, true); }
+
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  iterator find(const K& key) { return tree.find(key); }
+
+  const_iterator find(const K& key) const { return tree.find(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) {
+    return tree.find(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  const_iterator find(const KT& key) const {
+    return tree.find(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key, или end().
+   */
+  iterator lower_bound(const K& key) { return tree.lower_bound(key); }
+
+  const_iterator lower_bound(const K& key) const {
+    return tree.lower_bound(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) {
+    return tree.lower_bound(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key,
+   * или end().
+   */
+  iterator upper_bound(const K& key) { return tree.upper_bound(key); }
+
+  const_iterator upper_bound(const K& key) const {
+    return tree.upper_bound(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) {
+    return tree.upper_bound(key);
+  }
+
+  /**
+   * @brief Заменяет содержимое элементами упорядоченного по возрастанию
+   * ключей диапазона [first, last) за O(n).
+   * @throw При исключении содержимое не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    BinaryTree temp(tree.get_allocator());
+    temp.insert_range(first, last, true);
+    tree = std::move(temp);
+  }
+
+  /**
+   * @brief Вставляет несколько пар с уникальными ключами за одну операцию.
+   * @return Пары итератор на элемент и флаг была ли выполнена вставка.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return tree.template insert_many<iterator>(true,
+                                               std::forward<Args>(args)...);
+  }
+};  // class btree_map
+
+namespace pmr {
+/**
+ * @brief btree_map, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          std::size_t NodeBytes = 256>
+using btree_map =
+    s21::btree_map<K, T, Compare,
+                   std::pmr::polymorphic_allocator<std::pair<const K, T>>,
+                   NodeBytes>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_BTREE_MAP_H
@@ -0,0 +1,342 @@
+#ifndef S21_BTREE_MULTISET_H
+#define S21_BTREE_MULTISET_H
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_btree.h"
+
+namespace s21 {
+
+/**
+ * @brief Мультимножество на B-дереве с интерфейсом s21::multiset. Равные
+ * ключи хранятся в порядке вставки.
+ * @warning В отличие от s21::multiset вставка и удаление делают
+ * недействительными все итераторы и ссылки на элементы контейнера.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>, std::size_t NodeBytes = 256>
+class btree_multiset {
+ public:
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree =
+      Btree<Key, Key, std::identity, Compare, Alloc, NodeBytes>;
+  using iterator = typename BinaryTree::const_iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  btree_multiset() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  btree_multiset(std::initializer_list<value_type> const& items)
+      : btree_multiset(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон добавляется в конец дерева без спуска от
+   * корня.
+   */
+  template <std::input_iterator InputIt>
+  btree_multiset(InputIt first, InputIt last) : btree_multiset{} {
+    tree.insert_range(first, last, false);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   */
+  template <std::input_iterator InputIt>
+  btree_multiset(sorted_range_t, InputIt first, InputIt last)
+      : btree_multiset{} {
+    tree.insert_range(first, last, false);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit btree_multiset(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  btree_multiset(std::initializer_list<value_type> const& items,
+                 const Alloc& alloc)
+      : btree_multiset(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  btree_multiset(InputIt first, InputIt last, const Alloc& alloc)
+      : btree_multiset(alloc) {
+    tree.insert_range(first, last, false);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  btree_multiset(const btree_multiset& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  btree_multiset(btree_multiset&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
+  btree_multiset(const btree_multiset& other) : tree(other.tree) {}
+
+  btree_multiset(btree_multiset&& other) noexcept
+      : tree(std::move(other.tree)) {}
+
+  ~btree_multiset() = default;
+
+  btree_multiset& operator=(const btree_multiset& other) {
+    tree = other.tree;
+    return *this;
+  }
+
+  btree_multiset& operator=(btree_multiset&& other) noexcept {
+    tree = std::move(other.tree);
+    return *this;
+  }
+
+  /**
+   * @brief Возвращает константный итератор на первый элемент. Итерация
+   * выполняется в порядке возрастания ключей.
+   */
+  inline iterator begin() const { return tree.begin(); }
+
+  /**
+   * @brief Возвращает константный итератор на позицию после последнего
+   * элемента.
+   */
+  inline iterator end() const { return tree.end(); }
+
+  inline bool empty() const noexcept { return tree.empty(); }
+
+  inline size_type size() const noexcept { return tree.size(); }
+
+  inline size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы из мультимножества.
+   */
+  void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды вместе со
+   * свободными местами в них, потери аллокатора и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Добавляет элемент после всех равных ему.
+   * @return Итератор на добавленный элемент.
+   */
+  iterator insert(const value_type& value) {
+    return tree.emplace_with_key(value, false, value).first;
+  }
+
+  iterator insert(value_type&& value) {
+    return tree.emplace_with_key(value, false, std::move(value)).first;
+  }
+
+  /**
+   * @brief Конструирует элемент из args и добавляет его.
+   * @return Итератор на добавленный элемент.
+   */
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return tree.emplace(false, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на добавленный элемент.
+   * @note Если элемент попадает непосредственно перед hint, место вставки
+   * находится без спуска от корня.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree.emplace_hint_with_key(hint, value, false, value).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree.emplace_hint_with_key(hint, value, false, std::move(value))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree.emplace_hint(hint, false, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   */
+  void erase(iterator pos) {
+    if (pos.is_same_iterator(&tree) && pos != end()) tree.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет один элемент с указанным ключом.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) { return tree.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return tree.erase_key(key);
+  }
+
+  void swap(btree_multiset& other) noexcept {
+    if (this != &other) tree.swap(other.tree);
+  }
+
+  /**
+   * @brief Перемещает в мультимножество все элементы other.
+   */
+  void merge(btree_multiset& other) { tree.merge(other.tree, false); }
+
+  iterator find(const Key& key) const { return tree.find(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return tree.find(key);
+  }
+
+  /**
+   * @brief Подсчитывает количество элементов с указанным ключом за
+   * O(log n + k), где k — количество найденных элементов.
+   */
+  size_type count(const Key& key) const { return count_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return count_key(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, не меньший key, или end().
+   */
+  iterator lower_bound(const Key& key) const { return tree.lower_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return tree.lower_bound(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, больший key, или end().
+   */
+  iterator upper_bound(const Key& key) const { return tree.upper_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return tree.upper_bound(key);
+  }
+
+  /**
+   * @brief Находит подпоследовательность элементов с ключом key.
+   * @return Пара {lower_bound(key), upper_bound(key)}.
+   */
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<iterator, iterator> equal_range(const KT& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  /**
+   * @brief Заменяет содержимое мультимножества элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @throw При исключении содержимое мультимножества не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    BinaryTree temp(tree.get_allocator());
+    temp.insert_range(first, last, false);
+    tree = std::move(temp);
+  }
+
+  /**
+   * @brief Вставляет несколько элементов за одну операцию.
+   * @return Пары итератор на элемент с таким ключом и true.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return tree.template insert_many<iterator>(false,
+                                               std::forward<Args>(args)...);
+  }
+
+ private:
+  template <typename KT>
+  size_type count_key(const KT& key) const {
+    auto range = equal_range(key);
+    return std::distance(range.first, range.second);
+  }
+};  // class btree_multiset
+
+namespace pmr {
+/**
+ * @brief btree_multiset, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          std::size_t NodeBytes = 256>
+using btree_multiset =
+    s21::btree_multiset<Key, Compare, std::pmr::polymorphic_allocator<Key>,
+                        NodeBytes>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_BTREE_MULTISET_H
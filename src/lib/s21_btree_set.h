@@ -0,0 +1,321 @@
+#ifndef S21_BTREE_SET_H
+#define S21_BTREE_SET_H
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_btree.h"
+
+namespace s21 {
+
+/**
+ * @brief Множество уникальных ключей на B-дереве: интерфейс как у s21::set,
+ * но ключи хранятся по много в ноде размером около NodeBytes байт, что
+ * уменьшает число промахов кэша при поиске и обходе.
+ * @warning В отличие от s21::set вставка и удаление делают недействительными
+ * все итераторы и ссылки на элементы контейнера.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>, std::size_t NodeBytes = 256>
+class btree_set {
+ public:
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree =
+      Btree<Key, Key, std::identity, Compare, Alloc, NodeBytes>;
+  using iterator = typename BinaryTree::const_iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  btree_set() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  btree_set(std::initializer_list<value_type> const& items)
+      : btree_set(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон добавляется в конец дерева без спуска от
+   * корня. Из повторяющихся ключей остается первый.
+   */
+  template <std::input_iterator InputIt>
+  btree_set(InputIt first, InputIt last) : btree_set{} {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   */
+  template <std::input_iterator InputIt>
+  btree_set(sorted_range_t, InputIt first, InputIt last) : btree_set{} {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit btree_set(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  btree_set(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : btree_set(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  btree_set(InputIt first, InputIt last, const Alloc& alloc)
+      : btree_set(alloc) {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  btree_set(const btree_set& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  btree_set(btree_set&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
+  btree_set(const btree_set& other) : tree(other.tree) {}
+
+  btree_set(btree_set&& other) noexcept : tree(std::move(other.tree)) {}
+
+  ~btree_set() = default;
+
+  btree_set& operator=(const btree_set& other) {
+    tree = other.tree;
+    return *this;
+  }
+
+  btree_set& operator=(btree_set&& other) noexcept {
+    tree = std::move(other.tree);
+    return *this;
+  }
+
+  /**
+   * @brief Возвращает константный итератор на первый элемент. Итерация
+   * выполняется в порядке возрастания ключей.
+   */
+  inline iterator begin() const { return tree.begin(); }
+
+  /**
+   * @brief Возвращает константный итератор на позицию после последнего
+   * элемента.
+   */
+  inline iterator end() const { return tree.end(); }
+
+  inline bool empty() const noexcept { return tree.empty(); }
+
+  inline size_type size() const noexcept { return tree.size(); }
+
+  inline size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы из множества.
+   */
+  void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды вместе со
+   * свободными местами в них, потери аллокатора и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Пытается вставить элемент в множество.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree.emplace_with_key(value, true, value);
+  }
+
+  /**
+   * @brief Пытается переместить элемент в множество. Если элемент уже есть,
+   * value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree.emplace_with_key(value, true, std::move(value));
+  }
+
+  /**
+   * @brief Конструирует элемент из args и вставляет его, если такого ключа
+   * ещё нет.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree.emplace(true, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент с таким ключом.
+   * @note Если элемент попадает непосредственно перед hint, место вставки
+   * находится без спуска от корня.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree.emplace_hint_with_key(hint, value, true, value).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree.emplace_hint_with_key(hint, value, true, std::move(value))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree.emplace_hint(hint, true, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   */
+  void erase(iterator pos) {
+    if (pos.is_same_iterator(&tree) && pos != end()) tree.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) { return tree.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return tree.erase_key(key);
+  }
+
+  void swap(btree_set& other) noexcept {
+    if (this != &other) tree.swap(other.tree);
+  }
+
+  /**
+   * @brief Перемещает в множество элементы other, ключей которых ещё нет.
+   * Остальные элементы остаются в other.
+   */
+  void merge(btree_set& other) { tree.merge(other.tree, true); }
+
+  iterator find(const Key& key) const { return tree.find(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return tree.find(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, не меньший key, или end().
+   */
+  iterator lower_bound(const Key& key) const { return tree.lower_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return tree.lower_bound(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, больший key, или end().
+   */
+  iterator upper_bound(const Key& key) const { return tree.upper_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return tree.upper_bound(key);
+  }
+
+  /**
+   * @brief Заменяет содержимое множества элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @throw При исключении содержимое множества не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    BinaryTree temp(tree.get_allocator());
+    temp.insert_range(first, last, true);
+    tree = std::move(temp);
+  }
+
+  /**
+   * @brief Вставляет несколько уникальных элементов за одну операцию.
+   * @return Пары итератор на элемент и флаг была ли выполнена вставка.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return tree.template insert_many<iterator>(true,
+                                               std::forward<Args>(args)...);
+  }
+};  // class btree_set
+
+namespace pmr {
+/**
+ * @brief btree_set, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          std::size_t NodeBytes = 256>
+using btree_set = s21::btree_set<Key, Compare,
+                                 std::pmr::polymorphic_allocator<Key>,
+                                 NodeBytes>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_BTREE_SET_H
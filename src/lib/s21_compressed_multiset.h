@@ -0,0 +1,589 @@
+#ifndef S21_COMPRESSED_MULTISET_H
+#define S21_COMPRESSED_MULTISET_H
+
+#include <algorithm>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Ключ и количество его повторений, хранимые в одной ноде.
+ */
+template <typename Key>
+struct Counted_key {
+  Key key;
+  std::size_t count;
+};  // struct Counted_key
+
+/**
+ * @brief Структура-функтор возвращает ключ из Counted_key.
+ */
+struct Select_key {
+  template <typename Entry>
+  const auto& operator()(const Entry& entry) const {
+    return entry.key;
+  }
+};
+
+/**
+ * @brief Мультимножество, хранящее одну ноду на каждый различный ключ вместе с
+ * количеством его повторений.
+ * @note Память зависит от количества различных ключей, а не от общего
+ * количества элементов. Равные ключи неразличимы: хранится только первый
+ * вставленный объект, остальные вхождения считаются его копиями.
+ * Итератор обходит каждое вхождение отдельно, как в multiset.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>,
+          template <typename> class NodeT = Node>
+class compressed_multiset {
+ public:
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using BinaryTree =
+      Rb_tree<Key, Counted_key<Key>, Select_key, Compare,
+              typename std::allocator_traits<Alloc>::template rebind_alloc<
+                  Counted_key<Key>>,
+              NodeT>;
+  using node_type = BinaryTree::node_type;
+
+  class Compressed_iterator;
+  using iterator = Compressed_iterator;
+  using const_iterator = Compressed_iterator;
+
+ private:
+  using tree_iterator = typename BinaryTree::const_iterator;
+
+  BinaryTree tree;
+  size_type total = 0;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  compressed_multiset() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  compressed_multiset(std::initializer_list<value_type> const& items)
+      : compressed_multiset(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   */
+  template <std::input_iterator InputIt>
+  compressed_multiset(InputIt first, InputIt last) : compressed_multiset{} {
+    assign_range(first, last);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc, например, std::pmr::polymorphic_allocator.
+   */
+  explicit compressed_multiset(const Alloc& alloc)
+      : tree(typename BinaryTree::allocator_type(alloc)) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  compressed_multiset(std::initializer_list<value_type> const& items,
+                      const Alloc& alloc)
+      : compressed_multiset(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  compressed_multiset(InputIt first, InputIt last, const Alloc& alloc)
+      : compressed_multiset(alloc) {
+    assign_range(first, last);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  compressed_multiset(const compressed_multiset& other, const Alloc& alloc)
+      : tree(other.tree, typename BinaryTree::allocator_type(alloc)),
+        total(other.total) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  compressed_multiset(compressed_multiset&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), typename BinaryTree::allocator_type(alloc)),
+        total(std::exchange(other.total, 0)) {}
+
+  /**
+   * @brief Конструктор копирования.
+   */
+  compressed_multiset(const compressed_multiset& other)
+      : tree(other.tree), total(other.total) {}
+
+  /**
+   * @brief Конструктор перемещения.
+   */
+  compressed_multiset(compressed_multiset&& other) noexcept
+      : tree(std::move(other.tree)), total(std::exchange(other.total, 0)) {}
+
+  ~compressed_multiset() = default;
+
+  /**
+   * @brief Оператор присваивания.
+   */
+  compressed_multiset& operator=(const compressed_multiset& other) {
+    if (this != &other) {
+      tree = other.tree;
+      total = other.total;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Оператор присваивающего перемещения.
+   */
+  compressed_multiset& operator=(compressed_multiset&& other) noexcept {
+    if (this != &other) {
+      tree = std::move(other.tree);
+      total = std::exchange(other.total, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Возвращает итератор на первое вхождение наименьшего ключа.
+   */
+  inline iterator begin() const { return iterator(tree.cbegin(), 0); }
+
+  /**
+   * @brief Возвращает итератор на позицию после последнего элемента.
+   */
+  inline iterator end() const { return iterator(tree.cend(), 0); }
+
+  /**
+   * @brief Возвращает true, если мультимножество пустое.
+   */
+  inline bool empty() const noexcept { return total == 0; }
+
+  /**
+   * @brief Возвращает количество элементов с учетом повторений.
+   */
+  inline size_type size() const noexcept { return total; }
+
+  /**
+   * @brief Возвращает количество различных ключей (и нод дерева).
+   */
+  inline size_type distinct_size() const noexcept { return tree.size(); }
+
+  /**
+   * @brief Возвращает максимально возможное количество элементов.
+   * @note Ограничено только счетчиком повторений, а не памятью под ноды.
+   */
+  inline size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max();
+  }
+
+  /**
+   * @brief Удаляет все элементы.
+   */
+  void clear() noexcept {
+    tree.clear();
+    total = 0;
+  }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды элементов и
+   * потери аллокатора вместе с самим объектом контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает копию аллокатора контейнера.
+   */
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(tree.get_allocator());
+  }
+
+  /**
+   * @brief Добавляет элемент.
+   * @return Итератор на добавленное вхождение, оно становится последним среди
+   * равных ключей.
+   * @note Для повторяющегося ключа только увеличивает счетчик, не выделяя
+   * память.
+   */
+  iterator insert(const value_type& value) { return insert(value, 1); }
+
+  /**
+   * @brief Перемещает элемент в мультимножество.
+   * @note Объект перемещается, только если такого ключа еще нет.
+   */
+  iterator insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value, true, std::move(value), 0);
+    return add_occurrences(res.first, 1);
+  }
+
+  /**
+   * @brief Добавляет count вхождений значения за O(log n).
+   * @return Итератор на первое из добавленных вхождений или lower_bound(value),
+   * если count == 0.
+   */
+  iterator insert(const value_type& value, size_type count) {
+    if (count == 0) return lower_bound(value);
+    auto res = tree.emplace_with_key(value, true, value, 0);
+    return add_occurrences(res.first, count);
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @note Подсказка используется, только если ключа еще нет, иначе
+   * увеличивается счетчик найденной ноды.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    auto res =
+        tree.emplace_hint_with_key(hint_node(hint), value, true, value, 0);
+    return add_occurrences(res.first, 1);
+  }
+
+  /**
+   * @brief Конструирует ключ из переданных аргументов и добавляет его.
+   */
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Удаляет вхождение, на которое указывает итератор.
+   * @param pos Итератор этого контейнера, отличный от end().
+   * @return Итератор на вхождение, следующее за удаленным, или end(). Для
+   * end(), недействительного номера вхождения и итератора другого контейнера
+   * ничего не удаляется и возвращается end().
+   * @note Вхождения после удаленного сдвигаются на одну позицию, поэтому
+   * итераторы на них (кроме возвращенного) становятся недействительными.
+   * Нода удаляется вместе с последним вхождением ключа.
+   */
+  iterator erase(const_iterator pos) {
+    node_type* node = const_cast<node_type*>(pos.current.get_current());
+    if (!tree.owns(pos.current) || pos.index >= count_node(node)) return end();
+    if (pos.index + 1 < node->val.count) {
+      remove_occurrence(node);
+      return pos;
+    }
+    const iterator next(std::next(pos.current), 0);
+    remove_occurrence(node);
+    return next;
+  }
+
+  /**
+   * @brief Удаляет одно вхождение ключа.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) {
+    node_type* node = tree.search(key);
+    if (node == tree.get_nil()) return 0;
+    remove_occurrence(node);
+    return 1;
+  }
+
+  /**
+   * @brief Обменивает данные с другим мультимножеством.
+   */
+  void swap(compressed_multiset& other) noexcept {
+    tree.swap(other.tree);
+    std::swap(total, other.total);
+  }
+
+  /**
+   * @brief Переносит все элементы other, счетчики равных ключей
+   * складываются.
+   * @note Работает за O(m log(n + m)), где m — количество различных ключей
+   * other. При исключении уже перенесенные ключи остаются в текущем
+   * контейнере, остальные в other.
+   */
+  void merge(compressed_multiset& other) {
+    if (this == &other) return;
+    while (!other.tree.empty()) {
+      node_type* source =
+          const_cast<node_type*>(other.tree.cbegin().get_current());
+      auto res = tree.emplace_with_key(source->val.key, true, source->val.key,
+                                        0);
+      const size_type count = source->val.count;
+      res.first->val.count += count;
+      total += count;
+      other.total -= count;
+      other.tree.delete_node(source);
+    }
+  }
+
+  /**
+   * @brief Находит первое вхождение ключа.
+   * @return Итератор на элемент или end().
+   */
+  iterator find(const Key& key) const {
+    return iterator(tree_iterator(tree.search(key), &tree), 0);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return iterator(tree_iterator(tree.search(key), &tree), 0);
+  }
+
+  /**
+   * @brief Подсчитывает количество элементов с указанным ключом за O(log n).
+   */
+  size_type count(const Key& key) const {
+    return count_node(tree.search(key));
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return count_node(tree.search(key));
+  }
+
+  /**
+   * @brief Определяет, существует ли элемент с заданным ключом.
+   */
+  bool contains(const Key& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  /**
+   * @brief Возвращает итератор на первое вхождение первого ключа, не
+   * меньшего key, или end().
+   */
+  iterator lower_bound(const Key& key) const {
+    return iterator(tree_iterator(tree.lower_bound(key), &tree), 0);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return iterator(tree_iterator(tree.lower_bound(key), &tree), 0);
+  }
+
+  /**
+   * @brief Возвращает итератор на первое вхождение первого ключа, большего
+   * key, или end().
+   */
+  iterator upper_bound(const Key& key) const {
+    return iterator(tree_iterator(tree.upper_bound(key), &tree), 0);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return iterator(tree_iterator(tree.upper_bound(key), &tree), 0);
+  }
+
+  /**
+   * @brief Находит подпоследовательность элементов с ключом key.
+   * @return Пару {lower_bound(key), upper_bound(key)}.
+   */
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<iterator, iterator> equal_range(const KT& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  /**
+   * @brief Константный итератор по всем вхождениям ключей.
+   * @note Хранит итератор ноды и номер вхождения ключа в ней. Как и итератор
+   * дерева, из end() инкрементом переходит в начало, декрементом в конец.
+   */
+  class Compressed_iterator {
+    friend class compressed_multiset;
+
+    tree_iterator current;
+    size_type index;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Key;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    Compressed_iterator(tree_iterator node, size_type occurrence)
+        : current(node), index(occurrence) {}
+
+    /**
+     * @brief Возвращает номер вхождения ключа, на которое указывает итератор.
+     */
+    size_type occurrence() const noexcept { return index; }
+
+    reference operator*() const { return current->key; }
+
+    pointer operator->() const { return &current->key; }
+
+    Compressed_iterator& operator++() {
+      if (++index >= count_node(current.get_current())) {
+        ++current;
+        index = 0;
+      }
+      return *this;
+    }
+
+    Compressed_iterator operator++(int) {
+      Compressed_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    Compressed_iterator& operator--() {
+      if (index == 0) {
+        --current;
+        const size_type count = count_node(current.get_current());
+        index = count == 0 ? 0 : count - 1;
+      } else {
+        --index;
+      }
+      return *this;
+    }
+
+    Compressed_iterator operator--(int) {
+      Compressed_iterator tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const Compressed_iterator& other) const {
+      return current == other.current && index == other.index;
+    }
+
+    bool operator!=(const Compressed_iterator& other) const {
+      return !(*this == other);
+    }
+  };  // class Compressed_iterator
+
+ private:
+  /**
+   * @brief Возвращает количество вхождений ключа ноды, для концевой — 0.
+   */
+  static size_type count_node(const node_type* node) noexcept {
+    return node == BinaryTree::get_nil() ? 0 : node->val.count;
+  }
+
+  /**
+   * @brief Увеличивает счетчик ноды на count.
+   * @return Итератор на первое добавленное вхождение.
+   */
+  iterator add_occurrences(node_type* node, size_type count) noexcept {
+    const size_type first = node->val.count;
+    node->val.count += count;
+    total += count;
+    return iterator(tree_iterator(node, &tree), first);
+  }
+
+  /**
+   * @brief Заменяет содержимое элементами диапазона [first, last).
+   * @note Ключи сортируются (если диапазон еще не упорядочен), равные
+   * соседние сворачиваются в счетчики, и дерево собирается из уже
+   * упорядоченных нод за O(m), где m — количество различных ключей.
+   */
+  template <std::input_iterator InputIt>
+  void assign_range(InputIt first, InputIt last) {
+    std::vector<Counted_key<Key>> runs;
+    if constexpr (std::forward_iterator<InputIt>) {
+      if (std::is_sorted(first, last, Compare{})) {
+        append_runs(first, last, runs);
+        assign_runs(runs);
+        return;
+      }
+    }
+    std::vector<Key> keys(first, last);
+    std::stable_sort(keys.begin(), keys.end(), Compare{});
+    append_runs(std::make_move_iterator(keys.begin()),
+                std::make_move_iterator(keys.end()), runs);
+    assign_runs(runs);
+  }
+
+  /**
+   * @brief Сворачивает упорядоченные ключи в пары ключ-счетчик, сохраняя
+   * первый из равных объектов.
+   */
+  template <typename It>
+  static void append_runs(It first, It last,
+                          std::vector<Counted_key<Key>>& runs) {
+    const Compare comp{};
+    for (; first != last; ++first) {
+      if (!runs.empty() && !comp(runs.back().key, *first)) {
+        ++runs.back().count;
+      } else {
+        runs.push_back(Counted_key<Key>{*first, 1});
+      }
+    }
+  }
+
+  /**
+   * @brief Собирает дерево из упорядоченных уникальных пар ключ-счетчик.
+   */
+  void assign_runs(const std::vector<Counted_key<Key>>& runs) {
+    size_type count = 0;
+    for (const auto& run : runs) count += run.count;
+    tree.assign_sorted(runs.begin(), runs.end(), true);
+    total = count;
+  }
+
+  /**
+   * @brief Удаляет одно вхождение ключа ноды, последнее удаляет и ноду.
+   */
+  void remove_occurrence(node_type* node) noexcept {
+    if (--node->val.count == 0) tree.delete_node(node);
+    --total;
+  }
+
+  /**
+   * @brief Возвращает ноду подсказки или nullptr, если итератор принадлежит
+   * другому контейнеру.
+   */
+  const node_type* hint_node(const_iterator hint) const {
+    return tree.owns(hint.current) ? hint.current.get_current() : nullptr;
+  }
+};  // class compressed_multiset
+
+namespace pmr {
+/**
+ * @brief compressed_multiset, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          template <typename> class NodeT = Node>
+using compressed_multiset =
+    s21::compressed_multiset<Key, Compare,
+                             std::pmr::polymorphic_allocator<Key>, NodeT>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_COMPRESSED_MULTISET_H
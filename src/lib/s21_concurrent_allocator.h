@@ -0,0 +1,266 @@
+#ifndef S21_CONCURRENT_ALLOCATOR_H
+#define S21_CONCURRENT_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Общий для всех потоков пул блоков размера BlockSize с выравниванием
+ * Align.
+ * @note Каждый поток держит собственный кеш из двух пачек свободных блоков и
+ * обращается к центральному пулу под мьютексом только тогда, когда его кеш
+ * пуст или переполнен, то есть не чаще одного раза на batch_size операций.
+ * Блок, освобожденный в другом потоке, попадает в кеш этого потока и затем
+ * целой пачкой возвращается в центральный пул, откуда его получит любой поток.
+ */
+template <std::size_t BlockSize, std::size_t Align>
+class Concurrent_pool {
+ public:
+  // Количество блоков в пачке, которой поток обменивается с центральным пулом.
+  static constexpr std::size_t batch_size = 64;
+  // Количество пачек в одном блоке памяти, запрашиваемом у системы.
+  static constexpr std::size_t batches_per_chunk = 16;
+
+  /**
+   * @brief Выдает один блок из кеша текущего потока.
+   * @throw std::bad_alloc Если системе не удалось выделить новый блок памяти.
+   */
+  static void* allocate() {
+    if (cache_destroyed) return allocate_uncached();
+    Thread_cache& cache = thread_cache();
+    if (cache.loaded.count == 0) {
+      if (cache.previous.count != 0) {
+        std::swap(cache.loaded, cache.previous);
+      } else {
+        cache.loaded = central().pop_batch();
+      }
+    }
+    Free_block* block = cache.loaded.head;
+    cache.loaded.head = block->next;
+    --cache.loaded.count;
+    return block;
+  }
+
+  /**
+   * @brief Возвращает блок в кеш текущего потока, даже если он был выделен в
+   * другом потоке.
+   */
+  static void deallocate(void* p) noexcept {
+    auto* block = static_cast<Free_block*>(p);
+    if (cache_destroyed) {
+      block->next = nullptr;
+      central().push_batch({block, 1});
+      return;
+    }
+    Thread_cache& cache = thread_cache();
+    if (cache.loaded.count == batch_size) {
+      if (cache.previous.count != 0) central().push_batch(cache.previous);
+      cache.previous = cache.loaded;
+      cache.loaded = Batch{};
+    }
+    block->next = cache.loaded.head;
+    cache.loaded.head = block;
+    ++cache.loaded.count;
+  }
+
+ private:
+  /**
+   * @brief Свободный блок. Поля next_batch и count заполнены только у первого
+   * блока пачки, лежащей в центральном пуле.
+   */
+  struct Free_block {
+    Free_block* next;
+    Free_block* next_batch;
+    std::size_t count;
+  };
+  static_assert(BlockSize >= sizeof(Free_block) &&
+                Align >= alignof(Free_block));
+
+  struct Batch {
+    Free_block* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  /**
+   * @brief Центральный пул: список целых пачек и нарезаемый блок памяти.
+   * @note Блоки нарезаются из памяти по одной пачке за раз, поэтому страницы
+   * не затрагиваются раньше, чем понадобятся.
+   */
+  struct Central {
+    std::mutex mutex;
+    Free_block* batches = nullptr;
+    char* bump = nullptr;
+    char* bump_end = nullptr;
+    std::vector<void*> chunks;
+
+    Batch pop_batch() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (batches != nullptr) {
+        Free_block* head = batches;
+        batches = head->next_batch;
+        return {head, head->count};
+      }
+      if (bump == bump_end) allocate_chunk();
+      auto* head = reinterpret_cast<Free_block*>(bump);
+      for (std::size_t i = 0; i < batch_size; ++i, bump += BlockSize) {
+        reinterpret_cast<Free_block*>(bump)->next =
+            i + 1 < batch_size ? reinterpret_cast<Free_block*>(bump + BlockSize)
+                               : nullptr;
+      }
+      return {head, batch_size};
+    }
+
+    void push_batch(Batch batch) noexcept {
+      std::lock_guard<std::mutex> lock(mutex);
+      batch.head->count = batch.count;
+      batch.head->next_batch = batches;
+      batches = batch.head;
+    }
+
+    void allocate_chunk() {
+      constexpr std::size_t bytes = BlockSize * batch_size * batches_per_chunk;
+      chunks.reserve(chunks.size() + 1);
+      if constexpr (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        bump = static_cast<char*>(
+            ::operator new(bytes, std::align_val_t{Align}));
+      } else {
+        bump = static_cast<char*>(::operator new(bytes));
+      }
+      chunks.push_back(bump);
+      bump_end = bump + bytes;
+    }
+  };
+
+  /**
+   * @brief Кеш потока. При завершении потока его блоки возвращаются в
+   * центральный пул.
+   */
+  struct Thread_cache {
+    Batch loaded;
+    Batch previous;
+
+    ~Thread_cache() {
+      cache_destroyed = true;
+      if (loaded.count != 0) central().push_batch(loaded);
+      if (previous.count != 0) central().push_batch(previous);
+    }
+  };
+
+  /**
+   * @brief Выставляется при уничтожении кеша потока.
+   * @note Тривиально разрушаемый флаг остается доступным, пока живы
+   * thread_local и статические объекты, уничтожаемые после кеша. Их блоки
+   * идут напрямую через центральный пул.
+   */
+  static inline thread_local bool cache_destroyed = false;
+
+  static void* allocate_uncached() {
+    Batch batch = central().pop_batch();
+    Free_block* block = batch.head;
+    batch.head = block->next;
+    if (--batch.count != 0) central().push_batch(batch);
+    return block;
+  }
+
+  static Thread_cache& thread_cache() noexcept {
+    static thread_local Thread_cache cache;
+    return cache;
+  }
+
+  /**
+   * @note Пул намеренно не уничтожается: контейнеры со статическим временем
+   * жизни и кеши потоков могут возвращать в него блоки уже после завершения
+   * main, в том числе после уничтожения кеша главного потока.
+   */
+  static Central& central() noexcept {
+    static Central* const pool = new Central;
+    return *pool;
+  }
+};
+
+/**
+ * @brief Потокобезопасный пул-аллокатор для контейнеров set, multiset, map.
+ * @tparam T Тип элементов, для которых выделяется память.
+ * @note Все аллокаторы с одинаковым размером и выравниванием блока
+ * используют один общий пул, поэтому они равны, а деревья в разных потоках
+ * могут обмениваться нодами при merge. Одиночные объекты берутся из кеша
+ * потока без блокировок, массивы выделяются через ::operator new.
+ * Память пула возвращается системе только при завершении процесса.
+ */
+template <typename T>
+class concurrent_pool_allocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  concurrent_pool_allocator() noexcept = default;
+
+  template <typename U>
+  concurrent_pool_allocator(const concurrent_pool_allocator<U>&) noexcept {}
+
+  /**
+   * @brief Выделяет память для n элементов типа T.
+   * @throw std::bad_alloc Если запрашиваемый размер слишком велик.
+   */
+  [[nodiscard]] T* allocate(size_type n) {
+    if (n == 0) return nullptr;
+    if (n > max_size()) throw std::bad_alloc();
+    if (n == 1) return static_cast<T*>(pool::allocate());
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return static_cast<T*>(
+          ::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    } else {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+  }
+
+  /**
+   * @brief Возвращает одиночные объекты в кеш текущего потока, массивы —
+   * системе.
+   */
+  void deallocate(T* p, size_type n) noexcept {
+    if (n == 1) {
+      pool::deallocate(p);
+    } else if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      ::operator delete(p, n * sizeof(T), std::align_val_t{alignof(T)});
+    } else {
+      ::operator delete(p, n * sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Возвращает максимально возможное колличество элементов.
+   */
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  friend bool operator==(const concurrent_pool_allocator&,
+                         const concurrent_pool_allocator&) noexcept {
+    return true;
+  }
+
+ private:
+  // В свободном блоке хранятся три слова списка пачек.
+  static constexpr size_type block_align = std::max(alignof(T), alignof(void*));
+  static constexpr size_type block_size =
+      (std::max(sizeof(T), 3 * sizeof(void*)) + block_align - 1) /
+      block_align * block_align;
+
+  using pool = Concurrent_pool<block_size, block_align>;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONCURRENT_ALLOCATOR_H
@@ -0,0 +1,264 @@
+#ifndef S21_CONCURRENT_MAP_H
+#define S21_CONCURRENT_MAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_epoch.h"
+#include "s21_map.h"
+
+namespace s21 {
+
+/**
+ * @brief Упорядоченный ассоциативный массив для многих читателей и редких
+ * записей. Читатели не блокируются: они обходят неизменяемую опубликованную
+ * версию (s21::map), а писатель строит следующую версию и публикует её
+ * одной атомарной записью. Старые версии освобождаются по эпохам
+ * (Epoch_domain), когда их больше не читает ни один поток.
+ * @note Каждая публикация копирует версию за O(n), поэтому несколько
+ * изменений лучше применять одним вызовом update(). Писатели
+ * выполняются по одному.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<const K, T>>>
+class concurrent_map {
+ public:
+  using map_type = s21::map<K, T, Compare, Alloc>;
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = typename map_type::value_type;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+  /**
+   * @brief Согласованный снимок для чтения: версия не освобождается, пока
+   * снимок существует, и не меняется, даже если писатель публикует новые.
+   * @warning Снимок закрепляет эпоху своего потока, поэтому его нельзя
+   * передавать в другой поток, и он должен быть уничтожен раньше
+   * контейнера. Долгоживущий снимок задерживает освобождение всех версий.
+   */
+  class snapshot {
+   public:
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+
+    const map_type& operator*() const noexcept { return *version_; }
+    const map_type* operator->() const noexcept { return version_; }
+
+   private:
+    friend class concurrent_map;
+
+    // seq_cst вместе с закреплением эпохи: писатель, не увидевший
+    // закрепления, уже опубликовал версию, которую прочитает снимок.
+    explicit snapshot(const concurrent_map& map)
+        : version_(map.version_.load(std::memory_order_seq_cst)) {}
+
+    // Объявлен первым: эпоха закрепляется до чтения указателя на версию.
+    Epoch_domain::Guard guard_;
+    const map_type* version_;
+  };
+
+  concurrent_map() : version_(new map_type) {}
+
+  /**
+   * @brief Создает пустой контейнер, версии которого выделяют ноды копиями
+   * alloc.
+   */
+  explicit concurrent_map(const Alloc& alloc)
+      : version_(new map_type(alloc)) {}
+
+  concurrent_map(std::initializer_list<value_type> const& items)
+      : version_(new map_type(items)) {}
+
+  /**
+   * @brief Забирает map как первую опубликованную версию.
+   */
+  explicit concurrent_map(map_type&& map)
+      : version_(new map_type(std::move(map))) {}
+
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+
+  /**
+   * @warning К моменту уничтожения не должно остаться снимков и вызовов в
+   * других потоках.
+   */
+  ~concurrent_map() {
+    for (auto& retired : retired_) delete retired.first;
+    delete version_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Возвращает снимок текущей версии. Не блокируется и не
+   * записывает в общую с другими читателями память.
+   */
+  snapshot read() const { return snapshot(*this); }
+
+  /**
+   * @brief Копирует значение по ключу из текущей версии.
+   */
+  std::optional<mapped_type> get(const key_type& key) const {
+    const snapshot current(*this);
+    auto it = current->find(key);
+    if (it == current->end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool contains(const key_type& key) const { return read()->contains(key); }
+
+  size_type size() const { return read()->size(); }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Копия текущей версии.
+   */
+  map_type copy() const { return *read(); }
+
+  /**
+   * @brief Применяет fn к копии текущей версии и публикует результат.
+   * @param fn Вызывается как fn(map_type&) под мьютексом писателей.
+   * @return Результат fn.
+   * @throw Если копирование или fn бросают исключение, ничего не
+   * публикуется.
+   */
+  template <typename Fn>
+  auto update(Fn&& fn) {
+    std::lock_guard<std::mutex> lock(writer_);
+    auto next = std::make_unique<map_type>(
+        *version_.load(std::memory_order_relaxed));
+    if constexpr (std::is_void_v<std::invoke_result_t<Fn, map_type&>>) {
+      std::forward<Fn>(fn)(*next);
+      publish(std::move(next));
+    } else {
+      auto res = std::forward<Fn>(fn)(*next);
+      publish(std::move(next));
+      return res;
+    }
+  }
+
+  /**
+   * @brief Публикует map целиком вместо текущей версии без копирования.
+   */
+  void assign(map_type&& map) {
+    auto next = std::make_unique<map_type>(std::move(map));
+    std::lock_guard<std::mutex> lock(writer_);
+    publish(std::move(next));
+  }
+
+  /**
+   * @brief Добавляет пару, если такого ключа еще нет.
+   * @return Флаг вставки. Если ключ уже есть, новая версия не создается.
+   */
+  bool insert(const value_type& value) {
+    std::lock_guard<std::mutex> lock(writer_);
+    const map_type& current = *version_.load(std::memory_order_relaxed);
+    if (current.contains(value.first)) return false;
+    auto next = std::make_unique<map_type>(current);
+    next->insert(value);
+    publish(std::move(next));
+    return true;
+  }
+
+  /**
+   * @brief Добавляет пару или заменяет значение существующего ключа.
+   * @return Флаг был ли создан элемент.
+   */
+  template <typename M>
+  bool insert_or_assign(const key_type& key, M&& obj) {
+    return update([&](map_type& next) {
+      return next.insert_or_assign(key, std::forward<M>(obj)).second;
+    });
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1). Если ключа нет, новая
+   * версия не создается.
+   */
+  size_type erase(const key_type& key) {
+    std::lock_guard<std::mutex> lock(writer_);
+    const map_type& current = *version_.load(std::memory_order_relaxed);
+    if (!current.contains(key)) return 0;
+    auto next = std::make_unique<map_type>(current);
+    next->erase(key);
+    publish(std::move(next));
+    return 1;
+  }
+
+  void clear() { assign(map_type(get_allocator())); }
+
+  allocator_type get_allocator() const {
+    return read()->get_allocator();
+  }
+
+  /**
+   * @brief Освобождает старые версии, которые больше никто не читает.
+   * @return Количество освобожденных версий.
+   * @note Вызывается при каждой публикации, отдельно нужен только чтобы
+   * освободить память после последней записи.
+   */
+  size_type reclaim() {
+    std::lock_guard<std::mutex> lock(writer_);
+    return reclaim_locked();
+  }
+
+  /**
+   * @brief Ждет окончания чтений старых версий и освобождает их.
+   * @warning Нельзя вызывать, удерживая снимок любого контейнера.
+   */
+  void synchronize() {
+    Epoch_domain::synchronize();
+    reclaim();
+  }
+
+  /**
+   * @brief Количество старых версий, ожидающих освобождения.
+   */
+  size_type retired_versions() const {
+    std::lock_guard<std::mutex> lock(writer_);
+    return retired_.size();
+  }
+
+ private:
+  /**
+   * @brief Публикует next и откладывает освобождение прежней версии.
+   * Вызывается под мьютексом писателей.
+   */
+  void publish(std::unique_ptr<map_type> next) {
+    retired_.reserve(retired_.size() + 1);
+    map_type* previous =
+        version_.exchange(next.release(), std::memory_order_seq_cst);
+    retired_.emplace_back(previous, Epoch_domain::current());
+    reclaim_locked();
+  }
+
+  size_type reclaim_locked() {
+    if (retired_.empty()) return 0;
+    Epoch_domain::try_advance();
+    // Эпохи в retired_ не убывают: свободные версии образуют префикс.
+    size_type ready = 0;
+    while (ready < retired_.size() &&
+           Epoch_domain::passed(retired_[ready].second)) {
+      delete retired_[ready].first;
+      ++ready;
+    }
+    retired_.erase(retired_.begin(), retired_.begin() + ready);
+    return ready;
+  }
+
+  std::atomic<map_type*> version_;
+  mutable std::mutex writer_;
+  // Снятые с публикации версии и эпохи, в которые это произошло.
+  std::vector<std::pair<map_type*, std::uint64_t>> retired_;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONCURRENT_MAP_H
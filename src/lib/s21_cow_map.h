@@ -0,0 +1,259 @@
+#ifndef S21_COW_MAP_H
+#define S21_COW_MAP_H
+
+#include <memory_resource>
+#include <stdexcept>
+
+#include "s21_cow_ptr.h"
+#include "s21_map.h"
+
+namespace s21 {
+
+/**
+ * @brief Ассоциативный массив s21::map с копированием при записи: копия
+ * разделяет дерево с оригиналом и копирует его только при первом изменении.
+ * @note Константные методы и константные итераторы работают с деревом
+ * напрямую, без атомарных операций. Неконстантные begin(), end(), find(),
+ * operator[] и at() возвращают доступ на запись, поэтому копируют
+ * разделяемое дерево.
+ * @warning Изменение контейнера, разделяющего дерево, делает
+ * недействительными полученные из него итераторы и ссылки.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<const K, T>>,
+          template <typename> class NodeT = Node>
+class cow_map {
+ public:
+  using map_type = s21::map<K, T, Compare, Alloc, NodeT>;
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = std::pair<const K, T>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename map_type::iterator;
+  using const_iterator = typename map_type::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  Cow_ptr<map_type> map_;
+
+  /**
+   * @brief Дерево для записи. Разделяемое дерево сначала копируется с тем же
+   * аллокатором, а не с аллокатором по умолчанию, как при копировании
+   * контейнера.
+   */
+  map_type& write() {
+    if (map_.shared()) {
+      map_ = Cow_ptr<map_type>(map_type(get(), get_allocator()));
+    }
+    return map_.write();
+  }
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов и не выделяет
+   * память.
+   */
+  cow_map() = default;
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit cow_map(const Alloc& alloc) : map_(map_type(alloc)) {}
+
+  cow_map(std::initializer_list<value_type> const& items)
+      : map_(map_type(items)) {}
+
+  template <std::input_iterator InputIt>
+  cow_map(InputIt first, InputIt last) : map_(map_type(first, last)) {}
+
+  /**
+   * @brief Забирает map как разделяемое дерево без копирования нод.
+   */
+  explicit cow_map(map_type&& map) : map_(std::move(map)) {}
+
+  /**
+   * @brief Разделяет дерево other за O(1).
+   */
+  cow_map(const cow_map& other) = default;
+
+  cow_map(cow_map&& other) noexcept = default;
+
+  ~cow_map() = default;
+
+  cow_map& operator=(const cow_map& other) = default;
+
+  cow_map& operator=(cow_map&& other) noexcept = default;
+
+  /**
+   * @brief Массив для чтения, например для передачи в функции,
+   * принимающие const s21::map&.
+   */
+  const map_type& get() const noexcept { return map_.get(); }
+
+  /**
+   * @brief Проверяет, что дерево разделяют другие копии и изменение его
+   * скопирует.
+   */
+  bool shared() const noexcept { return map_.shared(); }
+
+  bool shares_with(const cow_map& other) const noexcept {
+    return map_.shares_with(other.map_);
+  }
+
+  /**
+   * @brief Доступ к значению по ключу на запись. Если ключа нет, создается
+   * элемент со значением по умолчанию.
+   */
+  T& operator[](const K& key) { return write()[key]; }
+
+  T& operator[](K&& key) { return write()[std::move(key)]; }
+
+  /**
+   * @throw std::out_of_range("cow_map::at") если такого ключа нет.
+   */
+  mapped_type& at(const key_type& key) {
+    map_type& map = write();
+    auto it = map.find(key);
+    if (it == map.end()) throw std::out_of_range("cow_map::at");
+    return it->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    auto it = get().find(key);
+    if (it == get().end()) throw std::out_of_range("cow_map::at");
+    return it->second;
+  }
+
+  iterator begin() { return write().begin(); }
+
+  const_iterator begin() const noexcept { return get().begin(); }
+
+  iterator end() { return write().end(); }
+
+  const_iterator end() const noexcept { return get().end(); }
+
+  const_iterator cbegin() const noexcept { return get().begin(); }
+
+  const_iterator cend() const noexcept { return get().end(); }
+
+  bool empty() const noexcept { return get().empty(); }
+
+  size_type size() const noexcept { return get().size(); }
+
+  size_type max_size() const noexcept {
+    return const_cast<map_type&>(get()).max_size();
+  }
+
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = get().memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return get().get_allocator();
+  }
+
+  /**
+   * @brief Удаляет все элементы. Разделяемое дерево не копируется, а
+   * остается другим копиям.
+   */
+  void clear() {
+    if (map_.shared()) {
+      map_ = Cow_ptr<map_type>(map_type(get_allocator()));
+    } else {
+      write().clear();
+    }
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return write().insert(value);
+  }
+
+  std::pair<iterator, bool> insert(const K& key, const T& obj) {
+    return write().insert(key, obj);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return write().insert(std::move(value));
+  }
+
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    map_type& map = write();
+    for (; first != last; ++first) map.insert(*first);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return write().emplace(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return write().try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    return write().insert_or_assign(key, std::forward<M>(obj));
+  }
+
+  /**
+   * @brief Удаляет элемент, на который указывает pos.
+   * @note Если дерево разделяется, элемент удаляется по ключу из
+   * собственной копии.
+   */
+  void erase(iterator pos) {
+    if (!map_.shared()) {
+      write().erase(pos);
+      return;
+    }
+    // Удерживает разделяемое дерево, пока ключ из pos нужен для поиска.
+    const Cow_ptr<map_type> keep(map_);
+    write().erase(pos->first);
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу. Если ключа нет, разделяемое дерево не
+   * копируется.
+   */
+  size_type erase(const key_type& key) {
+    if (map_.shared() && !get().contains(key)) return 0;
+    return write().erase(key);
+  }
+
+  void swap(cow_map& other) noexcept { map_.swap(other.map_); }
+
+  /**
+   * @brief Переносит в контейнер элементы other, ключей которых в нем нет.
+   */
+  void merge(cow_map& other) {
+    if (this != &other) write().merge(other.write());
+  }
+
+  bool contains(const key_type& key) const { return get().contains(key); }
+
+  size_type count(const key_type& key) const { return get().count(key); }
+
+  iterator find(const key_type& key) { return write().find(key); }
+
+  const_iterator find(const key_type& key) const { return get().find(key); }
+};  // class cow_map
+
+namespace pmr {
+/**
+ * @brief cow_map, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Compare = std::less<K>>
+using cow_map =
+    s21::cow_map<K, T, Compare,
+                 std::pmr::polymorphic_allocator<std::pair<const K, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_COW_MAP_H
@@ -0,0 +1,127 @@
+#ifndef S21_COW_PTR_H
+#define S21_COW_PTR_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace s21 {
+
+/**
+ * @brief Владеющий указатель с копированием при записи: копии разделяют один
+ * объект, а первая запись через копию, которую разделяют другие, создает ей
+ * собственный экземпляр.
+ * @tparam T тип объекта, должен иметь конструктор по умолчанию и
+ * копирования.
+ * @note Чтение через get() не трогает счетчик ссылок. Атомарные операции
+ * выполняются только при копировании, уничтожении и записи, поэтому копии
+ * можно передавать в другие потоки. Пустой указатель читается как T().
+ * @warning Одну копию нельзя изменять одновременно с другими обращениями к
+ * ней.
+ */
+template <typename T>
+class Cow_ptr {
+ public:
+  Cow_ptr() noexcept : block_(nullptr) {}
+
+  /**
+   * @brief Забирает value как разделяемый объект.
+   */
+  explicit Cow_ptr(T&& value) : block_(new Block(std::move(value))) {}
+
+  Cow_ptr(const Cow_ptr& other) noexcept : block_(other.block_) {
+    retain(block_);
+  }
+
+  Cow_ptr(Cow_ptr&& other) noexcept
+      : block_(std::exchange(other.block_, nullptr)) {}
+
+  ~Cow_ptr() { release(block_); }
+
+  Cow_ptr& operator=(const Cow_ptr& other) noexcept {
+    retain(other.block_);
+    release(block_);
+    block_ = other.block_;
+    return *this;
+  }
+
+  Cow_ptr& operator=(Cow_ptr&& other) noexcept {
+    if (this != &other) {
+      release(block_);
+      block_ = std::exchange(other.block_, nullptr);
+    }
+    return *this;
+  }
+
+  void swap(Cow_ptr& other) noexcept { std::swap(block_, other.block_); }
+
+  /**
+   * @brief Объект для чтения без синхронизации.
+   */
+  const T& get() const noexcept {
+    return block_ != nullptr ? block_->value : empty();
+  }
+
+  /**
+   * @brief Объект для записи. Если его разделяют другие копии, сначала
+   * создается собственный экземпляр.
+   * @throw Исключение копирования T. Указатель остается прежним.
+   */
+  T& write() {
+    if (block_ == nullptr) {
+      block_ = new Block();
+    } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+      Block* copy = new Block(std::as_const(block_->value));
+      release(block_);
+      block_ = copy;
+    }
+    return block_->value;
+  }
+
+  /**
+   * @brief Проверяет, что объект разделяют другие копии и запись его
+   * скопирует.
+   */
+  bool shared() const noexcept {
+    return block_ != nullptr &&
+           block_->refs.load(std::memory_order_relaxed) != 1;
+  }
+
+  /**
+   * @brief Проверяет, что указатели разделяют один объект.
+   */
+  bool shares_with(const Cow_ptr& other) const noexcept {
+    return block_ != nullptr && block_ == other.block_;
+  }
+
+ private:
+  struct Block {
+    std::atomic<std::size_t> refs{1};
+    T value;
+
+    template <typename... Args>
+    explicit Block(Args&&... args) : value(std::forward<Args>(args)...) {}
+  };
+
+  static const T& empty() noexcept {
+    static const T value;
+    return value;
+  }
+
+  static void retain(Block* block) noexcept {
+    if (block != nullptr) block->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void release(Block* block) noexcept {
+    if (block != nullptr &&
+        block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete block;
+    }
+  }
+
+  Block* block_;
+};  // class Cow_ptr
+
+}  // namespace s21
+
+#endif  // S21_COW_PTR_H
@@ -0,0 +1,224 @@
+#ifndef S21_COW_SET_H
+#define S21_COW_SET_H
+
+#include <memory_resource>
+
+#include "s21_cow_ptr.h"
+#include "s21_set.h"
+
+namespace s21 {
+
+/**
+ * @brief Множество s21::set с копированием при записи: копия разделяет
+ * дерево с оригиналом и копирует его только при первом изменении. Подходит
+ * для передачи множеств по значению, когда большинство копий только
+ * читается.
+ * @note Итераторы и константные методы работают с деревом напрямую, без
+ * атомарных операций. Изменение, которое ничего не меняет (вставка
+ * существующего ключа, удаление отсутствующего), дерево не копирует.
+ * @warning Изменение контейнера, разделяющего дерево, делает
+ * недействительными полученные из него итераторы.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>,
+          template <typename> class NodeT = Node>
+class cow_set {
+ public:
+  using set_type = s21::set<Key, Compare, Alloc, NodeT>;
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using iterator = typename set_type::iterator;
+  using const_iterator = typename set_type::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  Cow_ptr<set_type> set_;
+
+  /**
+   * @brief Дерево для записи. Разделяемое дерево сначала копируется с тем же
+   * аллокатором, а не с аллокатором по умолчанию, как при копировании
+   * контейнера.
+   */
+  set_type& write() {
+    if (set_.shared()) {
+      set_ = Cow_ptr<set_type>(set_type(get(), get_allocator()));
+    }
+    return set_.write();
+  }
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов и не выделяет
+   * память.
+   */
+  cow_set() = default;
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit cow_set(const Alloc& alloc) : set_(set_type(alloc)) {}
+
+  cow_set(std::initializer_list<value_type> const& items)
+      : set_(set_type(items)) {}
+
+  template <std::input_iterator InputIt>
+  cow_set(InputIt first, InputIt last) : set_(set_type(first, last)) {}
+
+  /**
+   * @brief Забирает set как разделяемое дерево без копирования нод.
+   */
+  explicit cow_set(set_type&& set) : set_(std::move(set)) {}
+
+  /**
+   * @brief Разделяет дерево other за O(1).
+   */
+  cow_set(const cow_set& other) = default;
+
+  cow_set(cow_set&& other) noexcept = default;
+
+  ~cow_set() = default;
+
+  cow_set& operator=(const cow_set& other) = default;
+
+  cow_set& operator=(cow_set&& other) noexcept = default;
+
+  /**
+   * @brief Множество для чтения, например для передачи в функции,
+   * принимающие const s21::set&.
+   */
+  const set_type& get() const noexcept { return set_.get(); }
+
+  /**
+   * @brief Проверяет, что дерево разделяют другие копии и изменение его
+   * скопирует.
+   */
+  bool shared() const noexcept { return set_.shared(); }
+
+  bool shares_with(const cow_set& other) const noexcept {
+    return set_.shares_with(other.set_);
+  }
+
+  iterator begin() const noexcept { return get().begin(); }
+
+  iterator end() const noexcept { return get().end(); }
+
+  const_iterator cbegin() const noexcept { return get().begin(); }
+
+  const_iterator cend() const noexcept { return get().end(); }
+
+  bool empty() const noexcept { return get().empty(); }
+
+  size_type size() const noexcept { return get().size(); }
+
+  size_type max_size() const noexcept {
+    return const_cast<set_type&>(get()).max_size();
+  }
+
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = get().memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return get().get_allocator();
+  }
+
+  /**
+   * @brief Удаляет все элементы. Разделяемое дерево не копируется, а
+   * остается другим копиям.
+   */
+  void clear() {
+    if (set_.shared()) {
+      set_ = Cow_ptr<set_type>(set_type(get_allocator()));
+    } else {
+      write().clear();
+    }
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    if (set_.shared()) {
+      auto it = get().find(value);
+      if (it != get().end()) return {it, false};
+    }
+    return write().insert(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    if (set_.shared()) {
+      auto it = get().find(value);
+      if (it != get().end()) return {it, false};
+    }
+    return write().insert(std::move(value));
+  }
+
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return write().emplace(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Удаляет элемент, на который указывает pos.
+   * @note Если дерево разделяется, элемент удаляется по ключу из
+   * собственной копии.
+   */
+  void erase(iterator pos) {
+    if (!set_.shared()) {
+      write().erase(pos);
+      return;
+    }
+    // Удерживает разделяемое дерево, пока ключ из pos нужен для поиска.
+    const Cow_ptr<set_type> keep(set_);
+    write().erase(*pos);
+  }
+
+  size_type erase(const key_type& key) {
+    if (set_.shared() && !get().contains(key)) return 0;
+    return write().erase(key);
+  }
+
+  void swap(cow_set& other) noexcept { set_.swap(other.set_); }
+
+  /**
+   * @brief Переносит в контейнер элементы other, ключей которых в нем нет.
+   */
+  void merge(cow_set& other) {
+    if (this != &other) write().merge(other.write());
+  }
+
+  bool contains(const key_type& key) const { return get().contains(key); }
+
+  size_type count(const key_type& key) const { return get().count(key); }
+
+  const_iterator find(const key_type& key) const { return get().find(key); }
+
+  const_iterator lower_bound(const key_type& key) const {
+    return get().lower_bound(key);
+  }
+
+  const_iterator upper_bound(const key_type& key) const {
+    return get().upper_bound(key);
+  }
+};  // class cow_set
+
+namespace pmr {
+/**
+ * @brief cow_set, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>>
+using cow_set =
+    s21::cow_set<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_COW_SET_H
@@ -0,0 +1,182 @@
+#ifndef S21_EPOCH_H
+#define S21_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace s21 {
+
+/**
+ * @brief Общие для процесса эпохи для освобождения памяти, которую читают
+ * другие потоки без блокировок (epoch-based reclamation).
+ * @note Читатель на время доступа закрепляет текущую эпоху (Guard).
+ * Писатель снимает объект с публикации и запоминает эпоху current(). Эпоха
+ * продвигается, только когда все закрепленные потоки видели текущую,
+ * поэтому после двух продвижений (passed()) ни один читатель уже не держит
+ * указатель на объект и его можно освободить. Читатель пишет только в
+ * собственную запись, так что чтения в разных потоках не мешают друг другу.
+ */
+class Epoch_domain {
+ public:
+  /**
+   * @brief Закрепляет эпоху текущего потока на время своего существования.
+   * Вложенные Guard одного потока допустимы.
+   * @throw std::bad_alloc при первом закреплении в потоке, если не удалось
+   * выделить его запись.
+   */
+  class Guard {
+   public:
+    Guard() { pin(); }
+    ~Guard() { unpin(); }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+  };
+
+  /**
+   * @brief Эпоха, которой помечается объект сразу после снятия с
+   * публикации.
+   */
+  static std::uint64_t current() noexcept {
+    return global().epoch.load(std::memory_order_seq_cst);
+  }
+
+  /**
+   * @brief Продвигает эпоху, если все закрепленные потоки видели текущую.
+   * @return true, если эпоха продвинута этим или другим потоком.
+   */
+  static bool try_advance() noexcept {
+    Global& g = global();
+    std::uint64_t epoch = g.epoch.load(std::memory_order_seq_cst);
+    for (Record* r = g.records.load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+      // seq_cst в паре с закреплением: либо читатель виден закрепленным,
+      // либо он прочитает уже новую версию. Заодно это acquire к выходу
+      // читателя, так что его чтения завершились до освобождения.
+      const std::uint64_t state = r->state.load(std::memory_order_seq_cst);
+      if ((state & 1) != 0 && (state >> 1) != epoch) return false;
+    }
+    g.epoch.compare_exchange_strong(epoch, epoch + 1,
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Проверяет, что объект, снятый с публикации в эпоху epoch, уже не
+   * виден ни одному читателю.
+   */
+  static bool passed(std::uint64_t epoch) noexcept {
+    return global().epoch.load(std::memory_order_acquire) >= epoch + 2;
+  }
+
+  /**
+   * @brief Ждет, пока выйдут все читатели, закрепившие эпоху до вызова:
+   * после возврата passed(e) истинно для любого e, полученного раньше.
+   * @warning Нельзя вызывать, удерживая Guard: ожидание не завершится.
+   */
+  static void synchronize() noexcept {
+    const std::uint64_t target = current() + 2;
+    while (global().epoch.load(std::memory_order_acquire) < target) {
+      if (!try_advance()) std::this_thread::yield();
+    }
+  }
+
+ private:
+  /**
+   * @brief Запись потока. Выровнена по кеш-линии, чтобы закрепления разных
+   * потоков не делили линию.
+   */
+  struct alignas(64) Record {
+    // (эпоха << 1) | 1, пока поток закреплен, иначе 0.
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> in_use{true};
+    // Не меняется после публикации записи в списке.
+    Record* next = nullptr;
+  };
+
+  struct Global {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<Record*> records{nullptr};
+  };
+
+  /**
+   * @brief Запись и глубина вложенности Guard в текущем потоке. При
+   * завершении потока запись освобождается для других потоков.
+   */
+  struct Thread_state {
+    Record* record = nullptr;
+    std::size_t depth = 0;
+
+    ~Thread_state() {
+      if (record != nullptr) {
+        record->in_use.store(false, std::memory_order_release);
+      }
+    }
+  };
+
+  static void pin() {
+    Thread_state& thread = thread_state();
+    if (thread.depth != 0) {
+      ++thread.depth;
+      return;
+    }
+    if (thread.record == nullptr) thread.record = acquire_record();
+    const std::uint64_t epoch = global().epoch.load(std::memory_order_relaxed);
+    // Закрепление должно стать видимым раньше, чем поток прочитает
+    // опубликованные указатели, поэтому запись seq_cst.
+    thread.record->state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+    thread.depth = 1;
+  }
+
+  static void unpin() noexcept {
+    Thread_state& thread = thread_state();
+    if (--thread.depth == 0) {
+      thread.record->state.store(0, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Занимает запись завершившегося потока или добавляет новую.
+   * Записи никогда не удаляются, поэтому список обходится без блокировок.
+   */
+  static Record* acquire_record() {
+    Global& g = global();
+    for (Record* r = g.records.load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true,
+                                            std::memory_order_acquire)) {
+        return r;
+      }
+    }
+    Record* record = new Record;
+    record->next = g.records.load(std::memory_order_relaxed);
+    while (!g.records.compare_exchange_weak(record->next, record,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    }
+    return record;
+  }
+
+  static Thread_state& thread_state() noexcept {
+    static thread_local Thread_state state;
+    return state;
+  }
+
+  /**
+   * @note Эпохи намеренно не уничтожаются: потоки могут завершаться и
+   * освобождать записи уже после завершения main.
+   */
+  static Global& global() noexcept {
+    static Global* const state = new Global;
+    return *state;
+  }
+};
+
+}  // namespace s21
+
+#endif  // S21_EPOCH_H
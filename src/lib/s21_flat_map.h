@@ -0,0 +1,585 @@
+#ifndef S21_FLAT_MAP_H
+#define S21_FLAT_MAP_H
+
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "s21_flat_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Ассоциативный массив в упорядоченном массиве пар с интерфейсом
+ * s21::map.
+ * @note Пары хранятся как std::pair<K, T>, чтобы их можно было сортировать
+ * и сдвигать. Итератор, как у std::flat_map, возвращает не ссылку на пару,
+ * а пару ссылок std::pair<const K&, T&>, поэтому ключ элемента нельзя
+ * менять через итератор. Для обхода с изменением значений используйте
+ * for (auto&& [key, value] : map).
+ * @warning Вставка и удаление одного элемента работают за O(n) и делают
+ * недействительными все итераторы и ссылки. Множество элементов лучше
+ * вставлять пакетно через insert(first, last).
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<K, T>>>
+class flat_map {
+ public:
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = std::pair<K, T>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree = Flat_tree<K, value_type, s21::Select1st, Compare, Alloc>;
+
+  template <bool Const>
+  class Flat_map_iterator;
+  using iterator = Flat_map_iterator<false>;
+  using const_iterator = Flat_map_iterator<true>;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using container_type = typename BinaryTree::container_type;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  flat_map() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  flat_map(std::initializer_list<value_type> const& items)
+      : flat_map(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Значения сортируются и сливаются пакетно за O(n log n). Из
+   * повторяющихся ключей остается первый.
+   */
+  template <std::input_iterator InputIt>
+  flat_map(InputIt first, InputIt last) : flat_map{} {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   * @warning Порядок элементов не проверяется.
+   */
+  template <std::input_iterator InputIt>
+  flat_map(sorted_range_t, InputIt first, InputIt last) : flat_map{} {
+    tree.assign_sorted(first, last);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, массив которого выделяется копией
+   * alloc.
+   */
+  explicit flat_map(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  flat_map(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : flat_map(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  flat_map(InputIt first, InputIt last, const Alloc& alloc)
+      : flat_map(alloc) {
+    tree.insert_range(first, last, true);
+  }
+
+  /**
+   * @brief Копирует other, выделяя массив копией alloc.
+   */
+  flat_map(const flat_map& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новый массив.
+   */
+  flat_map(flat_map&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
+  flat_map(const flat_map& other) : tree(other.tree) {}
+
+  flat_map(flat_map&& other) noexcept : tree(std::move(other.tree)) {}
+
+  ~flat_map() = default;
+
+  flat_map& operator=(const flat_map& other) {
+    tree = other.tree;
+    return *this;
+  }
+
+  flat_map& operator=(flat_map&& other) noexcept {
+    tree = std::move(other.tree);
+    return *this;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу. Если ключа нет, создается элемент со
+   * значением по умолчанию.
+   * @note Выполняет один двоичный поиск.
+   */
+  T& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  T& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  /**
+   * @brief Получает ссылку на значение по ключу.
+   * @throw std::out_of_range("flat_map::at") если такого ключа нет.
+   */
+  mapped_type& at(const key_type& key) {
+    auto it = tree.find(key);
+    if (it == tree.end()) throw std::out_of_range("flat_map::at");
+    return it->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    auto it = tree.find(key);
+    if (it == tree.end()) throw std::out_of_range("flat_map::at");
+    return it->second;
+  }
+
+  /**
+   * @brief Итераторы обходят пары в порядке возрастания ключей.
+   */
+  inline iterator begin() { return tree.begin(); }
+  inline const_iterator begin() const { return tree.begin(); }
+  inline iterator end() { return tree.end(); }
+  inline const_iterator end() const { return tree.end(); }
+
+  inline bool empty() const noexcept { return tree.empty(); }
+
+  inline size_type size() const noexcept { return tree.size(); }
+
+  inline size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы.
+   */
+  inline void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Уменьшает емкость массива до количества элементов.
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: массив вместе с
+   * запасом емкости и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Добавляет пару, только если такого ключа еще нет.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree.emplace_with_key(value.first, true, value);
+  }
+
+  std::pair<iterator, bool> insert(const K& key, const T& obj) {
+    return tree.emplace_with_key(key, true, key, obj);
+  }
+
+  /**
+   * @brief Перемещает пару, только если такого ключа еще нет. Если ключ уже
+   * есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree.emplace_with_key(value.first, true, std::move(value));
+  }
+
+  /**
+   * @brief Конструирует пару из args и вставляет её, если такого ключа ещё
+   * нет.
+   * @note Пара создается до поиска места вставки. Чтобы не создавать
+   * значение зря, используйте try_emplace.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree.emplace(true, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Добавляет пару, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент с таким ключом.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree.emplace_hint_with_key(hint.base(), value.first, true, value)
+        .first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree
+        .emplace_hint_with_key(hint.base(), value.first, true,
+                               std::move(value))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree.emplace_hint(hint.base(), true, std::forward<Args>(args)...)
+        .first;
+  }
+
+  /**
+   * @brief Пакетная вставка диапазона [first, last): элементы сортируются и
+   * сливаются с массивом за O(n + m log m) вместо m сдвигов хвоста.
+   * @note Из равных ключей остается первый: уже существующий или раньше
+   * встретившийся в диапазоне.
+   */
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    tree.insert_range(first, last, true);
+  }
+
+  void insert(std::initializer_list<value_type> items) {
+    insert(items.begin(), items.end());
+  }
+
+  /**
+   * @brief Вставляет элемент с ключом key, значение которого конструируется
+   * из args, если такого ключа ещё нет.
+   * @note Если ключ уже существует, ни key, ни args не используются.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return tree.emplace_with_key(
+        key, true, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return tree.emplace_with_key(
+        key, true, std::piecewise_construct,
+        std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, const K& key, Args&&... args) {
+    return tree
+        .emplace_hint_with_key(
+            hint.base(), key, true, std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, K&& key, Args&&... args) {
+    return tree
+        .emplace_hint_with_key(
+            hint.base(), key, true, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...))
+        .first;
+  }
+
+  /**
+   * @brief Добавляет пару или заменяет значение существующего ключа.
+   * @return Пара итератор на элемент и флаг был ли создан элемент.
+   */
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    auto res = try_emplace(key, std::forward<M>(obj));
+    // try_emplace использует obj только при вставке.
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    auto res = try_emplace(std::move(key), std::forward<M>(obj));
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   */
+  void erase(iterator pos) {
+    if (tree.owns(pos.base()) && pos != end()) tree.erase(pos.base());
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const K& key) { return tree.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, const_iterator>)
+  size_type erase(const KT& key) {
+    return tree.erase_key(key);
+  }
+
+  void swap(flat_map& other) noexcept {
+    if (this != &other) tree.swap(other.tree);
+  }
+
+  /**
+   * @brief Перемещает элементы other, ключей которых ещё нет. Остальные
+   * элементы остаются в other.
+   */
+  void merge(flat_map& other) { tree.merge(other.tree, true); }
+
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  iterator find(const K& key) { return tree.find(key); }
+
+  const_iterator find(const K& key) const { return tree.find(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) {
+    return tree.find(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  const_iterator find(const KT& key) const {
+    return tree.find(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key, или end().
+   */
+  iterator lower_bound(const K& key) { return tree.lower_bound(key); }
+
+  const_iterator lower_bound(const K& key) const {
+    return tree.lower_bound(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) {
+    return tree.lower_bound(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key,
+   * или end().
+   */
+  iterator upper_bound(const K& key) { return tree.upper_bound(key); }
+
+  const_iterator upper_bound(const K& key) const {
+    return tree.upper_bound(key);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) {
+    return tree.upper_bound(key);
+  }
+
+  /**
+   * @brief Заменяет содержимое элементами упорядоченного по возрастанию
+   * ключей диапазона [first, last) за O(n).
+   * @throw При исключении содержимое не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    tree.assign_sorted(first, last);
+  }
+
+  /**
+   * @brief Забирает упорядоченный массив за O(1), например, собранный
+   * заранее или полученный из другого процесса.
+   * @warning Порядок и уникальность ключей не проверяются.
+   */
+  void replace(container_type&& sorted) noexcept {
+    tree.replace(std::move(sorted));
+  }
+
+  /**
+   * @brief Резервирует место под n элементов, чтобы вставки не
+   * перевыделяли массив.
+   */
+  void reserve(size_type n) { tree.reserve(n); }
+
+  size_type capacity() const noexcept { return tree.capacity(); }
+
+  /**
+   * @brief Вставляет несколько пар с уникальными ключами за одну операцию.
+   * @return Пары итератор на элемент и флаг была ли выполнена вставка.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return tree.template insert_many<iterator>(true,
+                                               std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Итератор произвольного доступа по массиву пар.
+   * @note Разыменование возвращает пару ссылок с константным ключом, а
+   * operator-> — указатель на такую пару, хранящуюся во временном объекте.
+   */
+  template <bool Const>
+  class Flat_map_iterator {
+    friend class Flat_map_iterator<!Const>;
+
+    using base_iterator =
+        std::conditional_t<Const, typename BinaryTree::const_iterator,
+                           typename BinaryTree::iterator>;
+
+    base_iterator it_{};
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::pair<K, T>;
+    using reference =
+        std::pair<const K&, std::conditional_t<Const, const T&, T&>>;
+
+    /**
+     * @brief Хранит пару ссылок, на которую указывает operator->.
+     */
+    struct pointer {
+      reference ref;
+      const reference* operator->() const noexcept { return &ref; }
+    };
+
+    Flat_map_iterator() = default;
+
+    /**
+     * @brief Оборачивает итератор массива.
+     */
+    Flat_map_iterator(base_iterator it) : it_(it) {}
+
+    /**
+     * @brief Неявное преобразование обычного итератора в константный.
+     */
+    template <bool IsConst = Const>
+      requires IsConst
+    Flat_map_iterator(const Flat_map_iterator<false>& it) : it_(it.it_) {}
+
+    /**
+     * @brief Возвращает итератор массива.
+     */
+    base_iterator base() const noexcept { return it_; }
+
+    reference operator*() const { return {it_->first, it_->second}; }
+
+    pointer operator->() const { return {**this}; }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    Flat_map_iterator& operator++() {
+      ++it_;
+      return *this;
+    }
+
+    Flat_map_iterator operator++(int) {
+      Flat_map_iterator tmp = *this;
+      ++it_;
+      return tmp;
+    }
+
+    Flat_map_iterator& operator--() {
+      --it_;
+      return *this;
+    }
+
+    Flat_map_iterator operator--(int) {
+      Flat_map_iterator tmp = *this;
+      --it_;
+      return tmp;
+    }
+
+    Flat_map_iterator& operator+=(difference_type n) {
+      it_ += n;
+      return *this;
+    }
+
+    Flat_map_iterator& operator-=(difference_type n) {
+      it_ -= n;
+      return *this;
+    }
+
+    friend Flat_map_iterator operator+(Flat_map_iterator it,
+                                       difference_type n) {
+      return it += n;
+    }
+
+    friend Flat_map_iterator operator+(difference_type n,
+                                       Flat_map_iterator it) {
+      return it += n;
+    }
+
+    friend Flat_map_iterator operator-(Flat_map_iterator it,
+                                       difference_type n) {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const Flat_map_iterator& lhs,
+                                     const Flat_map_iterator& rhs) {
+      return lhs.it_ - rhs.it_;
+    }
+
+    friend bool operator==(const Flat_map_iterator& lhs,
+                           const Flat_map_iterator& rhs) {
+      return lhs.it_ == rhs.it_;
+    }
+
+    friend auto operator<=>(const Flat_map_iterator& lhs,
+                            const Flat_map_iterator& rhs) {
+      return lhs.it_ <=> rhs.it_;
+    }
+  };  // class Flat_map_iterator
+};  // class flat_map
+
+namespace pmr {
+/**
+ * @brief flat_map, выделяющий массив из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Compare = std::less<K>>
+using flat_map =
+    s21::flat_map<K, T, Compare,
+                  std::pmr::polymorphic_allocator<std::pair<K, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_FLAT_MAP_H
@@ -0,0 +1,369 @@
+#ifndef S21_FLAT_MULTISET_H
+#define S21_FLAT_MULTISET_H
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_flat_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Мультимножество в упорядоченном массиве с интерфейсом
+ * s21::multiset. Равные ключи хранятся в порядке вставки.
+ * @warning Вставка и удаление одного элемента работают за O(n) и делают
+ * недействительными все итераторы и ссылки. Множество элементов лучше
+ * вставлять пакетно через insert(first, last).
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<Key>>
+class flat_multiset {
+ public:
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree = Flat_tree<Key, Key, std::identity, Compare, Alloc>;
+  using iterator = typename BinaryTree::const_iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using container_type = typename BinaryTree::container_type;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  flat_multiset() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  flat_multiset(std::initializer_list<value_type> const& items)
+      : flat_multiset(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Значения сортируются и сливаются пакетно за O(n log n).
+   */
+  template <std::input_iterator InputIt>
+  flat_multiset(InputIt first, InputIt last) : flat_multiset{} {
+    tree.insert_range(first, last, false);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   * @warning Порядок элементов не проверяется.
+   */
+  template <std::input_iterator InputIt>
+  flat_multiset(sorted_range_t, InputIt first, InputIt last)
+      : flat_multiset{} {
+    tree.assign_sorted(first, last);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, массив которого выделяется копией
+   * alloc.
+   */
+  explicit flat_multiset(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  flat_multiset(std::initializer_list<value_type> const& items,
+                 const Alloc& alloc)
+      : flat_multiset(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  flat_multiset(InputIt first, InputIt last, const Alloc& alloc)
+      : flat_multiset(alloc) {
+    tree.insert_range(first, last, false);
+  }
+
+  /**
+   * @brief Копирует other, выделяя массив копией alloc.
+   */
+  flat_multiset(const flat_multiset& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новый массив.
+   */
+  flat_multiset(flat_multiset&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
+  flat_multiset(const flat_multiset& other) : tree(other.tree) {}
+
+  flat_multiset(flat_multiset&& other) noexcept
+      : tree(std::move(other.tree)) {}
+
+  ~flat_multiset() = default;
+
+  flat_multiset& operator=(const flat_multiset& other) {
+    tree = other.tree;
+    return *this;
+  }
+
+  flat_multiset& operator=(flat_multiset&& other) noexcept {
+    tree = std::move(other.tree);
+    return *this;
+  }
+
+  /**
+   * @brief Возвращает константный итератор на первый элемент. Итерация
+   * выполняется в порядке возрастания ключей.
+   */
+  inline iterator begin() const { return tree.begin(); }
+
+  /**
+   * @brief Возвращает константный итератор на позицию после последнего
+   * элемента.
+   */
+  inline iterator end() const { return tree.end(); }
+
+  inline bool empty() const noexcept { return tree.empty(); }
+
+  inline size_type size() const noexcept { return tree.size(); }
+
+  inline size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы из мультимножества.
+   */
+  void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Уменьшает емкость массива до количества элементов.
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: массив вместе с
+   * запасом емкости и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Добавляет элемент после всех равных ему.
+   * @return Итератор на добавленный элемент.
+   */
+  iterator insert(const value_type& value) {
+    return tree.emplace_with_key(value, false, value).first;
+  }
+
+  iterator insert(value_type&& value) {
+    return tree.emplace_with_key(value, false, std::move(value)).first;
+  }
+
+  /**
+   * @brief Конструирует элемент из args и добавляет его.
+   * @return Итератор на добавленный элемент.
+   */
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return tree.emplace(false, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на добавленный элемент.
+   * @note Если элемент попадает непосредственно перед hint, место вставки
+   * находится без поиска.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree.emplace_hint_with_key(hint, value, false, value).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree.emplace_hint_with_key(hint, value, false, std::move(value))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree.emplace_hint(hint, false, std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Пакетная вставка диапазона [first, last): элементы сортируются и
+   * сливаются с массивом за O(n + m log m) вместо m сдвигов хвоста.
+   * @note Равные ключи сохраняют порядок вставки.
+   */
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    tree.insert_range(first, last, false);
+  }
+
+  void insert(std::initializer_list<value_type> items) {
+    insert(items.begin(), items.end());
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   */
+  void erase(iterator pos) {
+    if (tree.owns(pos) && pos != end()) tree.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет один элемент с указанным ключом.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) { return tree.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return tree.erase_key(key);
+  }
+
+  void swap(flat_multiset& other) noexcept {
+    if (this != &other) tree.swap(other.tree);
+  }
+
+  /**
+   * @brief Перемещает в мультимножество все элементы other.
+   */
+  void merge(flat_multiset& other) { tree.merge(other.tree, false); }
+
+  iterator find(const Key& key) const { return tree.find(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return tree.find(key);
+  }
+
+  /**
+   * @brief Подсчитывает количество элементов с указанным ключом за
+   * O(log n + k), где k — количество найденных элементов.
+   */
+  size_type count(const Key& key) const { return count_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return count_key(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, не меньший key, или end().
+   */
+  iterator lower_bound(const Key& key) const { return tree.lower_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return tree.lower_bound(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, больший key, или end().
+   */
+  iterator upper_bound(const Key& key) const { return tree.upper_bound(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return tree.upper_bound(key);
+  }
+
+  /**
+   * @brief Находит подпоследовательность элементов с ключом key.
+   * @return Пара {lower_bound(key), upper_bound(key)}.
+   */
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<iterator, iterator> equal_range(const KT& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  /**
+   * @brief Заменяет содержимое мультимножества элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @throw При исключении содержимое мультимножества не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    tree.assign_sorted(first, last);
+  }
+
+  /**
+   * @brief Забирает упорядоченный массив за O(1), например, собранный
+   * заранее или полученный из другого процесса.
+   * @warning Порядок не проверяется.
+   */
+  void replace(container_type&& sorted) noexcept {
+    tree.replace(std::move(sorted));
+  }
+
+  /**
+   * @brief Резервирует место под n элементов, чтобы вставки не
+   * перевыделяли массив.
+   */
+  void reserve(size_type n) { tree.reserve(n); }
+
+  size_type capacity() const noexcept { return tree.capacity(); }
+
+  /**
+   * @brief Вставляет несколько элементов за одну операцию.
+   * @return Пары итератор на элемент с таким ключом и true.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return tree.template insert_many<iterator>(false,
+                                               std::forward<Args>(args)...);
+  }
+
+ private:
+  template <typename KT>
+  size_type count_key(const KT& key) const {
+    auto range = equal_range(key);
+    return std::distance(range.first, range.second);
+  }
+};  // class flat_multiset
+
+namespace pmr {
+/**
+ * @brief flat_multiset, выделяющий массив из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>>
+using flat_multiset =
+    s21::flat_multiset<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_FLAT_MULTISET_H
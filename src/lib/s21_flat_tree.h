@@ -0,0 +1,433 @@
+#ifndef S21_FLAT_TREE_H
+#define S21_FLAT_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_helpers.h"
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Упорядоченный массив значений в непрерывной памяти: основа
+ * flat_set, flat_map и flat_multiset.
+ * @tparam K тип ключа.
+ * @tparam V тип значения, должен быть перемещаемым и присваиваемым.
+ * @tparam KeyOfValue функтор извлечения ключа из значения.
+ * @tparam Compare функтор для сравнения ключей.
+ * @tparam Alloc аллокатор массива.
+ * @note Поиск — двоичный без ветвлений, обход — последовательное чтение
+ * памяти. Вставка и удаление одного элемента сдвигают хвост массива за O(n)
+ * и делают недействительными итераторы и ссылки, поэтому контейнер
+ * предназначен для данных, которые строятся пакетно и много читаются.
+ */
+template <typename K, typename V, typename KeyOfValue = std::identity,
+          typename Compare = std::less<K>, typename Alloc = std::allocator<V>>
+class Flat_tree {
+ public:
+  using key_type = K;
+  using value_type = V;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using container_type = std::vector<V, Alloc>;
+  using iterator = typename container_type::iterator;
+  using const_iterator = typename container_type::const_iterator;
+
+ private:
+  container_type data_;
+  [[no_unique_address]] KeyOfValue kov;
+  [[no_unique_address]] Compare comp;
+
+ public:
+  Flat_tree() = default;
+
+  explicit Flat_tree(const Alloc& a) : data_(a) {}
+
+  Flat_tree(const Flat_tree& other, const Alloc& a)
+      : data_(other.data_, a), comp(other.comp) {}
+
+  /**
+   * @brief Перемещение с аллокатором. Если a не равен аллокатору other,
+   * значения перемещаются в новый массив.
+   */
+  Flat_tree(Flat_tree&& other, const Alloc& a)
+      : data_(std::move(other.data_), a), comp(other.comp) {
+    other.data_.clear();
+  }
+
+  Flat_tree(const Flat_tree& other) = default;
+
+  Flat_tree(Flat_tree&& other) noexcept
+      : data_(std::move(other.data_)), comp(other.comp) {}
+
+  Flat_tree& operator=(const Flat_tree& other) = default;
+
+  Flat_tree& operator=(Flat_tree&& other) noexcept(
+      std::is_nothrow_move_assignable_v<container_type>) {
+    data_ = std::move(other.data_);
+    other.data_.clear();
+    comp = other.comp;
+    return *this;
+  }
+
+  void swap(Flat_tree& other) noexcept {
+    data_.swap(other.data_);
+    std::swap(comp, other.comp);
+  }
+
+  iterator begin() noexcept { return data_.begin(); }
+  const_iterator begin() const noexcept { return data_.begin(); }
+  iterator end() noexcept { return data_.end(); }
+  const_iterator end() const noexcept { return data_.end(); }
+
+  bool empty() const noexcept { return data_.empty(); }
+  size_type size() const noexcept { return data_.size(); }
+  size_type max_size() const noexcept { return data_.max_size(); }
+  size_type capacity() const noexcept { return data_.capacity(); }
+
+  void reserve(size_type n) { data_.reserve(n); }
+
+  allocator_type get_allocator() const noexcept {
+    return data_.get_allocator();
+  }
+
+  /**
+   * @brief Возвращает память массива: занятые значения и запас емкости.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    return {data_.size() * sizeof(value_type),
+            (data_.capacity() - data_.size()) * sizeof(value_type)};
+  }
+
+  /**
+   * @brief Уменьшает емкость массива до размера.
+   */
+  void shrink_to_fit() { data_.shrink_to_fit(); }
+
+  void clear() noexcept { data_.clear(); }
+
+  /**
+   * @brief Ищет первый элемент с ключом, эквивалентным key.
+   * @return Итератор на элемент или end().
+   */
+  template <typename KT>
+  iterator find(const KT& key) {
+    return begin() + find_index(key);
+  }
+
+  template <typename KT>
+  const_iterator find(const KT& key) const {
+    return begin() + find_index(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key, или end().
+   */
+  template <typename KT>
+  iterator lower_bound(const KT& key) {
+    return begin() + lower_index(key);
+  }
+
+  template <typename KT>
+  const_iterator lower_bound(const KT& key) const {
+    return begin() + lower_index(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key,
+   * или end().
+   */
+  template <typename KT>
+  iterator upper_bound(const KT& key) {
+    return begin() + upper_index(key);
+  }
+
+  template <typename KT>
+  const_iterator upper_bound(const KT& key) const {
+    return begin() + upper_index(key);
+  }
+
+  /**
+   * @brief Добавление нового элемента по ключу.
+   * @param key Ключ, по которому ищется место вставки.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Пара: итератор на элемент с таким ключом и флаг была ли
+   * выполнена вставка.
+   * @note Значение конструируется, только если ключа еще нет, поэтому key
+   * может ссылаться на объект, перемещаемый в args.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_with_key(const K& key, bool unique_keys,
+                                             Args&&... args) {
+    size_type index;
+    if (unique_keys) {
+      index = lower_index(key);
+      if (index < data_.size() && !comp(key, kov(data_[index]))) {
+        return {begin() + index, false};
+      }
+    } else {
+      index = upper_index(key);
+    }
+    return {data_.emplace(begin() + index, std::forward<Args>(args)...), true};
+  }
+
+  /**
+   * @brief Создает значение из аргументов и добавляет его.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(bool unique_keys, Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return emplace_with_key(kov(value), unique_keys, std::move(value));
+  }
+
+  /**
+   * @brief Аналог emplace_with_key с подсказкой позиции вставки.
+   * @param hint Итератор, перед которым ожидается вставка.
+   * @note Если ключ попадает между hint и её предшественником, место
+   * вставки находится без поиска.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_with_key(const_iterator hint,
+                                                  const K& key,
+                                                  bool unique_keys,
+                                                  Args&&... args) {
+    if (fits_at(hint, key, unique_keys)) {
+      const size_type index = hint - begin();
+      return {data_.emplace(begin() + index, std::forward<Args>(args)...),
+              true};
+    }
+    return emplace_with_key(key, unique_keys, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint(const_iterator hint, bool unique_keys,
+                                         Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return emplace_hint_with_key(hint, kov(value), unique_keys,
+                                 std::move(value));
+  }
+
+  /**
+   * @brief Пакетная вставка диапазона [first, last): новые значения
+   * дописываются в конец, сортируются и сливаются с массивом за
+   * O(n + m log m).
+   * @note Из равных ключей при unique_keys остается первый: уже
+   * существующий или раньше встретившийся в диапазоне. Если исключение
+   * возникает до слияния, содержимое не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void insert_range(InputIt first, InputIt last, bool unique_keys) {
+    const size_type old_size = data_.size();
+    try {
+      data_.insert(data_.end(), first, last);
+      std::stable_sort(begin() + old_size, end(), value_compare());
+    } catch (...) {
+      data_.erase(begin() + old_size, end());
+      throw;
+    }
+    std::inplace_merge(begin(), begin() + old_size, end(), value_compare());
+    if (unique_keys) {
+      data_.erase(std::unique(begin(), end(),
+                              [this](const V& lhs, const V& rhs) {
+                                return !comp(kov(lhs), kov(rhs));
+                              }),
+                  end());
+    }
+  }
+
+  /**
+   * @brief Заменяет содержимое упорядоченным массивом за O(1).
+   * @warning Порядок (и уникальность ключей) не проверяется.
+   */
+  void replace(container_type&& sorted) noexcept {
+    data_ = std::move(sorted);
+  }
+
+  /**
+   * @brief Заменяет содержимое упорядоченным диапазоном [first, last) за
+   * O(n).
+   * @throw При исключении содержимое не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    container_type sorted(first, last, data_.get_allocator());
+    data_.swap(sorted);
+  }
+
+  /**
+   * @brief Вставляет значения args по одному, при исключении удаляет уже
+   * вставленные.
+   * @tparam Iterator Тип итератора в результате.
+   * @note Вставка сдвигает значения, поэтому итераторы результата находятся
+   * заново по скопированным ключам после всех вставок.
+   */
+  template <typename Iterator, typename... Args>
+  std::vector<std::pair<Iterator, bool>> insert_many(bool unique_keys,
+                                                     Args&&... args) {
+    std::vector<K> keys;
+    std::vector<bool> inserted;
+    std::vector<std::pair<Iterator, bool>> res;
+    keys.reserve(sizeof...(Args));
+    inserted.reserve(sizeof...(Args));
+    res.reserve(sizeof...(Args));
+    try {
+      (insert_one(keys, inserted, unique_keys, std::forward<Args>(args)), ...);
+    } catch (...) {
+      for (size_type i = 0; i < inserted.size(); ++i) {
+        if (inserted[i]) erase_key(keys[i]);
+      }
+      throw;
+    }
+    for (size_type i = 0; i < keys.size(); ++i) {
+      res.emplace_back(Iterator(find(keys[i])), inserted[i]);
+    }
+    return res;
+  }
+
+  /**
+   * @brief Проверяет, что итератор указывает в массив этого контейнера,
+   * включая end().
+   */
+  bool owns(const_iterator pos) const noexcept {
+    const value_type* p = std::to_address(pos);
+    return !std::less<const value_type*>()(p, data_.data()) &&
+           !std::less<const value_type*>()(data_.data() + data_.size(), p);
+  }
+
+  /**
+   * @brief Удаляет элемент.
+   * @return Итератор на следующий элемент.
+   */
+  iterator erase(const_iterator pos) { return data_.erase(pos); }
+
+  /**
+   * @brief Удаляет один элемент с ключом key.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  template <typename KT>
+  size_type erase_key(const KT& key) {
+    const size_type index = find_index(key);
+    if (index == data_.size()) return 0;
+    data_.erase(begin() + index);
+    return 1;
+  }
+
+  /**
+   * @brief Перемещает в массив элементы other за один проход слияния.
+   * @note При unique_keys элементы, ключи которых уже есть, остаются в
+   * other.
+   */
+  void merge(Flat_tree& other, bool unique_keys) {
+    if (this == &other) return;
+    if (!unique_keys) {
+      insert_range(std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()), false);
+      other.clear();
+      return;
+    }
+    auto present = [this](const V& value) {
+      return find_index(kov(value)) != data_.size();
+    };
+    // Элементы с новыми ключами собираются в конце other.
+    auto moved = std::stable_partition(other.begin(), other.end(), present);
+    insert_range(std::make_move_iterator(moved),
+                 std::make_move_iterator(other.end()), false);
+    other.data_.erase(moved, other.end());
+  }
+
+ private:
+  /**
+   * @brief Сравнение значений по ключам для алгоритмов сортировки.
+   */
+  auto value_compare() const {
+    return [this](const V& lhs, const V& rhs) {
+      return comp(kov(lhs), kov(rhs));
+    };
+  }
+
+  /**
+   * @brief Двоичный поиск без ветвлений: индекс первого значения с ключом не
+   * меньше key (upper == false) или больше key (upper == true).
+   * @note Вместо условного перехода сдвиг базы выбирается условной
+   * пересылкой, поэтому непредсказуемые сравнения не сбрасывают конвейер.
+   */
+  template <typename KT>
+  size_type bound_index(const KT& key, bool upper) const {
+    size_type length = data_.size();
+    if (length == 0) return 0;
+    const value_type* base = data_.data();
+    while (length > 1) {
+      const size_type half = length / 2;
+      const bool before = upper ? !comp(key, kov(base[half]))
+                                : comp(kov(base[half]), key);
+      base += before ? half : 0;
+      length -= half;
+    }
+    const bool before =
+        upper ? !comp(key, kov(*base)) : comp(kov(*base), key);
+    return base - data_.data() + before;
+  }
+
+  template <typename KT>
+  size_type lower_index(const KT& key) const {
+    return bound_index(key, false);
+  }
+
+  template <typename KT>
+  size_type upper_index(const KT& key) const {
+    return bound_index(key, true);
+  }
+
+  /**
+   * @brief Индекс первого значения с ключом key или size().
+   */
+  template <typename KT>
+  size_type find_index(const KT& key) const {
+    const size_type index = lower_index(key);
+    if (index < data_.size() && !comp(key, kov(data_[index]))) return index;
+    return data_.size();
+  }
+
+  /**
+   * @brief Ключ помещается непосредственно перед hint.
+   */
+  bool fits_at(const_iterator hint, const K& key, bool unique_keys) const {
+    if (!owns(hint)) return false;
+    if (hint != end() && (unique_keys ? !comp(key, kov(*hint))
+                                      : comp(kov(*hint), key))) {
+      return false;
+    }
+    if (hint != begin()) {
+      const K& prev = kov(*std::prev(hint));
+      return unique_keys ? comp(prev, key) : !comp(key, prev);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Шаг insert_many: ключ запоминается до вставки, чтобы при
+   * исключении удалить только вставленные значения.
+   */
+  template <typename Arg>
+  void insert_one(std::vector<K>& keys, std::vector<bool>& inserted,
+                  bool unique_keys, Arg&& arg) {
+    value_type value(std::forward<Arg>(arg));
+    keys.push_back(kov(value));
+    inserted.push_back(false);
+    inserted.back() =
+        emplace_with_key(keys.back(), unique_keys, std::move(value)).second;
+  }
+};  // class Flat_tree
+
+}  // namespace s21
+
+#endif  // S21_FLAT_TREE_H
@@ -0,0 +1,1047 @@
+#ifndef S21_HASH_TABLE_H
+#define S21_HASH_TABLE_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "s21_helpers.h"
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Значения управляющих байтов хеш-таблицы. Занятое место хранит
+ * младшие 7 бит хеша ключа (0..127), остальные состояния отрицательны.
+ */
+struct Swiss_ctrl {
+  static constexpr std::int8_t empty = -128;
+  static constexpr std::int8_t deleted = -2;
+  // Стоит после последнего места и останавливает обход итератором.
+  static constexpr std::int8_t sentinel = -1;
+};
+
+/**
+ * @brief Маска совпадений в группе управляющих байтов.
+ * @tparam T целый тип маски.
+ * @tparam Shift log2 числа бит маски на байт группы: 0 для SSE2, 3 для
+ * переносимой группы, где совпадение отмечено старшим битом байта.
+ */
+template <typename T, int Shift>
+class Swiss_bitmask {
+ public:
+  explicit Swiss_bitmask(T mask) noexcept : mask_(mask) {}
+
+  explicit operator bool() const noexcept { return mask_ != 0; }
+
+  /**
+   * @brief Индекс первого отмеченного байта.
+   */
+  std::size_t lowest() const noexcept {
+    return static_cast<std::size_t>(std::countr_zero(mask_)) >> Shift;
+  }
+
+  /**
+   * @brief Количество неотмеченных байтов в конце группы.
+   */
+  std::size_t leading_zeros() const noexcept {
+    return static_cast<std::size_t>(std::countl_zero(mask_)) >> Shift;
+  }
+
+  void remove_lowest() noexcept { mask_ &= mask_ - 1; }
+
+ private:
+  T mask_;
+};
+
+#if defined(__SSE2__)
+/**
+ * @brief Группа из 16 управляющих байтов, которые сравниваются с образцом
+ * одной инструкцией SSE2.
+ */
+class Swiss_group_sse2 {
+ public:
+  static constexpr std::size_t width = 16;
+  using mask_type = Swiss_bitmask<std::uint16_t, 0>;
+
+  explicit Swiss_group_sse2(const std::int8_t* pos) noexcept
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  /**
+   * @brief Места, управляющий байт которых равен h2.
+   */
+  mask_type match(std::int8_t h2) const noexcept {
+    return mask_type(to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+  }
+
+  mask_type match_empty() const noexcept { return match(Swiss_ctrl::empty); }
+
+  /**
+   * @brief Пустые и удаленные места: байты меньше Swiss_ctrl::sentinel.
+   */
+  mask_type match_empty_or_deleted() const noexcept {
+    return mask_type(to_mask(empty_or_deleted()));
+  }
+
+  /**
+   * @brief Количество пустых и удаленных мест подряд с начала группы.
+   */
+  std::size_t count_leading_empty_or_deleted() const noexcept {
+    return static_cast<std::size_t>(
+        std::countr_one(to_mask(empty_or_deleted())));
+  }
+
+ private:
+  __m128i empty_or_deleted() const noexcept {
+    return _mm_cmpgt_epi8(_mm_set1_epi8(Swiss_ctrl::sentinel), ctrl_);
+  }
+
+  static std::uint16_t to_mask(__m128i bytes) noexcept {
+    return static_cast<std::uint16_t>(_mm_movemask_epi8(bytes));
+  }
+
+  __m128i ctrl_;
+};
+#endif
+
+/**
+ * @brief Группа из 8 управляющих байтов, которые сравниваются битовыми
+ * операциями над одним 64-битным словом. Используется без SSE2.
+ */
+class Swiss_group_portable {
+ public:
+  static constexpr std::size_t width = 8;
+  using mask_type = Swiss_bitmask<std::uint64_t, 3>;
+
+  explicit Swiss_group_portable(const std::int8_t* pos) noexcept {
+    std::memcpy(&ctrl_, pos, sizeof(ctrl_));
+    if constexpr (std::endian::native == std::endian::big) {
+      ctrl_ = __builtin_bswap64(ctrl_);
+    }
+  }
+
+  /**
+   * @brief Места, управляющий байт которых равен h2.
+   * @note Байт выше настоящего совпадения может дать ложное совпадение, но
+   * только на занятом месте: ключ все равно сравнивается.
+   */
+  mask_type match(std::int8_t h2) const noexcept {
+    const std::uint64_t x = ctrl_ ^ (lsbs * static_cast<std::uint8_t>(h2));
+    return mask_type((x - lsbs) & ~x & msbs);
+  }
+
+  /**
+   * @brief Пустые места: старший бит установлен, а первый сброшен.
+   */
+  mask_type match_empty() const noexcept {
+    return mask_type(ctrl_ & ~(ctrl_ << 6) & msbs);
+  }
+
+  /**
+   * @brief Пустые и удаленные места: старший бит установлен, а младший
+   * сброшен.
+   */
+  mask_type match_empty_or_deleted() const noexcept {
+    return mask_type(ctrl_ & ~(ctrl_ << 7) & msbs);
+  }
+
+  std::size_t count_leading_empty_or_deleted() const noexcept {
+    const std::uint64_t full_or_sentinel = ~(ctrl_ & ~(ctrl_ << 7)) & msbs;
+    return static_cast<std::size_t>(std::countr_zero(full_or_sentinel)) >> 3;
+  }
+
+ private:
+  static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+  static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+  std::uint64_t ctrl_;
+};
+
+#if defined(__SSE2__)
+using Swiss_group = Swiss_group_sse2;
+#else
+using Swiss_group = Swiss_group_portable;
+#endif
+
+/**
+ * @brief Хеш-таблица с открытой адресацией по схеме Swiss table. Рядом с
+ * массивом значений хранится массив управляющих байтов, и поиск сравнивает
+ * 7 бит хеша сразу с группой из Group::width мест. До сравнения ключей
+ * доходят почти только настоящие совпадения.
+ * @tparam K тип ключа.
+ * @tparam V тип значения.
+ * @tparam KeyOfValue функтор извлечения ключа из значения.
+ * @tparam Hash хеш-функция ключей.
+ * @tparam KeyEqual предикат равенства ключей.
+ * @tparam Alloc аллокатор.
+ * @tparam Group группа управляющих байтов: Swiss_group_sse2 или
+ * Swiss_group_portable.
+ * @note Емкость равна 2^k - 1 и заполняется не больше чем на 7/8.
+ * Перестройка таблицы делает недействительными все итераторы и ссылки,
+ * удаление - только на удаленный элемент.
+ */
+template <typename K, typename V, typename KeyOfValue = std::identity,
+          typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>,
+          typename Alloc = std::allocator<V>, typename Group = Swiss_group>
+class Hash_table {
+ public:
+  template <bool Const>
+  class Hash_iterator;
+
+  using key_type = K;
+  using value_type = V;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using iterator = Hash_iterator<false>;
+  using const_iterator = Hash_iterator<true>;
+
+ private:
+  using ctrl_t = std::int8_t;
+  using slot_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<V>;
+  using ctrl_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<ctrl_t>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+  static constexpr bool propagate_on_copy =
+      slot_traits::propagate_on_container_copy_assignment::value;
+  static constexpr bool propagate_on_move =
+      slot_traits::propagate_on_container_move_assignment::value;
+
+  /**
+   * @brief Последовательность просматриваемых групп. Смещения растут
+   * треугольными числами групп, поэтому при емкости 2^k - 1 каждая группа
+   * просматривается не больше одного раза.
+   */
+  class Probe {
+   public:
+    Probe(std::uint64_t h1, size_type mask) noexcept
+        : mask_(mask), offset_(static_cast<size_type>(h1) & mask) {}
+
+    size_type offset() const noexcept { return offset_; }
+
+    size_type offset(size_type i) const noexcept {
+      return (offset_ + i) & mask_;
+    }
+
+    void next() noexcept {
+      index_ += Group::width;
+      offset_ = (offset_ + index_) & mask_;
+    }
+
+   private:
+    size_type mask_;
+    size_type offset_;
+    size_type index_ = 0;
+  };
+
+  /**
+   * @brief Значение, созданное до перестройки таблицы: аргументы вставки
+   * могут ссылаться на элементы, которые перестройка переместит.
+   */
+  struct Value_holder {
+    template <typename... Args>
+    explicit Value_holder(slot_allocator& alloc, Args&&... args)
+        : alloc_(alloc) {
+      slot_traits::construct(alloc_, &value, std::forward<Args>(args)...);
+    }
+
+    ~Value_holder() { slot_traits::destroy(alloc_, &value); }
+
+    slot_allocator& alloc_;
+    union {
+      value_type value;
+    };
+  };
+
+  ctrl_t* ctrl_;
+  value_type* slots_;
+  size_type capacity_;
+  size_type size_;
+  // Сколько пустых мест еще можно занять до перестройки.
+  size_type growth_left_;
+  // Функторы и аллокаторы обычно пустые и не должны увеличивать размер.
+  [[no_unique_address]] KeyOfValue kov;
+  [[no_unique_address]] Hash hash_;
+  [[no_unique_address]] KeyEqual eq_;
+  [[no_unique_address]] slot_allocator slot_alloc_;
+  [[no_unique_address]] ctrl_allocator ctrl_alloc_;
+
+ public:
+  Hash_table() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                        std::is_nothrow_default_constructible_v<KeyEqual> &&
+                        std::is_nothrow_default_constructible_v<Alloc>)
+      : ctrl_(empty_group()),
+        slots_(nullptr),
+        capacity_(0),
+        size_(0),
+        growth_left_(0),
+        kov{},
+        hash_{},
+        eq_{},
+        slot_alloc_{},
+        ctrl_alloc_{} {}
+
+  /**
+   * @brief Создает пустую таблицу, массивы которой выделяются копиями a.
+   * @note Память не выделяется до первой вставки.
+   */
+  explicit Hash_table(const Alloc& a)
+      : ctrl_(empty_group()),
+        slots_(nullptr),
+        capacity_(0),
+        size_(0),
+        growth_left_(0),
+        kov{},
+        hash_{},
+        eq_{},
+        slot_alloc_(a),
+        ctrl_alloc_(a) {}
+
+  Hash_table(const Hash_table& other)
+      : Hash_table(other, slot_traits::select_on_container_copy_construction(
+                              other.slot_alloc_)) {}
+
+  /**
+   * @brief Копирует other, выделяя массивы копиями a. Раскладка таблицы
+   * копируется без вычисления хешей.
+   */
+  Hash_table(const Hash_table& other, const Alloc& a) : Hash_table(a) {
+    hash_ = other.hash_;
+    eq_ = other.eq_;
+    copy_from(other);
+  }
+
+  /**
+   * @brief Конструктор перемещения, забирает массивы и аллокаторы other за
+   * O(1).
+   */
+  Hash_table(Hash_table&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, empty_group())),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        kov(other.kov),
+        hash_(other.hash_),
+        eq_(other.eq_),
+        slot_alloc_(std::move(other.slot_alloc_)),
+        ctrl_alloc_(std::move(other.ctrl_alloc_)) {}
+
+  /**
+   * @brief Конструктор перемещения с аллокатором. Если a не равен аллокатору
+   * other, значения перемещаются в новые массивы, а other очищается.
+   */
+  Hash_table(Hash_table&& other, const Alloc& a) : Hash_table(a) {
+    hash_ = other.hash_;
+    eq_ = other.eq_;
+    if (same_allocator(other)) {
+      steal_storage(other);
+    } else {
+      move_values_from(other);
+    }
+  }
+
+  ~Hash_table() { release(); }
+
+  /**
+   * @brief Оператор присваивания копированием. Аллокатор other копируется,
+   * только если этого требует propagate_on_container_copy_assignment.
+   */
+  Hash_table& operator=(const Hash_table& other) {
+    if (this != &other) {
+      Hash_table temp(other, propagate_on_copy ? Alloc(other.slot_alloc_)
+                                               : Alloc(slot_alloc_));
+      release();
+      hash_ = other.hash_;
+      eq_ = other.eq_;
+      steal_storage(temp);
+      if constexpr (propagate_on_copy) {
+        slot_alloc_ = std::move(temp.slot_alloc_);
+        ctrl_alloc_ = std::move(temp.ctrl_alloc_);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Оператор присваивания перемещением. Если аллокатор не
+   * передается и не равен аллокатору other, значения перемещаются в новые
+   * массивы.
+   */
+  Hash_table& operator=(Hash_table&& other) noexcept(
+      propagate_on_move || slot_traits::is_always_equal::value) {
+    if (this != &other) {
+      release();
+      hash_ = other.hash_;
+      eq_ = other.eq_;
+      if constexpr (propagate_on_move) {
+        steal_storage(other);
+        std::swap(slot_alloc_, other.slot_alloc_);
+        std::swap(ctrl_alloc_, other.ctrl_alloc_);
+      } else if (same_allocator(other)) {
+        steal_storage(other);
+      } else {
+        move_values_from(other);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Обменивает содержимое таблиц за O(1).
+   */
+  void swap(Hash_table& other) noexcept {
+    if (this != &other) {
+      std::swap(ctrl_, other.ctrl_);
+      std::swap(slots_, other.slots_);
+      std::swap(capacity_, other.capacity_);
+      std::swap(size_, other.size_);
+      std::swap(growth_left_, other.growth_left_);
+      std::swap(hash_, other.hash_);
+      std::swap(eq_, other.eq_);
+      if constexpr (slot_traits::propagate_on_container_swap::value) {
+        std::swap(slot_alloc_, other.slot_alloc_);
+        std::swap(ctrl_alloc_, other.ctrl_alloc_);
+      }
+    }
+  }
+
+  iterator begin() noexcept {
+    iterator it(ctrl_, slots_);
+    it.skip_empty_or_deleted();
+    return it;
+  }
+
+  const_iterator begin() const noexcept {
+    const_iterator it(ctrl_, slots_);
+    it.skip_empty_or_deleted();
+    return it;
+  }
+
+  iterator end() noexcept { return iterator_at(capacity_); }
+  const_iterator end() const noexcept { return iterator_at(capacity_); }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / (sizeof(value_type) + 1);
+  }
+
+  /**
+   * @brief Количество мест в таблице.
+   */
+  size_type bucket_count() const noexcept { return capacity_; }
+
+  float load_factor() const noexcept {
+    return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / capacity_;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(slot_alloc_);
+  }
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return eq_; }
+
+  /**
+   * @brief Возвращает память таблицы: значения в node_bytes, свободные
+   * места и управляющие байты в overhead_bytes.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    const size_type ctrl_bytes = capacity_ == 0 ? 0 : capacity_ + Group::width;
+    return {size_ * sizeof(value_type),
+            (capacity_ - size_) * sizeof(value_type) + ctrl_bytes};
+  }
+
+  /**
+   * @brief Удаляет все элементы, сохраняя выделенные массивы.
+   */
+  void clear() noexcept {
+    destroy_values();
+    size_ = 0;
+    if (capacity_ != 0) reset_ctrl();
+  }
+
+  /**
+   * @brief Готовит таблицу к n элементам без перестроек при вставке.
+   */
+  void reserve(size_type n) {
+    if (n > size_ + growth_left_) resize(capacity_for(n));
+  }
+
+  /**
+   * @brief Перестраивает таблицу с емкостью не меньше n и достаточной для
+   * size() элементов, освобождая места удаленных элементов.
+   * @note rehash(0) уменьшает таблицу до наименьшей подходящей емкости.
+   */
+  void rehash(size_type n) {
+    const size_type target =
+        std::max(capacity_for(size_), n == 0 ? 0 : normalize_capacity(n));
+    if (target == 0) {
+      release();
+    } else {
+      resize(target);
+    }
+  }
+
+  /**
+   * @brief Ищет элемент с ключом, равным key.
+   * @return Итератор на элемент или end().
+   */
+  template <typename KT>
+  iterator find(const KT& key) {
+    return iterator_at(find_index(key, hash_of(key)));
+  }
+
+  template <typename KT>
+  const_iterator find(const KT& key) const {
+    return iterator_at(find_index(key, hash_of(key)));
+  }
+
+  /**
+   * @brief Вставляет значение, сконструированное из args, если элемента с
+   * ключом key еще нет.
+   * @param key Ключ создаваемого значения.
+   * @return Пара итератор на элемент с таким ключом и флаг вставки.
+   * @note Если ключ уже есть, args не используются.
+   */
+  template <typename KT, typename... Args>
+  std::pair<iterator, bool> emplace_with_key(const KT& key, Args&&... args) {
+    const std::uint64_t hash = hash_of(key);
+    const size_type index = find_index(key, hash);
+    if (index != capacity_) return {iterator_at(index), false};
+    return {iterator_at(insert_new(hash, std::forward<Args>(args)...)), true};
+  }
+
+  /**
+   * @brief Конструирует значение из args и вставляет его, если такого ключа
+   * еще нет.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return emplace_with_key(kov(value), std::move(value));
+  }
+
+  /**
+   * @brief Добавляет элементы диапазона [first, last). Для прямых
+   * итераторов таблица заранее расширяется под весь диапазон.
+   */
+  template <std::input_iterator InputIt>
+  void insert_range(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) {
+      reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) emplace(*first);
+  }
+
+  /**
+   * @brief Вставляет значения args по одному, при исключении удаляет уже
+   * вставленные.
+   * @tparam Iterator Тип итератора в результате.
+   * @return Пары итератор на элемент с таким ключом и флаг вставки.
+   * @note Вставка может перестроить таблицу, поэтому итераторы результата
+   * находятся заново по скопированным ключам после всех вставок.
+   */
+  template <typename Iterator, typename... Args>
+  std::vector<std::pair<Iterator, bool>> insert_many(Args&&... args) {
+    std::vector<K> keys;
+    std::vector<bool> inserted;
+    std::vector<std::pair<Iterator, bool>> res;
+    keys.reserve(sizeof...(Args));
+    inserted.reserve(sizeof...(Args));
+    res.reserve(sizeof...(Args));
+    try {
+      (insert_one(keys, inserted, std::forward<Args>(args)), ...);
+    } catch (...) {
+      for (size_type i = 0; i < inserted.size(); ++i) {
+        if (inserted[i]) erase_key(keys[i]);
+      }
+      throw;
+    }
+    for (size_type i = 0; i < keys.size(); ++i) {
+      res.emplace_back(Iterator(find(keys[i])), inserted[i]);
+    }
+    return res;
+  }
+
+  /**
+   * @brief Проверяет, указывает ли pos на место этой таблицы.
+   */
+  bool owns(const_iterator pos) const noexcept {
+    return !std::less<const ctrl_t*>()(pos.ctrl_, ctrl_) &&
+           std::less<const ctrl_t*>()(pos.ctrl_, ctrl_ + capacity_);
+  }
+
+  /**
+   * @brief Удаляет элемент.
+   * @param pos Итератор этой таблицы, не end().
+   */
+  void erase(const_iterator pos) noexcept {
+    erase_at(static_cast<size_type>(pos.ctrl_ - ctrl_));
+  }
+
+  /**
+   * @brief Удаляет элемент с ключом key.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  template <typename KT>
+  size_type erase_key(const KT& key) {
+    const size_type index = find_index(key, hash_of(key));
+    if (index == capacity_) return 0;
+    erase_at(index);
+    return 1;
+  }
+
+  /**
+   * @brief Перемещает в таблицу элементы other, ключей которых еще нет.
+   * Остальные элементы остаются в other.
+   */
+  void merge(Hash_table& other) {
+    if (this == &other) return;
+    for (size_type i = 0; i < other.capacity_; ++i) {
+      if (!is_full(other.ctrl_[i])) continue;
+      value_type& value = other.slots_[i];
+      const std::uint64_t hash = hash_of(kov(value));
+      if (find_index(kov(value), hash) != capacity_) continue;
+      insert_new(hash, std::move(value));
+      other.erase_at(i);
+    }
+  }
+
+ private:
+  /**
+   * @brief Шаг insert_many: ключ запоминается до вставки, чтобы при
+   * исключении удалить только вставленные значения.
+   */
+  template <typename Arg>
+  void insert_one(std::vector<K>& keys, std::vector<bool>& inserted,
+                  Arg&& arg) {
+    value_type value(std::forward<Arg>(arg));
+    keys.push_back(kov(value));
+    inserted.push_back(false);
+    inserted.back() = emplace_with_key(keys.back(), std::move(value)).second;
+  }
+
+  /**
+   * @brief Управляющие байты таблицы без мест: поиск в ней сразу встречает
+   * пустое место, а обход - sentinel.
+   * @note Массив никогда не изменяется: все записи идут в выделенные
+   * массивы, а таблица без емкости перед вставкой расширяется.
+   */
+  static inline constinit std::array<ctrl_t, Group::width> empty_group_ = [] {
+    std::array<ctrl_t, Group::width> group{};
+    group.fill(Swiss_ctrl::empty);
+    group[0] = Swiss_ctrl::sentinel;
+    return group;
+  }();
+
+  static ctrl_t* empty_group() noexcept { return empty_group_.data(); }
+
+  static bool is_full(ctrl_t ctrl) noexcept { return ctrl >= 0; }
+
+  /**
+   * @brief Наибольшее число элементов в таблице емкости capacity. Хотя бы
+   * одно место остается пустым, иначе поиск отсутствующего ключа не
+   * остановится.
+   */
+  static constexpr size_type growth(size_type capacity) noexcept {
+    return Group::width == 8 && capacity == 7 ? 6 : capacity - capacity / 8;
+  }
+
+  /**
+   * @brief Наименьшая допустимая емкость (2^k - 1, не меньше
+   * Group::width - 1), не меньшая n.
+   */
+  static size_type normalize_capacity(size_type n) noexcept {
+    return std::max<size_type>(Group::width - 1, std::bit_ceil(n + 1) - 1);
+  }
+
+  /**
+   * @brief Наименьшая емкость, вмещающая n элементов.
+   */
+  static size_type capacity_for(size_type n) noexcept {
+    if (n == 0) return 0;
+    size_type capacity = Group::width - 1;
+    while (growth(capacity) < n) capacity = capacity * 2 + 1;
+    return capacity;
+  }
+
+  /**
+   * @brief Хеш ключа после перемешивания: std::hash для целых - тождественная
+   * функция, а таблице нужны случайные и младшие 7 бит (h2), и старшие (h1).
+   */
+  template <typename KT>
+  std::uint64_t hash_of(const KT& key) const {
+    const std::uint64_t x =
+        static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 32);
+  }
+
+  static std::uint64_t h1(std::uint64_t hash) noexcept { return hash >> 7; }
+
+  static ctrl_t h2(std::uint64_t hash) noexcept {
+    return static_cast<ctrl_t>(hash & 0x7F);
+  }
+
+  /**
+   * @brief Индекс элемента с ключом key или capacity_, если его нет.
+   */
+  template <typename KT>
+  size_type find_index(const KT& key, std::uint64_t hash) const {
+    Probe probe(h1(hash), capacity_);
+    while (true) {
+      const Group group(ctrl_ + probe.offset());
+      for (auto match = group.match(h2(hash)); match; match.remove_lowest()) {
+        const size_type index = probe.offset(match.lowest());
+        if (eq_(key, kov(slots_[index]))) return index;
+      }
+      if (group.match_empty()) return capacity_;
+      probe.next();
+    }
+  }
+
+  /**
+   * @brief Первое пустое или удаленное место на пути поиска ключа с
+   * хешем hash.
+   */
+  size_type find_first_non_full(std::uint64_t hash) const noexcept {
+    Probe probe(h1(hash), capacity_);
+    while (true) {
+      const auto free = Group(ctrl_ + probe.offset()).match_empty_or_deleted();
+      if (free) return probe.offset(free.lowest());
+      probe.next();
+    }
+  }
+
+  /**
+   * @brief Записывает управляющий байт места index и его копию после
+   * sentinel, по которой группы читаются через конец массива.
+   */
+  void set_ctrl(size_type index, ctrl_t value) noexcept {
+    constexpr size_type cloned = Group::width - 1;
+    ctrl_[index] = value;
+    ctrl_[((index - cloned) & capacity_) + cloned] = value;
+  }
+
+  /**
+   * @brief Помечает все места пустыми.
+   */
+  void reset_ctrl() noexcept {
+    std::memset(ctrl_, Swiss_ctrl::empty, capacity_ + Group::width);
+    ctrl_[capacity_] = Swiss_ctrl::sentinel;
+    growth_left_ = growth(capacity_);
+  }
+
+  /**
+   * @brief Вставляет значение из args на первое свободное место для хеша
+   * hash. Ключа в таблице быть не должно.
+   * @return Индекс вставленного значения.
+   */
+  template <typename... Args>
+  size_type insert_new(std::uint64_t hash, Args&&... args) {
+    size_type index = find_first_non_full(hash);
+    if (growth_left_ == 0 && ctrl_[index] != Swiss_ctrl::deleted) {
+      Value_holder holder(slot_alloc_, std::forward<Args>(args)...);
+      grow();
+      index = insert_unchecked(hash, std::move(holder.value));
+    } else {
+      slot_traits::construct(slot_alloc_, slots_ + index,
+                             std::forward<Args>(args)...);
+      growth_left_ -= ctrl_[index] == Swiss_ctrl::empty;
+      set_ctrl(index, h2(hash));
+    }
+    ++size_;
+    return index;
+  }
+
+  /**
+   * @brief Вставка без проверки ключа и свободного места, size_ не меняется.
+   */
+  template <typename... Args>
+  size_type insert_unchecked(std::uint64_t hash, Args&&... args) {
+    const size_type index = find_first_non_full(hash);
+    slot_traits::construct(slot_alloc_, slots_ + index,
+                           std::forward<Args>(args)...);
+    growth_left_ -= ctrl_[index] == Swiss_ctrl::empty;
+    set_ctrl(index, h2(hash));
+    return index;
+  }
+
+  /**
+   * @brief Освобождает место для вставки: если удаленные места занимают
+   * не меньше половины таблицы, она перестраивается с той же емкостью,
+   * иначе емкость удваивается.
+   */
+  void grow() {
+    if (capacity_ == 0) {
+      resize(Group::width - 1);
+    } else {
+      resize(size_ <= capacity_ / 2 ? capacity_ : capacity_ * 2 + 1);
+    }
+  }
+
+  /**
+   * @brief Переносит значения в новые массивы емкости capacity.
+   * @throw При исключении таблица не меняется. Значения с бросающим
+   * конструктором перемещения копируются.
+   */
+  void resize(size_type capacity) {
+    ctrl_t* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    const size_type old_capacity = capacity_;
+    const size_type old_growth_left = growth_left_;
+    allocate(capacity);
+    try {
+      for (size_type i = 0; i < old_capacity; ++i) {
+        if (is_full(old_ctrl[i])) {
+          insert_unchecked(hash_of(kov(old_slots[i])),
+                           std::move_if_noexcept(old_slots[i]));
+        }
+      }
+    } catch (...) {
+      destroy_values();
+      deallocate();
+      ctrl_ = old_ctrl;
+      slots_ = old_slots;
+      capacity_ = old_capacity;
+      growth_left_ = old_growth_left;
+      throw;
+    }
+    for (size_type i = 0; i < old_capacity; ++i) {
+      if (is_full(old_ctrl[i])) {
+        slot_traits::destroy(slot_alloc_, old_slots + i);
+      }
+    }
+    if (old_capacity != 0) {
+      ctrl_traits::deallocate(ctrl_alloc_, old_ctrl,
+                              old_capacity + Group::width);
+      slot_traits::deallocate(slot_alloc_, old_slots, old_capacity);
+    }
+  }
+
+  /**
+   * @brief Выделяет пустые массивы емкости capacity, не освобождая старые.
+   */
+  void allocate(size_type capacity) {
+    ctrl_t* ctrl = ctrl_traits::allocate(ctrl_alloc_, capacity + Group::width);
+    try {
+      slots_ = slot_traits::allocate(slot_alloc_, capacity);
+    } catch (...) {
+      ctrl_traits::deallocate(ctrl_alloc_, ctrl, capacity + Group::width);
+      throw;
+    }
+    ctrl_ = ctrl;
+    capacity_ = capacity;
+    reset_ctrl();
+  }
+
+  void deallocate() noexcept {
+    if (capacity_ == 0) return;
+    ctrl_traits::deallocate(ctrl_alloc_, ctrl_, capacity_ + Group::width);
+    slot_traits::deallocate(slot_alloc_, slots_, capacity_);
+  }
+
+  void destroy_values() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_type i = 0; i < capacity_; ++i) {
+        if (is_full(ctrl_[i])) slot_traits::destroy(slot_alloc_, slots_ + i);
+      }
+    }
+  }
+
+  /**
+   * @brief Уничтожает значения и освобождает массивы.
+   */
+  void release() noexcept {
+    destroy_values();
+    deallocate();
+    ctrl_ = empty_group();
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+  }
+
+  /**
+   * @brief Удаляет значение места index. Место становится пустым, если
+   * рядом с ним не было Group::width занятых мест подряд: тогда ни один
+   * поиск не продолжался дальше него.
+   */
+  void erase_at(size_type index) noexcept {
+    slot_traits::destroy(slot_alloc_, slots_ + index);
+    --size_;
+    const size_type before = (index - Group::width) & capacity_;
+    const auto empty_after = Group(ctrl_ + index).match_empty();
+    const auto empty_before = Group(ctrl_ + before).match_empty();
+    const bool was_never_full =
+        empty_before && empty_after &&
+        empty_after.lowest() + empty_before.leading_zeros() < Group::width;
+    set_ctrl(index, was_never_full ? Swiss_ctrl::empty : Swiss_ctrl::deleted);
+    growth_left_ += was_never_full;
+  }
+
+  /**
+   * @brief Копирует раскладку other в пустую таблицу без емкости.
+   */
+  void copy_from(const Hash_table& other) {
+    if (other.size_ == 0) return;
+    allocate(other.capacity_);
+    std::memcpy(ctrl_, other.ctrl_, capacity_ + Group::width);
+    size_type i = 0;
+    try {
+      for (; i < capacity_; ++i) {
+        if (is_full(ctrl_[i])) {
+          slot_traits::construct(slot_alloc_, slots_ + i, other.slots_[i]);
+        }
+      }
+    } catch (...) {
+      while (i-- > 0) {
+        if (is_full(ctrl_[i])) slot_traits::destroy(slot_alloc_, slots_ + i);
+      }
+      deallocate();
+      ctrl_ = empty_group();
+      slots_ = nullptr;
+      capacity_ = 0;
+      growth_left_ = 0;
+      throw;
+    }
+    size_ = other.size_;
+    growth_left_ = other.growth_left_;
+  }
+
+  /**
+   * @brief Перемещает значения other по одному и очищает other.
+   */
+  void move_values_from(Hash_table& other) {
+    reserve(other.size_);
+    for (size_type i = 0; i < other.capacity_; ++i) {
+      if (is_full(other.ctrl_[i])) {
+        insert_unchecked(hash_of(kov(other.slots_[i])),
+                         std::move(other.slots_[i]));
+        ++size_;
+      }
+    }
+    other.clear();
+  }
+
+  /**
+   * @brief Забирает массивы other, other становится пустой таблицей без
+   * емкости.
+   */
+  void steal_storage(Hash_table& other) noexcept {
+    ctrl_ = std::exchange(other.ctrl_, empty_group());
+    slots_ = std::exchange(other.slots_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    size_ = std::exchange(other.size_, 0);
+    growth_left_ = std::exchange(other.growth_left_, 0);
+  }
+
+  bool same_allocator(const Hash_table& other) const noexcept {
+    if constexpr (slot_traits::is_always_equal::value) {
+      return true;
+    } else {
+      return slot_alloc_ == other.slot_alloc_;
+    }
+  }
+
+  iterator iterator_at(size_type index) noexcept {
+    return iterator(ctrl_ + index, slots_ + index);
+  }
+
+  const_iterator iterator_at(size_type index) const noexcept {
+    return const_iterator(ctrl_ + index, slots_ + index);
+  }
+
+ public:
+  /**
+   * @brief Однонаправленный итератор по занятым местам в порядке массива.
+   */
+  template <bool Const>
+  class Hash_iterator {
+    friend class Hash_table;
+    friend class Hash_iterator<!Const>;
+
+    using slot_pointer = std::conditional_t<Const, const V*, V*>;
+
+    const ctrl_t* ctrl_ = nullptr;
+    slot_pointer slot_ = nullptr;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = V;
+    using pointer = slot_pointer;
+    using reference = std::conditional_t<Const, const V&, V&>;
+
+    Hash_iterator() = default;
+
+    Hash_iterator(const ctrl_t* ctrl, slot_pointer slot)
+        : ctrl_(ctrl), slot_(slot) {}
+
+    /**
+     * @brief Неявное преобразование обычного итератора в константный.
+     */
+    template <bool IsConst = Const>
+      requires IsConst
+    Hash_iterator(const Hash_iterator<false>& it)
+        : ctrl_(it.ctrl_), slot_(it.slot_) {}
+
+    reference operator*() const { return *slot_; }
+
+    pointer operator->() const { return slot_; }
+
+    Hash_iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      skip_empty_or_deleted();
+      return *this;
+    }
+
+    Hash_iterator operator++(int) {
+      Hash_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const Hash_iterator& lhs,
+                           const Hash_iterator& rhs) {
+      return lhs.ctrl_ == rhs.ctrl_;
+    }
+
+   private:
+    /**
+     * @brief Пропускает свободные места целыми группами до занятого места
+     * или sentinel.
+     */
+    void skip_empty_or_deleted() noexcept {
+      while (*ctrl_ < Swiss_ctrl::sentinel) {
+        const size_type shift = Group(ctrl_).count_leading_empty_or_deleted();
+        ctrl_ += shift;
+        slot_ += shift;
+      }
+    }
+  };
+};
+
+}  // namespace s21
+
+#endif  // S21_HASH_TABLE_H
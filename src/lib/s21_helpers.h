@@ -27,6 +27,47 @@ struct Select1st {
   }
 };
 
+/**
+ * @brief Компаратор поддерживает гетерогенный поиск (сравнение ключа с
+ * объектами других типов без их приведения к типу ключа).
+ */
+template <typename Compare>
+concept transparent_compare = requires { typename Compare::is_transparent; };
+
+/**
+ * @brief Хеш-функция и предикат равенства вместе поддерживают гетерогенный
+ * поиск.
+ */
+template <typename Hash, typename KeyEqual>
+concept transparent_hash = requires {
+  typename Hash::is_transparent;
+  typename KeyEqual::is_transparent;
+};
+
+/**
+ * @brief Тег для конструкторов, принимающих уже упорядоченный по возрастанию
+ * ключей диапазон.
+ * @note Повторяющиеся ключи допускаются, контейнеры с уникальными ключами
+ * оставят только первое вхождение.
+ */
+struct sorted_range_t {
+  explicit sorted_range_t() = default;
+};
+inline constexpr sorted_range_t sorted_range{};
+
+/**
+ * @brief Тег для операций над множествами, разрешающий выполнять независимые
+ * ветви рекурсии в разных потоках.
+ * @note Используется вместо std::execution::par, чтобы не требовать от
+ * пользователей подключения TBB, которое нужно <execution> в libstdc++.
+ */
+namespace execution {
+struct parallel_policy {
+  explicit parallel_policy() = default;
+};
+inline constexpr parallel_policy par{};
+}  // namespace execution
+
 /**
  * @brief Структура-функтор сравнивает два значения одного типа.
  */
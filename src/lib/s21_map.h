@@ -1,13 +1,16 @@
 #ifndef S21_MAP_H
 #define S21_MAP_H
 
+#include <memory_resource>
+#include <tuple>
 #include <vector>
 
 #include "s21_red_black_tree.h"
 
 namespace s21 {
 template <typename K, typename T, typename Compare = std::less<K>,
-          typename Alloc = std::allocator<std::pair<const K, T>>>
+          typename Alloc = std::allocator<std::pair<const K, T>>,
+          template <typename> class NodeT = Node>
 class map {
  public:
   using key_type = K;
@@ -15,56 +18,109 @@ class map {
   using value_type = std::pair<const K, T>;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using BinaryTree = Rb_tree<K, value_type, s21::Select1st, Compare, Alloc>;
+  using BinaryTree =
+      Rb_tree<K, value_type, s21::Select1st, Compare, Alloc, NodeT>;
   using iterator = typename BinaryTree::iterator;
   using const_iterator = typename BinaryTree::const_iterator;
   using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using node_type = typename BinaryTree::template node_handle<T>;
+  using insert_return_type = Insert_return<iterator, node_type>;
 
  private:
-  using node_type = BinaryTree::node_type;
-  BinaryTree* tree;
+  using tree_node = BinaryTree::node_type;
+  BinaryTree tree;
 
  public:
   /**
    * @brief Конструктор по умолчанию, не создает элементов.
    */
-  map() { tree = new BinaryTree; }
+  map() = default;
 
   /**
    * @brief Конструктор из списка инициализации.
    * @note В случае возникновения исключения новые элементы удаляются и set
    * остается пустым.
    */
-  map(std::initializer_list<value_type> const& items) : map{} {
-    auto curr = std::begin(items);
-    try {
-      for (; curr != std::end(items); ++curr) {
-        tree->insert((*curr).first, *curr, true);
-      }
-    } catch (...) {
-      ++curr;  // Устанавливаем в позицию после последнего добавленного.
-      for (auto it = std::begin(items); it != curr; ++it) {
-        node_type* node = tree->search((*it).first);
-        tree->delete_node(node);
-      }
-      throw;
-    }
+  map(std::initializer_list<value_type> const& items)
+      : map(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон собирается за O(n), неупорядоченный
+   * предварительно сортируется. Из повторяющихся ключей остается первый.
+   */
+  template <std::input_iterator InputIt>
+  map(InputIt first, InputIt last) : map{} {
+    tree.assign_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   * @warning Порядок элементов не проверяется.
+   */
+  template <std::input_iterator InputIt>
+  map(sorted_range_t, InputIt first, InputIt last) : map{} {
+    tree.assign_sorted(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc, например, std::pmr::polymorphic_allocator.
+   */
+  explicit map(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  map(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : map(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  map(InputIt first, InputIt last, const Alloc& alloc) : map(alloc) {
+    tree.assign_range(first, last, true);
   }
 
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  map(const map& other, const Alloc& alloc) : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Копирует other, распределяя копирование поддеревьев между
+   * потоками.
+   * @param threads Количество потоков, 0 — по числу ядер.
+   * @note Параллельно копируются большие массивы с аллокатором, у которого
+   * is_always_equal, например std::allocator и concurrent_pool_allocator.
+   * Остальные, в том числе на pool_allocator и pmr, копируются
+   * последовательно.
+   */
+  map(execution::parallel_policy policy, const map& other,
+      unsigned threads = 0)
+      : tree(policy, other.tree, threads) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  map(map&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
   /**
    * @brief Конструктор копирования.
    * @param other Сылка на другой map.
    */
-  map(const map& other) { tree = new BinaryTree(*other.tree); }
+  map(const map& other) : tree(other.tree) {}
 
   /**
    * @brief Конструктор перемещения.
    * @param other rvalue на другой map.
    */
-  map(map&& other) noexcept {
-    tree = other.tree;
-    other.tree = new BinaryTree;
-  }
+  map(map&& other) noexcept : tree(std::move(other.tree)) {}
 
   /**
    * @brief Деструктор удаляет только сами элементы. Важно отметить, что если
@@ -72,16 +128,13 @@ class map {
    * не затрагивается. Управление памятью, на которую указывают указатели,
    * является ответственностью пользователя.
    */
-  ~map() { delete tree; }
+  ~map() = default;
 
   /**
    * @brief Оператор присваивания для map.
    */
   map& operator=(const map& other) {
-    if (this != &other) {
-      delete tree;
-      tree = new BinaryTree(*other.tree);
-    }
+    tree = other.tree;
     return *this;
   }
 
@@ -89,11 +142,7 @@ class map {
    * @brief Оператор присваивающего перемещения.
    */
   map& operator=(map&& other) noexcept {
-    if (this != &other) {
-      delete tree;
-      tree = other.tree;
-      other.tree = new BinaryTree;
-    }
+    tree = std::move(other.tree);
     return *this;
   }
 
@@ -106,18 +155,11 @@ class map {
    * Возвращает данные, связанные с ключом, указанным в квадратных скобках.
    * Если ключ не существует, создается пара с этим ключом, используя значения
    * по умолчанию, которая затем возвращается.
+   * @note Выполняет один спуск по дереву, значение создается прямо в ноде.
    */
-  T& operator[](const K& key) {
-    auto node = tree->search(key);
-    if (node == tree->get_nil()) {
-      auto p = insert(value_type(key, mapped_type()));
-      // Из пары получаем итератор, из итератора получаем ноду, из ноды(пара),
-      // получаем значение.
-      return (*(p.first)).second;
-    } else {
-      return node->val.second;
-    }
-  }
+  T& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  T& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
 
   /**
    * @brief Поучает ссылку на значение по ключу.
@@ -126,8 +168,8 @@ class map {
    * @throw std::out_of_range("map::at") если такого ключа нет в map.
    */
   mapped_type& at(const key_type& key) {
-    auto node = tree->search(key);
-    if (node == tree->get_nil()) {
+    auto node = tree.search(key);
+    if (node == tree.get_nil()) {
       throw std::out_of_range("map::at");
     }
     return (node->val).second;
@@ -137,42 +179,42 @@ class map {
    * Возвращает изменяемый (read/write) итератор, указывающий на первую пару в
    * map. Итерация выполняется в порядке возрастания ключей.
    */
-  inline iterator begin() { return tree->begin(); }
+  inline iterator begin() { return tree.begin(); }
 
   /**
    * Возвращает константный (только для чтения) итератор, указывающий на первую
    * пару в map. Итерация выполняется в порядке возрастания ключей.
    */
-  inline const_iterator begin() const { return tree->cbegin(); }
+  inline const_iterator begin() const { return tree.cbegin(); }
 
   /**
    * Возвращает изменяемый (read/write) итератор, указывающий на позицию после
    * последней пары в map. Итерация выполняется в порядке возрастания ключей.
    */
-  inline iterator end() { return tree->end(); }
+  inline iterator end() { return tree.end(); }
 
   /**
    * Возвращает константный (только для чтения) итератор, указывающий на позицию
    * после последней пары в map. Итерация выполняется в порядке возрастания
    * ключей.
    */
-  inline const_iterator end() const { return tree->cend(); }
+  inline const_iterator end() const { return tree.cend(); }
 
   /**
    * Возвращает true, если карта пуста (в этом случае begin() будет равен
    * end()).
    */
-  inline bool empty() const noexcept { return tree->empty(); }
+  inline bool empty() const noexcept { return tree.empty(); }
 
   /**
    * Возвращает количество элементов (размер) в map.
    */
-  inline size_type size() const noexcept { return tree->size(); }
+  inline size_type size() const noexcept { return tree.size(); }
 
   /**
    * @brief Возвращает максимально возможный размер map.
    */
-  inline size_type max_size() noexcept { return tree->max_size(); }
+  inline size_type max_size() noexcept { return tree.max_size(); }
 
   /**
    * @brief Удаляет все элементы из map. Важно отметить, что эта функция
@@ -181,7 +223,40 @@ class map {
    * памятью, на которую указывают указатели, является ответственностью
    * пользователя.
    */
-  inline void clear() { tree->clear(); }
+  inline void clear() { tree.clear(); }
+
+  /**
+   * @brief Удаляет не больше max_nodes первых элементов, чтобы распределить
+   * очистку большого массива по нескольким вызовам, например по итерациям
+   * цикла событий.
+   * @return true, если контейнер опустел.
+   */
+  bool clear_some(size_type max_nodes) noexcept {
+    return tree.clear_some(max_nodes);
+  }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды элементов и
+   * потери аллокатора вместе с самим объектом контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает копию аллокатора контейнера.
+   */
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
 
   /**
    * @brief Добавляет новое значение в коллекцию только если такого ключа еще
@@ -191,8 +266,8 @@ class map {
    * указывающее на то был ли зоздан элемент.
    */
   std::pair<iterator, bool> insert(const value_type& value) {
-    auto res = tree->insert(value.first, value, true);
-    return {iterator(res.first, tree), res.second};
+    auto res = tree.insert(value.first, value, true);
+    return {iterator(res.first, &tree), res.second};
   }
 
   /**
@@ -204,24 +279,149 @@ class map {
    * указывающее на то был ли зоздан элемент.
    */
   std::pair<iterator, bool> insert(const K& key, const T& obj) {
-    auto res = tree->insert(key, {key, obj}, true);
-    return {iterator(res.first, tree), res.second};
+    auto res = tree.emplace_with_key(key, true, key, obj);
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Перемещает пару в коллекцию только если такого ключа еще нет.
+   * @param value rvalue пары ключ-значение.
+   * @return Пара итератор на элемент сообтветствующий ключу, булево значение
+   * указывающее на то был ли зоздан элемент.
+   * @note Если ключ уже есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value.first, true, std::move(value));
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Конструирует пару на месте из переданных аргументов и вставляет
+   * её, если такого ключа ещё нет.
+   * @param args Аргументы конструктора value_type.
+   * @return Пара итератор на элемент сообтветствующий ключу, булево значение
+   * указывающее на то был ли зоздан элемент.
+   * @note Пара создается до поиска места вставки и уничтожается, если ключ уже
+   * существует. Чтобы не создавать значение зря, используйте try_emplace.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto res = tree.emplace(true, std::forward<Args>(args)...);
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Добавляет пару, используя подсказку позиции, если такого ключа ещё
+   * нет.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value Пара ключ-значение.
+   * @return Итератор на элемент сообтветствующий ключу.
+   * @note Если ключ попадает непосредственно перед hint, вставка выполняется
+   * за амортизированное O(1). Иначе (в том числе для итератора другого
+   * контейнера) место ищется спуском от корня.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    auto res =
+        tree.emplace_hint_with_key(hint_node(hint), value.first, true, value);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Перемещает пару в коллекцию, используя подсказку позиции, если
+   * такого ключа ещё нет.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value rvalue пары ключ-значение.
+   * @return Итератор на элемент сообтветствующий ключу.
+   */
+  iterator insert(const_iterator hint, value_type&& value) {
+    auto res = tree.emplace_hint_with_key(hint_node(hint), value.first, true,
+                                           std::move(value));
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Аналог emplace с подсказкой позиции вставки.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент с таким ключом.
+   */
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    auto res =
+        tree.emplace_hint(hint_node(hint), true, std::forward<Args>(args)...);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Вставляет элемент с ключом key, значение которого конструируется
+   * из args, если такого ключа ещё нет.
+   * @param key Ключ.
+   * @param args Аргументы конструктора mapped_type.
+   * @return Пара итератор на элемент сообтветствующий ключу, булево значение
+   * указывающее на то был ли зоздан элемент.
+   * @note Если ключ уже существует, ни key, ни args не используются.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    auto res = tree.emplace_with_key(
+        key, true, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    auto res = tree.emplace_with_key(
+        key, true, std::piecewise_construct,
+        std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Аналог try_emplace с подсказкой позиции вставки.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент сообтветствующий ключу.
+   */
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, const K& key, Args&&... args) {
+    auto res = tree.emplace_hint_with_key(
+        hint_node(hint), key, true, std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return iterator(res.first, &tree);
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, K&& key, Args&&... args) {
+    auto res = tree.emplace_hint_with_key(
+        hint_node(hint), key, true, std::piecewise_construct,
+        std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return iterator(res.first, &tree);
   }
 
   /**
    * @brief Добавляет новое значение в коллекцию, если ключ существует заменит
    * его.
    * @param key Ключ.
-   * @param obj Значение.
+   * @param obj Значение, копируется или перемещается в зависимости от
+   * категории переданного выражения.
    * @note Пара итератор на элемент сообтветствующий ключу, булево значение
    * указывающее на то был ли зоздан элемент.
    */
-  std::pair<iterator, bool> insert_or_assign(const K& key, const T& obj) {
-    auto res = tree->insert(key, {key, obj}, true);
-    // Из пары получаем ноду, из ноды значение(пара), из значения второе
-    // значение.
-    if (res.second == false) res.first->val.second = obj;
-    return {iterator(res.first, tree), res.second};
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    auto res = try_emplace(key, std::forward<M>(obj));
+    // try_emplace использует obj только при вставке.
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    auto res = try_emplace(std::move(key), std::forward<M>(obj));
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
   }
 
   /**
@@ -230,7 +430,76 @@ class map {
    * контейнеру, из которого происходит удаление.
    */
   void erase(iterator pos) {
-    if (pos.is_same_iterator(tree)) tree->delete_node(pos.get_current());
+    if (tree.owns(pos)) tree.delete_node(pos.get_current());
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @param key Ключ.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const K& key) { return erase_node(tree.search(key)); }
+
+  /**
+   * @brief Гетерогенное удаление по объекту, сравнимому с ключом. Доступно
+   * для прозрачных компараторов.
+   */
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return erase_node(tree.search(key));
+  }
+
+  /**
+   * @brief Извлекает элемент из map вместе с его нодой без
+   * освобождения памяти.
+   * @param pos Итератор этого map.
+   * @return Дескриптор ноды, пустой для end() и итератора другого контейнера.
+   * @note Недоступно с pool_allocator: его копия — отдельный пул, который не
+   * может освободить ноду. Дескрипторы с пулом нод работают у pmr-контейнеров
+   * на общем s21::pmr::pool_resource.
+   */
+  node_type extract(const_iterator pos) noexcept {
+    if (!tree.owns(pos)) return node_type{};
+    return tree.template extract<node_type>(
+        const_cast<tree_node*>(pos.get_current()));
+  }
+
+  /**
+   * @brief Извлекает элемент с ключом key.
+   * @return Дескриптор ноды, пустой если ключа нет. Ключ извлеченной ноды
+   * можно изменить через key() и вставить ноду обратно.
+   */
+  node_type extract(const K& key) {
+    return tree.template extract<node_type>(tree.search(key));
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора без выделения памяти.
+   * @param nh Дескриптор ноды, извлеченной из контейнера с равным
+   * аллокатором.
+   * @return Итератор на элемент с таким ключом, флаг вставки и пустой
+   * дескриптор, либо исходная нода, если ключ уже есть.
+   * @note Ноду с другим аллокатором нельзя перенести: её значение
+   * перемещается в новую ноду.
+   * @note Как и extract, недоступно с pool_allocator.
+   */
+  insert_return_type insert(node_type&& nh) {
+    auto res = tree.insert_handle(nh, nullptr, true);
+    if (res.second || nh.empty()) {
+      return {iterator(res.first, &tree), res.second, node_type{}};
+    }
+    return {iterator(res.first, &tree), false, std::move(nh)};
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора, используя подсказку позиции.
+   * @return Итератор на элемент с таким ключом. Если ключ уже есть, нода
+   * остается в nh.
+   */
+  iterator insert(const_iterator hint, node_type&& nh) {
+    return iterator(tree.insert_handle(nh, hint_node(hint), true).first, &tree);
   }
 
   /**
@@ -238,7 +507,7 @@ class map {
    * @param other map того же типа элементов.
    */
   void swap(map& other) noexcept {
-    if (this != &other) std::swap(tree, other.tree);
+    if (this != &other) tree.swap(other.tree);
   }
 
   /**
@@ -248,7 +517,7 @@ class map {
    * уникальные значения для первого map перенесены не будут.
    */
   void merge(map& other) {
-    if (this != &other) tree->merge(other.tree, true);
+    if (this != &other) tree.merge(&other.tree, true);
   }
 
   /**
@@ -256,8 +525,26 @@ class map {
    * @param key Ключ элемента для поиска
    * @return true, если элемент с указанным ключом существует
    */
-  bool contains(const K& key) {
-    return tree->search(key) == tree->get_nil() ? false : true;
+  bool contains(const K& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  /**
+   * @brief Подсчитывает количество элементов с указанным ключом.
+   * @return 1 если ключ есть в map, иначе 0.
+   */
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
   }
 
   /**
@@ -266,7 +553,152 @@ class map {
    * @return Итератор, указывающий на искомый элемент, или end(), если элемент
    * не найден.
    */
-  iterator find(const K& key) { return iterator(tree->search(key), tree); }
+  iterator find(const K& key) { return iterator(tree.search(key), &tree); }
+
+  const_iterator find(const K& key) const {
+    return const_iterator(tree.search(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) {
+    return iterator(tree.search(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  const_iterator find(const KT& key) const {
+    return const_iterator(tree.search(key), &tree);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key, или end().
+   */
+  iterator lower_bound(const K& key) {
+    return iterator(tree.lower_bound(key), &tree);
+  }
+
+  const_iterator lower_bound(const K& key) const {
+    return const_iterator(tree.lower_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) {
+    return iterator(tree.lower_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  const_iterator lower_bound(const KT& key) const {
+    return const_iterator(tree.lower_bound(key), &tree);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key,
+   * или end().
+   */
+  iterator upper_bound(const K& key) {
+    return iterator(tree.upper_bound(key), &tree);
+  }
+
+  const_iterator upper_bound(const K& key) const {
+    return const_iterator(tree.upper_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) {
+    return iterator(tree.upper_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  const_iterator upper_bound(const KT& key) const {
+    return const_iterator(tree.upper_bound(key), &tree);
+  }
+
+  /**
+   * @brief Находит диапазон элементов с ключом key (не больше одного).
+   * @return Пару {lower_bound(key), upper_bound(key)}.
+   */
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<iterator, iterator> equal_range(const KT& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<const_iterator, const_iterator> equal_range(const KT& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  /**
+   * @brief Считает элементы, ключ которых меньше key, за O(log n).
+   * @return Индекс lower_bound(key) в порядке обхода.
+   * @note Доступно, если контейнер объявлен с параметром NodeT = Sized_node.
+   */
+  size_type rank(const K& key) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.rank(key);
+  }
+
+  template <typename KT>
+    requires BinaryTree::sized_nodes && transparent_compare<Compare>
+  size_type rank(const KT& key) const {
+    return tree.rank(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент с индексом index в порядке обхода
+   * за O(log n).
+   * @return Итератор на элемент или end(), если index >= size().
+   */
+  iterator nth(size_type index)
+    requires BinaryTree::sized_nodes
+  {
+    return iterator(tree.select(index), &tree);
+  }
+
+  const_iterator nth(size_type index) const
+    requires BinaryTree::sized_nodes
+  {
+    return const_iterator(tree.select(index), &tree);
+  }
+
+  /**
+   * @brief Возвращает индекс элемента в порядке обхода за O(log n).
+   * @param pos Итератор этого контейнера.
+   * @return Индекс элемента, для end() — size().
+   * @note std::distance(begin(), pos) дает то же значение, но за O(k).
+   */
+  size_type index_of(const_iterator pos) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.position(pos.get_current());
+  }
+
+  /**
+   * @brief Заменяет содержимое map элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @warning Порядок элементов не проверяется.
+   * @throw При исключении содержимое map не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    tree.assign_sorted(first, last, true);
+  }
 
   /**
    * @brief Вставляет несколько уникльных элементов в контейнер за одну
@@ -302,7 +734,38 @@ class map {
     return res;
   }
 
+ private:
+  /**
+   * @brief Удаляет найденную ноду, если она не концевая.
+   * @return Количество удаленных элементов.
+   */
+  size_type erase_node(tree_node* node) {
+    if (node == tree.get_nil()) return 0;
+    tree.delete_node(node);
+    return 1;
+  }
+
+  /**
+   * @brief Возвращает ноду подсказки или nullptr, если итератор принадлежит
+   * другому контейнеру.
+   */
+  const tree_node* hint_node(const_iterator hint) const {
+    return tree.owns(hint) ? hint.get_current() : nullptr;
+  }
+
 };  // class map
+
+namespace pmr {
+/**
+ * @brief map, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          template <typename> class NodeT = Node>
+using map =
+    s21::map<K, T, Compare,
+             std::pmr::polymorphic_allocator<std::pair<const K, T>>, NodeT>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_MAP_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef S21_MEMORY_RESOURCE_H
+#define S21_MEMORY_RESOURCE_H
+
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+#include <tuple>
+
+#include "s21_allocator.h"
+
+namespace s21::pmr {
+
+/**
+ * @brief Ресурс памяти для std::pmr контейнеров, раздающий блоки до
+ * max_block_size байт из пулов pool_allocator по классам размеров 16, 32, 64,
+ * 128 и 256 байт.
+ * @note Несколько контейнеров могут использовать один ресурс, в отличие от
+ * pool_allocator, копия которого создает новый пул. Большие и сверхвыровненные
+ * блоки выделяются из upstream. Ресурс не потокобезопасен.
+ */
+class pool_resource : public std::pmr::memory_resource {
+ public:
+  // Наибольший блок, обслуживаемый пулами.
+  static constexpr std::size_t max_block_size = 256;
+
+  /**
+   * @param chunk_size Количество блоков в первом фрагменте каждого пула.
+   * @param upstream Ресурс для блоков больше max_block_size.
+   */
+  explicit pool_resource(std::size_t chunk_size = 1024,
+                         std::pmr::memory_resource* upstream =
+                             std::pmr::get_default_resource()) noexcept
+      : pools_(chunk_size, chunk_size, chunk_size, chunk_size, chunk_size),
+        upstream_(upstream) {}
+
+  pool_resource(const pool_resource&) = delete;
+  pool_resource& operator=(const pool_resource&) = delete;
+
+  /**
+   * @brief Возвращает системе пустые фрагменты всех пулов.
+   * @return Количество освобожденных байт.
+   */
+  std::size_t release() noexcept {
+    return std::apply(
+        [](auto&... pools) { return (pools.release() + ...); }, pools_);
+  }
+
+  std::pmr::memory_resource* upstream_resource() const noexcept {
+    return upstream_;
+  }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    switch (size_class(bytes, alignment)) {
+      case 0:
+        return std::get<0>(pools_).allocate(1);
+      case 1:
+        return std::get<1>(pools_).allocate(1);
+      case 2:
+        return std::get<2>(pools_).allocate(1);
+      case 3:
+        return std::get<3>(pools_).allocate(1);
+      case 4:
+        return std::get<4>(pools_).allocate(1);
+      default:
+        return upstream_->allocate(bytes, alignment);
+    }
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    switch (size_class(bytes, alignment)) {
+      case 0:
+        return std::get<0>(pools_).deallocate(static_cast<Block<16>*>(p), 1);
+      case 1:
+        return std::get<1>(pools_).deallocate(static_cast<Block<32>*>(p), 1);
+      case 2:
+        return std::get<2>(pools_).deallocate(static_cast<Block<64>*>(p), 1);
+      case 3:
+        return std::get<3>(pools_).deallocate(static_cast<Block<128>*>(p), 1);
+      case 4:
+        return std::get<4>(pools_).deallocate(static_cast<Block<256>*>(p), 1);
+      default:
+        return upstream_->deallocate(p, bytes, alignment);
+    }
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  template <std::size_t Size>
+  struct alignas(std::max_align_t) Block {
+    std::byte bytes[Size];
+  };
+
+  /**
+   * @brief Номер пула для блока, 5 — блок выделяется из upstream.
+   */
+  static std::size_t size_class(std::size_t bytes,
+                                std::size_t alignment) noexcept {
+    if (bytes > max_block_size || alignment > alignof(std::max_align_t)) {
+      return 5;
+    }
+    return bytes <= 16 ? 0 : std::bit_width((bytes - 1) >> 4);
+  }
+
+  std::tuple<pool_allocator<Block<16>>, pool_allocator<Block<32>>,
+             pool_allocator<Block<64>>, pool_allocator<Block<128>>,
+             pool_allocator<Block<256>>>
+      pools_;
+  std::pmr::memory_resource* upstream_;
+};
+
+}  // namespace s21::pmr
+
+#endif  // S21_MEMORY_RESOURCE_H
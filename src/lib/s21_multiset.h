@@ -1,6 +1,7 @@
 #ifndef S21_MULTISET_H
 #define S21_MULTISET_H
 
+#include <memory_resource>
 #include <vector>
 
 #include "s21_red_black_tree.h"
@@ -8,63 +9,117 @@
 namespace s21 {
 
 template <typename Key, typename Compare = std::less<Key>,
-          typename Alloc = std::allocator<Key>>
+          typename Alloc = std::allocator<Key>,
+          template <typename> class NodeT = Node>
 class multiset {
  public:
   using value_type = Key;
   using key_type = Key;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using BinaryTree = Rb_tree<Key, Key, std::identity, Compare, Alloc>;
-  using node_type = BinaryTree::node_type;
+  using BinaryTree =
+      Rb_tree<Key, Key, std::identity, Compare, Alloc, NodeT>;
+  using tree_node = BinaryTree::node_type;
   using iterator = typename BinaryTree::const_iterator;
   using const_iterator = typename BinaryTree::const_iterator;
   using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using node_type = typename BinaryTree::template node_handle<>;
 
  private:
-  BinaryTree* tree;
+  BinaryTree tree;
 
  public:
   /**
    * @brief Конструктор по умолчанию, не создает элементов.
    */
-  multiset() { tree = new BinaryTree; }
+  multiset() = default;
 
   /**
    * @brief Конструктор из списка инициализации.
    * @note В случае возникновения исключения новые элементы удаляются и multiset
    * остается пустым.
    */
-  multiset(std::initializer_list<value_type> const& items) : multiset{} {
-    auto curr = std::begin(items);
-    try {
-      for (; curr != std::end(items); ++curr) {
-        tree->insert(*curr, *curr, false);
-      }
-    } catch (...) {
-      ++curr;  // Устанавливаем в позицию после последнего добавленного.
-      for (auto it = std::begin(items); it != curr; ++it) {
-        node_type* node = tree->search(*it);
-        tree->delete_node(node);
-      }
-      throw;
-    }
+  multiset(std::initializer_list<value_type> const& items)
+      : multiset(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон собирается за O(n), неупорядоченный
+   * предварительно сортируется.
+   */
+  template <std::input_iterator InputIt>
+  multiset(InputIt first, InputIt last) : multiset{} {
+    tree.assign_range(first, last, false);
   }
 
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   * @warning Порядок элементов не проверяется.
+   */
+  template <std::input_iterator InputIt>
+  multiset(sorted_range_t, InputIt first, InputIt last) : multiset{} {
+    tree.assign_sorted(first, last, false);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc, например, std::pmr::polymorphic_allocator.
+   */
+  explicit multiset(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  multiset(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : multiset(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  multiset(InputIt first, InputIt last, const Alloc& alloc) : multiset(alloc) {
+    tree.assign_range(first, last, false);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  multiset(const multiset& other, const Alloc& alloc)
+      : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Копирует other, распределяя копирование поддеревьев между
+   * потоками.
+   * @param threads Количество потоков, 0 — по числу ядер.
+   * @note Параллельно копируются большие множества с аллокатором, у которого
+   * is_always_equal, например std::allocator и concurrent_pool_allocator.
+   * Остальные, в том числе на pool_allocator и pmr, копируются
+   * последовательно.
+   */
+  multiset(execution::parallel_policy policy, const multiset& other,
+           unsigned threads = 0)
+      : tree(policy, other.tree, threads) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  multiset(multiset&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
   /**
    * @brief Конструктор копирования.
    * @param other Сылка на другое множество.
    */
-  multiset(const multiset& other) { tree = new BinaryTree(*other.tree); }
+  multiset(const multiset& other) : tree(other.tree) {}
 
   /**
    * @brief Конструктор перемещения.
    * @param other rvalue на другое множество.
    */
-  multiset(multiset&& other) noexcept {
-    tree = other.tree;
-    other.tree = new BinaryTree;
-  }
+  multiset(multiset&& other) noexcept : tree(std::move(other.tree)) {}
 
   /**
    * @brief Деструктор удаляет только сами элементы. Важно отметить, что если
@@ -72,16 +127,13 @@ class multiset {
    * не затрагивается. Управление памятью, на которую указывают указатели,
    * является ответственностью пользователя.
    */
-  ~multiset() { delete tree; }
+  ~multiset() = default;
 
   /**
    * @brief Оператор присваивания для множества.
    */
   multiset& operator=(const multiset& other) {
-    if (this != &other) {
-      delete tree;
-      tree = new BinaryTree(*other.tree);
-    }
+    tree = other.tree;
     return *this;
   }
 
@@ -89,11 +141,7 @@ class multiset {
    * @brief Оператор присваивающего перемещения.
    */
   multiset& operator=(multiset&& other) noexcept {
-    if (this != &other) {
-      delete tree;
-      tree = other.tree;
-      other.tree = new BinaryTree;
-    }
+    tree = std::move(other.tree);
     return *this;
   }
 
@@ -101,29 +149,29 @@ class multiset {
    * @brief Возвращает константный итератор, указывающий на первый элемент
    * множества. Итерация выполняется в порядке возрастания ключей.
    */
-  inline iterator begin() const { return tree->cbegin(); }
+  inline iterator begin() const { return tree.cbegin(); }
 
   /**
    * @brief Возвращает константный итератор, указывающий на позицию после
    * последнего элемента множества. Итерация выполняется в порядке возрастания
    * ключей.
    */
-  inline iterator end() const { return tree->cend(); }
+  inline iterator end() const { return tree.cend(); }
 
   /**
    * @brief Возвращает true, если множество пустое.
    */
-  inline bool empty() const noexcept { return tree->empty(); }
+  inline bool empty() const noexcept { return tree.empty(); }
 
   /**
    * @brief Возвращает размер множества.
    */
-  inline size_type size() const noexcept { return tree->size(); }
+  inline size_type size() const noexcept { return tree.size(); }
 
   /**
    * @brief Возвращает максимально возможный размер множества.
    */
-  inline size_type max_size() noexcept { return tree->max_size(); }
+  inline size_type max_size() noexcept { return tree.max_size(); }
 
   /**
    * @brief Удаляет все элементы из множества. Важно отметить, что эта функция
@@ -132,7 +180,40 @@ class multiset {
    * памятью, на которую указывают указатели, является ответственностью
    * пользователя.
    */
-  void clear() { tree->clear(); }
+  void clear() { tree.clear(); }
+
+  /**
+   * @brief Удаляет не больше max_nodes первых элементов, чтобы распределить
+   * очистку большого множества по нескольким вызовам, например по итерациям
+   * цикла событий.
+   * @return true, если контейнер опустел.
+   */
+  bool clear_some(size_type max_nodes) noexcept {
+    return tree.clear_some(max_nodes);
+  }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды элементов и
+   * потери аллокатора вместе с самим объектом контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает копию аллокатора контейнера.
+   */
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
 
   /**
    * @brief Добавляет элемент в множество.
@@ -140,8 +221,69 @@ class multiset {
    * @return Итератор, указывающий на добавленный элемент.
    */
   iterator insert(const value_type& value) {
-    auto res = tree->insert(value, value, false);
-    return iterator(res.first, tree);
+    auto res = tree.insert(value, value, false);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Перемещает элемент в множество.
+   * @param value rvalue элемента для вставки.
+   * @return Итератор, указывающий на добавленный элемент.
+   */
+  iterator insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value, false, std::move(value));
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Конструирует элемент на месте из переданных аргументов и добавляет
+   * его в множество.
+   * @param args Аргументы конструктора value_type.
+   * @return Итератор, указывающий на добавленный элемент.
+   */
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    auto res = tree.emplace(false, std::forward<Args>(args)...);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value Элемент для вставки.
+   * @return Итератор, указывающий на добавленный элемент.
+   * @note Если элемент попадает непосредственно перед hint, вставка
+   * выполняется за амортизированное O(1). Иначе (в том числе для итератора
+   * другого контейнера) место ищется спуском от корня.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    auto res =
+        tree.emplace_hint_with_key(hint_node(hint), value, false, value);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Перемещает элемент в множество, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value rvalue элемента для вставки.
+   * @return Итератор, указывающий на добавленный элемент.
+   */
+  iterator insert(const_iterator hint, value_type&& value) {
+    auto res = tree.emplace_hint_with_key(hint_node(hint), value, false,
+                                           std::move(value));
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Аналог emplace с подсказкой позиции вставки.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор, указывающий на добавленный элемент.
+   */
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    auto res =
+        tree.emplace_hint(hint_node(hint), false, std::forward<Args>(args)...);
+    return iterator(res.first, &tree);
   }
 
   /**
@@ -150,22 +292,79 @@ class multiset {
    * контейнеру, из которого происходит удаление.
    */
   void erase(iterator pos) {
-    if (pos.is_same_iterator(tree))
-      tree->delete_node(const_cast<node_type*>(pos.get_current()));
+    if (tree.owns(pos))
+      tree.delete_node(const_cast<tree_node*>(pos.get_current()));
   }
 
   /**
-   * @brief Удаляет элемент по ключу.
+   * @brief Удаляет один элемент с указанным ключом.
    * @param key Ключ.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) { return erase_node(tree.search(key)); }
+
+  /**
+   * @brief Гетерогенное удаление по объекту, сравнимому с ключом. Доступно
+   * для прозрачных компараторов.
+   */
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return erase_node(tree.search(key));
+  }
+
+  /**
+   * @brief Извлекает элемент из мультимножества вместе с его нодой без
+   * освобождения памяти.
+   * @param pos Итератор этого мультимножества.
+   * @return Дескриптор ноды, пустой для end() и итератора другого контейнера.
+   * @note Недоступно с pool_allocator: его копия — отдельный пул, который не
+   * может освободить ноду. Дескрипторы с пулом нод работают у pmr-контейнеров
+   * на общем s21::pmr::pool_resource.
+   */
+  node_type extract(const_iterator pos) noexcept {
+    if (!tree.owns(pos)) return node_type{};
+    return tree.template extract<node_type>(
+        const_cast<tree_node*>(pos.get_current()));
+  }
+
+  /**
+   * @brief Извлекает один элемент с ключом key.
+   * @return Дескриптор ноды, пустой если ключа нет.
+   */
+  node_type extract(const key_type& key) {
+    return tree.template extract<node_type>(tree.search(key));
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора без выделения памяти.
+   * @param nh Дескриптор ноды, извлеченной из контейнера с равным
+   * аллокатором.
+   * @return Итератор на вставленный элемент или end() для пустого nh.
+   * @note Ноду с другим аллокатором нельзя перенести: её значение
+   * перемещается в новую ноду.
+   * @note Как и extract, недоступно с pool_allocator.
    */
-  void erase(key_type key) { tree->delete_node(tree->search(key)); }
+  iterator insert(node_type&& nh) {
+    return iterator(tree.insert_handle(nh, nullptr, false).first, &tree);
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора, используя подсказку позиции.
+   * @return Итератор на вставленный элемент или end() для пустого nh.
+   */
+  iterator insert(const_iterator hint, node_type&& nh) {
+    return iterator(tree.insert_handle(nh, hint_node(hint), false).first,
+                    &tree);
+  }
 
   /**
    * @brief Обменивает данные с другим множеством
    * @param other Множество того же типа элементов.
    */
   void swap(multiset& other) noexcept {
-    if (this != &other) std::swap(tree, other.tree);
+    if (this != &other) tree.swap(other.tree);
   }
 
   /**
@@ -175,7 +374,7 @@ class multiset {
    * уникальные значения для первого множества перенесены не будут.
    */
   void merge(multiset& other) {
-    if (this != &other) tree->merge(other.tree, false);
+    if (this != &other) tree.merge(&other.tree, false);
   }
 
   /**
@@ -184,21 +383,29 @@ class multiset {
    *  @return Итератор, указывающий на искомый элемент или end(), если он не
    * найден.
    */
-  iterator find(const Key& key) { return iterator(tree->search(key), tree); }
+  iterator find(const Key& key) const {
+    return iterator(tree.search(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return iterator(tree.search(key), &tree);
+  }
 
   /**
    *  @brief Подсчитывает количество элементов с указанным ключом.
    *  @param key  Ключ к элементам, которые необходимо найти.
    *  @return Количество элементов с указанным ключом.
+   *  @note С NodeT = Sized_node работает за O(log n), иначе за O(log n + k),
+   * где k — количество найденных элементов.
    */
-  size_type count(const Key& key) {
-    auto it = find(key);
-    size_type count = 0;
-    while (*it == key) {
-      ++count;
-      ++it;
-    }
-    return count;
+  size_type count(const Key& key) const { return count_key(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return count_key(key);
   }
 
   /**
@@ -207,8 +414,14 @@ class multiset {
    *  @return Значение True, если существует какой-либо элемент с указанным
    * ключом.
    */
-  bool contains(const Key& key) {
-    return tree->search(key) == tree->get_nil() ? false : true;
+  bool contains(const Key& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return tree.search(key) != tree.get_nil();
   }
 
   /**
@@ -218,8 +431,14 @@ class multiset {
    *  @return Итератор, указывающий на первый элемент, равный или больший, чем
    * ключ или end().
    */
-  iterator lower_bound(const Key& key) {
-    return iterator(tree->lower_bound(key), tree);
+  iterator lower_bound(const Key& key) const {
+    return iterator(tree.lower_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return iterator(tree.lower_bound(key), &tree);
   }
 
   /**
@@ -229,10 +448,14 @@ class multiset {
    *  @return Итератор, указывающий на первый элемент который больше, чем key
    * или end().
    */
-  iterator upper_bound(const Key& key) {
-    iterator it = iterator(tree->lower_bound(key), tree);
-    while (it != end() && *it == key) ++it;
-    return it;
+  iterator upper_bound(const Key& key) const {
+    return iterator(tree.upper_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return iterator(tree.upper_bound(key), &tree);
   }
 
   /**
@@ -246,11 +469,65 @@ class multiset {
    *    std::make_pair(c.lower_bound(val),
    *                   c.upper_bound(val))
    */
-  std::pair<iterator, iterator> equal_range(const Key& key) {
-    iterator it_start = iterator(tree->lower_bound(key), tree);
-    iterator it_end = it_start;
-    while (it_end != end() && *it_end == key) ++it_end;
-    return {it_start, it_end};
+  std::pair<iterator, iterator> equal_range(const Key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  std::pair<iterator, iterator> equal_range(const KT& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  /**
+   * @brief Считает элементы, ключ которых меньше key, за O(log n).
+   * @return Индекс lower_bound(key) в порядке обхода.
+   * @note Доступно, если контейнер объявлен с параметром NodeT = Sized_node.
+   */
+  size_type rank(const Key& key) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.rank(key);
+  }
+
+  template <typename KT>
+    requires BinaryTree::sized_nodes && transparent_compare<Compare>
+  size_type rank(const KT& key) const {
+    return tree.rank(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент с индексом index в порядке обхода
+   * за O(log n).
+   * @return Итератор на элемент или end(), если index >= size().
+   */
+  iterator nth(size_type index) const
+    requires BinaryTree::sized_nodes
+  {
+    return iterator(tree.select(index), &tree);
+  }
+
+  /**
+   * @brief Возвращает индекс элемента в порядке обхода за O(log n).
+   * @param pos Итератор этого контейнера.
+   * @return Индекс элемента, для end() — size().
+   * @note std::distance(begin(), pos) дает то же значение, но за O(k).
+   */
+  size_type index_of(const_iterator pos) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.position(pos.get_current());
+  }
+
+  /**
+   * @brief Заменяет содержимое множества элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @warning Порядок элементов не проверяется.
+   * @throw При исключении содержимое множества не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    tree.assign_sorted(first, last, false);
   }
 
   /**
@@ -286,8 +563,51 @@ class multiset {
     return res;
   }
 
+ private:
+  /**
+   * @brief Удаляет найденную ноду, если она не концевая.
+   * @return Количество удаленных элементов.
+   */
+  size_type erase_node(tree_node* node) {
+    if (node == tree.get_nil()) return 0;
+    tree.delete_node(node);
+    return 1;
+  }
+
+  /**
+   * @brief Считает элементы с ключом key: по рангам за O(log n), если ноды
+   * хранят размеры поддеревьев, иначе обходом за O(log n + k).
+   */
+  template <typename KT>
+  size_type count_key(const KT& key) const {
+    if constexpr (BinaryTree::sized_nodes) {
+      return tree.upper_rank(key) - tree.rank(key);
+    } else {
+      auto range = equal_range(key);
+      return std::distance(range.first, range.second);
+    }
+  }
+
+  /**
+   * @brief Возвращает ноду подсказки или nullptr, если итератор принадлежит
+   * другому контейнеру.
+   */
+  const tree_node* hint_node(const_iterator hint) const {
+    return tree.owns(hint) ? hint.get_current() : nullptr;
+  }
+
 };  // class multiset
 
+namespace pmr {
+/**
+ * @brief multiset, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          template <typename> class NodeT = Node>
+using multiset =
+    s21::multiset<Key, Compare, std::pmr::polymorphic_allocator<Key>, NodeT>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_MULTISET_H
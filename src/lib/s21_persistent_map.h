@@ -0,0 +1,277 @@
+#ifndef S21_PERSISTENT_MAP_H
+#define S21_PERSISTENT_MAP_H
+
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+
+#include "s21_helpers.h"
+#include "s21_persistent_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Ассоциативный массив с интерфейсом s21::map, копия которого
+ * создается за O(1): копии разделяют ноды персистентного дерева, а
+ * изменение копирует только затронутый путь. Подходит для согласованных
+ * снимков большого массива, который продолжает меняться.
+ * @warning Итераторы только константные и становятся недействительными
+ * после изменения контейнера. Ссылки, полученные через operator[] и
+ * неконстантный at(), действительны до следующего изменения или копирования
+ * контейнера.
+ */
+template <typename K, typename T, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<std::pair<const K, T>>>
+class persistent_map {
+ public:
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = std::pair<const K, T>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree =
+      Persistent_tree<K, value_type, s21::Select1st, Compare, Alloc>;
+  using iterator = typename BinaryTree::iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов.
+   */
+  persistent_map() = default;
+
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc.
+   */
+  explicit persistent_map(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации. Из повторяющихся ключей
+   * остается первый.
+   */
+  persistent_map(std::initializer_list<value_type> const& items,
+                 const Alloc& alloc = Alloc())
+      : persistent_map(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last), например из s21::map.
+   */
+  template <std::input_iterator InputIt>
+  persistent_map(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+      : tree(alloc) {
+    insert(first, last);
+  }
+
+  /**
+   * @brief Создает снимок other за O(1): ноды разделяются до первого
+   * изменения любой из копий.
+   */
+  persistent_map(const persistent_map& other) = default;
+
+  persistent_map(persistent_map&& other) noexcept = default;
+
+  ~persistent_map() = default;
+
+  persistent_map& operator=(const persistent_map& other) = default;
+
+  persistent_map& operator=(persistent_map&& other) noexcept = default;
+
+  /**
+   * @brief Снимок текущего содержимого за O(1), то же, что копия.
+   */
+  persistent_map snapshot() const noexcept { return *this; }
+
+  /**
+   * @brief Доступ к значению по ключу. Если ключа нет, создается элемент со
+   * значением по умолчанию.
+   */
+  T& operator[](const K& key) {
+    return tree
+        .emplace_with_key(key, true, std::piecewise_construct,
+                          std::forward_as_tuple(key), std::tuple<>())
+        .first->val.second;
+  }
+
+  T& operator[](K&& key) {
+    return tree
+        .emplace_with_key(key, true, std::piecewise_construct,
+                          std::forward_as_tuple(std::move(key)),
+                          std::tuple<>())
+        .first->val.second;
+  }
+
+  /**
+   * @brief Получает ссылку на значение по ключу, копируя разделяемые со
+   * снимками ноды на пути к нему.
+   * @throw std::out_of_range("persistent_map::at") если такого ключа нет.
+   */
+  mapped_type& at(const key_type& key) {
+    value_type* value = tree.find_for_write(key);
+    if (value == nullptr) throw std::out_of_range("persistent_map::at");
+    return value->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    const value_type* value = tree.find_value(key);
+    if (value == nullptr) throw std::out_of_range("persistent_map::at");
+    return value->second;
+  }
+
+  const_iterator begin() const noexcept { return tree.begin(); }
+
+  const_iterator end() const noexcept { return tree.end(); }
+
+  const_iterator cbegin() const noexcept { return tree.begin(); }
+
+  const_iterator cend() const noexcept { return tree.end(); }
+
+  bool empty() const noexcept { return tree.empty(); }
+
+  size_type size() const noexcept { return tree.size(); }
+
+  size_type max_size() const noexcept { return tree.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы. Ноды, разделяемые со снимками, остаются
+   * им.
+   */
+  void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Возвращает память нод этой версии, включая разделяемые со
+   * снимками, и самого объекта контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  /**
+   * @brief Проверяет, что контейнеры еще разделяют ноды, то есть один из них
+   * снимок другого без последующих изменений корня.
+   */
+  bool shares_nodes_with(const persistent_map& other) const noexcept {
+    return tree.shares_nodes_with(other.tree);
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  /**
+   * @brief Добавляет пару, если такого ключа еще нет.
+   * @return Пара итератор на элемент с этим ключом и флаг вставки.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    const bool inserted =
+        tree.emplace_with_key(value.first, false, value).second;
+    return {tree.find(value.first), inserted};
+  }
+
+  std::pair<iterator, bool> insert(const K& key, const T& obj) {
+    const bool inserted = tree.emplace_with_key(key, false, key, obj).second;
+    return {tree.find(key), inserted};
+  }
+
+  /**
+   * @brief Перемещает пару в контейнер, если такого ключа еще нет.
+   * @note Если ключ уже есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value.first, false, std::move(value));
+    return {tree.find(res.first->val.first), res.second};
+  }
+
+  /**
+   * @brief Добавляет пары из диапазона [first, last), ключей которых еще
+   * нет.
+   */
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      const value_type& value = *first;
+      tree.emplace_with_key(value.first, false, value);
+    }
+  }
+
+  void insert(std::initializer_list<value_type> const& items) {
+    insert(items.begin(), items.end());
+  }
+
+  /**
+   * @brief Конструирует пару из args и вставляет её, если такого ключа еще
+   * нет.
+   * @note Пара создается до поиска и уничтожается, если ключ уже есть.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto res = tree.emplace(std::forward<Args>(args)...);
+    return {tree.find(res.first->val.first), res.second};
+  }
+
+  /**
+   * @brief Создает элемент из key и args, только если такого ключа еще нет.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    auto res = tree.emplace_with_key(
+        key, false, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {tree.find(key), res.second};
+  }
+
+  /**
+   * @brief Добавляет пару или заменяет значение существующего ключа.
+   * @return Пара итератор на элемент и флаг был ли элемент создан.
+   */
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    auto res = tree.emplace_with_key(key, true, key, std::forward<M>(obj));
+    // emplace_with_key использует obj только при вставке.
+    if (!res.second) res.first->val.second = std::forward<M>(obj);
+    return {tree.find(key), res.second};
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const K& key) { return tree.erase(key); }
+
+  void swap(persistent_map& other) noexcept { tree.swap(other.tree); }
+
+  bool contains(const K& key) const { return tree.contains(key); }
+
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  const_iterator find(const K& key) const { return tree.find(key); }
+
+  const_iterator lower_bound(const K& key) const {
+    return tree.lower_bound(key);
+  }
+
+  const_iterator upper_bound(const K& key) const {
+    return tree.upper_bound(key);
+  }
+};  // class persistent_map
+
+namespace pmr {
+/**
+ * @brief persistent_map, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Compare = std::less<K>>
+using persistent_map =
+    s21::persistent_map<K, T, Compare,
+                        std::pmr::polymorphic_allocator<std::pair<const K, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_MAP_H
@@ -0,0 +1,155 @@
+#ifndef S21_PERSISTENT_SET_H
+#define S21_PERSISTENT_SET_H
+
+#include <memory_resource>
+
+#include "s21_persistent_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Множество с интерфейсом s21::set, копия которого создается за O(1):
+ * копии разделяют ноды персистентного дерева, а изменение копирует только
+ * затронутый путь.
+ * @warning Итераторы становятся недействительными после изменения
+ * контейнера.
+ */
+template <typename K, typename Compare = std::less<K>,
+          typename Alloc = std::allocator<K>>
+class persistent_set {
+ public:
+  using key_type = K;
+  using value_type = K;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using BinaryTree = Persistent_tree<K, K, std::identity, Compare, Alloc>;
+  using iterator = typename BinaryTree::iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+ private:
+  BinaryTree tree;
+
+ public:
+  persistent_set() = default;
+
+  explicit persistent_set(const Alloc& alloc) : tree(alloc) {}
+
+  persistent_set(std::initializer_list<value_type> const& items,
+                 const Alloc& alloc = Alloc())
+      : persistent_set(items.begin(), items.end(), alloc) {}
+
+  template <std::input_iterator InputIt>
+  persistent_set(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+      : tree(alloc) {
+    insert(first, last);
+  }
+
+  /**
+   * @brief Создает снимок other за O(1).
+   */
+  persistent_set(const persistent_set& other) = default;
+
+  persistent_set(persistent_set&& other) noexcept = default;
+
+  ~persistent_set() = default;
+
+  persistent_set& operator=(const persistent_set& other) = default;
+
+  persistent_set& operator=(persistent_set&& other) noexcept = default;
+
+  /**
+   * @brief Снимок текущего содержимого за O(1), то же, что копия.
+   */
+  persistent_set snapshot() const noexcept { return *this; }
+
+  const_iterator begin() const noexcept { return tree.begin(); }
+
+  const_iterator end() const noexcept { return tree.end(); }
+
+  const_iterator cbegin() const noexcept { return tree.begin(); }
+
+  const_iterator cend() const noexcept { return tree.end(); }
+
+  bool empty() const noexcept { return tree.empty(); }
+
+  size_type size() const noexcept { return tree.size(); }
+
+  size_type max_size() const noexcept { return tree.max_size(); }
+
+  void clear() noexcept { tree.clear(); }
+
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  bool shares_nodes_with(const persistent_set& other) const noexcept {
+    return tree.shares_nodes_with(other.tree);
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    const bool inserted = tree.emplace_with_key(value, false, value).second;
+    return {tree.find(value), inserted};
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value, false, std::move(value));
+    return {tree.find(res.first->val), res.second};
+  }
+
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      const value_type& value = *first;
+      tree.emplace_with_key(value, false, value);
+    }
+  }
+
+  void insert(std::initializer_list<value_type> const& items) {
+    insert(items.begin(), items.end());
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto res = tree.emplace(std::forward<Args>(args)...);
+    return {tree.find(res.first->val), res.second};
+  }
+
+  size_type erase(const K& key) { return tree.erase(key); }
+
+  void swap(persistent_set& other) noexcept { tree.swap(other.tree); }
+
+  bool contains(const K& key) const { return tree.contains(key); }
+
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  const_iterator find(const K& key) const { return tree.find(key); }
+
+  const_iterator lower_bound(const K& key) const {
+    return tree.lower_bound(key);
+  }
+
+  const_iterator upper_bound(const K& key) const {
+    return tree.upper_bound(key);
+  }
+};  // class persistent_set
+
+namespace pmr {
+/**
+ * @brief persistent_set, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename K, typename Compare = std::less<K>>
+using persistent_set =
+    s21::persistent_set<K, Compare, std::pmr::polymorphic_allocator<K>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_SET_H
@@ -0,0 +1,711 @@
+#ifndef S21_PERSISTENT_TREE_H
+#define S21_PERSISTENT_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+/**
+ * @brief Нода персистентного дерева. Одну ноду могут разделять несколько
+ * версий дерева, поэтому у нее нет указателя на родителя, а цвета хранятся
+ * на ребрах: red[i] - цвет потомка child[i].
+ * @note Перекраска потомка меняет только родителя, поэтому балансировка не
+ * копирует соседние поддеревья.
+ */
+template <typename V>
+struct Persistent_node {
+  using value_type = V;
+
+  // Количество ссылок на ноду из родителей и корней версий.
+  std::atomic<std::size_t> refs;
+  Persistent_node* child[2];
+  bool red[2];
+  value_type val;
+
+  template <typename... Args>
+  explicit Persistent_node(std::in_place_t, Args&&... args)
+      : refs(1),
+        child{nullptr, nullptr},
+        red{false, false},
+        val(std::forward<Args>(args)...) {}
+};  // struct Persistent_node
+
+/**
+ * @brief Персистентное красно-черное дерево: копия дерева разделяет с
+ * оригиналом все ноды и создается за O(1). Вставка и удаление копируют
+ * только разделяемые ноды на пути от корня и рядом с ним (O(log n)), поэтому
+ * снимок занимает память пропорционально числу изменений после него.
+ * @tparam K тип ключа.
+ * @tparam V тип значения.
+ * @tparam KeyOfValue функтор извлечения ключа из значения.
+ * @tparam Compare функтор для сравнения ключей.
+ * @tparam Alloc аллокатор.
+ * @note Изменять можно только ноды, на которые ссылается одна версия, а
+ * ноды разделяются копиями дерева, поэтому итераторы константные, а
+ * изменение дерева делает их недействительными. Все версии одного дерева
+ * освобождают ноды общим аллокатором: копии pool_allocator не могут
+ * освобождать память друг друга.
+ * @warning Разные версии можно читать и уничтожать в разных потоках, если
+ * аллокатор потокобезопасен. Одну версию нельзя изменять одновременно с
+ * другими обращениями к ней.
+ */
+template <typename K, typename V, typename KeyOfValue = std::identity,
+          typename Compare = std::less<K>, typename Alloc = std::allocator<V>>
+class Persistent_tree {
+ public:
+  class Persistent_iterator;
+
+  using key_type = K;
+  using value_type = V;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using node_type = Persistent_node<V>;
+  using iterator = Persistent_iterator;
+  using const_iterator = Persistent_iterator;
+
+  // Высота красно-черного дерева из n нод не больше 2 log2(n + 1).
+  static constexpr size_type max_height =
+      2 * std::numeric_limits<size_type>::digits;
+
+ private:
+  using node_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<node_type>;
+  using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+  /**
+   * @brief Путь от корня: ноды и направления, в которых продолжается спуск.
+   */
+  struct Path {
+    node_type* nodes[max_height];
+    unsigned char dirs[max_height];
+    size_type depth = 0;
+  };
+
+  node_type* root_;
+  size_type size_;
+  // Общий для всех версий, которые могут разделять ноды.
+  std::shared_ptr<node_allocator> alloc_;
+  [[no_unique_address]] KeyOfValue kov;
+  [[no_unique_address]] Compare comp;
+
+ public:
+  Persistent_tree() : Persistent_tree(Alloc()) {}
+
+  explicit Persistent_tree(const Alloc& alloc)
+      : root_(nullptr),
+        size_(0),
+        alloc_(std::make_shared<node_allocator>(alloc)) {}
+
+  /**
+   * @brief Создает версию, разделяющую с other все ноды, за O(1).
+   */
+  Persistent_tree(const Persistent_tree& other) noexcept
+      : root_(other.root_),
+        size_(other.size_),
+        alloc_(other.alloc_),
+        kov(other.kov),
+        comp(other.comp) {
+    retain(root_);
+  }
+
+  /**
+   * @note Аллокатор остается общим, поэтому other можно заполнять заново.
+   */
+  Persistent_tree(Persistent_tree&& other) noexcept
+      : root_(std::exchange(other.root_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        alloc_(other.alloc_),
+        kov(other.kov),
+        comp(other.comp) {}
+
+  ~Persistent_tree() { release(root_); }
+
+  Persistent_tree& operator=(const Persistent_tree& other) noexcept {
+    if (this != &other) {
+      retain(other.root_);
+      release(root_);
+      root_ = other.root_;
+      size_ = other.size_;
+      alloc_ = other.alloc_;
+      comp = other.comp;
+    }
+    return *this;
+  }
+
+  Persistent_tree& operator=(Persistent_tree&& other) noexcept {
+    if (this != &other) {
+      release(root_);
+      root_ = std::exchange(other.root_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      alloc_ = other.alloc_;
+      comp = other.comp;
+    }
+    return *this;
+  }
+
+  void swap(Persistent_tree& other) noexcept {
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+    alloc_.swap(other.alloc_);
+    std::swap(comp, other.comp);
+  }
+
+  size_type size() const noexcept { return size_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type max_size() const noexcept {
+    return node_alloc_traits::max_size(*alloc_);
+  }
+
+  allocator_type get_allocator() const noexcept { return Alloc(*alloc_); }
+
+  /**
+   * @brief Память нод этой версии, включая разделяемые с другими версиями.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    return {size_ * sizeof(node_type), 0};
+  }
+
+  /**
+   * @brief Проверяет, что версии разделяют хотя бы корень дерева.
+   */
+  bool shares_nodes_with(const Persistent_tree& other) const noexcept {
+    return root_ != nullptr && root_ == other.root_;
+  }
+
+  void clear() noexcept {
+    release(std::exchange(root_, nullptr));
+    size_ = 0;
+  }
+
+  const_iterator begin() const noexcept {
+    const_iterator it(root_);
+    for (const node_type* n = root_; n != nullptr; n = n->child[0]) it.push(n);
+    return it;
+  }
+
+  const_iterator end() const noexcept { return const_iterator(root_); }
+
+  bool contains(const K& key) const { return find_node(key) != nullptr; }
+
+  const_iterator find(const K& key) const {
+    const_iterator it(root_);
+    for (const node_type* n = root_; n != nullptr;) {
+      it.push(n);
+      const K& n_key = kov(n->val);
+      if (comp(key, n_key)) {
+        n = n->child[0];
+      } else if (comp(n_key, key)) {
+        n = n->child[1];
+      } else {
+        return it;
+      }
+    }
+    return end();
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого не меньше
+   * key.
+   */
+  const_iterator lower_bound(const K& key) const {
+    return bound(key, [this](const K& k, const K& n_key) {
+      return !comp(n_key, k);
+    });
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, ключ которого больше key.
+   */
+  const_iterator upper_bound(const K& key) const {
+    return bound(key, [this](const K& k, const K& n_key) {
+      return comp(k, n_key);
+    });
+  }
+
+  /**
+   * @brief Ищет значение без копирования нод.
+   * @return Указатель на значение или nullptr, если ключа нет.
+   */
+  const value_type* find_value(const K& key) const {
+    const node_type* node = find_node(key);
+    return node != nullptr ? &node->val : nullptr;
+  }
+
+  /**
+   * @brief Ищет значение, чтобы его изменить: разделяемые ноды на пути к нему
+   * копируются.
+   * @return Указатель на значение или nullptr, если ключа нет.
+   * @warning Указатель действителен до следующего изменения или копирования
+   * дерева: после копирования запись через него изменит и копию.
+   */
+  value_type* find_for_write(const K& key) {
+    Path path;
+    if (!search(key, path)) return nullptr;
+    own_path(path);
+    return &path.nodes[path.depth - 1]->val;
+  }
+
+  /**
+   * @brief Вставляет значение, сконструированное из args, если ключа key еще
+   * нет.
+   * @param key Ключ значения, которое будет создано.
+   * @param for_write Скопировать путь к существующему значению, чтобы его
+   * можно было изменить.
+   * @return Пара нода с ключом key и флаг вставки. Значение новой ноды и
+   * ноды, найденной с for_write, можно изменять до следующего изменения или
+   * копирования дерева.
+   * @throw std::bad_alloc или исключение конструктора значения. Дерево
+   * остается прежним.
+   */
+  template <typename... Args>
+  std::pair<node_type*, bool> emplace_with_key(const K& key, bool for_write,
+                                               Args&&... args) {
+    Path path;
+    if (search(key, path)) {
+      if (for_write) own_path(path);
+      return {path.nodes[path.depth - 1], false};
+    }
+    return {insert_node(path, create_node(std::forward<Args>(args)...)), true};
+  }
+
+  /**
+   * @brief Вставляет значение, сконструированное из args, если его ключа еще
+   * нет.
+   * @note Значение создается до поиска и уничтожается, если ключ уже есть.
+   */
+  template <typename... Args>
+  std::pair<node_type*, bool> emplace(Args&&... args) {
+    node_type* node = create_node(std::forward<Args>(args)...);
+    Path path;
+    if (search(kov(node->val), path)) {
+      destroy_node(node);
+      return {path.nodes[path.depth - 1], false};
+    }
+    return {insert_node(path, node), true};
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   * @throw std::bad_alloc или исключение копирования значения, если нужно
+   * скопировать разделяемые ноды. Дерево остается прежним.
+   */
+  size_type erase(const K& key) {
+    Path path;
+    if (!search(key, path)) return 0;
+    const size_type target = path.depth - 1;
+    const node_type* node = path.nodes[target];
+    if (node->child[0] != nullptr && node->child[1] != nullptr) {
+      // Удаляемая позиция - наименьший элемент правого поддерева.
+      path.dirs[target] = 1;
+      for (node_type* n = node->child[1]; n != nullptr; n = n->child[0]) {
+        path.dirs[path.depth] = 0;
+        path.nodes[path.depth++] = n;
+      }
+    }
+    // Все, что изменит удаление, копируется до первого изменения.
+    own_path(path);
+    own_erase_fixup(path);
+
+    const size_type last = path.depth - 1;
+    if (last != target) swap_positions(path, target, last);
+    node_type* removed = path.nodes[last];
+    node_type* child = removed->child[removed->child[0] != nullptr ? 0 : 1];
+    const bool was_red = is_red(path, last);
+    *slot(path, last) = child;
+    // Единственный потомок черной ноды красный и занимает ее место черным.
+    if (last > 0) path.nodes[last - 1]->red[path.dirs[last - 1]] = false;
+    destroy_node(removed);
+    --size_;
+    if (!was_red && child == nullptr && last > 0) erase_fixup(path, last - 1);
+    return 1;
+  }
+
+ private:
+  const node_type* find_node(const K& key) const {
+    const node_type* n = root_;
+    while (n != nullptr) {
+      const K& n_key = kov(n->val);
+      if (comp(key, n_key)) {
+        n = n->child[0];
+      } else if (comp(n_key, key)) {
+        n = n->child[1];
+      } else {
+        break;
+      }
+    }
+    return n;
+  }
+
+  /**
+   * @brief Спуск к первому элементу, для ключа которого go_left истинно.
+   */
+  template <typename GoLeft>
+  const_iterator bound(const K& key, GoLeft go_left) const {
+    const_iterator it(root_);
+    unsigned char found = 0;
+    for (const node_type* n = root_; n != nullptr;) {
+      it.push(n);
+      if (go_left(key, kov(n->val))) {
+        found = it.depth_;
+        n = n->child[0];
+      } else {
+        n = n->child[1];
+      }
+    }
+    it.depth_ = found;
+    return it;
+  }
+
+  /**
+   * @brief Спускается к key, записывая путь. Найденная нода - последняя в
+   * пути.
+   * @return true, если ключ найден.
+   */
+  bool search(const K& key, Path& path) const {
+    path.depth = 0;
+    for (node_type* n = root_; n != nullptr;) {
+      path.nodes[path.depth] = n;
+      const K& n_key = kov(n->val);
+      if (comp(key, n_key)) {
+        path.dirs[path.depth++] = 0;
+        n = n->child[0];
+      } else if (comp(n_key, key)) {
+        path.dirs[path.depth++] = 1;
+        n = n->child[1];
+      } else {
+        ++path.depth;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Ссылка на ноду path.nodes[i] из ее родителя или корня.
+   */
+  node_type** slot(Path& path, size_type i) noexcept {
+    return i == 0 ? &root_ : &path.nodes[i - 1]->child[path.dirs[i - 1]];
+  }
+
+  static bool is_red(const Path& path, size_type i) noexcept {
+    return i > 0 && path.nodes[i - 1]->red[path.dirs[i - 1]];
+  }
+
+  /**
+   * @brief Делает ноду по ссылке link собственной для этого дерева: если ее
+   * разделяют другие версии, link перенаправляется на копию.
+   * @note Ссылка link должна принадлежать собственной ноде или корню.
+   * Копирование не меняет содержимое дерева, поэтому исключение оставляет
+   * его корректным.
+   */
+  node_type* own(node_type*& link) {
+    node_type* node = link;
+    if (node->refs.load(std::memory_order_acquire) == 1) return node;
+    node_type* copy = create_node(node->val);
+    for (int i = 0; i < 2; ++i) {
+      copy->child[i] = node->child[i];
+      copy->red[i] = node->red[i];
+      retain(node->child[i]);
+    }
+    link = copy;
+    release(node);
+    return copy;
+  }
+
+  void own_path(Path& path) {
+    for (size_type i = 0; i < path.depth; ++i) {
+      path.nodes[i] = own(*slot(path, i));
+    }
+  }
+
+  /**
+   * @brief Вставляет node под последней нодой пути и восстанавливает
+   * свойства дерева. Повороты и перекраски затрагивают только ноды пути.
+   */
+  node_type* insert_node(Path& path, node_type* node) {
+    try {
+      own_path(path);
+    } catch (...) {
+      destroy_node(node);
+      throw;
+    }
+    ++size_;
+    *slot(path, path.depth) = node;
+    if (path.depth == 0) return node;
+    path.nodes[path.depth - 1]->red[path.dirs[path.depth - 1]] = true;
+    // Красная нода под path.nodes[i] нарушает свойства, если он тоже красный.
+    for (size_type i = path.depth - 1; i > 0;) {
+      node_type* grand = path.nodes[i - 1];
+      const int side = path.dirs[i - 1];
+      if (!grand->red[side]) break;
+      if (grand->red[!side]) {
+        grand->red[0] = grand->red[1] = false;
+        if (i < 2) break;
+        path.nodes[i - 2]->red[path.dirs[i - 2]] = true;
+        i -= 2;
+        continue;
+      }
+      if (path.dirs[i] != side) {
+        grand->child[side] = rotate(path.nodes[i], side);
+      }
+      *slot(path, i - 1) = rotate(grand, !side);
+      break;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Поворачивает поддерево node в сторону dir: его вершиной становится
+   * потомок с другой стороны. Вершина сохраняет цвет node, а node
+   * становится красной.
+   * @return Новая вершина поддерева.
+   */
+  static node_type* rotate(node_type* node, int dir) noexcept {
+    node_type* top = node->child[!dir];
+    node->child[!dir] = top->child[dir];
+    node->red[!dir] = top->red[dir];
+    top->child[dir] = node;
+    top->red[dir] = true;
+    return top;
+  }
+
+  /**
+   * @brief Меняет местами ноды path.nodes[upper] и ее преемника
+   * path.nodes[lower] вместе с цветами позиций.
+   */
+  void swap_positions(Path& path, size_type upper, size_type lower) noexcept {
+    node_type* node = path.nodes[upper];
+    node_type* next = path.nodes[lower];
+    *slot(path, upper) = next;
+    std::swap(node->child, next->child);
+    std::swap(node->red, next->red);
+    if (lower == upper + 1) {
+      next->child[1] = node;
+    } else {
+      path.nodes[lower - 1]->child[0] = node;
+    }
+    path.nodes[upper] = next;
+    path.nodes[lower] = node;
+  }
+
+  /**
+   * @brief Повторяет решения erase_fixup без изменений дерева и копирует
+   * разделяемые ноды, которые повернет балансировка.
+   * @note Перекраска соседа меняет только его родителя из пути, а
+   * повороты выполняются один раз на уровне, где балансировка
+   * останавливается.
+   */
+  void own_erase_fixup(Path& path) {
+    const size_type last = path.depth - 1;
+    const node_type* removed = path.nodes[last];
+    if (last == 0 || is_red(path, last) || removed->child[0] != nullptr ||
+        removed->child[1] != nullptr) {
+      return;
+    }
+    for (size_type i = last - 1;; --i) {
+      node_type* parent = path.nodes[i];
+      const int dir = path.dirs[i];
+      const node_type* sibling = parent->child[!dir];
+      if (!parent->red[!dir] && !sibling->red[0] && !sibling->red[1]) {
+        if (is_red(path, i) || i == 0) return;
+        continue;
+      }
+      node_type* next = own(parent->child[!dir]);
+      if (parent->red[!dir]) next = own(next->child[dir]);
+      if (!next->red[!dir] && next->red[dir]) own(next->child[dir]);
+      return;
+    }
+  }
+
+  /**
+   * @brief Восстанавливает черную высоту после удаления черного листа со
+   * стороны path.dirs[i] ноды path.nodes[i].
+   */
+  void erase_fixup(Path& path, size_type i) noexcept {
+    for (;;) {
+      node_type* parent = path.nodes[i];
+      const int dir = path.dirs[i];
+      node_type** parent_slot = slot(path, i);
+      bool* parent_red =
+          i > 0 ? &path.nodes[i - 1]->red[path.dirs[i - 1]] : nullptr;
+      node_type* sibling = parent->child[!dir];
+      if (parent->red[!dir]) {
+        // Красный сосед поднимается, parent становится красным.
+        *parent_slot = rotate(parent, dir);
+        parent_slot = &sibling->child[dir];
+        parent_red = &sibling->red[dir];
+        sibling = parent->child[!dir];
+      }
+      if (!sibling->red[0] && !sibling->red[1]) {
+        parent->red[!dir] = true;
+        if (parent_red != nullptr && *parent_red) {
+          *parent_red = false;
+          return;
+        }
+        if (i == 0) return;
+        --i;
+        continue;
+      }
+      if (!sibling->red[!dir]) {
+        parent->child[!dir] = sibling = rotate(sibling, !dir);
+      }
+      *parent_slot = rotate(parent, dir);
+      sibling->red[0] = sibling->red[1] = false;
+      return;
+    }
+  }
+
+  template <typename... Args>
+  node_type* create_node(Args&&... args) {
+    node_type* node = node_alloc_traits::allocate(*alloc_, 1);
+    try {
+      node_alloc_traits::construct(*alloc_, node, std::in_place,
+                                   std::forward<Args>(args)...);
+      return node;
+    } catch (...) {
+      node_alloc_traits::deallocate(*alloc_, node, 1);
+      throw;
+    }
+  }
+
+  void destroy_node(node_type* node) noexcept {
+    node_alloc_traits::destroy(*alloc_, node);
+    node_alloc_traits::deallocate(*alloc_, node, 1);
+  }
+
+  static void retain(node_type* node) noexcept {
+    if (node != nullptr) node->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Снимает ссылку на node и освобождает ноды, на которые больше
+   * никто не ссылается.
+   */
+  void release(node_type* node) noexcept {
+    while (node != nullptr &&
+           node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      release(node->child[0]);
+      node_type* right = node->child[1];
+      destroy_node(node);
+      node = right;
+    }
+  }
+
+ public:
+  /**
+   * @brief Константный двунаправленный итератор. Хранит путь от корня,
+   * потому что у нод нет указателя на родителя.
+   */
+  class Persistent_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = V;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const V*;
+    using reference = const V&;
+
+    Persistent_iterator() noexcept : root_(nullptr), depth_(0) {}
+
+    Persistent_iterator(const Persistent_iterator& other) noexcept
+        : root_(other.root_), depth_(other.depth_) {
+      std::copy_n(other.path_, depth_, path_);
+    }
+
+    Persistent_iterator& operator=(const Persistent_iterator& other) noexcept {
+      root_ = other.root_;
+      depth_ = other.depth_;
+      std::copy_n(other.path_, depth_, path_);
+      return *this;
+    }
+
+    reference operator*() const noexcept { return path_[depth_ - 1]->val; }
+
+    pointer operator->() const noexcept { return &path_[depth_ - 1]->val; }
+
+    Persistent_iterator& operator++() noexcept {
+      step(1);
+      return *this;
+    }
+
+    Persistent_iterator operator++(int) noexcept {
+      Persistent_iterator tmp(*this);
+      step(1);
+      return tmp;
+    }
+
+    /**
+     * @note Уменьшение end() переходит к наибольшему элементу.
+     */
+    Persistent_iterator& operator--() noexcept {
+      if (depth_ == 0) {
+        for (const node_type* n = root_; n != nullptr; n = n->child[1]) {
+          push(n);
+        }
+      } else {
+        step(0);
+      }
+      return *this;
+    }
+
+    Persistent_iterator operator--(int) noexcept {
+      Persistent_iterator tmp(*this);
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const Persistent_iterator& other) const noexcept {
+      return current() == other.current();
+    }
+
+   private:
+    friend class Persistent_tree;
+
+    explicit Persistent_iterator(const node_type* root) noexcept
+        : root_(root), depth_(0) {}
+
+    const node_type* current() const noexcept {
+      return depth_ == 0 ? nullptr : path_[depth_ - 1];
+    }
+
+    void push(const node_type* node) noexcept { path_[depth_++] = node; }
+
+    /**
+     * @brief Переходит к соседнему элементу: dir == 1 к следующему,
+     * dir == 0 к предыдущему.
+     */
+    void step(int dir) noexcept {
+      const node_type* n = path_[depth_ - 1];
+      if (n->child[dir] != nullptr) {
+        for (n = n->child[dir]; n != nullptr; n = n->child[!dir]) push(n);
+        return;
+      }
+      // Поднимаемся, пока приходим со стороны dir.
+      n = path_[--depth_];
+      while (depth_ > 0 && path_[depth_ - 1]->child[dir] == n) {
+        n = path_[--depth_];
+      }
+    }
+
+    const node_type* root_;
+    unsigned char depth_;
+    const node_type* path_[max_height];
+  };  // class Persistent_iterator
+};  // class Persistent_tree
+
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_TREE_H
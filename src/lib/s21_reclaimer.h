@@ -0,0 +1,162 @@
+#ifndef S21_RECLAIMER_H
+#define S21_RECLAIMER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+/**
+ * @brief Контейнер, который можно уничтожить в другом потоке: передается
+ * по rvalue, перемещается без исключений, а его аллокатор имеет
+ * is_always_equal и освобождает память из любого потока (std::allocator,
+ * concurrent_pool_allocator). pool_allocator и std::pmr не подходят:
+ * владелец продолжает пользоваться тем же аллокатором одновременно с
+ * потоком удаления.
+ */
+template <typename Container>
+concept Reclaimable =
+    !std::is_reference_v<Container> &&
+    std::is_nothrow_move_constructible_v<Container> &&
+    std::allocator_traits<
+        typename Container::allocator_type>::is_always_equal::value;
+
+/**
+ * @brief Поток, уничтожающий переданные ему контейнеры, чтобы освобождение
+ * большого контейнера не задерживало вызывающий поток.
+ * @note retire() забирает содержимое контейнера перемещением за O(1) и
+ * выделяет только небольшой заголовок задачи. Деструкторы элементов
+ * выполняются в потоке удаления.
+ */
+class Reclaimer {
+ public:
+  using size_type = std::size_t;
+
+  /**
+   * @brief Запускает поток удаления.
+   * @throw std::system_error если поток создать не удалось.
+   */
+  Reclaimer() : thread_([this] { run(); }) {}
+
+  /**
+   * @brief Уничтожает все переданные контейнеры и останавливает поток.
+   */
+  ~Reclaimer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+
+  Reclaimer(const Reclaimer&) = delete;
+  Reclaimer& operator=(const Reclaimer&) = delete;
+
+  /**
+   * @brief Общий для процесса поток удаления, запускается при первом
+   * вызове.
+   * @note При завершении программы уничтожает оставшиеся контейнеры.
+   */
+  static Reclaimer& global() {
+    static Reclaimer reclaimer;
+    return reclaimer;
+  }
+
+  /**
+   * @brief Передает содержимое container потоку удаления, container
+   * остается пустым.
+   * @throw std::bad_alloc если не удалось выделить заголовок задачи,
+   * container при этом не меняется.
+   */
+  template <Reclaimable Container>
+  void retire(Container&& container) {
+    Task_base* task = new Task<Container>(std::move(container));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task->next = head_;
+      head_ = task;
+      ++pending_;
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Ждет, пока будут уничтожены все переданные контейнеры.
+   */
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return pending_ == 0; });
+  }
+
+  /**
+   * @brief Количество переданных, но еще не уничтоженных контейнеров.
+   */
+  size_type pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+  }
+
+ private:
+  struct Task_base {
+    Task_base* next{nullptr};
+
+    virtual ~Task_base() = default;
+  };
+
+  template <typename Container>
+  struct Task final : Task_base {
+    Container container;
+
+    explicit Task(Container&& c) noexcept : container(std::move(c)) {}
+  };
+
+  void run() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wake_.wait(lock, [this] { return head_ != nullptr || stop_; });
+      if (head_ == nullptr) return;
+      Task_base* tasks = std::exchange(head_, nullptr);
+      // Контейнеры уничтожаются без блокировки, retire() не ждет.
+      lock.unlock();
+      size_type done = 0;
+      while (tasks != nullptr) {
+        delete std::exchange(tasks, tasks->next);
+        ++done;
+      }
+      lock.lock();
+      pending_ -= done;
+      if (pending_ == 0) idle_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  Task_base* head_{nullptr};
+  size_type pending_{0};
+  bool stop_{false};
+  // Поток запускается последним, когда остальные поля уже созданы.
+  std::thread thread_;
+};  // class Reclaimer
+
+/**
+ * @brief Передает содержимое container общему потоку удаления
+ * Reclaimer::global().
+ * @code
+ * s21::destroy_in_background(std::move(huge_map));
+ * @endcode
+ */
+template <Reclaimable Container>
+void destroy_in_background(Container&& container) {
+  Reclaimer::global().retire(std::move(container));
+}
+
+}  // namespace s21
+
+#endif  // S21_RECLAIMER_H
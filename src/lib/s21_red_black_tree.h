@@ -1,8 +1,21 @@
 #ifndef S21_RED_BLACK_TREE_H
 #define S21_RED_BLACK_TREE_H
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
 #include <stack>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "s21_allocator.h"
 #include "s21_helpers.h"
@@ -16,22 +29,351 @@ namespace s21 {
 
 enum Node_color { Red = false, Black = true };
 
+/**
+ * @brief Тег конструктора концевой ноды.
+ */
+struct sentinel_t {
+  explicit sentinel_t() = default;
+};
+inline constexpr sentinel_t sentinel{};
+
+/**
+ * @brief Нода красно-черного дерева.
+ * @note Значение хранится в объединении: концевая нода создается без
+ * значения, поэтому V не обязан иметь конструктор по умолчанию. Значение
+ * уничтожает дерево, деструктор ноды его не трогает.
+ */
 template <typename V>
 struct Node {
   using value_type = V;
 
-  value_type val;
+  union {
+    value_type val;
+    char no_value_;
+  };
   Node_color color;
   Node *left;
   Node *right;
   Node *p;
 
-  explicit Node(V val = V(), Node_color color = Red, Node *left = nullptr,
-                Node *right = nullptr, Node *p = nullptr)
-      : val{val}, color(color), left{left}, right{right}, p{p} {};
+  /**
+   * @brief Создает красную ноду, значение которой конструируется на месте из
+   * переданных аргументов.
+   */
+  template <typename... Args>
+  explicit Node(std::in_place_t, Args &&...args)
+      : val(std::forward<Args>(args)...),
+        color(Red),
+        left(nullptr),
+        right(nullptr),
+        p(nullptr) {}
+
+  /**
+   * @brief Создает черную концевую ноду без значения, потомки которой
+   * указывают на нее саму.
+   */
+  constexpr explicit Node(sentinel_t) noexcept
+      : no_value_{}, color(Black), left(this), right(this), p(nullptr) {}
 
+  constexpr ~Node() {}
 };  // struct Node
 
+/**
+ * @brief Нода, дополнительно хранящая размер своего поддерева.
+ * @note Передается в Rb_tree параметром NodeT и включает порядковую
+ * статистику: rank, select и подсчет элементов за O(log n). Расстояние
+ * между итераторами за O(log n) дает operator-, а не std::distance.
+ */
+template <typename V>
+struct Sized_node {
+  using value_type = V;
+
+  union {
+    value_type val;
+    char no_value_;
+  };
+  Node_color color;
+  Sized_node *left;
+  Sized_node *right;
+  Sized_node *p;
+  std::size_t size;
+
+  /**
+   * @brief Создает красную ноду с поддеревом из одного элемента, значение
+   * которой конструируется на месте из переданных аргументов.
+   */
+  template <typename... Args>
+  explicit Sized_node(std::in_place_t, Args &&...args)
+      : val(std::forward<Args>(args)...),
+        color(Red),
+        left(nullptr),
+        right(nullptr),
+        p(nullptr),
+        size(1) {}
+
+  /**
+   * @brief Создает концевую ноду с пустым поддеревом.
+   */
+  constexpr explicit Sized_node(sentinel_t) noexcept
+      : no_value_{},
+        color(Black),
+        left(this),
+        right(this),
+        p(nullptr),
+        size(0) {}
+
+  constexpr ~Sized_node() {}
+};  // struct Sized_node
+
+/**
+ * @brief Указатель на родителя, в младшем бите которого хранится цвет ноды.
+ * @note Ноды выровнены минимум по размеру указателя, поэтому младший бит
+ * адреса всегда равен нулю.
+ */
+template <typename NodeType>
+class Parent_and_color {
+ public:
+  NodeType *parent() const noexcept {
+    return reinterpret_cast<NodeType *>(bits_ & ~kColorBit);
+  }
+
+  void set_parent(NodeType *parent) noexcept {
+    bits_ = reinterpret_cast<std::uintptr_t>(parent) | (bits_ & kColorBit);
+  }
+
+  Node_color color() const noexcept {
+    return static_cast<Node_color>(bits_ & kColorBit);
+  }
+
+  void set_color(Node_color color) noexcept {
+    bits_ = (bits_ & ~kColorBit) | static_cast<std::uintptr_t>(color);
+  }
+
+ protected:
+  constexpr Parent_and_color() noexcept = default;
+
+  /**
+   * @brief Черная нода без родителя.
+   */
+  constexpr explicit Parent_and_color(sentinel_t) noexcept : bits_(Black) {}
+
+ private:
+  static constexpr std::uintptr_t kColorBit = 1;
+
+  // Красная нода без родителя.
+  std::uintptr_t bits_{0};
+};  // class Parent_and_color
+
+/**
+ * @brief Компактная нода: цвет хранится в младшем бите указателя на родителя.
+ * @note Для ключей размером с указатель нода меньше Node на 8 байт.
+ * Передается в Rb_tree параметром NodeT.
+ */
+template <typename V>
+struct Compact_node : Parent_and_color<Compact_node<V>> {
+  using value_type = V;
+
+  union {
+    value_type val;
+    char no_value_;
+  };
+  Compact_node *left;
+  Compact_node *right;
+
+  /**
+   * @brief Создает красную ноду, значение которой конструируется на месте из
+   * переданных аргументов.
+   */
+  template <typename... Args>
+  explicit Compact_node(std::in_place_t, Args &&...args)
+      : val(std::forward<Args>(args)...), left(nullptr), right(nullptr) {}
+
+  constexpr explicit Compact_node(sentinel_t) noexcept
+      : Parent_and_color<Compact_node>(sentinel),
+        no_value_{},
+        left(this),
+        right(this) {}
+
+  constexpr ~Compact_node() {}
+};  // struct Compact_node
+
+/**
+ * @brief Компактная нода, дополнительно хранящая размер своего поддерева.
+ */
+template <typename V>
+struct Compact_sized_node : Parent_and_color<Compact_sized_node<V>> {
+  using value_type = V;
+
+  union {
+    value_type val;
+    char no_value_;
+  };
+  Compact_sized_node *left;
+  Compact_sized_node *right;
+  std::size_t size;
+
+  template <typename... Args>
+  explicit Compact_sized_node(std::in_place_t, Args &&...args)
+      : val(std::forward<Args>(args)...),
+        left(nullptr),
+        right(nullptr),
+        size(1) {}
+
+  constexpr explicit Compact_sized_node(sentinel_t) noexcept
+      : Parent_and_color<Compact_sized_node>(sentinel),
+        no_value_{},
+        left(this),
+        right(this),
+        size(0) {}
+
+  constexpr ~Compact_sized_node() {}
+};  // struct Compact_sized_node
+
+/**
+ * @brief Память, занимаемая контейнером.
+ */
+struct memory_usage_info {
+  std::size_t node_bytes;      // Ноды с элементами
+  std::size_t overhead_bytes;  // Объект контейнера и потери аллокатора
+  std::size_t total() const noexcept { return node_bytes + overhead_bytes; }
+};
+
+template <typename K, typename V, typename KeyOfValue, typename Compare,
+          typename Alloc, template <typename> class NodeT>
+class Rb_tree;
+
+/**
+ * @brief Дескриптор ноды, извлеченной из контейнера методом extract.
+ * @tparam NodeT Тип ноды дерева.
+ * @tparam Alloc Аллокатор контейнера.
+ * @tparam Mapped Тип отображаемого значения для map, void для множеств.
+ * @note Владеет нодой вместе с копией аллокатора: если нода не вставлена в
+ * контейнер, значение уничтожается, а память возвращается аллокатору. Между
+ * контейнерами с равными аллокаторами нода переходит без выделения памяти.
+ * Аллокаторы, единолично владеющие своими фрагментами (pool_allocator), не
+ * поддерживаются: копия такого аллокатора в дескрипторе не может освободить
+ * ноду, поэтому extract не компилируется.
+ */
+template <typename NodeT, typename Alloc, typename Mapped = void>
+class Node_handle {
+  using node_allocator =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<NodeT>;
+  using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+ public:
+  using value_type = typename NodeT::value_type;
+  using allocator_type = Alloc;
+
+  constexpr Node_handle() noexcept = default;
+
+  Node_handle(Node_handle &&other) noexcept
+      : node_(std::exchange(other.node_, nullptr)) {
+    if (other.alloc_) alloc_.emplace(std::move(*other.alloc_));
+    other.alloc_.reset();
+  }
+
+  /**
+   * @brief Уничтожает текущую ноду и забирает ноду other.
+   */
+  Node_handle &operator=(Node_handle &&other) noexcept {
+    if (this != &other) {
+      reset();
+      node_ = std::exchange(other.node_, nullptr);
+      if (other.alloc_) alloc_.emplace(std::move(*other.alloc_));
+      other.alloc_.reset();
+    }
+    return *this;
+  }
+
+  ~Node_handle() { reset(); }
+
+  [[nodiscard]] bool empty() const noexcept { return node_ == nullptr; }
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+
+  /**
+   * @brief Возвращает копию аллокатора. Дескриптор не должен быть пустым.
+   */
+  allocator_type get_allocator() const { return allocator_type(*alloc_); }
+
+  /**
+   * @brief Значение ноды множества.
+   */
+  value_type &value() const noexcept
+    requires std::is_void_v<Mapped>
+  {
+    return node_->val;
+  }
+
+  /**
+   * @brief Ключ ноды map. Его можно изменить до вставки ноды в контейнер.
+   */
+  auto &key() const noexcept
+    requires(!std::is_void_v<Mapped>)
+  {
+    using key_type = std::remove_const_t<typename value_type::first_type>;
+    return const_cast<key_type &>(node_->val.first);
+  }
+
+  /**
+   * @brief Отображаемое значение ноды map.
+   */
+  auto &mapped() const noexcept
+    requires(!std::is_void_v<Mapped>)
+  {
+    return node_->val.second;
+  }
+
+  void swap(Node_handle &other) noexcept {
+    Node_handle temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+  }
+
+  friend void swap(Node_handle &lhs, Node_handle &rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+ private:
+  template <typename K, typename V, typename KeyOfValue, typename Compare,
+            typename A, template <typename> class N>
+  friend class Rb_tree;
+
+  Node_handle(NodeT *node, const node_allocator &alloc) noexcept
+      : node_(node), alloc_(alloc) {}
+
+  /**
+   * @brief Передает ноду вызывающему, дескриптор становится пустым.
+   */
+  NodeT *release() noexcept {
+    alloc_.reset();
+    return std::exchange(node_, nullptr);
+  }
+
+  void reset() noexcept {
+    if (node_ != nullptr) {
+      std::destroy_at(std::addressof(node_->val));
+      node_alloc_traits::destroy(*alloc_, node_);
+      node_alloc_traits::deallocate(*alloc_, node_, 1);
+      node_ = nullptr;
+    }
+    alloc_.reset();
+  }
+
+  NodeT *node_ = nullptr;
+  std::optional<node_allocator> alloc_;
+};  // class Node_handle
+
+/**
+ * @brief Результат вставки дескриптора ноды в контейнер с уникальными
+ * ключами: если ключ уже есть, нода возвращается в поле node.
+ */
+template <typename Iterator, typename NodeHandle>
+struct Insert_return {
+  Iterator position;
+  bool inserted;
+  NodeHandle node;
+};
+
 /**
  * @brief Класс с реализацией красно-чёрного дерева.
  * @tparam K тип ключа.
@@ -39,9 +381,12 @@ struct Node {
  * @tparam KeyOfValue функтор извлечения ключа из поля val структуры Node.
  * @tparam Compare функтор для сравнения ключей.
  * @tparam Alloc аллокатор.
+ * @tparam NodeT шаблон ноды: Node, Sized_node, Compact_node или
+ * Compact_sized_node.
  */
 template <typename K, typename V, typename KeyOfValue = std::identity,
-          typename Compare = std::less<K>, typename Alloc = std::allocator<V>>
+          typename Compare = std::less<K>, typename Alloc = std::allocator<V>,
+          template <typename> class NodeT = Node>
 class Rb_tree {
  public:
   class Rb_tree_iterator;
@@ -53,11 +398,41 @@ class Rb_tree {
   using const_reference = const value_type &;
   using size_type = size_t;
   using allocator_type = Alloc;
-  using node_type = Node<V>;
+  using node_type = NodeT<V>;
+
+  /**
+   * @brief Ноды хранят размеры поддеревьев.
+   */
+  static constexpr bool sized_nodes =
+      requires(node_type &node) { node.size; };
+
+  /**
+   * @brief Цвет ноды хранится в указателе на родителя.
+   */
+  static constexpr bool packed_color =
+      requires(const node_type &node) { node.parent(); };
+
+  /**
+   * @brief Конструктор с execution::par копирует дерево в нескольких потоках.
+   * @note Требует is_always_equal у аллокатора (std::allocator,
+   * concurrent_pool_allocator). Деревья на pool_allocator и
+   * std::pmr::polymorphic_allocator копируются последовательно: копия пула
+   * не может освободить ноды дерева, а ресурс pmr не обязан быть
+   * потокобезопасным.
+   */
+  static constexpr bool parallel_copy =
+      std::allocator_traits<typename std::allocator_traits<
+          Alloc>::template rebind_alloc<node_type>>::is_always_equal::value;
 
   using iterator = Rb_tree_iterator;
   using const_iterator = Rb_tree_const_iterator;
 
+  /**
+   * @brief Дескриптор ноды дерева, Mapped — тип значения map или void.
+   */
+  template <typename Mapped = void>
+  using node_handle = Node_handle<node_type, Alloc, Mapped>;
+
  private:
   // Перепривязка аллокатора для типа Node
   using node_allocator =
@@ -65,88 +440,179 @@ class Rb_tree {
 
   // Трейты для работы с аллокатором узлов
   using node_alloc_traits = std::allocator_traits<node_allocator>;
+  static constexpr bool propagate_on_copy =
+      node_alloc_traits::propagate_on_container_copy_assignment::value;
+  static constexpr bool propagate_on_move =
+      node_alloc_traits::propagate_on_container_move_assignment::value;
+  // Аллокатор единолично владеет своими фрагментами (как pool_allocator):
+  // его копия — отдельный пул, который не может освободить наши ноды.
+  static constexpr bool exclusive_allocator =
+      requires(node_allocator &a) { a.release_all(); };
+
+  // Общая для всех деревьев этого типа концевая нода. Инициализируется на
+  // этапе компиляции и никогда не изменяется, поэтому деревья можно изменять
+  // из разных потоков, а пустое дерево не выделяет память.
+  static constinit inline node_type sentinel_node_{sentinel};
+  static constexpr node_type *nil_ = &sentinel_node_;
 
   node_type *root;
-  node_type *nil_;
+  node_type *leftmost_;   // Минимальная нода или nil_.
+  node_type *rightmost_;  // Максимальная нода или nil_.
   size_type node_count;
-  KeyOfValue kov;
-  Compare comp;
-  node_allocator alloc;
+  // Функторы и аллокатор обычно пустые и не должны увеличивать размер дерева.
+  [[no_unique_address]] KeyOfValue kov;
+  [[no_unique_address]] Compare comp;
+  [[no_unique_address]] node_allocator alloc;
 
  public:
-  Rb_tree() : node_count{}, comp{} {
-    nil_ = create_node(value_type());
-    nil_->color = Black;
-    nil_->left = nil_->right = nil_->p = nil_;
-    root = nil_;
+  Rb_tree() noexcept(std::is_nothrow_default_constructible_v<Compare> &&
+                     std::is_nothrow_default_constructible_v<node_allocator>)
+      : root(nil_),
+        leftmost_(nil_),
+        rightmost_(nil_),
+        node_count{},
+        kov{},
+        comp{},
+        alloc{} {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @note Упорядоченный диапазон собирается за O(n), неупорядоченный
+   * предварительно сортируется.
+   */
+  template <std::input_iterator InputIt>
+  Rb_tree(InputIt first, InputIt last, bool unique_keys) : Rb_tree() {
+    assign_range(first, last, unique_keys);
   }
 
+  /**
+   * @brief Создает пустое дерево, ноды которого выделяются копией a.
+   */
+  explicit Rb_tree(const Alloc &a)
+      : root(nil_),
+        leftmost_(nil_),
+        rightmost_(nil_),
+        node_count{},
+        kov{},
+        comp{},
+        alloc(a) {}
+
   Rb_tree(const Rb_tree &other)
-      : node_count{},
-        kov{other.kov},
-        comp{other.comp},
-        alloc{node_alloc_traits::select_on_container_copy_construction(
-            other.alloc)} {
-    try {
-      // 1. Создаём nil-узел.
-      nil_ = create_node(value_type());
-      nil_->color = Black;
-      nil_->left = nil_->right = nil_->p = nil_;
-      root = nil_;
+      : Rb_tree(other, node_alloc_traits::select_on_container_copy_construction(
+                           other.alloc)) {}
 
-      // 2. Копируем основное дерево.
-      if (other.get_root() != other.get_nil()) {
-        copy_tree(other.get_root(), other.get_nil());
-      }
-      node_count = other.node_count;
+  /**
+   * @brief Копирует other, выделяя ноды копией a.
+   */
+  Rb_tree(const Rb_tree &other, const Alloc &a)
+      : Rb_tree(other, node_allocator(a)) {}
 
-    } catch (...) {
-      if (root != nil_) clear();
-      throw;
-    }
-  }
+  /**
+   * @brief Копирует other, распределяя поддеревья между потоками.
+   * @param threads Количество потоков, 0 — по числу ядер.
+   * @note Параллельно копируются деревья не меньше kParallelCopyGrain нод с
+   * аллокатором, у которого is_always_equal (std::allocator,
+   * concurrent_pool_allocator): ноды, выделенные копией такого аллокатора в
+   * другом потоке, можно освобождать аллокатором дерева. С pool_allocator и
+   * std::pmr::polymorphic_allocator (parallel_copy == false) конструктор
+   * молча копирует дерево последовательно в текущем потоке: у пула нет
+   * общих с копиями фрагментов, а ресурс pmr может быть непотокобезопасным.
+   */
+  Rb_tree(execution::parallel_policy, const Rb_tree &other,
+          unsigned threads = 0)
+      : Rb_tree(other,
+                node_alloc_traits::select_on_container_copy_construction(
+                    other.alloc),
+                copy_threads(other, threads)) {}
 
+  /**
+   * @brief Конструктор перемещения, забирает ноды и аллокатор other за O(1)
+   * без выделения памяти.
+   */
   Rb_tree(Rb_tree &&other) noexcept
       : root(other.root),
-        nil_(other.nil_),
+        leftmost_(other.leftmost_),
+        rightmost_(other.rightmost_),
         node_count(other.node_count),
+        kov(other.kov),
+        comp(other.comp),
         alloc(std::move(other.alloc)) {
-    other.nil_ = create_node(value_type());
-    other.root = other.nil_;
+    other.root = other.leftmost_ = other.rightmost_ = nil_;
     other.node_count = 0;
   }
 
-  ~Rb_tree() {
-    clear();
-    destroy_node(nil_);
+  /**
+   * @brief Конструктор перемещения с аллокатором. Если a не равен аллокатору
+   * other, значения перемещаются в новые ноды, а other очищается.
+   */
+  Rb_tree(Rb_tree &&other, const Alloc &a)
+      : root(nil_),
+        leftmost_(nil_),
+        rightmost_(nil_),
+        node_count{},
+        kov(other.kov),
+        comp(other.comp),
+        alloc(a) {
+    if (same_allocator(other)) {
+      steal_nodes(other);
+    } else {
+      move_nodes(other);
+    }
   }
 
+  ~Rb_tree() { clear(); }
+
+  /**
+   * @brief Оператор присваивания копированием. Аллокатор other копируется,
+   * только если этого требует propagate_on_container_copy_assignment.
+   */
   Rb_tree &operator=(const Rb_tree &other) {
     if (this != &other) {
-      Rb_tree temp(other);
-      swap(temp);
+      Rb_tree temp(other, propagate_on_copy ? other.alloc : alloc);
+      clear();
+      comp = other.comp;
+      steal_nodes(temp);
+      if constexpr (propagate_on_copy) alloc = std::move(temp.alloc);
     }
     return *this;
   }
 
-  Rb_tree &operator=(Rb_tree &&other) noexcept {
+  /**
+   * @brief Оператор присваивания перемещением. Если аллокатор не
+   * передается (propagate_on_container_move_assignment) и не равен
+   * аллокатору other, значения перемещаются в новые ноды.
+   */
+  Rb_tree &operator=(Rb_tree &&other) noexcept(
+      propagate_on_move || node_alloc_traits::is_always_equal::value) {
     if (this != &other) {
       clear();
-      std::swap(nil_, other.nil_);
-      root = other.root;
-      node_count = other.node_count;
-      std::swap(other.alloc, alloc);
-
-      other.root = other.nil_;
-      other.node_count = 0;
+      comp = other.comp;
+      if constexpr (propagate_on_move) {
+        steal_nodes(other);
+        std::swap(other.alloc, alloc);
+      } else if (same_allocator(other)) {
+        steal_nodes(other);
+      } else {
+        move_nodes(other);
+      }
     }
     return *this;
   }
 
+  /**
+   * @brief Возвращает копию аллокатора.
+   */
+  Alloc get_allocator() const noexcept { return Alloc(alloc); }
+
  public:
-  iterator begin() { return iterator(minimum(root), this); }
-  const_iterator begin() const { return const_iterator(minimum(root), this); }
-  const_iterator cbegin() const { return const_iterator(minimum(root), this); }
+  iterator begin() noexcept { return iterator(leftmost_, this); }
+  const_iterator begin() const noexcept {
+    return const_iterator(leftmost_, this);
+  }
+  const_iterator cbegin() const noexcept {
+    return const_iterator(leftmost_, this);
+  }
 
   iterator end() noexcept { return iterator(nil_, this); }
   const_iterator end() const { return const_iterator(nil_, this); }
@@ -155,7 +621,24 @@ class Rb_tree {
   inline node_type *get_root() noexcept { return root; }
   inline const node_type *get_root() const noexcept { return root; }
 
-  inline const node_type *get_nil() const noexcept { return nil_; }
+  static constexpr const node_type *get_nil() noexcept { return nil_; }
+
+  /**
+   * @brief Проверяет, что итератор указывает на ноду этого дерева.
+   * @details Итератор хранит адрес дерева, а дерево встроено в контейнер,
+   * поэтому после перемещения или swap контейнера адрес в итераторе уже не
+   * совпадает. В этом случае принадлежность ноды проверяется подъемом к корню.
+   * Как и в std, такой итератор нельзя передавать прежнему владельцу.
+   * @return false для end() и нод другого дерева.
+   */
+  template <typename It>
+  bool owns(const It &pos) const noexcept {
+    if (pos.is_same_iterator(this)) return true;
+    const node_type *node = pos.get_current();
+    if (node == nil_) return false;
+    while (parent_of(node) != nil_) node = parent_of(node);
+    return node == root;
+  }
 
   inline bool empty() const noexcept { return root == nil_ ? true : false; }
 
@@ -163,13 +646,62 @@ class Rb_tree {
 
   size_type max_size() noexcept { return node_alloc_traits::max_size(alloc); }
 
+  /**
+   * @brief Возвращает память нод и потери аллокатора без учета объекта
+   * дерева.
+   * @note Если аллокатор ведет статистику (метод stats()), как pool_allocator,
+   * в потери входят свободные ячейки и служебные данные его фрагментов.
+   * Для остальных аллокаторов учитываются только сами ноды.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage{node_count * sizeof(node_type), 0};
+    if constexpr (requires(const node_allocator &a) { a.stats(); }) {
+      const auto stats = alloc.stats();
+      usage.overhead_bytes =
+          stats.bytes_reserved + stats.bytes_bookkeeping - usage.node_bytes;
+    }
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает системе память аллокатора, не занятую нодами, если
+   * аллокатор это поддерживает (метод release()).
+   */
+  void shrink_to_fit() noexcept {
+    if constexpr (requires(node_allocator &a) { a.release(); }) {
+      alloc.release();
+    }
+  }
+
   /**
    * @brief Очистка дерева.
+   * @note Если ноды можно освободить разом (release_all_nodes), работает без
+   * обхода дерева.
    */
   void clear() noexcept {
-    destroy_subtree(root, nil_);
-    root = nil_;
-    node_count = 0;
+    if (root != nil_ && release_all_nodes()) {
+      root = leftmost_ = rightmost_ = nil_;
+      node_count = 0;
+    } else {
+      destroy_all();
+    }
+  }
+
+  /**
+   * @brief Удаляет не больше max_nodes наименьших элементов, чтобы
+   * распределить очистку большого дерева между несколькими вызовами.
+   * @return true, если дерево опустело.
+   * @note Между вызовами дерево остается корректным. Удаление минимума
+   * перебалансирует дерево в среднем за O(1), поэтому вызов работает за
+   * O(max_nodes) в среднем. Последний вызов очищает дерево через clear().
+   */
+  bool clear_some(size_type max_nodes) noexcept {
+    if (node_count <= max_nodes) {
+      clear();
+      return true;
+    }
+    for (; max_nodes > 0; --max_nodes) delete_node(leftmost_);
+    return false;
   }
 
   /**
@@ -182,11 +714,29 @@ class Rb_tree {
    */
   std::pair<node_type *, bool> insert(const K &key, const V &value,
                                       bool unique_keys = true) {
+    return emplace_with_key(key, unique_keys, value);
+  }
+
+  /**
+   * @brief Добавление нового элемента по ключу за один спуск по дереву.
+   * @param key Ссылка на ключ, по которому ищется место вставки.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Объект pair содержащий указатель на ноду и булево значение была ли
+   * создана нода.
+   * @note Значение конструируется прямо в ноде и только если она создается,
+   * поэтому key может ссылаться на объект, перемещаемый в args.
+   */
+  template <typename... Args>
+  std::pair<node_type *, bool> emplace_with_key(const K &key, bool unique_keys,
+                                                Args &&...args) {
     bool created{true};
-    node_type *node = find_or_create(key, value, created, unique_keys);
+    node_type *node = find_or_create(key, created, unique_keys,
+                                     std::forward<Args>(args)...);
 
     if (created == true) {
-      if (node->p != nil_ && node->p->color == Red && node->p->p != nil_) {
+      if (parent_of(node) != nil_ && color_of(parent_of(node)) == Red &&
+          parent_of(parent_of(node)) != nil_) {
         insert_fixup(node);
       }
       ++node_count;
@@ -195,72 +745,292 @@ class Rb_tree {
   }
 
   /**
-   * @brief Удаляет ноду.
-   * @param z Удаляемая нода.
+   * @brief Создает ноду из аргументов и добавляет её в дерево.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Объект pair содержащий указатель на ноду и булево значение была ли
+   * добавлена нода. Если ключ уже существует, созданная нода уничтожается и
+   * возвращается существующая.
    */
-  void delete_node(node_type *z) noexcept {
-    if (z == nil_) return;
-
-    node_type *y;
-    node_type *x;
-    Node_color y_original_color = z->color;
-
-    if (z->left == nil_) {
-      x = z->right;
-      transplant(z, z->right);
-    } else if (z->right == nil_) {
-      x = z->left;
-      transplant(z, z->left);
-    } else {
-      y = minimum(z->right);
-      y_original_color = y->color;
-      x = y->right;
-
-      if (y != z->right) {
-        transplant(y, y->right);
-        y->right = z->right;
-        y->right->p = y;
-      } else {
-        x->p = y;
-      }
+  template <typename... Args>
+  std::pair<node_type *, bool> emplace(bool unique_keys, Args &&...args) {
+    return emplace_hint(nullptr, unique_keys, std::forward<Args>(args)...);
+  }
 
-      transplant(z, y);
-      y->left = z->left;
-      y->left->p = y;
-      y->color = z->color;
+  /**
+   * @brief Аналог emplace_with_key с подсказкой позиции вставки.
+   * @param hint Нода, перед которой ожидается вставка (nil_ означает конец
+   * дерева), или nullptr если подсказки нет.
+   * @param key Ссылка на ключ, по которому ищется место вставки.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Объект pair содержащий указатель на ноду и булево значение была ли
+   * создана нода.
+   * @note Если ключ попадает между hint и её предшественником, вставка
+   * выполняется за амортизированное O(1), иначе спуском от корня.
+   */
+  template <typename... Args>
+  std::pair<node_type *, bool> emplace_hint_with_key(const node_type *hint,
+                                                     const K &key,
+                                                     bool unique_keys,
+                                                     Args &&...args) {
+    Insert_position pos;
+    if (hint != nullptr) pos = hint_position(hint, key, unique_keys);
+
+    if (pos.existing != nullptr) return {pos.existing, false};
+    if (pos.father == nullptr) {
+      return emplace_with_key(key, unique_keys, std::forward<Args>(args)...);
     }
 
-    destroy_node(z);
-    --node_count;
-
-    if (y_original_color == Black) {
-      delete_fixup(x);
+    node_type *node = create_node(std::forward<Args>(args)...);
+    link_at(pos.father, node, pos.insert_left);
+    if (parent_of(node) != nil_ && color_of(parent_of(node)) == Red &&
+        parent_of(parent_of(node)) != nil_) {
+      insert_fixup(node);
     }
+    ++node_count;
+    return {node, true};
   }
 
   /**
-   * @brief Находит минимальное значение для поддерева sub_tree.
-   * @param sub_tree Нода являющаяся корнем поддерева.
-   * @return Нода с минимальным значением.
+   * @brief Аналог emplace с подсказкой позиции вставки.
+   * @param hint Нода, перед которой ожидается вставка (nil_ означает конец
+   * дерева), или nullptr если подсказки нет.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
+   * @return Объект pair содержащий указатель на ноду и булево значение была ли
+   * добавлена нода.
    */
-  node_type *minimum(node_type *sub_tree) {
-    while (sub_tree->left != nil_) {
-      sub_tree = sub_tree->left;
+  template <typename... Args>
+  std::pair<node_type *, bool> emplace_hint(const node_type *hint,
+                                            bool unique_keys, Args &&...args) {
+    node_type *node = create_node(std::forward<Args>(args)...);
+    std::pair<node_type *, bool> res;
+    try {
+      res = insert_node_hint(hint, node, unique_keys);
+    } catch (...) {
+      destroy_node(node);
+      throw;
     }
-    return sub_tree;
-  }
 
-  const node_type *minimum(const node_type *sub_tree) const {
-    while (sub_tree->left != nil_) {
-      sub_tree = sub_tree->left;
+    if (res.second == true) {
+      ++node_count;
+    } else {
+      destroy_node(node);
     }
-    return sub_tree;
+    return res;
   }
 
   /**
-   * @brief Находит максимальное значение для поддерева sub_tree.
-   * @param sub_tree Нода являющаяся корнем поддерева.
-   * @return Нода с максимальным значением.
+   * @brief Заменяет содержимое дерева элементами диапазона [first, last).
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @note Если диапазон уже упорядочен (проверяется для forward итераторов),
+   * дерево собирается снизу вверх за O(n), иначе элементы предварительно
+   * сортируются за O(n log n). Порядок равных элементов сохраняется, при
+   * уникальных ключах остается первое вхождение.
+   * @throw При исключении содержимое дерева не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_range(InputIt first, InputIt last, bool unique_keys) {
+    auto key_less = [this](const auto &lhs, const auto &rhs) {
+      return comp(kov(lhs), kov(rhs));
+    };
+
+    if constexpr (std::forward_iterator<InputIt>) {
+      if (std::is_sorted(first, last, key_less)) {
+        assign_sorted(first, last, unique_keys);
+        return;
+      }
+    }
+
+    // Диапазон не упорядочен: сортируем указатели на значения, чтобы не
+    // требовать от value_type присваивания (у map ключ константный).
+    std::vector<V> buffer;
+    std::vector<const V *> sorted;
+    if constexpr (std::forward_iterator<InputIt> &&
+                  std::is_same_v<std::iter_value_t<InputIt>, V>) {
+      sorted.reserve(std::distance(first, last));
+      for (; first != last; ++first) sorted.push_back(std::addressof(*first));
+    } else {
+      for (; first != last; ++first) buffer.emplace_back(*first);
+      sorted.reserve(buffer.size());
+      for (const V &value : buffer) sorted.push_back(std::addressof(value));
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&key_less](const V *lhs, const V *rhs) {
+                       return key_less(*lhs, *rhs);
+                     });
+    build_from_sorted(sorted.begin(), sorted.end(),
+                      [](const V *value) -> const V & { return *value; },
+                      unique_keys);
+  }
+
+  /**
+   * @brief Заменяет содержимое дерева элементами упорядоченного диапазона
+   * [first, last) за O(n).
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @warning Диапазон должен быть упорядочен по возрастанию ключей, порядок
+   * не проверяется.
+   * @throw При исключении содержимое дерева не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last, bool unique_keys) {
+    build_from_sorted(
+        first, last, [](const auto &value) -> const auto & { return value; },
+        unique_keys);
+  }
+
+  /**
+   * @brief Удаляет ноду.
+   * @param z Удаляемая нода.
+   */
+  void delete_node(node_type *z) noexcept {
+    if (z == nil_) return;
+    unlink_node(z);
+    destroy_node(z);
+  }
+
+  /**
+   * @brief Отсоединяет ноду от дерева и передает её дескриптору без
+   * освобождения памяти.
+   * @param z Нода дерева или nil_, тогда дескриптор пустой.
+   */
+  template <typename Handle>
+  Handle extract(node_type *z) noexcept {
+    static_assert(!exclusive_allocator,
+                  "node handles need an allocator whose copies can free "
+                  "the tree's nodes; pool_allocator is not supported, use a "
+                  "pmr container on s21::pmr::pool_resource instead");
+    if (z == nil_) return Handle{};
+    unlink_node(z);
+    set_parent(z, nil_);
+    set_color(z, Red);
+    return Handle(z, alloc);
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора.
+   * @param hint Нода, перед которой ожидается вставка, или nullptr.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @return Пара как у emplace, для пустого дескриптора {nil_, false}. Если
+   * нода не вставлена, она остается в nh.
+   * @note Если аллокатор nh не равен аллокатору дерева, значение
+   * перемещается в новую ноду, а нода nh уничтожается.
+   */
+  template <typename Handle>
+  std::pair<node_type *, bool> insert_handle(Handle &nh,
+                                             const node_type *hint,
+                                             bool unique_keys) {
+    if (nh.empty()) return {nil_, false};
+    node_type *node = nh.node_;
+    if (!(*nh.alloc_ == alloc)) {
+      auto res = emplace_hint_with_key(hint, kov(node->val), unique_keys,
+                                       std::move(node->val));
+      if (res.second) nh.reset();
+      return res;
+    }
+
+    auto res = insert_node_hint(hint, node, unique_keys);
+    if (res.second) {
+      ++node_count;
+      nh.release();
+    }
+    return res;
+  }
+
+ private:
+  /**
+   * @brief Отсоединяет ноду от дерева, не уничтожая её.
+   * @param z Нода дерева, не nil_.
+   */
+  void unlink_node(node_type *z) noexcept {
+    // У крайних нод нет потомка с внешней стороны, поэтому соседняя нода
+    // находится за O(1) в среднем.
+    if (z == leftmost_) {
+      leftmost_ = z->right != nil_ ? minimum(z->right) : parent_of(z);
+    }
+    if (z == rightmost_) {
+      rightmost_ = z->left != nil_ ? maximum(z->left) : parent_of(z);
+    }
+
+    if constexpr (sized_nodes) {
+      // Из дерева уходит нода z или ее преемник, поэтому размеры уменьшаются
+      // на пути от родителя уходящей ноды до корня.
+      const bool two_children = z->left != nil_ && z->right != nil_;
+      add_size_upwards(two_children ? parent_of(minimum(z->right))
+                                    : parent_of(z),
+                       static_cast<size_type>(-1));
+    }
+
+    node_type *y;
+    node_type *x;
+    // Родитель x хранится отдельно: x может оказаться общей концевой нодой,
+    // которая не изменяется.
+    node_type *x_parent;
+    Node_color y_original_color = color_of(z);
+
+    if (z->left == nil_) {
+      x = z->right;
+      x_parent = parent_of(z);
+      transplant(z, z->right);
+    } else if (z->right == nil_) {
+      x = z->left;
+      x_parent = parent_of(z);
+      transplant(z, z->left);
+    } else {
+      y = minimum(z->right);
+      y_original_color = color_of(y);
+      x = y->right;
+
+      if (y != z->right) {
+        x_parent = parent_of(y);
+        transplant(y, y->right);
+        y->right = z->right;
+        set_parent(y->right, y);
+      } else {
+        x_parent = y;
+      }
+
+      transplant(z, y);
+      y->left = z->left;
+      set_parent(y->left, y);
+      set_color(y, color_of(z));
+      copy_size(y, z);
+    }
+
+    --node_count;
+
+    if (y_original_color == Black) {
+      delete_fixup(x, x_parent);
+    }
+  }
+
+ public:
+
+  /**
+   * @brief Находит минимальное значение для поддерева sub_tree.
+   * @param sub_tree Нода являющаяся корнем поддерева.
+   * @return Нода с минимальным значением.
+   */
+  node_type *minimum(node_type *sub_tree) {
+    while (sub_tree->left != nil_) {
+      sub_tree = sub_tree->left;
+    }
+    return sub_tree;
+  }
+
+  const node_type *minimum(const node_type *sub_tree) const {
+    while (sub_tree->left != nil_) {
+      sub_tree = sub_tree->left;
+    }
+    return sub_tree;
+  }
+
+  /**
+   * @brief Находит максимальное значение для поддерева sub_tree.
+   * @param sub_tree Нода являющаяся корнем поддерева.
+   * @return Нода с максимальным значением.
    */
   node_type *maximum(node_type *sub_tree) {
     while (sub_tree->right != nil_) {
@@ -269,220 +1039,1374 @@ class Rb_tree {
     return sub_tree;
   }
 
-  const node_type *maximum(const node_type *sub_tree) const {
-    while (sub_tree->right != nil_) {
-      sub_tree = sub_tree->right;
-    }
-    return sub_tree;
+  const node_type *maximum(const node_type *sub_tree) const {
+    while (sub_tree->right != nil_) {
+      sub_tree = sub_tree->right;
+    }
+    return sub_tree;
+  }
+
+  /**
+   * @brief Находит ноду с указаным ключём.
+   * @param key Ссылка на ключ.
+   * @return Указатель на найденую ноду, если такого ключа нет будет возвращена
+   * концевая нода nil_.
+   */
+  node_type *search(const K &key) const { return find_node(key); }
+
+  /**
+   * @brief Гетерогенный поиск ноды, доступен для прозрачных компараторов.
+   * @param key Объект, сравнимый с ключом через Compare.
+   */
+  template <typename KT>
+    requires transparent_compare<Compare>
+  node_type *search(const KT &key) const {
+    return find_node(key);
+  }
+
+  /**
+   *  @brief Находит начало подпоследовательности, соответствующей заданному
+   * ключу.
+   *  @param key - ключ для поиска элементов.
+   *  @return Нода элемента, значение которой равно или больший, чем
+   * ключ или end().
+   */
+  node_type *lower_bound(const K &key) const { return lower_node(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  node_type *lower_bound(const KT &key) const {
+    return lower_node(key);
+  }
+
+  /**
+   *  @brief Находит конец подпоследовательности, соответствующей заданному
+   * ключу.
+   *  @param key - ключ для поиска элементов.
+   *  @return Нода первого элемента, ключ которого больше key, или nil_.
+   */
+  node_type *upper_bound(const K &key) const { return upper_node(key); }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  node_type *upper_bound(const KT &key) const {
+    return upper_node(key);
+  }
+
+  /**
+   * @brief Считает элементы, ключ которых меньше key, за O(log n).
+   * @param key Ключ.
+   * @return Индекс lower_bound(key) в порядке обхода.
+   */
+  size_type rank(const K &key) const
+    requires sized_nodes
+  {
+    return count_before(key, false);
+  }
+
+  template <typename KT>
+    requires sized_nodes && transparent_compare<Compare>
+  size_type rank(const KT &key) const {
+    return count_before(key, false);
+  }
+
+  /**
+   * @brief Считает элементы, ключ которых не больше key, за O(log n).
+   * @param key Ключ.
+   * @return Индекс upper_bound(key) в порядке обхода.
+   */
+  size_type upper_rank(const K &key) const
+    requires sized_nodes
+  {
+    return count_before(key, true);
+  }
+
+  template <typename KT>
+    requires sized_nodes && transparent_compare<Compare>
+  size_type upper_rank(const KT &key) const {
+    return count_before(key, true);
+  }
+
+  /**
+   * @brief Находит ноду с индексом index в порядке обхода за O(log n).
+   * @param index Индекс элемента, начиная с 0.
+   * @return Найденную ноду или nil_, если index >= size().
+   */
+  node_type *select(size_type index) const
+    requires sized_nodes
+  {
+    node_type *node = root;
+    while (node != nil_) {
+      const size_type left_size = node->left->size;
+      if (index < left_size) {
+        node = node->left;
+      } else if (index == left_size) {
+        return node;
+      } else {
+        index -= left_size + 1;
+        node = node->right;
+      }
+    }
+    return nil_;
+  }
+
+  /**
+   * @brief Находит индекс ноды в порядке обхода за O(log n).
+   * @param node Нода дерева или nil_.
+   * @return Индекс ноды, для nil_ — size().
+   */
+  size_type position(const node_type *node) const noexcept
+    requires sized_nodes
+  {
+    if (node == nil_) return node_count;
+
+    size_type index = node->left->size;
+    for (; parent_of(node) != nil_; node = parent_of(node)) {
+      node_type *parent = parent_of(node);
+      if (node == parent->right) index += parent->left->size + 1;
+    }
+    return index;
+  }
+
+  /**
+   * @brief Добавляет ноды из other в текущее дерево, елси добавление не удалось
+   * нода остается в other.
+   * @param other Указатель на дерево для слияния.
+   * @param unique_keys Опредеяет будут ли ключи уникалными.
+   * @note Если other сравним по размеру с текущим деревом, оба дерева
+   * обходятся по порядку и пересобираются за O(n + m), иначе ноды other
+   * вставляются по одной за O(m log(n + m)). Ноды переносятся без
+   * перевыделения, только если аллокаторы деревьев равны, иначе значения
+   * перемещаются в новые ноды текущего дерева.
+   * @throw std::bad_alloc при нехватке памяти под вспомогательные массивы или
+   * новые ноды. Линейное слияние в этом случае оставляет оба дерева без
+   * изменений.
+   */
+  void merge(Rb_tree *other, bool unique_keys) {
+    if (other == this || other->node_count == 0) return;
+
+    const size_type total = node_count + other->node_count;
+    if (other->node_count * std::bit_width(total) >= total) {
+      merge_linear(other, unique_keys);
+    } else if (same_allocator(*other)) {
+      merge_by_nodes(other, unique_keys);
+    } else {
+      merge_by_values(other, unique_keys);
+    }
+  }
+
+  /**
+   * @brief Объединяет дерево с other за O(m log(n/m + 1)), где m <= n —
+   * размеры деревьев.
+   * @param other Дерево, ноды которого переносятся в текущее; после вызова
+   * пустое.
+   * @param parallel Разрешает выполнять независимые ветви рекурсии в разных
+   * потоках.
+   * @param keep_other Из двух равных элементов оставить элемент other.
+   * @note Только для уникальных ключей. Ноды other сначала перепривязываются к
+   * концевому узлу текущего дерева за O(m). Сравнение ключей не должно
+   * бросать исключений.
+   * @throw std::bad_alloc до начала перестройки, деревья не меняются.
+   */
+  void unite(Rb_tree &other, bool parallel = false, bool keep_other = false) {
+    if (&other == this) return;
+    const size_type total = node_count + other.node_count;
+    const bool other_smaller = other.node_count <= node_count;
+    Piece adopted = adopt_piece(other);
+    Piece own = take_piece();
+    Discarded discarded;
+    // Разбирается меньшее дерево, большее режется по его ключам.
+    Piece result =
+        other_smaller
+            ? unite_pieces(own, adopted, !keep_other, discarded,
+                           fork_budget(parallel))
+            : unite_pieces(adopted, own, keep_other, discarded,
+                           fork_budget(parallel));
+    install(result, total - destroy_discarded(discarded));
+  }
+
+  /**
+   * @brief Оставляет в дереве только элементы, ключи которых есть в other.
+   * @param other Дерево, которое только читается.
+   * @param parallel Разрешает выполнять независимые ветви рекурсии в разных
+   * потоках.
+   * @note Только для уникальных ключей. Сравнение ключей не должно бросать
+   * исключений.
+   */
+  void intersect(const Rb_tree &other, bool parallel = false) noexcept {
+    if (&other == this) return;
+    const size_type total = node_count;
+    Discarded discarded;
+    Piece result = intersect_pieces(take_piece(), other.root, other.nil_,
+                                    discarded, fork_budget(parallel));
+    install(result, total - destroy_discarded(discarded));
+  }
+
+  /**
+   * @brief Удаляет из дерева элементы, ключи которых есть в other.
+   * @param other Дерево, которое только читается.
+   * @param parallel Разрешает выполнять независимые ветви рекурсии в разных
+   * потоках.
+   * @note Только для уникальных ключей. Сравнение ключей не должно бросать
+   * исключений.
+   */
+  void subtract(const Rb_tree &other, bool parallel = false) noexcept {
+    if (&other == this) {
+      clear();
+      return;
+    }
+    const size_type total = node_count;
+    Discarded discarded;
+    Piece result = subtract_pieces(take_piece(), other.root, other.nil_,
+                                   discarded, fork_budget(parallel));
+    install(result, total - destroy_discarded(discarded));
+  }
+
+  /**
+   * @brief Оставляет элементы, ключи которых есть ровно в одном из деревьев.
+   * @param other Дерево, ноды которого переносятся в текущее; после вызова
+   * пустое.
+   * @param parallel Разрешает выполнять независимые ветви рекурсии в разных
+   * потоках.
+   * @note Только для уникальных ключей. Ноды other сначала перепривязываются к
+   * концевому узлу текущего дерева за O(m). Сравнение ключей не должно
+   * бросать исключений.
+   * @throw std::bad_alloc до начала перестройки, деревья не меняются.
+   */
+  void symmetric_subtract(Rb_tree &other, bool parallel = false) {
+    if (&other == this) {
+      clear();
+      return;
+    }
+    const size_type total = node_count + other.node_count;
+    const bool other_smaller = other.node_count <= node_count;
+    Piece adopted = adopt_piece(other);
+    Piece own = take_piece();
+    Discarded discarded;
+    Piece result =
+        other_smaller
+            ? symmetric_pieces(own, adopted, discarded, fork_budget(parallel))
+            : symmetric_pieces(adopted, own, discarded, fork_budget(parallel));
+    install(result, total - destroy_discarded(discarded));
+  }
+
+  /**
+   * @brief Обменивает содержимое деревьев за O(1).
+   * @warning Если propagate_on_container_swap ложно, аллокаторы деревьев
+   * должны быть равны.
+   */
+  void swap(Rb_tree &other) noexcept {
+    if (this != &other) {
+      std::swap(root, other.root);
+      std::swap(leftmost_, other.leftmost_);
+      std::swap(rightmost_, other.rightmost_);
+      std::swap(node_count, other.node_count);
+      std::swap(comp, other.comp);
+      if constexpr (node_alloc_traits::propagate_on_container_swap::value) {
+        std::swap(alloc, other.alloc);
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief Спуск от корня к ноде с ключом, эквивалентным key.
+   * @note Ключи нод сравниваются только через Compare по ссылке, без
+   * копирования.
+   */
+  template <typename KT>
+  node_type *find_node(const KT &key) const {
+    node_type *current = root;
+    while (current != nil_) {
+      if (comp(key, kov(current->val))) {
+        current = current->left;
+      } else if (comp(kov(current->val), key)) {
+        current = current->right;
+      } else {
+        break;
+      }
+    }
+    return current;
+  }
+
+  /**
+   * @brief Находит самую левую ноду, ключ которой не меньше key.
+   */
+  template <typename KT>
+  node_type *lower_node(const KT &key) const {
+    node_type *res = nil_;
+    node_type *current = root;
+    // Спускаемся до листа, чтобы среди равных ключей найти самый левый.
+    while (current != nil_) {
+      if (!comp(kov(current->val), key)) {
+        res = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return res;
+  }
+
+  /**
+   * @brief Находит самую левую ноду, ключ которой больше key.
+   */
+  template <typename KT>
+  node_type *upper_node(const KT &key) const {
+    node_type *res = nil_;
+    node_type *current = root;
+    while (current != nil_) {
+      if (comp(key, kov(current->val))) {
+        res = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return res;
+  }
+
+  /**
+   * @brief Считает ноды, ключ которых меньше key (или не больше key, если
+   * inclusive), складывая размеры левых поддеревьев на пути спуска.
+   */
+  template <typename KT>
+  size_type count_before(const KT &key, bool inclusive) const {
+    size_type result = 0;
+    node_type *current = root;
+    while (current != nil_) {
+      const bool goes_left = inclusive ? comp(key, kov(current->val))
+                                       : !comp(kov(current->val), key);
+      if (goes_left) {
+        current = current->left;
+      } else {
+        result += current->left->size + 1;
+        current = current->right;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Добавление новую ноду в дерево.
+   * @param node Добавляемая нода.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @return Пара: добавленная нода и true, либо нода с таким же ключом и
+   * false, если ключи уникальные.
+   */
+  std::pair<node_type *, bool> insert_node(node_type *node,
+                                           bool unique_keys = false) {
+    bool created{true};
+
+    node_type *father = nil_;
+    node_type *current = root;
+
+    // Поиск родителя.
+    while (current != nil_) {
+      father = current;
+
+      // Если только уникльные ключи и ключ уже существует.
+      if (unique_keys == true && !comp(kov(node->val), kov(current->val)) &&
+          !comp(kov(current->val), kov(node->val))) {
+        created = false;
+        break;
+      }
+
+      if (comp(kov(node->val), kov(current->val))) {
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+
+    if (created == true) {
+      link_new_node(father, node);
+
+      if (parent_of(node) != nil_ && color_of(parent_of(node)) == Red &&
+          parent_of(parent_of(node)) != nil_) {
+        insert_fixup(node);
+      }
+    }
+    return {created ? node : father, created};
+  }
+
+  /**
+   * @brief Добавляет готовую ноду, используя подсказку, если она подходит.
+   * @param hint Нода, перед которой ожидается вставка, или nullptr.
+   * @return Пара как у insert_node, node_count не изменяется.
+   */
+  std::pair<node_type *, bool> insert_node_hint(const node_type *hint,
+                                                node_type *node,
+                                                bool unique_keys) {
+    Insert_position pos;
+    if (hint != nullptr) pos = hint_position(hint, kov(node->val), unique_keys);
+
+    if (pos.existing != nullptr) return {pos.existing, false};
+    if (pos.father == nullptr) return insert_node(node, unique_keys);
+
+    link_at(pos.father, node, pos.insert_left);
+    if (parent_of(node) != nil_ && color_of(parent_of(node)) == Red &&
+        parent_of(parent_of(node)) != nil_) {
+      insert_fixup(node);
+    }
+    return {node, true};
+  }
+
+  /**
+   * @brief Выполняет post_order обход с применением переданной функции.
+   * @param subtree_root Указатель на корень дерева.
+   * @param nil Указатель на концевой узел дерева.
+   * @param action Функция.
+   */
+  template <typename Action>
+  void post_order_process(node_type *subtree_root, node_type *nil,
+                          Action action) noexcept {
+    if (subtree_root == nil) return;
+
+    node_type *current = subtree_root;
+    while (current != nil) {
+      if (current->left != nil) {
+        // Идём влево
+        current = current->left;
+      } else if (current->right != nil) {
+        // Идём вправо
+        current = current->right;
+      } else {
+        // Лист - обрабатываем
+        node_type *parent = parent_of(current);
+
+        // Отсоединяем от родителя (если он есть)
+        if (parent != nil) {
+          if (current == parent->left) {
+            parent->left = nil;
+          } else {
+            parent->right = nil;
+          }
+        }
+
+        node_type *to_process = current;
+        current = parent;  // Возвращаемся на уровень выше
+
+        set_color(to_process, Red);
+        action(to_process);  // Применяем действие к узлу
+      }
+    }
+  }
+
+  /**
+   * @brief Копирует поддерево с корнем source, выделяя ноды аллокатором a.
+   * @tparam NodePtr Указатель на константную ноду для копирования значений
+   * или на неконстантную для их перемещения.
+   * @return Корень копии, родитель которого nil_.
+   * @note При исключении созданные ноды освобождаются.
+   */
+  template <typename NodePtr>
+  node_type *copy_subtree(NodePtr source, const node_type *source_nil,
+                          node_allocator &a) {
+    node_type *copy_root = copy_node(source, a);
+    try {
+      // Стек для эмуляции рекурсии: храним пары <оригинальный узел, копия>
+      std::stack<std::pair<NodePtr, node_type *>> stack;
+      stack.push({source, copy_root});
+      while (!stack.empty()) {
+        auto [orig_node, copy] = stack.top();
+        stack.pop();
+        // Копируем правое поддерево (кладём в стек первым, чтобы обработать
+        // левое раньше)
+        if (orig_node->right != source_nil) {
+          copy->right = copy_node(NodePtr(orig_node->right), a);
+          set_parent(copy->right, copy);
+          stack.push({orig_node->right, copy->right});
+        }
+        // Копируем левое поддерево
+        if (orig_node->left != source_nil) {
+          copy->left = copy_node(NodePtr(orig_node->left), a);
+          set_parent(copy->left, copy);
+          stack.push({orig_node->left, copy->left});
+        }
+      }
+    } catch (...) {
+      destroy_subtree(copy_root, nil_);
+      throw;
+    }
+    return copy_root;
+  }
+
+  /**
+   * @brief Создает копию ноды source без потомков.
+   */
+  template <typename NodePtr>
+  node_type *copy_node(NodePtr source, node_allocator &a) {
+    node_type *copy = create_node_with(a, source_value(source));
+    set_color(copy, color_of(source));
+    copy_size(copy, source);
+    set_parent(copy, nil_);
+    copy->left = copy->right = nil_;
+    return copy;
+  }
+
+  /**
+   * @brief Поддерево, которое копирует один из потоков.
+   */
+  struct Copy_task {
+    const node_type *source;
+    node_type *parent;  // Нода копии, к которой присоединяется результат.
+    bool left;
+    node_type *copy{nullptr};
+    std::exception_ptr error;
+  };
+
+  /**
+   * @brief Копирует дерево с корнем other_root в пустое дерево: верхние
+   * уровни в текущем потоке, поддеревья под ними в threads потоках.
+   * @note Каждый поток выделяет ноды своей копией аллокатора, поэтому
+   * аллокатор должен иметь is_always_equal. Если поток создать не удалось,
+   * его поддеревья копируют остальные.
+   * @throw Первое исключение потоков. Скопированные поддеревья остаются
+   * присоединенными к дереву, чтобы вызывающий мог его очистить.
+   */
+  void parallel_copy_tree(const node_type *other_root, unsigned threads) {
+    const int levels = std::bit_width(threads) + kCopyTasksPerThreadLog;
+    std::vector<Copy_task> tasks;
+    tasks.reserve(size_type{1} << levels);
+    root = copy_top(other_root, levels, tasks);
+
+    std::atomic<size_type> next{0};
+    std::atomic<bool> failed{false};
+    auto work = [this, &tasks, &next, &failed] {
+      node_allocator local(alloc);
+      while (!failed.load(std::memory_order_relaxed)) {
+        const size_type i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= tasks.size()) break;
+        try {
+          tasks[i].copy = copy_subtree(tasks[i].source, nil_, local);
+        } catch (...) {
+          tasks[i].error = std::current_exception();
+          failed.store(true, std::memory_order_relaxed);
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+    try {
+      workers.reserve(threads - 1);
+      for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work);
+    } catch (...) {
+      // Потоков меньше, чем просили, их задачи достанутся остальным.
+    }
+    work();
+    for (std::thread &worker : workers) worker.join();
+
+    std::exception_ptr error;
+    for (Copy_task &task : tasks) {
+      if (task.copy != nullptr) {
+        (task.left ? task.parent->left : task.parent->right) = task.copy;
+        set_parent(task.copy, task.parent);
+      }
+      if (task.error && !error) error = task.error;
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+  /**
+   * @brief Копирует верхние levels уровней поддерева source, а поддеревья под
+   * ними добавляет в tasks.
+   * @note tasks должен вмещать 2^levels задач без перевыделения.
+   */
+  node_type *copy_top(const node_type *source, int levels,
+                      std::vector<Copy_task> &tasks) {
+    node_type *copy = copy_node(source, alloc);
+    try {
+      for (const bool left : {true, false}) {
+        const node_type *child = left ? source->left : source->right;
+        if (child == nil_) continue;
+        if (levels == 1) {
+          tasks.push_back({child, copy, left, nullptr, nullptr});
+        } else {
+          node_type *child_copy = copy_top(child, levels - 1, tasks);
+          (left ? copy->left : copy->right) = child_copy;
+          set_parent(child_copy, copy);
+        }
+      }
+    } catch (...) {
+      destroy_subtree(copy, nil_);
+      throw;
+    }
+    return copy;
+  }
+
+  /**
+   * @brief Количество потоков для копирования other: не больше одного на
+   * kParallelCopyGrain нод и 1, если аллокатор не позволяет параллельное
+   * копирование.
+   * @param threads Запрошенное количество потоков, 0 — по числу ядер.
+   */
+  static unsigned copy_threads(const Rb_tree &other,
+                               unsigned threads) noexcept {
+    if constexpr (!parallel_copy) {
+      return 1;
+    } else {
+      if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      const size_type limit =
+          std::max<size_type>(other.node_count / kParallelCopyGrain, 1);
+      return static_cast<unsigned>(std::min<size_type>(threads, limit));
+    }
+  }
+
+  static const value_type &source_value(const node_type *node) noexcept {
+    return node->val;
+  }
+  static value_type &&source_value(node_type *node) noexcept {
+    return std::move(node->val);
+  }
+
+  /**
+   * @brief Копирует other с аллокатором a.
+   * @param threads Количество потоков копирования, больше 1 только если
+   * аллокатор позволяет параллельное копирование.
+   */
+  Rb_tree(const Rb_tree &other, const node_allocator &a, unsigned threads = 1)
+      : root(nil_),
+        leftmost_(nil_),
+        rightmost_(nil_),
+        node_count{},
+        kov{other.kov},
+        comp{other.comp},
+        alloc{a} {
+    try {
+      if (threads > 1) {
+        parallel_copy_tree(other.get_root(), threads);
+      } else if (other.get_root() != other.get_nil()) {
+        root = copy_subtree(other.get_root(), other.get_nil(), alloc);
+      }
+      node_count = other.node_count;
+      reset_extremes();
+
+    } catch (...) {
+      if (root != nil_) clear();
+      throw;
+    }
+  }
+
+  /**
+   * @brief Забирает ноды other за O(1), аллокаторы должны быть равны.
+   */
+  void steal_nodes(Rb_tree &other) noexcept {
+    root = std::exchange(other.root, nil_);
+    leftmost_ = std::exchange(other.leftmost_, nil_);
+    rightmost_ = std::exchange(other.rightmost_, nil_);
+    node_count = std::exchange(other.node_count, 0);
+  }
+
+  /**
+   * @brief Перемещает значения other в ноды, выделенные своим аллокатором,
+   * и очищает other. Дерево должно быть пустым.
+   */
+  void move_nodes(Rb_tree &other) {
+    if (other.root != nil_) {
+      try {
+        root = copy_subtree(other.root, nil_, alloc);
+      } catch (...) {
+        if (root != nil_) clear();
+        throw;
+      }
+      node_count = other.node_count;
+      reset_extremes();
+      other.clear();
+    }
+  }
+
+  /**
+   * @brief Ноды, выделенные аллокатором other, можно освобождать аллокатором
+   * текущего дерева.
+   */
+  bool same_allocator(const Rb_tree &other) const noexcept {
+    if constexpr (node_alloc_traits::is_always_equal::value) {
+      return true;
+    } else {
+      return alloc == other.alloc;
+    }
+  }
+
+  /**
+   * @brief Возвращает ноды дерева в порядке возрастания ключей.
+   * @note Обход со стеком вместо successor не поднимается повторно по
+   * родителям, что в разы быстрее на больших деревьях.
+   */
+  std::vector<node_type *> collect_nodes() {
+    std::vector<node_type *> nodes;
+    nodes.reserve(node_count);
+    std::vector<node_type *> path;
+    node_type *node = root;
+    while (node != nil_ || !path.empty()) {
+      while (node != nil_) {
+        path.push_back(node);
+        node = node->left;
+      }
+      node = path.back();
+      path.pop_back();
+      nodes.push_back(node);
+      node = node->right;
+    }
+    return nodes;
+  }
+
+  /**
+   * @brief Пересобирает дерево из упорядоченного массива нод.
+   */
+  void relink_sorted(const std::vector<node_type *> &nodes) noexcept {
+    root = link_sorted(nodes.data(), nodes.size(), nil_, 0,
+                       red_level(nodes.size()));
+    node_count = nodes.size();
+    reset_extremes();
+  }
+
+  /**
+   * @brief Слияние за O(n + m): упорядоченные последовательности нод обоих
+   * деревьев сливаются, после чего оба дерева пересобираются.
+   * @note При равных ключах ноды текущего дерева идут первыми.
+   */
+  void merge_linear(Rb_tree *other, bool unique_keys) {
+    std::vector<node_type *> mine = collect_nodes();
+    std::vector<node_type *> theirs = other->collect_nodes();
+    std::vector<node_type *> merged;
+    std::vector<node_type *> rejected;
+    // Позиции в merged, занятые нодами other, если их нельзя перенести.
+    std::vector<size_type> foreign;
+    const bool adopt = same_allocator(*other);
+    merged.reserve(mine.size() + theirs.size());
+
+    auto next_mine = mine.begin();
+    for (node_type *node : theirs) {
+      while (next_mine != mine.end() &&
+             !comp(kov(node->val), kov((*next_mine)->val))) {
+        merged.push_back(*next_mine++);
+      }
+      if (unique_keys && !merged.empty() &&
+          !comp(kov(merged.back()->val), kov(node->val))) {
+        rejected.push_back(node);
+        continue;
+      }
+      if (!adopt) foreign.push_back(merged.size());
+      merged.push_back(node);
+    }
+    merged.insert(merged.end(), next_mine, mine.end());
+
+    if (!adopt) replace_foreign_nodes(other, merged, foreign);
+
+    relink_sorted(merged);
+    other->relink_sorted(rejected);
+  }
+
+  /**
+   * @brief Заменяет ноды other в merged на новые ноды текущего дерева с
+   * перемещенными значениями, старые ноды уничтожаются.
+   * @throw При исключении новые ноды уничтожаются, ноды other не меняются.
+   */
+  void replace_foreign_nodes(Rb_tree *other, std::vector<node_type *> &merged,
+                             const std::vector<size_type> &foreign) {
+    // Память выделяется заранее, чтобы значения перемещались только тогда,
+    // когда место под все ноды уже есть.
+    std::vector<node_type *> created;
+    created.reserve(foreign.size());
+    size_type constructed = 0;
+    try {
+      for (size_type i = 0; i < foreign.size(); ++i) {
+        created.push_back(node_alloc_traits::allocate(alloc, 1));
+      }
+      for (; constructed < foreign.size(); ++constructed) {
+        node_alloc_traits::construct(
+            alloc, created[constructed], std::in_place,
+            std::move_if_noexcept(merged[foreign[constructed]]->val));
+      }
+    } catch (...) {
+      for (size_type i = 0; i < created.size(); ++i) {
+        if (i < constructed) node_alloc_traits::destroy(alloc, created[i]);
+        node_alloc_traits::deallocate(alloc, created[i], 1);
+      }
+      throw;
+    }
+
+    for (size_type i = 0; i < foreign.size(); ++i) {
+      other->destroy_node(merged[foreign[i]]);
+      merged[foreign[i]] = created[i];
+    }
+  }
+
+  /**
+   * @brief Вставляет ноды other по одной, ноды переносятся без перевыделения.
+   */
+  void merge_by_nodes(Rb_tree *other, bool unique_keys) noexcept {
+    node_type *old_root = other->root;
+    other->root = other->leftmost_ = other->rightmost_ = other->nil_;
+    other->node_count = 0;
+
+    post_order_process(old_root, other->nil_,
+                       [this, &other, unique_keys](node_type *node) {
+                         if (this->insert_node(node, unique_keys).second) {
+                           ++(this->node_count);
+
+                         } else {
+                           other->insert_node(node, unique_keys);
+                           ++(other->node_count);
+                         }
+                       });
+  }
+
+  /**
+   * @brief Перемещает значения other в новые ноды текущего дерева по одному.
+   * @throw При исключении ещё не перенесенные значения остаются в other.
+   */
+  void merge_by_values(Rb_tree *other, bool unique_keys) {
+    node_type *node = other->leftmost_;
+    while (node != other->nil_) {
+      node_type *next = other->successor(node);
+      if (emplace_with_key(kov(node->val), unique_keys,
+                           std::move_if_noexcept(node->val))
+              .second) {
+        other->delete_node(node);
+      }
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Отсоединенное поддерево: корень черный или nil_, его p равен nil_.
+   * @note black_height — число черных нод на пути от корня к листу без учета
+   * nil_.
+   */
+  struct Piece {
+    node_type *root;
+    int black_height;
+  };
+
+  /**
+   * @brief Результат разрезания поддерева по ключу: меньшие ключи, нода с
+   * равным ключом (или nullptr) и большие ключи.
+   */
+  struct Split {
+    Piece left;
+    node_type *node;
+    Piece right;
+  };
+
+  /**
+   * @brief Список отброшенных поддеревьев, связанных через указатель p их
+   * корней. Не выделяет память, поэтому перестройку нельзя прервать нехваткой
+   * памяти.
+   */
+  struct Discarded {
+    node_type *head{nullptr};
+    node_type *tail{nullptr};
+
+    void push(node_type *subtree) noexcept {
+      set_parent(subtree, head);
+      head = subtree;
+      if (tail == nullptr) tail = subtree;
+    }
+
+    void append(const Discarded &other) noexcept {
+      if (other.head == nullptr) return;
+      set_parent(other.tail, head);
+      head = other.head;
+      if (tail == nullptr) tail = other.tail;
+    }
+  };
+
+  // Ветви рекурсии с меньшей черной высотой (меньше ~1000 нод) выполняются в
+  // текущем потоке.
+  static constexpr int kParallelHeight = 10;
+
+  // Минимальное количество нод на поток при параллельном копировании.
+  static constexpr size_type kParallelCopyGrain = size_type{1} << 15;
+  // Поддеревьев для параллельного копирования в 2^kCopyTasksPerThreadLog раз
+  // больше, чем потоков, чтобы уравнять нагрузку при разной высоте ветвей.
+  static constexpr int kCopyTasksPerThreadLog = 2;
+
+  /**
+   * @brief Количество уровней рекурсии, на которых разрешено порождать потоки.
+   */
+  static int fork_budget(bool parallel) noexcept {
+    if (!parallel) return 0;
+    return std::bit_width(std::max(1u, std::thread::hardware_concurrency()));
+  }
+
+  /**
+   * @brief Черная высота поддерева, считается по левому краю.
+   */
+  int black_height(const node_type *node) const noexcept {
+    int height = 0;
+    for (; node != nil_; node = node->left) {
+      if (color_of(node) == Black) ++height;
+    }
+    return height;
+  }
+
+  /**
+   * @brief Отсоединяет всё дерево как кусок, оставляя дерево пустым.
+   */
+  Piece take_piece() noexcept {
+    Piece piece{root, black_height(root)};
+    root = leftmost_ = rightmost_ = nil_;
+    node_count = 0;
+    return piece;
+  }
+
+  /**
+   * @brief Делает кусок содержимым дерева.
+   */
+  void install(Piece piece, size_type count) noexcept {
+    root = piece.root;
+    node_count = count;
+    reset_extremes();
+  }
+
+  /**
+   * @brief Переносит все ноды other в кусок; other остается пустым.
+   * @note Ноды переходят за O(log m). Если аллокаторы не равны, значения
+   * перемещаются в новые ноды текущего дерева за O(m).
+   * @throw std::bad_alloc, other при этом не меняется.
+   */
+  Piece adopt_piece(Rb_tree &other) {
+    if (other.root == other.nil_) return {nil_, 0};
+
+    Piece piece;
+    if (same_allocator(other)) {
+      // Концевая нода у деревьев общая, ноды переходят без изменений.
+      piece = {other.root, other.black_height(other.root)};
+    } else {
+      std::vector<node_type *> nodes = other.collect_nodes();
+      std::vector<size_type> all(nodes.size());
+      for (size_type i = 0; i < all.size(); ++i) all[i] = i;
+      replace_foreign_nodes(&other, nodes, all);
+      node_type *top = link_sorted(nodes.data(), nodes.size(), nil_, 0,
+                                   red_level(nodes.size()));
+      piece = {top, black_height(top)};
+    }
+
+    other.root = other.leftmost_ = other.rightmost_ = other.nil_;
+    other.node_count = 0;
+    return piece;
+  }
+
+  /**
+   * @brief Уничтожает отброшенные поддеревья.
+   * @return Количество уничтоженных нод.
+   */
+  size_type destroy_discarded(const Discarded &discarded) noexcept {
+    size_type count = 0;
+    node_type *subtree = discarded.head;
+    while (subtree != nullptr) {
+      node_type *next = parent_of(subtree);
+      set_parent(subtree, nil_);
+      post_order_process(subtree, nil_, [this, &count](node_type *node) {
+        destroy_node(node);
+        ++count;
+      });
+      subtree = next;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Отбрасывает одиночную ноду.
+   */
+  void discard_node(node_type *node, Discarded &discarded) noexcept {
+    node->left = node->right = nil_;
+    discarded.push(node);
+  }
+
+  /**
+   * @brief Отсоединяет поддерево от родителя, красный корень перекрашивается.
+   * @param black_height Черная высота поддерева с учетом цвета корня.
+   */
+  Piece make_piece(node_type *node, int black_height) noexcept {
+    if (node == nil_) return {nil_, 0};
+    set_parent(node, nil_);
+    if (color_of(node) == Red) {
+      set_color(node, Black);
+      ++black_height;
+    }
+    return {node, black_height};
+  }
+
+  /**
+   * @brief Разбирает непустой кусок на левое поддерево, корень и правое
+   * поддерево.
+   */
+  Split expose(Piece piece) noexcept {
+    node_type *node = piece.root;
+    // Корень куска черный, поэтому черная высота детей на единицу меньше.
+    return {make_piece(node->left, piece.black_height - 1), node,
+            make_piece(node->right, piece.black_height - 1)};
+  }
+
+  /**
+   * @brief Соединяет куски и ноду pivot, ключ которой больше ключей left и
+   * меньше ключей right, за O(|bh(left) - bh(right)| + 1).
+   */
+  Piece join(Piece left, node_type *pivot, Piece right) noexcept {
+    set_color(pivot, Red);
+    if (left.black_height >= right.black_height) {
+      // Спуск по правому краю left до черной ноды с черной высотой right.
+      node_type *parent = nil_;
+      node_type *child = left.root;
+      int height = left.black_height;
+      while (height > right.black_height || color_of(child) == Red) {
+        if (color_of(child) == Black) --height;
+        parent = child;
+        child = child->right;
+      }
+      link_pivot(pivot, child, right.root, parent);
+      if (parent == nil_) return make_piece(pivot, left.black_height);
+      parent->right = pivot;
+      add_size_upwards(parent, subtree_size(right.root) + 1);
+      return fix_join(pivot, left);
+    }
+
+    node_type *parent = nil_;
+    node_type *child = right.root;
+    int height = right.black_height;
+    while (height > left.black_height || color_of(child) == Red) {
+      if (color_of(child) == Black) --height;
+      parent = child;
+      child = child->left;
+    }
+    link_pivot(pivot, left.root, child, parent);
+    parent->left = pivot;
+    add_size_upwards(parent, subtree_size(left.root) + 1);
+    return fix_join(pivot, right);
+  }
+
+  /**
+   * @brief Делает left и right потомками pivot, а parent — его родителем.
+   */
+  void link_pivot(node_type *pivot, node_type *left, node_type *right,
+                  node_type *parent) noexcept {
+    pivot->left = left;
+    pivot->right = right;
+    set_parent(pivot, parent);
+    if (left != nil_) set_parent(left, pivot);
+    if (right != nil_) set_parent(right, pivot);
+    update_size(pivot);
+  }
+
+  /**
+   * @brief Восстанавливает свойства куска после вставки красной ноды pivot.
+   */
+  Piece fix_join(node_type *pivot, Piece piece) noexcept {
+    fix_double_red(pivot, piece.root);
+    if (color_of(piece.root) == Red) {
+      set_color(piece.root, Black);
+      ++piece.black_height;
+    }
+    return piece;
+  }
+
+  /**
+   * @brief Соединяет куски, все ключи left меньше ключей right.
+   */
+  Piece join2(Piece left, Piece right) noexcept {
+    if (right.root == nil_) return left;
+    if (left.root == nil_) return right;
+    auto [rest, last] = split_last(left);
+    return join(rest, last, right);
+  }
+
+  /**
+   * @brief Отделяет от непустого куска ноду с максимальным ключом.
+   */
+  std::pair<Piece, node_type *> split_last(Piece piece) noexcept {
+    Split parts = expose(piece);
+    if (parts.right.root == nil_) return {parts.left, parts.node};
+    auto [rest, last] = split_last(parts.right);
+    return {join(parts.left, parts.node, rest), last};
   }
 
   /**
-   * @brief Находит ноду с указаным ключём.
-   * @param key Ссылка на ключ.
-   * @return Указатель на найденую ноду, если такого ключа нет будет возвращена
-   * концевая нода nil_.
+   * @brief Разрезает кусок по ключу за O(log n).
    */
-  node_type *search(const K &key) {
-    node_type *res = root;
-    K node_key = kov(res->val);
-    while (res != nil_ && key != node_key) {
-      if (comp(key, node_key)) {
-        res = res->left;
-      } else {
-        res = res->right;
-      }
-      node_key = kov(res->val);
+  template <typename KT>
+  Split split_piece(Piece piece, const KT &key) noexcept {
+    if (piece.root == nil_) return {piece, nullptr, piece};
+
+    Split parts = expose(piece);
+    if (comp(key, kov(parts.node->val))) {
+      Split result = split_piece(parts.left, key);
+      result.right = join(result.right, parts.node, parts.right);
+      return result;
     }
-    return res;
+    if (comp(kov(parts.node->val), key)) {
+      Split result = split_piece(parts.right, key);
+      result.left = join(parts.left, parts.node, result.left);
+      return result;
+    }
+    return parts;
   }
 
   /**
-   *  @brief Находит начало подпоследовательности, соответствующей заданному
-   * ключу.
-   *  @param key - ключ для поиска элементов.
-   *  @return Нода элемента, значение которой равно или больший, чем
-   * ключ или end().
+   * @brief Выполняет две независимые задачи, при разрешении — параллельно.
+   * @param forks Оставшееся количество уровней, на которых можно порождать
+   * потоки.
+   * @param large Задачи достаточно велики, чтобы окупить поток.
+   * @note Задачи получают собственный список отброшенных поддеревьев, чтобы
+   * потоки не писали в общий.
    */
-  node_type *lower_bound(const K &key) noexcept {
-    node_type *res = root;
-    node_type *prev = root;
-    K node_key = kov(res->val);
-    while (res != nil_ && key != node_key) {
-      if (comp(key, node_key)) {
-        prev = res;
-        res = res->left;
-      } else {
-        prev = res;
-        res = res->right;
+  template <typename LeftTask, typename RightTask>
+  std::pair<Piece, Piece> fork_join(int forks, bool large,
+                                    LeftTask left_task, RightTask right_task,
+                                    Discarded &discarded) noexcept {
+    if (forks > 0 && large) {
+      Discarded left_discarded;
+      std::future<Piece> left;
+      try {
+        left = std::async(std::launch::async, [&left_task, &left_discarded] {
+          return left_task(left_discarded);
+        });
+      } catch (...) {
+        // Поток создать не удалось, выполняем последовательно.
+      }
+      if (left.valid()) {
+        Piece right = right_task(discarded);
+        Piece result = left.get();
+        discarded.append(left_discarded);
+        return {result, right};
       }
-      node_key = kov(res->val);
     }
-    if (res == nil_ && comp(key, kov(prev->val))) res = prev;
-    return res;
+    Piece left = left_task(discarded);
+    return {left, right_task(discarded)};
   }
 
   /**
-   * @brief Добавляет ноды из other в текущее дерево, елси добавление не удалось
-   * нода остается в other.
-   * @param other Указатель на дерево для слияния.
-   * @param unique_keys Опредеяет будут ли ключи уникалными.
+   * @brief Оба куска достаточно велики для отдельного потока.
    */
-  void merge(Rb_tree *other, bool unique_keys) noexcept {
-    node_type *old_root = other->root;
-    old_root->p = other->nil_;
-    other->nil_->p = other->nil_;
-    other->root = other->nil_;
-    other->node_count = 0;
-
-    if (old_root == other->nil_) return;
+  static bool is_large(Piece left, Piece right) noexcept {
+    return left.black_height >= kParallelHeight &&
+           right.black_height >= kParallelHeight;
+  }
 
-    post_order_process(old_root, other->nil_,
-                       [this, &other, unique_keys](node_type *node) {
-                         if (this->insert_node(node, unique_keys) == true) {
-                           ++(this->node_count);
+  /**
+   * @brief Объединение кусков одного дерева.
+   * @param keep_first Из двух равных элементов оставить элемент first.
+   */
+  Piece unite_pieces(Piece first, Piece second, bool keep_first,
+                     Discarded &discarded, int forks) noexcept {
+    if (first.root == nil_) return second;
+    if (second.root == nil_) return first;
+
+    Split by = expose(second);
+    Split parts = split_piece(first, kov(by.node->val));
+    node_type *pivot = by.node;
+    if (parts.node != nullptr) {
+      if (keep_first) std::swap(pivot, parts.node);
+      discard_node(parts.node, discarded);
+    }
 
-                         } else {
-                           other->insert_node(node, unique_keys);
-                           ++(other->node_count);
-                         }
-                       });
+    auto [left, right] = fork_join(
+        forks, is_large(parts.left, parts.right),
+        [&](Discarded &out) {
+          return unite_pieces(parts.left, by.left, keep_first, out, forks - 1);
+        },
+        [&](Discarded &out) {
+          return unite_pieces(parts.right, by.right, keep_first, out,
+                              forks - 1);
+        },
+        discarded);
+    return join(left, pivot, right);
   }
 
-  void swap(Rb_tree &other) noexcept {
-    if (this != &other) {
-      std::swap(root, other.root);
-      std::swap(nil_, other.nil_);
-      std::swap(node_count, other.node_count);
-      std::swap(comp, other.comp);
-      std::swap(alloc, other.alloc);
+  /**
+   * @brief Пересечение куска с поддеревом другого дерева.
+   * @param node Корень поддерева другого дерева, которое только читается.
+   * @param other_nil Концевой узел другого дерева.
+   */
+  Piece intersect_pieces(Piece piece, const node_type *node,
+                         const node_type *other_nil, Discarded &discarded,
+                         int forks) noexcept {
+    if (piece.root == nil_) return piece;
+    if (node == other_nil) {
+      discarded.push(piece.root);
+      return {nil_, 0};
     }
+
+    Split parts = split_piece(piece, kov(node->val));
+    auto [left, right] = fork_join(
+        forks, is_large(parts.left, parts.right),
+        [&](Discarded &out) {
+          return intersect_pieces(parts.left, node->left, other_nil, out,
+                                  forks - 1);
+        },
+        [&](Discarded &out) {
+          return intersect_pieces(parts.right, node->right, other_nil, out,
+                                  forks - 1);
+        },
+        discarded);
+    if (parts.node != nullptr) return join(left, parts.node, right);
+    return join2(left, right);
   }
 
- private:
   /**
-   * @brief Добавление новую ноду в дерево.
-   * @param node Добавляемая нода.
-   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
-   * @return Если нода добавлена в дерево true, иначе false
+   * @brief Разность куска и поддерева другого дерева.
+   * @param node Корень поддерева другого дерева, которое только читается.
+   * @param other_nil Концевой узел другого дерева.
    */
-  bool insert_node(node_type *node, bool unique_keys = false) {
-    bool created{true};
+  Piece subtract_pieces(Piece piece, const node_type *node,
+                        const node_type *other_nil, Discarded &discarded,
+                        int forks) noexcept {
+    if (piece.root == nil_ || node == other_nil) return piece;
+
+    Split parts = split_piece(piece, kov(node->val));
+    auto [left, right] = fork_join(
+        forks, is_large(parts.left, parts.right),
+        [&](Discarded &out) {
+          return subtract_pieces(parts.left, node->left, other_nil, out,
+                                 forks - 1);
+        },
+        [&](Discarded &out) {
+          return subtract_pieces(parts.right, node->right, other_nil, out,
+                                 forks - 1);
+        },
+        discarded);
+    if (parts.node != nullptr) discard_node(parts.node, discarded);
+    return join2(left, right);
+  }
 
-    node_type *father = nil_;
-    node_type *current = root;
+  /**
+   * @brief Симметрическая разность кусков одного дерева.
+   */
+  Piece symmetric_pieces(Piece first, Piece second, Discarded &discarded,
+                         int forks) noexcept {
+    if (first.root == nil_) return second;
+    if (second.root == nil_) return first;
+
+    Split by = expose(second);
+    Split parts = split_piece(first, kov(by.node->val));
+    auto [left, right] = fork_join(
+        forks, is_large(parts.left, parts.right),
+        [&](Discarded &out) {
+          return symmetric_pieces(parts.left, by.left, out, forks - 1);
+        },
+        [&](Discarded &out) {
+          return symmetric_pieces(parts.right, by.right, out, forks - 1);
+        },
+        discarded);
+    if (parts.node == nullptr) return join(left, by.node, right);
+    discard_node(parts.node, discarded);
+    discard_node(by.node, discarded);
+    return join2(left, right);
+  }
 
-    // Поиск родителя.
-    while (current != nil_) {
-      father = current;
+  /**
+   * @brief Создает ноды для упорядоченного диапазона и собирает из них
+   * сбалансированное дерево, заменяя текущее содержимое.
+   * @param get Функтор получения значения по разыменованному итератору.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   */
+  template <typename It, typename Get>
+  void build_from_sorted(It first, It last, Get get, bool unique_keys) {
+    std::vector<node_type *> nodes;
+    if constexpr (std::forward_iterator<It>) {
+      nodes.reserve(std::distance(first, last));
+    }
 
-      // Если только уникльные ключи и ключ уже существует.
-      if (unique_keys == true && !comp(kov(node->val), kov(current->val)) &&
-          !comp(kov(current->val), kov(node->val))) {
-        created = false;
-        break;
+    auto append = [this, &nodes, unique_keys](const auto &value) {
+      // В упорядоченном диапазоне дубликат может быть только соседним.
+      if (unique_keys && !nodes.empty() &&
+          !comp(kov(nodes.back()->val), kov(value))) {
+        return;
       }
+      nodes.push_back(nullptr);
+      nodes.back() = create_node(value);
+    };
 
-      if (comp(kov(node->val), kov(current->val))) {
-        current = current->left;
-      } else {
-        current = current->right;
+    try {
+      for (; first != last; ++first) append(get(*first));
+    } catch (...) {
+      for (node_type *node : nodes) {
+        if (node != nullptr) destroy_node(node);
       }
+      throw;
     }
 
-    if (created == true) {
-      link_new_node(father, node);
-
-      if (node->p != nil_ && node->p->color == Red && node->p->p != nil_) {
-        insert_fixup(node);
-      }
-    }
-    return created;
+    // Новые ноды уже выделены, поэтому старые нельзя освобождать разом.
+    destroy_all();
+    relink_sorted(nodes);
   }
 
   /**
-   * @brief Выполняет post_order обход с применением переданной функции.
-   * @param subtree_root Указатель на корень дерева.
-   * @param nil Указатель на концевой узел дерева.
-   * @param action Функция.
+   * @brief Связывает упорядоченный массив нод в сбалансированное дерево.
+   * @param nodes Указатель на первую ноду.
+   * @param count Количество нод.
+   * @param parent Родитель корня собираемого поддерева.
+   * @param depth Глубина корня собираемого поддерева.
+   * @param red_depth Глубина, ноды на которой красятся в красный.
+   * @return Корень поддерева или nil_.
+   * @note Все уровни кроме последнего заполнены полностью, поэтому покраска
+   * только последнего неполного уровня в красный сохраняет черную высоту.
    */
-  template <typename Action>
-  void post_order_process(node_type *subtree_root, node_type *nil,
-                          Action action) noexcept {
-    if (subtree_root == nil) return;
-
-    node_type *current = subtree_root;
-    while (current != nil) {
-      if (current->left != nil) {
-        // Идём влево
-        current = current->left;
-      } else if (current->right != nil) {
-        // Идём вправо
-        current = current->right;
-      } else {
-        // Лист - обрабатываем
-        node_type *parent = current->p;
-
-        // Отсоединяем от родителя (если он есть)
-        if (parent != nil) {
-          if (current == parent->left) {
-            parent->left = nil;
-          } else {
-            parent->right = nil;
-          }
-        }
-
-        node_type *to_process = current;
-        current = parent;  // Возвращаемся на уровень выше
+  node_type *link_sorted(node_type *const *nodes, size_type count,
+                         node_type *parent, size_type depth,
+                         size_type red_depth) noexcept {
+    if (count == 0) return nil_;
+
+    const size_type mid = count / 2;
+    node_type *node = nodes[mid];
+    set_parent(node, parent);
+    set_color(node, depth == red_depth ? Red : Black);
+    node->left = link_sorted(nodes, mid, node, depth + 1, red_depth);
+    node->right = link_sorted(nodes + mid + 1, count - mid - 1, node,
+                              depth + 1, red_depth);
+    update_size(node);
+    return node;
+  }
 
-        to_process->color = Red;
-        action(to_process);  // Применяем действие к узлу
-      }
+  /**
+   * @brief Вычисляет глубину последнего неполного уровня сбалансированного
+   * дерева из count нод.
+   * @note Для полного дерева возвращает глубину, на которой нод нет.
+   */
+  static size_type red_level(size_type count) noexcept {
+    size_type level = 0;
+    for (auto m = static_cast<std::ptrdiff_t>(count) - 1; m >= 0;
+         m = m / 2 - 1) {
+      ++level;
     }
+    return level;
   }
 
   /**
-   * @brief Создает копию дерева.
-   * @return Указатель на корень нового дерева.
+   * @brief Освобождает все ноды дерева разом, не обходя его.
+   * @return false, если ноды нужно удалять по одной.
+   * @note Возможно только для тривиально уничтожаемых значений, когда
+   * аллокатор единолично владеет своими фрагментами (метод release_all(),
+   * как у pool_allocator), или когда ноды лежат в монотонной арене pmr, где
+   * освобождение ничего не делает.
    */
-  void copy_tree(const node_type *other_root, const node_type *other_nil) {
-    if (other_root == other_nil) {
-      root = nil_;
+  bool release_all_nodes() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      return false;
+    } else if constexpr (exclusive_allocator) {
+      alloc.release_all();
+      return true;
+    } else if constexpr (std::is_same_v<
+                             node_allocator,
+                             std::pmr::polymorphic_allocator<node_type>>) {
+      return dynamic_cast<std::pmr::monotonic_buffer_resource *>(
+                 alloc.resource()) != nullptr;
+    } else {
+      return false;
     }
-    // Стек для эмуляции рекурсии: храним пары <оригинальный узел, родитель
-    // копии>
-    std::stack<std::pair<const node_type *, node_type *>> stack;
-    node_type *new_root = create_node(other_root->val);
-    new_root->color = other_root->color;
-    new_root->p = nil_;  // Родитель корня — nil_
-    root = new_root;
-
-    stack.push({other_root, new_root});
+  }
 
-    while (!stack.empty()) {
-      auto [orig_node, copy_node] = stack.top();
-      stack.pop();
-      // Копируем правое поддерево (кладём в стек первым, чтобы обработать левое
-      // раньше)
-      if (orig_node->right != other_nil) {
-        copy_node->right = create_node(orig_node->right->val);
-        copy_node->right->color = orig_node->right->color;
-        copy_node->right->p = copy_node;
-        copy_node->right->right = copy_node->right->left = nil_;
-        stack.push({orig_node->right, copy_node->right});
-      } else {
-        copy_node->right = nil_;
-      }
-      // Копируем левое поддерево
-      if (orig_node->left != other_nil) {
-        copy_node->left = create_node(orig_node->left->val);
-        copy_node->left->color = orig_node->left->color;
-        copy_node->left->p = copy_node;
-        copy_node->left->right = copy_node->left->left = nil_;
-        stack.push({orig_node->left, copy_node->left});
-      } else {
-        copy_node->left = nil_;
-      }
-    }
+  /**
+   * @brief Удаляет ноды дерева по одной, не затрагивая другие ноды,
+   * выделенные тем же аллокатором.
+   */
+  void destroy_all() noexcept {
+    destroy_subtree(root, nil_);
+    root = leftmost_ = rightmost_ = nil_;
+    node_count = 0;
   }
 
   /**
@@ -501,6 +2425,7 @@ class Rb_tree {
    * @param node Указатель на узел для удаления.
    */
   void destroy_node(node_type *node) noexcept {
+    std::destroy_at(std::addressof(node->val));
     node_alloc_traits::destroy(alloc, node);
     node_alloc_traits::deallocate(alloc, node, 1);
   }
@@ -511,37 +2436,238 @@ class Rb_tree {
    * @param new_node Указатель на ноду потомка.
    */
   void link_new_node(node_type *father, node_type *new_node) {
+    // Определяем new_node левый или правый потомок.
+    link_at(father, new_node,
+            father != nil_ && comp(kov(new_node->val), kov(father->val)));
+  }
+
+  /**
+   * @brief Связывает новый узел с родителем с указанной стороны.
+   * @param father Указатель на родительскую ноду.
+   * @param new_node Указатель на ноду потомка.
+   * @param insert_left true если new_node станет левым потомком.
+   * @note Соответствующий потомок father должен быть nil_.
+   */
+  void link_at(node_type *father, node_type *new_node,
+               bool insert_left) noexcept {
     new_node->left = new_node->right = nil_;
+    if constexpr (sized_nodes) new_node->size = 1;
 
     if (father == nil_) {
-      root = new_node;
-      root->p = nil_;
-      root->color = Black;
+      root = leftmost_ = rightmost_ = new_node;
+      set_parent(root, nil_);
+      set_color(root, Black);
     } else {
-      new_node->p = father;
-      // Определяем new_node левый или правый потомок.
-      if (comp(kov(new_node->val), kov(father->val))) {
+      set_parent(new_node, father);
+      if (insert_left) {
         father->left = new_node;
+        if (father == leftmost_) leftmost_ = new_node;
       } else {
         father->right = new_node;
+        if (father == rightmost_) rightmost_ = new_node;
       }
+      add_size_upwards(father, 1);
     }
   }
 
   /**
-   * @brief Создает новую ноду инициализированную переданными занчениями.
-   * @param value Ссылка на значение.
+   * @brief Место вставки, найденное по подсказке.
+   * @note father == nullptr и existing == nullptr означают, что подсказка не
+   * подошла и место нужно искать спуском от корня.
+   */
+  struct Insert_position {
+    node_type *father{nullptr};
+    bool insert_left{false};
+    node_type *existing{nullptr};
+  };
+
+  /**
+   * @brief Проверяет, можно ли вставить ключ непосредственно перед hint.
+   * @param hint_node Нода-подсказка, nil_ означает конец дерева.
+   * @param key Ссылка на вставляемый ключ.
+   * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @return Место вставки либо пустой результат, если ключ не попадает в
+   * окрестность hint.
+   * @note Выполняет не более двух сравнений и один шаг итератора.
+   */
+  template <typename KT>
+  Insert_position hint_position(const node_type *hint_node, const KT &key,
+                                bool unique_keys) {
+    node_type *hint = const_cast<node_type *>(hint_node);
+    // Для уникальных ключей соседи должны быть строго меньше/больше ключа,
+    // для повторяющихся достаточно нестрогого порядка.
+    auto before = [&](const node_type *lhs, const KT &rhs) {
+      return unique_keys ? comp(kov(lhs->val), rhs) : !comp(rhs, kov(lhs->val));
+    };
+    auto after = [&](const KT &lhs, const node_type *rhs) {
+      return unique_keys ? comp(lhs, kov(rhs->val)) : !comp(kov(rhs->val), lhs);
+    };
+
+    if (hint == nil_) {
+      if (node_count > 0 && before(rightmost_, key)) {
+        return {rightmost_, false, nullptr};
+      }
+      return {};
+    }
+
+    if (after(key, hint)) {
+      if (hint == leftmost_) return {hint, true, nullptr};
+      node_type *prev = predecessor(hint);
+      if (!before(prev, key)) return {};
+      // Если у prev есть правый потомок, то hint лежит в нём и не имеет
+      // левого потомка.
+      return prev->right == nil_ ? Insert_position{prev, false, nullptr}
+                                 : Insert_position{hint, true, nullptr};
+    }
+
+    if (before(hint, key)) {
+      if (hint == rightmost_) return {hint, false, nullptr};
+      node_type *next = successor(hint);
+      if (!after(key, next)) return {};
+      return hint->right == nil_ ? Insert_position{hint, false, nullptr}
+                                 : Insert_position{next, true, nullptr};
+    }
+
+    // Ключ равен ключу подсказки (возможно только для уникальных ключей).
+    return {nullptr, false, hint};
+  }
+
+  /**
+   * @brief Возвращает следующую по порядку ноду или nil_.
+   */
+  node_type *successor(node_type *node) noexcept {
+    if (node->right != nil_) return minimum(node->right);
+    node_type *father = parent_of(node);
+    while (father != nil_ && node == father->right) {
+      node = father;
+      father = parent_of(father);
+    }
+    return father;
+  }
+
+  /**
+   * @brief Возвращает предыдущую по порядку ноду или nil_.
+   */
+  node_type *predecessor(node_type *node) noexcept {
+    if (node->left != nil_) return maximum(node->left);
+    node_type *father = parent_of(node);
+    while (father != nil_ && node == father->left) {
+      node = father;
+      father = parent_of(father);
+    }
+    return father;
+  }
+
+  /**
+   * @brief Пересчитывает крайние ноды после перестройки всего дерева.
+   */
+  void reset_extremes() noexcept {
+    leftmost_ = minimum(root);
+    rightmost_ = maximum(root);
+  }
+
+  /**
+   * @brief Возвращает родителя ноды.
+   */
+  static node_type *parent_of(const node_type *node) noexcept {
+    if constexpr (packed_color) {
+      return node->parent();
+    } else {
+      return node->p;
+    }
+  }
+
+  static void set_parent(node_type *node, node_type *parent) noexcept {
+    if constexpr (packed_color) {
+      node->set_parent(parent);
+    } else {
+      node->p = parent;
+    }
+  }
+
+  /**
+   * @brief Возвращает цвет ноды.
+   */
+  static Node_color color_of(const node_type *node) noexcept {
+    if constexpr (packed_color) {
+      return node->color();
+    } else {
+      return node->color;
+    }
+  }
+
+  static void set_color(node_type *node, Node_color color) noexcept {
+    if constexpr (packed_color) {
+      node->set_color(color);
+    } else {
+      node->color = color;
+    }
+  }
+
+  /**
+   * @brief Возвращает размер поддерева node, для nil_ — 0.
+   * @note Для нод без размеров всегда возвращает 0.
+   */
+  size_type subtree_size(const node_type *node) const noexcept {
+    if constexpr (sized_nodes) {
+      return node->size;
+    } else {
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Пересчитывает размер поддерева node по размерам его потомков.
+   */
+  void update_size(node_type *node) const noexcept {
+    if constexpr (sized_nodes) {
+      node->size = node->left->size + node->right->size + 1;
+    }
+  }
+
+  /**
+   * @brief Переносит размер поддерева from на ноду to.
+   */
+  static void copy_size(node_type *to, const node_type *from) noexcept {
+    if constexpr (sized_nodes) to->size = from->size;
+  }
+
+  /**
+   * @brief Прибавляет delta к размерам node и всех его предков.
+   * @note Уменьшение передается как беззнаковое переполнение, например
+   * static_cast<size_type>(-1). nil_ не изменяется.
+   */
+  void add_size_upwards(node_type *node, size_type delta) const noexcept {
+    if constexpr (sized_nodes) {
+      for (; node != nil_; node = parent_of(node)) node->size += delta;
+    }
+  }
+
+  /**
+   * @brief Создает новую ноду, значение которой конструируется из переданных
+   * аргументов.
+   * @param args Аргументы конструктора значения.
    * @return Созданную ноду.
    * @throw std::bad_alloc или исключение брошенное конструктором пердаваемого
    * типа.
    */
-  node_type *create_node(const V &value) {
-    node_type *new_node = node_alloc_traits::allocate(alloc, 1);
+  template <typename... Args>
+  node_type *create_node(Args &&...args) {
+    return create_node_with(alloc, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Создает новую ноду, выделяя память аллокатором a.
+   */
+  template <typename... Args>
+  node_type *create_node_with(node_allocator &a, Args &&...args) {
+    node_type *new_node = node_alloc_traits::allocate(a, 1);
     try {
-      node_alloc_traits::construct(alloc, new_node, value);
+      node_alloc_traits::construct(a, new_node, std::in_place,
+                                   std::forward<Args>(args)...);
       return new_node;
     } catch (...) {
-      node_alloc_traits::deallocate(alloc, new_node, 1);
+      node_alloc_traits::deallocate(a, new_node, 1);
       throw;
     }
   }
@@ -549,15 +2675,16 @@ class Rb_tree {
   /**
    * @brief Создает новую ноду.
    * @param key Ссылка на ключ.
-   * @param value Ссылка на значение.
    * @param created Ссылка на значение определяющее была ли создана нода.
    * @param unique_keys Флаг определяющий будут ли ключи уникльными.
+   * @param args Аргументы конструктора значения.
    * @return Новая нода.
    * @note Если ключи должны быть уникальными при нахождении дубликата будет
    * возвращен дубликат и нода не будет создана.
    */
-  node_type *find_or_create(const K &key, const V &value, bool &created,
-                            bool unique_keys) {
+  template <typename... Args>
+  node_type *find_or_create(const K &key, bool &created, bool unique_keys,
+                            Args &&...args) {
     node_type *father = nil_;
     node_type *current = root;
     created = true;
@@ -581,7 +2708,7 @@ class Rb_tree {
     }
 
     if (created == true) {
-      node_type *new_node = create_node(value);
+      node_type *new_node = create_node(std::forward<Args>(args)...);
       link_new_node(father, new_node);
       current = new_node;
     }
@@ -594,39 +2721,52 @@ class Rb_tree {
    * @param node Указатель на ноду для которой выполняется ребаланс дерева.
    */
   void insert_fixup(node_type *node) noexcept {
-    while (node->p->color == Red) {
-      if (node->p == node->p->p->left) {
-        node = rebalance_left(node);
+    fix_double_red(node, root);
+    set_color(root, Black);
+  }
+
+  /**
+   * @brief Устраняет два красных узла подряд над красной нодой node.
+   * @param node Красная нода, черные высоты поддеревьев которой совпадают.
+   * @param top Корень поддерева, обновляется при повороте вокруг него.
+   * @note Корень не перекрашивается, поэтому после вызова он может оказаться
+   * красным.
+   */
+  void fix_double_red(node_type *node, node_type *&top) noexcept {
+    while (color_of(parent_of(node)) == Red) {
+      if (parent_of(node) == parent_of(parent_of(node))->left) {
+        node = rebalance_left(node, top);
       } else {
-        node = rebalance_right(node);
+        node = rebalance_right(node, top);
       }
     }
-    root->color = Black;
   }
 
   /**
    * @brief Производит перебалансировку для потомка слева.
    * @param node Указатель на ноду для которой выполняется ребаланс дерева.
+   * @param top Корень поддерева, в котором выполняется ребаланс.
    * @return Следующая нода для которой нужно выполнить балансировку.
    */
-  node_type *rebalance_left(node_type *node) noexcept {
+  node_type *rebalance_left(node_type *node, node_type *&top) noexcept {
     // temp - дядя ноды.
-    node_type *temp = node->p->p->right;
+    node_type *temp = parent_of(parent_of(node))->right;
     // Если дядя красный перекрашиваем родителя и дядю в черный, а дедушку в
     // красный.
-    if (temp->color == Red) {
-      temp->color = node->p->color = Black;
-      node->p->p->color = Red;
-      node = node->p->p;
+    if (color_of(temp) == Red) {
+      set_color(temp, Black);
+      set_color(parent_of(node), Black);
+      set_color(parent_of(parent_of(node)), Red);
+      node = parent_of(parent_of(node));
     } else {
       // Если Left-right imbalance (LR) приводим к Left-left imbalance (LL).
-      if (node == node->p->right) {
-        node = node->p;
-        left_rotate(node);
+      if (node == parent_of(node)->right) {
+        node = parent_of(node);
+        left_rotate(node, top);
       }
-      node->p->color = Black;
-      node->p->p->color = Red;
-      right_rotate(node->p->p);
+      set_color(parent_of(node), Black);
+      set_color(parent_of(parent_of(node)), Red);
+      right_rotate(parent_of(parent_of(node)), top);
     }
 
     return node;
@@ -635,26 +2775,28 @@ class Rb_tree {
   /**
    * @brief Производит перебалансировку для потомка справа.
    * @param node Указатель на ноду для которой выполняется ребаланс дерева.
+   * @param top Корень поддерева, в котором выполняется ребаланс.
    * @return Следующая нода для которой нужно выполнить балансировку.
    */
-  node_type *rebalance_right(node_type *node) {
+  node_type *rebalance_right(node_type *node, node_type *&top) noexcept {
     // temp - дядя ноды
-    node_type *temp = node->p->p->left;
+    node_type *temp = parent_of(parent_of(node))->left;
     // Если дядя красный перекрашиваем родителя и дядю в черный, а дедушку в
     // красный.
-    if (temp->color == Red) {
-      temp->color = node->p->color = Black;
-      node->p->p->color = Red;
-      node = node->p->p;
+    if (color_of(temp) == Red) {
+      set_color(temp, Black);
+      set_color(parent_of(node), Black);
+      set_color(parent_of(parent_of(node)), Red);
+      node = parent_of(parent_of(node));
     } else {
       // Если Right-left imbalance (RL) приводим к Right-right imbalance (RR)
-      if (node == node->p->left) {
-        node = node->p;
-        right_rotate(node);
+      if (node == parent_of(node)->left) {
+        node = parent_of(node);
+        right_rotate(node, top);
       }
-      node->p->color = Black;
-      node->p->p->color = Red;
-      left_rotate(node->p->p);
+      set_color(parent_of(node), Black);
+      set_color(parent_of(parent_of(node)), Red);
+      left_rotate(parent_of(parent_of(node)), top);
     }
 
     return node;
@@ -664,8 +2806,18 @@ class Rb_tree {
    * @brief Выполняет поворот вправо.
    * @param parent_node Указатель на ноду (родитель).
    */
-
   void right_rotate(node_type *const parent_node) noexcept {
+    right_rotate(parent_node, root);
+  }
+
+  /**
+   * @brief Выполняет поворот вправо внутри поддерева.
+   * @param parent_node Указатель на ноду (родитель).
+   * @param top Корень поддерева, обновляется при повороте вокруг него.
+   * @note Не обращается к root, поэтому поддеревья с непересекающимися нодами
+   * можно балансировать из разных потоков.
+   */
+  void right_rotate(node_type *const parent_node, node_type *&top) noexcept {
     node_type *const child = parent_node->left;
 
     // Перемещаем правое поддерево child в левое поддерево parent_node.
@@ -673,22 +2825,26 @@ class Rb_tree {
 
     // Обновляем родителя перемещённого поддерева.
     if (child->right != nil_) {
-      child->right->p = parent_node;
+      set_parent(child->right, parent_node);
     }
 
     // Дед становится родителем внука.
-    child->p = parent_node->p;
-    if (parent_node->p == nil_) {
-      root = child;
-    } else if (parent_node == parent_node->p->right) {
-      parent_node->p->right = child;
+    set_parent(child, parent_of(parent_node));
+    if (parent_of(parent_node) == nil_) {
+      top = child;
+    } else if (parent_node == parent_of(parent_node)->right) {
+      parent_of(parent_node)->right = child;
     } else {
-      parent_node->p->left = child;
+      parent_of(parent_node)->left = child;
     }
 
     // Делаем parent_node правым потомком child.
     child->right = parent_node;
-    parent_node->p = child;
+    set_parent(parent_node, child);
+
+    // child занимает место parent_node вместе со всем поддеревом.
+    copy_size(child, parent_node);
+    update_size(parent_node);
   }
 
   /**
@@ -696,6 +2852,15 @@ class Rb_tree {
    * @param parent_node Указатель на ноду.
    */
   void left_rotate(node_type *const parent_node) noexcept {
+    left_rotate(parent_node, root);
+  }
+
+  /**
+   * @brief Выполняет поворот влево внутри поддерева.
+   * @param parent_node Указатель на ноду.
+   * @param top Корень поддерева, обновляется при повороте вокруг него.
+   */
+  void left_rotate(node_type *const parent_node, node_type *&top) noexcept {
     node_type *const child = parent_node->right;
 
     // Перемещаем левое поддерево child в правое поддерево parent_node.
@@ -703,122 +2868,132 @@ class Rb_tree {
 
     // Обновляем родителя перемещённого поддерева.
     if (child->left != nil_) {
-      child->left->p = parent_node;
+      set_parent(child->left, parent_node);
     }
 
     // Дед становится родителем внука.
-    child->p = parent_node->p;
-    if (parent_node->p == nil_) {
-      root = child;
+    set_parent(child, parent_of(parent_node));
+    if (parent_of(parent_node) == nil_) {
+      top = child;
       // Для левого потомка.
-    } else if (parent_node == parent_node->p->left) {
-      parent_node->p->left = child;
+    } else if (parent_node == parent_of(parent_node)->left) {
+      parent_of(parent_node)->left = child;
       // Для правого.
     } else {
-      parent_node->p->right = child;
+      parent_of(parent_node)->right = child;
     }
 
     // Делаем parent_node левым потомком child.
     child->left = parent_node;
-    parent_node->p = child;
+    set_parent(parent_node, child);
+
+    copy_size(child, parent_node);
+    update_size(parent_node);
   }
 
   /**
    * @brief Меняет ноду u на ноду v.
    * @param u Удаляемая нода.
    * @param v Нода которая станет на место удаляемой.
-   * @note Цвет замененной ноды такой же как ноды v.
+   * @note Цвет замененной ноды такой же как ноды v. Если v — концевая
+   * нода, ее родитель не меняется.
    */
   void transplant(node_type *u, node_type *v) noexcept {
-    if (u->p == nil_) {
+    if (parent_of(u) == nil_) {
       root = v;
-    } else if (u == u->p->left) {
-      u->p->left = v;
+    } else if (u == parent_of(u)->left) {
+      parent_of(u)->left = v;
     } else {
-      u->p->right = v;
+      parent_of(u)->right = v;
     }
 
-    v->p = u->p;
+    if (v != nil_) set_parent(v, parent_of(u));
   }
 
   /**
    * @brief Производит пeребалансировку дерева.
    * @param x Нода с которой начинается балансировка.
+   * @param parent Родитель x, x может быть концевой нодой.
    */
-  void delete_fixup(node_type *x) noexcept {
-    while (x != root && x->color == Black) {
-      if (x == x->p->left) {
-        x = delete_fixup_left(x);
+  void delete_fixup(node_type *x, node_type *parent) noexcept {
+    while (x != root && color_of(x) == Black) {
+      if (x == parent->left) {
+        x = delete_fixup_left(parent);
       } else {
-        x = delete_fixup_right(x);
+        x = delete_fixup_right(parent);
       }
     }
-    x->color = Black;
+    if (x != nil_) set_color(x, Black);
   }
 
   /**
    * @brief Производит пребалансировку дерева левого потомка.
-   * @param x Нода с которой начинается балансировка.
+   * @param parent Родитель ноды, с которой начинается балансировка,
+   * обновляется вместе с ней.
+   * @return Следующая нода для балансировки.
    */
-  node_type *delete_fixup_left(node_type *x) noexcept {
-    node_type *w = x->p->right;
-    if (w->color == Red) {
-      w->color = Black;
-      x->p->color = Red;
-      left_rotate(x->p);
-      w = x->p->right;
+  node_type *delete_fixup_left(node_type *&parent) noexcept {
+    node_type *w = parent->right;
+    if (color_of(w) == Red) {
+      set_color(w, Black);
+      set_color(parent, Red);
+      left_rotate(parent);
+      w = parent->right;
     }
 
-    if (w->left->color == Black && w->right->color == Black) {
-      w->color = Red;
-      x = x->p;
-    } else {
-      if (w->right->color == Black) {
-        w->left->color = Black;
-        w->color = Red;
-        right_rotate(w);
-        w = x->p->right;
-      }
+    if (color_of(w->left) == Black && color_of(w->right) == Black) {
+      set_color(w, Red);
+      node_type *x = parent;
+      parent = parent_of(x);
+      return x;
+    }
 
-      w->color = x->p->color;
-      w->right->color = Black;
-      x->p->color = Black;
-      left_rotate(x->p);
-      x = root;
+    if (color_of(w->right) == Black) {
+      set_color(w->left, Black);
+      set_color(w, Red);
+      right_rotate(w);
+      w = parent->right;
     }
-    return x;
+    set_color(w, color_of(parent));
+    set_color(w->right, Black);
+    set_color(parent, Black);
+    left_rotate(parent);
+    return root;
   }
 
   /**
    * @brief Производит пребалансировку дерева праваого потомка.
-   * @param x Нода с которой начинается балансировка.
+   * @param parent Родитель ноды, с которой начинается балансировка,
+   * обновляется вместе с ней.
+   * @return Следующая нода для балансировки.
    */
-  node_type *delete_fixup_right(node_type *x) noexcept {
-    node_type *w = x->p->left;
-    if (w->color == Red) {
-      w->color = Black;
-      x->p->color = Red;
-      right_rotate(x->p);
-      w = x->p->left;
+  node_type *delete_fixup_right(node_type *&parent) noexcept {
+    node_type *w = parent->left;
+    if (color_of(w) == Red) {
+      set_color(w, Black);
+      set_color(parent, Red);
+      right_rotate(parent);
+      w = parent->left;
     }
 
-    if (w->right->color == Black && w->left->color == Black) {
-      w->color = Red;
-      x = x->p;
-    } else {
-      if (w->left->color == Black) {
-        w->right->color = Black;
-        w->color = Red;
-        left_rotate(w);
-        w = x->p->left;
-      }
-      w->color = x->p->color;
-      w->left->color = Black;
-      x->p->color = Black;
-      right_rotate(x->p);
-      x = root;
+    if (color_of(w->left) == Black && color_of(w->right) == Black) {
+      set_color(w, Red);
+      node_type *x = parent;
+      parent = parent_of(x);
+      return x;
     }
-    return x;
+
+    if (color_of(w->left) == Black) {
+      set_color(w->right, Black);
+      set_color(w, Red);
+      left_rotate(w);
+      w = parent->left;
+    }
+    set_color(w, color_of(parent));
+    set_color(w->left, Black);
+    set_color(parent, Black);
+    right_rotate(parent);
+    return root;
   }
 
  public:
@@ -829,17 +3004,22 @@ class Rb_tree {
    * возвратится на начало коллекции, при декременте в конец.
    */
   class Rb_tree_iterator {
+    friend class Rb_tree_const_iterator;
+
     node_type *current;
     Rb_tree *tree;
 
    public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
     using value_type = V;
+    using pointer = value_type *;
     using reference = value_type &;
 
     explicit Rb_tree_iterator(node_type *node, Rb_tree *t)
         : current(node), tree(t) {}
 
-    node_type *get_current() { return current; }
+    node_type *get_current() const noexcept { return current; }
 
     /**
      * @brief Проверяет принадлежит ли итератор переданному дереву.
@@ -849,6 +3029,8 @@ class Rb_tree {
 
     reference operator*() { return current->val; }
 
+    pointer operator->() { return &current->val; }
+
     Rb_tree_iterator &operator++() {
       increment();
       return *this;
@@ -879,6 +3061,20 @@ class Rb_tree {
       return !(*this == other);
     }
 
+    /**
+     * @brief Расстояние между итераторами одного дерева за O(log n).
+     * @note Доступно, только если ноды хранят размеры поддеревьев. Итератор
+     * остается двунаправленным, поэтому std::distance и алгоритмы std этим
+     * не пользуются и проходят k элементов за O(k): для быстрого расстояния
+     * нужно вызывать last - first или index_of контейнера.
+     */
+    difference_type operator-(const Rb_tree_iterator &other) const
+      requires sized_nodes
+    {
+      return static_cast<difference_type>(tree->position(current)) -
+             static_cast<difference_type>(tree->position(other.current));
+    }
+
    private:
     void increment() {
       const node_type *nil = tree->get_nil();
@@ -890,10 +3086,10 @@ class Rb_tree {
         current = current->right;
         while (current->left != nil) current = current->left;
       } else {
-        node_type *father = current->p;
+        node_type *father = parent_of(current);
         while (father != nil && current == father->right) {
           current = father;
-          father = father->p;
+          father = parent_of(father);
         }
         current = father;
       }
@@ -909,10 +3105,10 @@ class Rb_tree {
         current = current->left;
         while (current->right != nil) current = current->right;
       } else {
-        Node<V> *father = current->p;
+        node_type *father = parent_of(current);
         while (father != nil && current == father->left) {
           current = father;
-          father = father->p;
+          father = parent_of(father);
         }
         current = father;
       }
@@ -930,12 +3126,22 @@ class Rb_tree {
     const Rb_tree *tree;
 
    public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
     using value_type = V;
+    using pointer = const value_type *;
+    using reference = const value_type &;
     using const_reference = const value_type &;
 
     explicit Rb_tree_const_iterator(const node_type *node, const Rb_tree *t)
         : current(node), tree(t) {}
 
+    /**
+     * @brief Неявное преобразование обычного итератора в константный.
+     */
+    Rb_tree_const_iterator(const Rb_tree_iterator &it)
+        : current(it.current), tree(it.tree) {}
+
     const node_type *get_current() const noexcept { return current; }
 
     /**
@@ -946,6 +3152,8 @@ class Rb_tree {
 
     const_reference operator*() const { return current->val; }
 
+    pointer operator->() const { return &current->val; }
+
     Rb_tree_const_iterator &operator++() {
       increment();
       return *this;
@@ -976,6 +3184,20 @@ class Rb_tree {
       return !(*this == other);
     }
 
+    /**
+     * @brief Расстояние между итераторами одного дерева за O(log n).
+     * @note Доступно, только если ноды хранят размеры поддеревьев. Итератор
+     * остается двунаправленным, поэтому std::distance и алгоритмы std этим
+     * не пользуются и проходят k элементов за O(k): для быстрого расстояния
+     * нужно вызывать last - first или index_of контейнера.
+     */
+    difference_type operator-(const Rb_tree_const_iterator &other) const
+      requires sized_nodes
+    {
+      return static_cast<difference_type>(tree->position(current)) -
+             static_cast<difference_type>(tree->position(other.current));
+    }
+
    private:
     void increment() {
       const node_type *nil = tree->get_nil();
@@ -987,10 +3209,10 @@ class Rb_tree {
         current = current->right;
         while (current->left != nil) current = current->left;
       } else {
-        const node_type *father = current->p;
+        const node_type *father = parent_of(current);
         while (father != nil && current == father->right) {
           current = father;
-          father = father->p;
+          father = parent_of(father);
         }
         current = father;
       }
@@ -1006,10 +3228,10 @@ class Rb_tree {
         current = current->left;
         while (current->right != nil) current = current->right;
       } else {
-        const node_type *father = current->p;
+        const node_type *father = parent_of(current);
         while (father != nil && current == father->left) {
           current = father;
-          father = father->p;
+          father = parent_of(father);
         }
         current = father;
       }
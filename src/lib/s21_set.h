@@ -1,69 +1,124 @@
 #ifndef S21_SET_H
 #define S21_SET_H
 
+#include <memory_resource>
 #include <vector>
 
 #include "s21_red_black_tree.h"
 
 namespace s21 {
 template <typename Key, typename Compare = std::less<Key>,
-          typename Alloc = std::allocator<Key>>
+          typename Alloc = std::allocator<Key>,
+          template <typename> class NodeT = Node>
 class set {
  public:
   using value_type = Key;
   using key_type = Key;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using BinaryTree = Rb_tree<Key, Key, std::identity, Compare, Alloc>;
-  using node_type = BinaryTree::node_type;
+  using BinaryTree =
+      Rb_tree<Key, Key, std::identity, Compare, Alloc, NodeT>;
+  using tree_node = BinaryTree::node_type;
   using iterator = typename BinaryTree::const_iterator;
   using const_iterator = typename BinaryTree::const_iterator;
   using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using node_type = typename BinaryTree::template node_handle<>;
+  using insert_return_type = Insert_return<iterator, node_type>;
 
  private:
-  BinaryTree* tree;
+  BinaryTree tree;
 
  public:
   /**
    * @brief Конструктор по умолчанию, не создает элементов.
    */
-  set() { tree = new BinaryTree; }
+  set() = default;
 
   /**
    * @brief Конструктор из списка инициализации.
    * @note В случае возникновения исключения новые элементы удаляются и set
    * остается пустым.
    */
-  set(std::initializer_list<value_type> const& items) : set{} {
-    auto curr = std::begin(items);
-    try {
-      for (; curr != std::end(items); ++curr) {
-        tree->insert(*curr, *curr, true);
-      }
-    } catch (...) {
-      ++curr;  // Устанавливаем в позицию после последнего добавленного.
-      for (auto it = std::begin(items); it != curr; ++it) {
-        node_type* node = tree->search(*it);
-        tree->delete_node(node);
-      }
-      throw;
-    }
+  set(std::initializer_list<value_type> const& items)
+      : set(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last).
+   * @note Упорядоченный диапазон собирается за O(n), неупорядоченный
+   * предварительно сортируется. Из повторяющихся ключей остается первый.
+   */
+  template <std::input_iterator InputIt>
+  set(InputIt first, InputIt last) : set{} {
+    tree.assign_range(first, last, true);
+  }
+
+  /**
+   * @brief Конструктор из упорядоченного по возрастанию ключей диапазона
+   * [first, last), работает за O(n).
+   * @warning Порядок элементов не проверяется.
+   */
+  template <std::input_iterator InputIt>
+  set(sorted_range_t, InputIt first, InputIt last) : set{} {
+    tree.assign_sorted(first, last, true);
   }
 
+  /**
+   * @brief Конструктор пустого контейнера, ноды которого выделяются копией
+   * alloc, например, std::pmr::polymorphic_allocator.
+   */
+  explicit set(const Alloc& alloc) : tree(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  set(std::initializer_list<value_type> const& items, const Alloc& alloc)
+      : set(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  set(InputIt first, InputIt last, const Alloc& alloc) : set(alloc) {
+    tree.assign_range(first, last, true);
+  }
+
+  /**
+   * @brief Копирует other, выделяя ноды копией alloc.
+   */
+  set(const set& other, const Alloc& alloc) : tree(other.tree, alloc) {}
+
+  /**
+   * @brief Копирует other, распределяя копирование поддеревьев между
+   * потоками.
+   * @param threads Количество потоков, 0 — по числу ядер.
+   * @note Параллельно копируются большие множества с аллокатором, у которого
+   * is_always_equal, например std::allocator и concurrent_pool_allocator.
+   * Остальные, в том числе на pool_allocator и pmr, копируются
+   * последовательно.
+   */
+  set(execution::parallel_policy policy, const set& other,
+      unsigned threads = 0)
+      : tree(policy, other.tree, threads) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые ноды по одному.
+   */
+  set(set&& other, const Alloc& alloc)
+      : tree(std::move(other.tree), alloc) {}
+
   /**
    * @brief Конструктор копирования.
    * @param other Сылка на другое множество.
    */
-  set(const set& other) { tree = new BinaryTree(*other.tree); }
+  set(const set& other) : tree(other.tree) {}
 
   /**
    * @brief Конструктор перемещения.
    * @param other rvalue на другое множество.
    */
-  set(set&& other) noexcept {
-    tree = other.tree;
-    other.tree = new BinaryTree;
-  }
+  set(set&& other) noexcept : tree(std::move(other.tree)) {}
 
   /**
    * @brief Деструктор удаляет только сами элементы. Важно отметить, что если
@@ -71,16 +126,13 @@ class set {
    * не затрагивается. Управление памятью, на которую указывают указатели,
    * является ответственностью пользователя.
    */
-  ~set() { delete tree; }
+  ~set() = default;
 
   /**
    * @brief Оператор присваивания для множества.
    */
   set& operator=(const set& other) {
-    if (this != &other) {
-      delete tree;
-      tree = new BinaryTree(*other.tree);
-    }
+    tree = other.tree;
     return *this;
   }
 
@@ -88,11 +140,7 @@ class set {
    * @brief Оператор присваивающего перемещения.
    */
   set& operator=(set&& other) noexcept {
-    if (this != &other) {
-      delete tree;
-      tree = other.tree;
-      other.tree = new BinaryTree;
-    }
+    tree = std::move(other.tree);
     return *this;
   }
 
@@ -100,29 +148,29 @@ class set {
    * @brief Возвращает константный итератор, указывающий на первый элемент
    * множества. Итерация выполняется в порядке возрастания ключей.
    */
-  inline iterator begin() const { return tree->cbegin(); }
+  inline iterator begin() const { return tree.cbegin(); }
 
   /**
    * @brief Возвращает константный итератор, указывающий на позицию после
    * последнего элемента множества. Итерация выполняется в порядке возрастания
    * ключей.
    */
-  inline iterator end() const { return tree->cend(); }
+  inline iterator end() const { return tree.cend(); }
 
   /**
    * @brief Возвращает true, если множество пустое.
    */
-  inline bool empty() const noexcept { return tree->empty(); }
+  inline bool empty() const noexcept { return tree.empty(); }
 
   /**
    * @brief Возвращает размер множества.
    */
-  inline size_type size() const noexcept { return tree->size(); }
+  inline size_type size() const noexcept { return tree.size(); }
 
   /**
    * @brief Возвращает максимально возможный размер множества.
    */
-  inline size_type max_size() noexcept { return tree->max_size(); }
+  inline size_type max_size() noexcept { return tree.max_size(); }
 
   /**
    * @brief Удаляет все элементы из множества. Важно отметить, что эта функция
@@ -131,7 +179,40 @@ class set {
    * памятью, на которую указывают указатели, является ответственностью
    * пользователя.
    */
-  void clear() noexcept { tree->clear(); }
+  void clear() noexcept { tree.clear(); }
+
+  /**
+   * @brief Удаляет не больше max_nodes первых элементов, чтобы распределить
+   * очистку большого множества по нескольким вызовам, например по итерациям
+   * цикла событий.
+   * @return true, если контейнер опустел.
+   */
+  bool clear_some(size_type max_nodes) noexcept {
+    return tree.clear_some(max_nodes);
+  }
+
+  /**
+   * @brief Возвращает системе память, освободившуюся после удаления
+   * элементов, если аллокатор это поддерживает (например, pool_allocator).
+   */
+  void shrink_to_fit() noexcept { tree.shrink_to_fit(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: ноды элементов и
+   * потери аллокатора вместе с самим объектом контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = tree.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  /**
+   * @brief Возвращает копию аллокатора контейнера.
+   */
+  allocator_type get_allocator() const noexcept {
+    return tree.get_allocator();
+  }
 
   /**
    * @brief Пытается вставить элемент в множество
@@ -145,8 +226,72 @@ class set {
    * множестве.
    */
   std::pair<iterator, bool> insert(const value_type& value) {
-    auto res = tree->insert(value, value, true);
-    return {iterator(res.first, tree), res.second};
+    auto res = tree.insert(value, value, true);
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Пытается переместить элемент в множество.
+   * @param value rvalue элемента для вставки.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка. Если элемент уже есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    auto res = tree.emplace_with_key(value, true, std::move(value));
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Конструирует элемент на месте из переданных аргументов и вставляет
+   * его, если такого ключа ещё нет.
+   * @param args Аргументы конструктора value_type.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   * @note Элемент создается до поиска места вставки и уничтожается, если ключ
+   * уже существует.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto res = tree.emplace(true, std::forward<Args>(args)...);
+    return {iterator(res.first, &tree), res.second};
+  }
+
+  /**
+   * @brief Вставляет элемент, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value Элемент для вставки.
+   * @return Итератор на элемент с таким ключом.
+   * @note Если элемент попадает непосредственно перед hint, вставка
+   * выполняется за амортизированное O(1). Иначе (в том числе для итератора
+   * другого контейнера) место ищется спуском от корня.
+   */
+  iterator insert(const_iterator hint, const value_type& value) {
+    auto res = tree.emplace_hint_with_key(hint_node(hint), value, true, value);
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Перемещает элемент в множество, используя подсказку позиции.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @param value rvalue элемента для вставки.
+   * @return Итератор на элемент с таким ключом.
+   */
+  iterator insert(const_iterator hint, value_type&& value) {
+    auto res = tree.emplace_hint_with_key(hint_node(hint), value, true,
+                                           std::move(value));
+    return iterator(res.first, &tree);
+  }
+
+  /**
+   * @brief Аналог emplace с подсказкой позиции вставки.
+   * @param hint Итератор на элемент, перед которым ожидается вставка.
+   * @return Итератор на элемент с таким ключом.
+   */
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    auto res =
+        tree.emplace_hint(hint_node(hint), true, std::forward<Args>(args)...);
+    return iterator(res.first, &tree);
   }
 
   /**
@@ -155,22 +300,84 @@ class set {
    * контейнеру, из которого происходит удаление.
    */
   void erase(iterator pos) {
-    if (pos.is_same_iterator(tree))
-      tree->delete_node(const_cast<node_type*>(pos.get_current()));
+    if (tree.owns(pos))
+      tree.delete_node(const_cast<tree_node*>(pos.get_current()));
   }
 
   /**
    * @brief Удаляет элемент по ключу.
    * @param key Ключ.
+   * @return Количество удаленных элементов (0 или 1).
    */
-  void erase(key_type key) { tree->delete_node(tree->search(key)); }
+  size_type erase(const key_type& key) { return erase_node(tree.search(key)); }
+
+  /**
+   * @brief Гетерогенное удаление по объекту, сравнимому с ключом. Доступно
+   * для прозрачных компараторов.
+   */
+  template <typename KT>
+    requires transparent_compare<Compare> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return erase_node(tree.search(key));
+  }
+
+  /**
+   * @brief Извлекает элемент из множества вместе с его нодой без
+   * освобождения памяти.
+   * @param pos Итератор этого множества.
+   * @return Дескриптор ноды, пустой для end() и итератора другого контейнера.
+   * @note Недоступно с pool_allocator: его копия — отдельный пул, который не
+   * может освободить ноду. Дескрипторы с пулом нод работают у pmr-контейнеров
+   * на общем s21::pmr::pool_resource.
+   */
+  node_type extract(const_iterator pos) noexcept {
+    if (!tree.owns(pos)) return node_type{};
+    return tree.template extract<node_type>(
+        const_cast<tree_node*>(pos.get_current()));
+  }
+
+  /**
+   * @brief Извлекает элемент с ключом key.
+   * @return Дескриптор ноды, пустой если ключа нет.
+   */
+  node_type extract(const key_type& key) {
+    return tree.template extract<node_type>(tree.search(key));
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора без выделения памяти.
+   * @param nh Дескриптор ноды, извлеченной из контейнера с равным
+   * аллокатором.
+   * @return Итератор на элемент с таким ключом, флаг вставки и пустой
+   * дескриптор, либо исходная нода, если ключ уже есть.
+   * @note Ноду с другим аллокатором нельзя перенести: её значение
+   * перемещается в новую ноду.
+   * @note Как и extract, недоступно с pool_allocator.
+   */
+  insert_return_type insert(node_type&& nh) {
+    auto res = tree.insert_handle(nh, nullptr, true);
+    if (res.second || nh.empty()) {
+      return {iterator(res.first, &tree), res.second, node_type{}};
+    }
+    return {iterator(res.first, &tree), false, std::move(nh)};
+  }
+
+  /**
+   * @brief Вставляет ноду дескриптора, используя подсказку позиции.
+   * @return Итератор на элемент с таким ключом. Если ключ уже есть, нода
+   * остается в nh.
+   */
+  iterator insert(const_iterator hint, node_type&& nh) {
+    return iterator(tree.insert_handle(nh, hint_node(hint), true).first, &tree);
+  }
 
   /**
    * @brief Обменивает данные с другим множеством
    * @param other Множество того же типа элементов.
    */
   void swap(set& other) noexcept {
-    if (this != &other) std::swap(tree, other.tree);
+    if (this != &other) tree.swap(other.tree);
   }
 
   /**
@@ -180,7 +387,71 @@ class set {
    * уникальные значения для первого множества перенесены не будут.
    */
   void merge(set& other) {
-    if (this != &other) tree->merge(other.tree, true);
+    if (this != &other) tree.merge(&other.tree, true);
+  }
+
+  /**
+   * @brief Объединение множеств за O(m log(n/m + 1)), где m <= n — размеры
+   * множеств. Из равных элементов остается элемент lhs.
+   * @note Множества принимаются по значению: для переданных через std::move
+   * ноды переиспользуются без копирования.
+   */
+  friend set set_union(set lhs, set rhs) {
+    lhs.tree.unite(rhs.tree);
+    return lhs;
+  }
+
+  /**
+   * @brief Объединение множеств, независимые ветви рекурсии выполняются в
+   * разных потоках.
+   */
+  friend set set_union(execution::parallel_policy, set lhs, set rhs) {
+    lhs.tree.unite(rhs.tree, true);
+    return lhs;
+  }
+
+  /**
+   * @brief Пересечение множеств за O(m log(n/m + 1)), ноды lhs
+   * переиспользуются.
+   */
+  friend set set_intersection(set lhs, const set& rhs) {
+    lhs.tree.intersect(rhs.tree);
+    return lhs;
+  }
+
+  friend set set_intersection(execution::parallel_policy, set lhs,
+                              const set& rhs) {
+    lhs.tree.intersect(rhs.tree, true);
+    return lhs;
+  }
+
+  /**
+   * @brief Элементы lhs, которых нет в rhs, за O(m log(n/m + 1)).
+   */
+  friend set set_difference(set lhs, const set& rhs) {
+    lhs.tree.subtract(rhs.tree);
+    return lhs;
+  }
+
+  friend set set_difference(execution::parallel_policy, set lhs,
+                            const set& rhs) {
+    lhs.tree.subtract(rhs.tree, true);
+    return lhs;
+  }
+
+  /**
+   * @brief Элементы, которые есть ровно в одном из множеств, за
+   * O(m log(n/m + 1)).
+   */
+  friend set symmetric_difference(set lhs, set rhs) {
+    lhs.tree.symmetric_subtract(rhs.tree);
+    return lhs;
+  }
+
+  friend set symmetric_difference(execution::parallel_policy, set lhs,
+                                  set rhs) {
+    lhs.tree.symmetric_subtract(rhs.tree, true);
+    return lhs;
   }
 
   /**
@@ -189,15 +460,118 @@ class set {
    * @return Итератор, указывающий на искомый элемент, или end(), если элемент
    * не найден.
    */
-  iterator find(const Key& key) { return iterator(tree->search(key), tree); }
+  iterator find(const Key& key) const {
+    return iterator(tree.search(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator find(const KT& key) const {
+    return iterator(tree.search(key), &tree);
+  }
 
   /**
    * @brief Проверяет наличие элемента с заданным ключом
    * @param key Ключ элемента для поиска
    * @return true, если элемент с указанным ключом существует
    */
-  bool contains(const Key& key) {
-    return tree->search(key) == tree->get_nil() ? false : true;
+  bool contains(const Key& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  bool contains(const KT& key) const {
+    return tree.search(key) != tree.get_nil();
+  }
+
+  /**
+   * @brief Подсчитывает количество элементов с указанным ключом.
+   * @return 1 если элемент есть в множестве, иначе 0.
+   */
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, не меньший key, или end().
+   */
+  iterator lower_bound(const Key& key) const {
+    return iterator(tree.lower_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator lower_bound(const KT& key) const {
+    return iterator(tree.lower_bound(key), &tree);
+  }
+
+  /**
+   * @brief Возвращает итератор на первый элемент, больший key, или end().
+   */
+  iterator upper_bound(const Key& key) const {
+    return iterator(tree.upper_bound(key), &tree);
+  }
+
+  template <typename KT>
+    requires transparent_compare<Compare>
+  iterator upper_bound(const KT& key) const {
+    return iterator(tree.upper_bound(key), &tree);
+  }
+
+  /**
+   * @brief Считает элементы, ключ которых меньше key, за O(log n).
+   * @return Индекс lower_bound(key) в порядке обхода.
+   * @note Доступно, если контейнер объявлен с параметром NodeT = Sized_node.
+   */
+  size_type rank(const Key& key) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.rank(key);
+  }
+
+  template <typename KT>
+    requires BinaryTree::sized_nodes && transparent_compare<Compare>
+  size_type rank(const KT& key) const {
+    return tree.rank(key);
+  }
+
+  /**
+   * @brief Возвращает итератор на элемент с индексом index в порядке обхода
+   * за O(log n).
+   * @return Итератор на элемент или end(), если index >= size().
+   */
+  iterator nth(size_type index) const
+    requires BinaryTree::sized_nodes
+  {
+    return iterator(tree.select(index), &tree);
+  }
+
+  /**
+   * @brief Возвращает индекс элемента в порядке обхода за O(log n).
+   * @param pos Итератор этого контейнера.
+   * @return Индекс элемента, для end() — size().
+   * @note std::distance(begin(), pos) дает то же значение, но за O(k).
+   */
+  size_type index_of(const_iterator pos) const
+    requires BinaryTree::sized_nodes
+  {
+    return tree.position(pos.get_current());
+  }
+
+  /**
+   * @brief Заменяет содержимое множества элементами упорядоченного по
+   * возрастанию ключей диапазона [first, last) за O(n).
+   * @warning Порядок элементов не проверяется.
+   * @throw При исключении содержимое множества не меняется.
+   */
+  template <std::input_iterator InputIt>
+  void assign_sorted(InputIt first, InputIt last) {
+    tree.assign_sorted(first, last, true);
   }
 
   /**
@@ -234,7 +608,37 @@ class set {
     return res;
   }
 
+ private:
+  /**
+   * @brief Удаляет найденную ноду, если она не концевая.
+   * @return Количество удаленных элементов.
+   */
+  size_type erase_node(tree_node* node) {
+    if (node == tree.get_nil()) return 0;
+    tree.delete_node(node);
+    return 1;
+  }
+
+  /**
+   * @brief Возвращает ноду подсказки или nullptr, если итератор принадлежит
+   * другому контейнеру.
+   */
+  const tree_node* hint_node(const_iterator hint) const {
+    return tree.owns(hint) ? hint.get_current() : nullptr;
+  }
+
 };  // class set
+
+namespace pmr {
+/**
+ * @brief set, выделяющий ноды из std::pmr::memory_resource.
+ */
+template <typename Key, typename Compare = std::less<Key>,
+          template <typename> class NodeT = Node>
+using set =
+    s21::set<Key, Compare, std::pmr::polymorphic_allocator<Key>, NodeT>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_SET_H
\ No newline at end of file
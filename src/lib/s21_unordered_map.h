@@ -0,0 +1,397 @@
+#ifndef S21_UNORDERED_MAP_H
+#define S21_UNORDERED_MAP_H
+
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "s21_hash_table.h"
+
+namespace s21 {
+
+/**
+ * @brief Ассоциативный массив в хеш-таблице с открытой адресацией (Swiss
+ * table) с интерфейсом s21::map без упорядоченных операций. Подходит для
+ * таблиц, где нужен только поиск по ключу: он выполняется в среднем за O(1)
+ * вместо спуска по дереву.
+ * @warning Вставка, вызвавшая перестройку таблицы, делает недействительными
+ * все итераторы и ссылки. Порядок обхода не определен.
+ */
+template <typename K, typename T, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Alloc = std::allocator<std::pair<const K, T>>>
+class unordered_map {
+ public:
+  using key_type = K;
+  using mapped_type = T;
+  using value_type = std::pair<const K, T>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using HashTable =
+      Hash_table<K, value_type, s21::Select1st, Hash, KeyEqual, Alloc>;
+  using iterator = typename HashTable::iterator;
+  using const_iterator = typename HashTable::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+ private:
+  HashTable table;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов и не выделяет
+   * память.
+   */
+  unordered_map() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  unordered_map(std::initializer_list<value_type> const& items)
+      : unordered_map(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last). Из повторяющихся ключей
+   * остается первый.
+   */
+  template <std::input_iterator InputIt>
+  unordered_map(InputIt first, InputIt last) : unordered_map{} {
+    table.insert_range(first, last);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, массивы которого выделяются
+   * копией alloc.
+   */
+  explicit unordered_map(const Alloc& alloc) : table(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  unordered_map(std::initializer_list<value_type> const& items,
+                const Alloc& alloc)
+      : unordered_map(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  unordered_map(InputIt first, InputIt last, const Alloc& alloc)
+      : unordered_map(alloc) {
+    table.insert_range(first, last);
+  }
+
+  /**
+   * @brief Копирует other, выделяя массивы копией alloc.
+   */
+  unordered_map(const unordered_map& other, const Alloc& alloc)
+      : table(other.table, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые массивы.
+   */
+  unordered_map(unordered_map&& other, const Alloc& alloc)
+      : table(std::move(other.table), alloc) {}
+
+  unordered_map(const unordered_map& other) : table(other.table) {}
+
+  unordered_map(unordered_map&& other) noexcept
+      : table(std::move(other.table)) {}
+
+  ~unordered_map() = default;
+
+  unordered_map& operator=(const unordered_map& other) {
+    table = other.table;
+    return *this;
+  }
+
+  unordered_map& operator=(unordered_map&& other) noexcept {
+    table = std::move(other.table);
+    return *this;
+  }
+
+  /**
+   * @brief Доступ к значению по ключу. Если ключа нет, создается элемент со
+   * значением по умолчанию.
+   * @note Хеш ключа вычисляется один раз.
+   */
+  T& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  T& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  /**
+   * @brief Получает ссылку на значение по ключу.
+   * @throw std::out_of_range("unordered_map::at") если такого ключа нет.
+   */
+  mapped_type& at(const key_type& key) {
+    auto it = table.find(key);
+    if (it == table.end()) throw std::out_of_range("unordered_map::at");
+    return it->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    auto it = table.find(key);
+    if (it == table.end()) throw std::out_of_range("unordered_map::at");
+    return it->second;
+  }
+
+  /**
+   * @brief Итераторы обходят пары в порядке мест таблицы.
+   */
+  inline iterator begin() { return table.begin(); }
+  inline const_iterator begin() const { return table.begin(); }
+  inline iterator end() { return table.end(); }
+  inline const_iterator end() const { return table.end(); }
+
+  inline bool empty() const noexcept { return table.empty(); }
+
+  inline size_type size() const noexcept { return table.size(); }
+
+  inline size_type max_size() const noexcept { return table.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы, сохраняя выделенную память.
+   */
+  inline void clear() noexcept { table.clear(); }
+
+  /**
+   * @brief Готовит контейнер к n элементам без перестроек таблицы.
+   */
+  void reserve(size_type n) { table.reserve(n); }
+
+  /**
+   * @brief Перестраивает таблицу не меньше чем на n мест.
+   */
+  void rehash(size_type n) { table.rehash(n); }
+
+  /**
+   * @brief Уменьшает таблицу до наименьшей емкости для текущего размера.
+   */
+  void shrink_to_fit() { table.rehash(0); }
+
+  size_type bucket_count() const noexcept { return table.bucket_count(); }
+
+  float load_factor() const noexcept { return table.load_factor(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: пары, свободные места
+   * с управляющими байтами и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = table.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return table.get_allocator();
+  }
+
+  hasher hash_function() const { return table.hash_function(); }
+
+  key_equal key_eq() const { return table.key_eq(); }
+
+  /**
+   * @brief Добавляет пару, только если такого ключа еще нет.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return table.emplace_with_key(value.first, value);
+  }
+
+  std::pair<iterator, bool> insert(const K& key, const T& obj) {
+    return table.emplace_with_key(key, key, obj);
+  }
+
+  /**
+   * @brief Перемещает пару, только если такого ключа еще нет. Если ключ уже
+   * есть, value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return table.emplace_with_key(value.first, std::move(value));
+  }
+
+  /**
+   * @brief Конструирует пару из args и вставляет её, если такого ключа ещё
+   * нет.
+   * @note Пара создается до поиска. Чтобы не создавать значение зря,
+   * используйте try_emplace.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table.emplace(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Вставка с подсказкой для совместимости с s21::map: место
+   * определяется хешем, подсказка не используется.
+   */
+  iterator insert(const_iterator, const value_type& value) {
+    return insert(value).first;
+  }
+
+  iterator insert(const_iterator, value_type&& value) {
+    return insert(std::move(value)).first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Вставляет пары диапазона [first, last), заранее расширяя
+   * таблицу, если размер диапазона известен.
+   */
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    table.insert_range(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> items) {
+    insert(items.begin(), items.end());
+  }
+
+  /**
+   * @brief Вставляет элемент с ключом key, значение которого конструируется
+   * из args, если такого ключа ещё нет.
+   * @note Если ключ уже существует, ни key, ни args не используются.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return table.emplace_with_key(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return table.emplace_with_key(
+        key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator, const K& key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...).first;
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator, K&& key, Args&&... args) {
+    return try_emplace(std::move(key), std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Добавляет пару или заменяет значение существующего ключа.
+   * @return Пара итератор на элемент и флаг был ли создан элемент.
+   */
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+    auto res = try_emplace(key, std::forward<M>(obj));
+    // try_emplace использует obj только при вставке.
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    auto res = try_emplace(std::move(key), std::forward<M>(obj));
+    if (res.second == false) res.first->second = std::forward<M>(obj);
+    return res;
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   * @note Итераторы и ссылки на остальные элементы остаются
+   * действительными.
+   */
+  void erase(iterator pos) {
+    if (table.owns(pos)) table.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const K& key) { return table.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual> &&
+             (!std::convertible_to<const KT&, const_iterator>)
+  size_type erase(const KT& key) {
+    return table.erase_key(key);
+  }
+
+  void swap(unordered_map& other) noexcept {
+    if (this != &other) table.swap(other.table);
+  }
+
+  /**
+   * @brief Перемещает элементы other, ключей которых ещё нет. Остальные
+   * элементы остаются в other.
+   */
+  void merge(unordered_map& other) { table.merge(other.table); }
+
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  iterator find(const K& key) { return table.find(key); }
+
+  const_iterator find(const K& key) const { return table.find(key); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  iterator find(const KT& key) {
+    return table.find(key);
+  }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  const_iterator find(const KT& key) const {
+    return table.find(key);
+  }
+
+  /**
+   * @brief Вставляет несколько пар с уникальными ключами за одну операцию.
+   * @return Пары итератор на элемент и флаг была ли выполнена вставка.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return table.template insert_many<iterator>(std::forward<Args>(args)...);
+  }
+};  // class unordered_map
+
+namespace pmr {
+/**
+ * @brief unordered_map, выделяющий массивы из std::pmr::memory_resource.
+ */
+template <typename K, typename T, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+using unordered_map =
+    s21::unordered_map<K, T, Hash, KeyEqual,
+                       std::pmr::polymorphic_allocator<std::pair<const K, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_UNORDERED_MAP_H
@@ -0,0 +1,304 @@
+#ifndef S21_UNORDERED_SET_H
+#define S21_UNORDERED_SET_H
+
+#include <memory_resource>
+#include <vector>
+
+#include "s21_hash_table.h"
+
+namespace s21 {
+
+/**
+ * @brief Множество уникальных ключей в хеш-таблице с открытой адресацией
+ * (Swiss table) с интерфейсом s21::set без упорядоченных операций. Поиск
+ * выполняется в среднем за O(1) и сравнивает с хешем сразу группу мест.
+ * @warning Вставка, вызвавшая перестройку таблицы, делает недействительными
+ * все итераторы и ссылки. Порядок обхода не определен.
+ */
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Alloc = std::allocator<Key>>
+class unordered_set {
+ public:
+  using value_type = Key;
+  using key_type = Key;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using HashTable = Hash_table<Key, Key, std::identity, Hash, KeyEqual, Alloc>;
+  using iterator = typename HashTable::const_iterator;
+  using const_iterator = typename HashTable::const_iterator;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+ private:
+  HashTable table;
+
+ public:
+  /**
+   * @brief Конструктор по умолчанию, не создает элементов и не выделяет
+   * память.
+   */
+  unordered_set() = default;
+
+  /**
+   * @brief Конструктор из списка инициализации.
+   */
+  unordered_set(std::initializer_list<value_type> const& items)
+      : unordered_set(items.begin(), items.end()) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last). Из повторяющихся ключей
+   * остается первый.
+   */
+  template <std::input_iterator InputIt>
+  unordered_set(InputIt first, InputIt last) : unordered_set{} {
+    table.insert_range(first, last);
+  }
+
+  /**
+   * @brief Конструктор пустого контейнера, массивы которого выделяются
+   * копией alloc.
+   */
+  explicit unordered_set(const Alloc& alloc) : table(alloc) {}
+
+  /**
+   * @brief Конструктор из списка инициализации с аллокатором.
+   */
+  unordered_set(std::initializer_list<value_type> const& items,
+                const Alloc& alloc)
+      : unordered_set(items.begin(), items.end(), alloc) {}
+
+  /**
+   * @brief Конструктор из диапазона [first, last) с аллокатором.
+   */
+  template <std::input_iterator InputIt>
+  unordered_set(InputIt first, InputIt last, const Alloc& alloc)
+      : unordered_set(alloc) {
+    table.insert_range(first, last);
+  }
+
+  /**
+   * @brief Копирует other, выделяя массивы копией alloc.
+   */
+  unordered_set(const unordered_set& other, const Alloc& alloc)
+      : table(other.table, alloc) {}
+
+  /**
+   * @brief Перемещает other. Если alloc не равен аллокатору other, элементы
+   * перемещаются в новые массивы.
+   */
+  unordered_set(unordered_set&& other, const Alloc& alloc)
+      : table(std::move(other.table), alloc) {}
+
+  unordered_set(const unordered_set& other) : table(other.table) {}
+
+  unordered_set(unordered_set&& other) noexcept
+      : table(std::move(other.table)) {}
+
+  ~unordered_set() = default;
+
+  unordered_set& operator=(const unordered_set& other) {
+    table = other.table;
+    return *this;
+  }
+
+  unordered_set& operator=(unordered_set&& other) noexcept {
+    table = std::move(other.table);
+    return *this;
+  }
+
+  /**
+   * @brief Возвращает константный итератор на первый элемент. Порядок обхода
+   * определяется хешами и меняется при перестройке таблицы.
+   */
+  inline iterator begin() const { return table.begin(); }
+
+  inline iterator end() const { return table.end(); }
+
+  inline bool empty() const noexcept { return table.empty(); }
+
+  inline size_type size() const noexcept { return table.size(); }
+
+  inline size_type max_size() const noexcept { return table.max_size(); }
+
+  /**
+   * @brief Удаляет все элементы, сохраняя выделенную память.
+   */
+  void clear() noexcept { table.clear(); }
+
+  /**
+   * @brief Готовит множество к n элементам без перестроек таблицы.
+   */
+  void reserve(size_type n) { table.reserve(n); }
+
+  /**
+   * @brief Перестраивает таблицу не меньше чем на n мест.
+   */
+  void rehash(size_type n) { table.rehash(n); }
+
+  /**
+   * @brief Уменьшает таблицу до наименьшей емкости для текущего размера.
+   */
+  void shrink_to_fit() { table.rehash(0); }
+
+  size_type bucket_count() const noexcept { return table.bucket_count(); }
+
+  float load_factor() const noexcept { return table.load_factor(); }
+
+  /**
+   * @brief Возвращает память, занимаемую контейнером: значения, свободные
+   * места с управляющими байтами и сам объект контейнера.
+   */
+  memory_usage_info memory_usage() const noexcept {
+    memory_usage_info usage = table.memory_usage();
+    usage.overhead_bytes += sizeof(*this);
+    return usage;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return table.get_allocator();
+  }
+
+  hasher hash_function() const { return table.hash_function(); }
+
+  key_equal key_eq() const { return table.key_eq(); }
+
+  /**
+   * @brief Пытается вставить элемент в множество.
+   * @return Пара итератор на элемент с таким ключом и флаг была ли выполнена
+   * вставка.
+   */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return table.emplace_with_key(value, value);
+  }
+
+  /**
+   * @brief Пытается переместить элемент в множество. Если элемент уже есть,
+   * value не перемещается.
+   */
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return table.emplace_with_key(value, std::move(value));
+  }
+
+  /**
+   * @brief Конструирует элемент из args и вставляет его, если такого ключа
+   * ещё нет.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table.emplace(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Вставка с подсказкой для совместимости с s21::set: место
+   * определяется хешем, подсказка не используется.
+   */
+  iterator insert(const_iterator, const value_type& value) {
+    return insert(value).first;
+  }
+
+  iterator insert(const_iterator, value_type&& value) {
+    return insert(std::move(value)).first;
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  /**
+   * @brief Вставляет элементы диапазона [first, last), заранее расширяя
+   * таблицу, если размер диапазона известен.
+   */
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    table.insert_range(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> items) {
+    insert(items.begin(), items.end());
+  }
+
+  /**
+   * @brief Удаляет элемент переданный в итераторе.
+   * @param pos Итератор этого контейнера.
+   * @note Итераторы и ссылки на остальные элементы остаются
+   * действительными.
+   */
+  void erase(iterator pos) {
+    if (table.owns(pos)) table.erase(pos);
+  }
+
+  /**
+   * @brief Удаляет элемент по ключу.
+   * @return Количество удаленных элементов (0 или 1).
+   */
+  size_type erase(const key_type& key) { return table.erase_key(key); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual> &&
+             (!std::convertible_to<const KT&, iterator>)
+  size_type erase(const KT& key) {
+    return table.erase_key(key);
+  }
+
+  void swap(unordered_set& other) noexcept {
+    if (this != &other) table.swap(other.table);
+  }
+
+  /**
+   * @brief Перемещает в множество элементы other, ключей которых ещё нет.
+   * Остальные элементы остаются в other.
+   */
+  void merge(unordered_set& other) { table.merge(other.table); }
+
+  iterator find(const Key& key) const { return table.find(key); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  iterator find(const KT& key) const {
+    return table.find(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  bool contains(const KT& key) const {
+    return find(key) != end();
+  }
+
+  size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  template <typename KT>
+    requires transparent_hash<Hash, KeyEqual>
+  size_type count(const KT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  /**
+   * @brief Вставляет несколько уникальных элементов за одну операцию.
+   * @return Пары итератор на элемент и флаг была ли выполнена вставка.
+   * @throws При исключении вставленные элементы удаляются.
+   */
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    return table.template insert_many<iterator>(std::forward<Args>(args)...);
+  }
+};  // class unordered_set
+
+namespace pmr {
+/**
+ * @brief unordered_set, выделяющий массивы из std::pmr::memory_resource.
+ */
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using unordered_set = s21::unordered_set<Key, Hash, KeyEqual,
+                                         std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_UNORDERED_SET_H
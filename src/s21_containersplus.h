@@ -2,6 +2,23 @@
 #define S21_CONTAINERSPLUS_H
 
 // #include "lib/s21_array.h"
+#include "lib/s21_btree_map.h"
+#include "lib/s21_btree_multiset.h"
+#include "lib/s21_btree_set.h"
+#include "lib/s21_compressed_multiset.h"
+#include "lib/s21_concurrent_allocator.h"
+#include "lib/s21_concurrent_map.h"
+#include "lib/s21_cow_map.h"
+#include "lib/s21_cow_set.h"
+#include "lib/s21_flat_map.h"
+#include "lib/s21_flat_multiset.h"
+#include "lib/s21_flat_set.h"
+#include "lib/s21_memory_resource.h"
 #include "lib/s21_multiset.h"
+#include "lib/s21_persistent_map.h"
+#include "lib/s21_persistent_set.h"
+#include "lib/s21_reclaimer.h"
+#include "lib/s21_unordered_map.h"
+#include "lib/s21_unordered_set.h"
 
 #endif  // S21_CONTAINERSPLUS_H
\ No newline at end of file
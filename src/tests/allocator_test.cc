@@ -147,3 +147,249 @@ TEST(PoolAllocatorTest, RebindDifferentChunkSize) {
   double* ptr = double_alloc.allocate(2);
   double_alloc.deallocate(ptr, 2);
 }
+
+TEST(PoolAllocatorMoveTest, MoveKeepsNodes) {
+  using PoolSet = s21::set<int, std::less<int>, s21::pool_allocator<int>>;
+  static_assert(std::is_nothrow_move_constructible_v<PoolSet>);
+
+  PoolSet source;
+  for (int i = 0; i < 100; ++i) source.insert(i);
+
+  // Блоки переходят вместе с нодами, источник можно уничтожить.
+  PoolSet moved;
+  {
+    PoolSet temp(std::move(source));
+    EXPECT_TRUE(source.empty());
+    moved = std::move(temp);
+  }
+  EXPECT_EQ(moved.size(), 100);
+  EXPECT_EQ(*moved.begin(), 0);
+  EXPECT_EQ(*moved.find(99), 99);
+
+  source.insert(7);
+  source.swap(moved);
+  EXPECT_EQ(source.size(), 100);
+  EXPECT_EQ(moved.size(), 1);
+  moved.insert(8);
+  EXPECT_EQ(*moved.find(8), 8);
+}
+
+TEST(PoolAllocatorReleaseTest, ReleaseEmptyChunks) {
+  // Фрагменты по 100, 200, 400, 800 и 1600 элементов.
+  s21::pool_allocator<long> alloc(100);
+  std::vector<long*> blocks;
+  for (int i = 0; i < 3000; ++i) {
+    blocks.push_back(alloc.allocate(1));
+    *blocks.back() = i;
+  }
+  EXPECT_EQ(alloc.release(), 0);
+
+  // Оставляем первый и последний элементы, средние фрагменты пустеют.
+  for (int i = 1; i < 2999; ++i) alloc.deallocate(blocks[i], 1);
+  EXPECT_EQ(alloc.release(), (200 + 400 + 800) * sizeof(long));
+  EXPECT_EQ(alloc.release(), 0);
+  EXPECT_EQ(*blocks[0], 0);
+  EXPECT_EQ(*blocks[2999], 2999);
+
+  long* reused = alloc.allocate(1);
+  *reused = 42;
+  EXPECT_EQ(*reused, 42);
+  alloc.deallocate(reused, 1);
+  alloc.deallocate(blocks[0], 1);
+  alloc.deallocate(blocks[2999], 1);
+  EXPECT_EQ(alloc.release(), (100 + 1600) * sizeof(long));
+}
+
+TEST(PoolAllocatorReleaseTest, AutomaticTrim) {
+  s21::pool_allocator<long> manual(64);
+  s21::pool_allocator<long> automatic(64, 64 * 16 * sizeof(long));
+  EXPECT_EQ(automatic.trim_threshold(), 64 * 16 * sizeof(long));
+  for (auto* alloc : {&manual, &automatic}) {
+    std::vector<long*> blocks;
+    for (int i = 0; i < 64 * 64; ++i) blocks.push_back(alloc->allocate(1));
+    for (long* block : blocks) alloc->deallocate(block, 1);
+  }
+  // Фрагменты от 64 до 4096 элементов, автоматический режим уже вернул
+  // часть из них.
+  EXPECT_EQ(manual.release(), (64 * 128 - 64) * sizeof(long));
+  EXPECT_LT(automatic.release(), (64 * 128 - 64) * sizeof(long));
+
+  automatic.set_trim_threshold(0);
+  EXPECT_EQ(automatic.trim_threshold(), 0);
+}
+
+// Порог автоматического освобождения не растет после фрагментированных
+// всплесков.
+TEST(PoolAllocatorReleaseTest, AutomaticTrimAfterFragmentedSpikes) {
+  // Фрагменты по 64, 128, ..., 2048 элементов, порог — 64 ячейки.
+  s21::pool_allocator<long> alloc(64, 64 * sizeof(long));
+  constexpr int total = 64 * 63;
+  std::vector<long*> blocks;
+  for (int i = 0; i < total; ++i) blocks.push_back(alloc.allocate(1));
+
+  // Первый всплеск: в каждом фрагменте остается занятая ячейка, release()
+  // ничего не освобождает.
+  std::vector<long*> pinned;
+  for (int i = 0, chunk = 64; i < total; i += chunk, chunk *= 2) {
+    pinned.push_back(blocks[i]);
+  }
+  for (long* block : blocks) {
+    if (std::find(pinned.begin(), pinned.end(), block) == pinned.end()) {
+      alloc.deallocate(block, 1);
+    }
+  }
+  EXPECT_EQ(alloc.stats().chunk_count, 6);
+
+  // Второй всплеск снова занимает все ячейки, затем все освобождаются.
+  blocks.clear();
+  for (int i = 0; i < total - 6; ++i) blocks.push_back(alloc.allocate(1));
+  EXPECT_EQ(alloc.stats().chunk_count, 6);
+  // Свободный список LIFO: в обратном порядке первыми пустеют малые
+  // фрагменты.
+  for (long* block : pinned) alloc.deallocate(block, 1);
+  std::reverse(blocks.begin(), blocks.end());
+  for (long* block : blocks) alloc.deallocate(block, 1);
+
+  // Фрагменты вернулись системе автоматически.
+  EXPECT_LT(alloc.stats().chunk_count, 6);
+  EXPECT_LT(alloc.release(), total * sizeof(long));
+}
+
+// Фрагменты растут вдвое, ячейки выдаются подряд.
+TEST(PoolAllocatorGrowthTest, GeometricChunks) {
+  s21::pool_allocator<long> alloc(16);
+  std::vector<long*> blocks;
+  for (int i = 0; i < 16 + 32 + 64; ++i) blocks.push_back(alloc.allocate(1));
+  for (int i = 1; i < 16; ++i) EXPECT_EQ(blocks[i], blocks[i - 1] + 1);
+  for (int i = 17; i < 48; ++i) EXPECT_EQ(blocks[i], blocks[i - 1] + 1);
+  for (int i = 49; i < 112; ++i) EXPECT_EQ(blocks[i], blocks[i - 1] + 1);
+
+  // Освободившиеся ячейки используются раньше новых.
+  alloc.deallocate(blocks[5], 1);
+  EXPECT_EQ(alloc.allocate(1), blocks[5]);
+  for (long* block : blocks) alloc.deallocate(block, 1);
+  EXPECT_EQ(alloc.release(), (16 + 32 + 64) * sizeof(long));
+}
+
+TEST(PoolAllocatorGrowthTest, HugePageChunks) {
+  using Alloc = s21::pool_allocator<long>;
+  Alloc alloc(Alloc::huge_page_size / sizeof(long), 0, true);
+  EXPECT_TRUE(alloc.huge_pages());
+  EXPECT_FALSE(Alloc().huge_pages());
+
+  long* first = alloc.allocate(1);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % Alloc::huge_page_size,
+            0);
+  *first = 1;
+
+  Alloc copy(alloc);
+  EXPECT_TRUE(copy.huge_pages());
+  alloc.deallocate(first, 1);
+  EXPECT_EQ(alloc.release(), Alloc::huge_page_size);
+}
+
+TEST(PoolAllocatorReleaseTest, MapShrinkToFit) {
+  s21::map<int, int, std::less<int>,
+           s21::pool_allocator<std::pair<const int, int>>>
+      m;
+  for (int i = 0; i < 10000; ++i) m.insert({i, i * 2});
+  for (int i = 0; i < 10000; ++i) {
+    if (i % 100 != 0) m.erase(i);
+  }
+  m.shrink_to_fit();
+  EXPECT_EQ(m.size(), 100);
+  for (int i = 0; i < 10000; i += 100) EXPECT_EQ(m.at(i), i * 2);
+  for (int i = 1; i < 1000; i += 100) m.insert({i, i});
+  EXPECT_EQ(m.size(), 110);
+  EXPECT_TRUE(std::is_sorted(
+      m.begin(), m.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; }));
+
+  s21::set<int> plain{1, 2, 3};
+  plain.shrink_to_fit();
+  EXPECT_EQ(plain.size(), 3);
+}
+
+// Тривиально уничтожаемые значения: clear возвращает все блоки пула разом.
+TEST(PoolAllocatorReleaseTest, ClearReleasesAllChunks) {
+  s21::set<int, std::less<int>, s21::pool_allocator<int>> s;
+  for (int i = 0; i < 10000; ++i) s.insert(i);
+  EXPECT_GT(s.memory_usage().overhead_bytes, 0);
+  s.clear();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.begin(), s.end());
+  s21::memory_usage_info usage = s.memory_usage();
+  EXPECT_EQ(usage.node_bytes, 0);
+  EXPECT_LT(usage.overhead_bytes, 1024);
+
+  for (int i = 0; i < 100; ++i) s.insert(99 - i);
+  EXPECT_EQ(s.size(), 100);
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+  EXPECT_TRUE(s.contains(42));
+}
+
+// Значения с деструктором по-прежнему удаляются по одной ноде.
+TEST(PoolAllocatorReleaseTest, ClearDestroysNonTrivialValues) {
+  s21::set<std::string, std::less<std::string>,
+           s21::pool_allocator<std::string>>
+      s;
+  for (int i = 0; i < 1000; ++i) {
+    s.insert(std::string(64, 'a') + std::to_string(i));
+  }
+  const std::size_t reserved = s.memory_usage().total();
+  s.clear();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.memory_usage().total(), reserved);
+  s.insert(std::string(64, 'b'));
+  EXPECT_EQ(s.size(), 1);
+}
+
+TEST(PoolAllocatorStatsTest, Stats) {
+  s21::pool_allocator<long> alloc(100);
+  s21::pool_stats empty = alloc.stats();
+  EXPECT_EQ(empty.bytes_reserved, 0);
+  EXPECT_EQ(empty.chunk_count, 0);
+  EXPECT_EQ(empty.high_water_mark, 0);
+
+  std::vector<long*> blocks;
+  for (int i = 0; i < 250; ++i) blocks.push_back(alloc.allocate(1));
+  s21::pool_stats full = alloc.stats();
+  EXPECT_EQ(full.chunk_count, 2);
+  EXPECT_EQ(full.bytes_reserved, (100 + 200) * sizeof(long));
+  EXPECT_EQ(full.bytes_in_use, 250 * sizeof(long));
+  EXPECT_EQ(full.free_list_length, 0);
+  EXPECT_EQ(full.high_water_mark, 250 * sizeof(long));
+  EXPECT_GE(full.bytes_bookkeeping, 2 * sizeof(void*));
+
+  for (int i = 0; i < 200; ++i) alloc.deallocate(blocks[i], 1);
+  s21::pool_stats drained = alloc.stats();
+  EXPECT_EQ(drained.bytes_in_use, 50 * sizeof(long));
+  EXPECT_EQ(drained.free_list_length, 200);
+  EXPECT_EQ(drained.high_water_mark, 250 * sizeof(long));
+
+  alloc.release();
+  s21::pool_stats released = alloc.stats();
+  EXPECT_EQ(released.chunk_count, 1);
+  EXPECT_EQ(released.bytes_reserved, 200 * sizeof(long));
+  EXPECT_EQ(released.free_list_length, 100);
+  for (int i = 200; i < 250; ++i) alloc.deallocate(blocks[i], 1);
+  EXPECT_EQ(alloc.stats().bytes_in_use, 0);
+}
+
+TEST(PoolAllocatorStatsTest, ReleaseAll) {
+  s21::pool_allocator<long> alloc(100);
+  for (int i = 0; i < 250; ++i) EXPECT_NE(alloc.allocate(1), nullptr);
+  alloc.release_all();
+  s21::pool_stats released = alloc.stats();
+  EXPECT_EQ(released.chunk_count, 0);
+  EXPECT_EQ(released.bytes_reserved, 0);
+  EXPECT_EQ(released.bytes_in_use, 0);
+  EXPECT_EQ(released.free_list_length, 0);
+  EXPECT_EQ(released.high_water_mark, 250 * sizeof(long));
+
+  // Рост фрагментов начинается заново.
+  long* p = alloc.allocate(1);
+  *p = 7;
+  EXPECT_EQ(alloc.stats().bytes_reserved, 100 * sizeof(long));
+  alloc.deallocate(p, 1);
+}
@@ -0,0 +1,418 @@
+#include <random>
+
+#include "testing.h"
+
+namespace {
+
+// Маленькие ноды по 4 значения дают глубокое дерево уже на сотнях элементов.
+template <typename Key>
+using small_btree_set =
+    s21::btree_set<Key, std::less<Key>, std::allocator<Key>, 32>;
+
+template <typename Key>
+using small_btree_multiset =
+    s21::btree_multiset<Key, std::less<Key>, std::allocator<Key>, 32>;
+
+// Сравнивает содержимое с эталонным контейнером в обоих направлениях обхода.
+template <typename Container, typename Expected>
+void ExpectSameElements(const Container& actual, const Expected& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin(),
+                         actual.end()));
+  EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(),
+                         std::make_reverse_iterator(actual.end()),
+                         std::make_reverse_iterator(actual.begin())));
+}
+
+// Ключ с номером вставки: равные ключи различимы.
+struct Tagged {
+  int key;
+  int tag;
+  bool operator<(const Tagged& other) const { return key < other.key; }
+  bool operator==(const Tagged& other) const {
+    return key == other.key && tag == other.tag;
+  }
+};
+
+// Ключ, копирование которого бросает исключение: B-дерево должно только
+// перемещать ключи.
+struct NoCopyKey {
+  std::string name;
+
+  explicit NoCopyKey(std::string s) : name(std::move(s)) {}
+  NoCopyKey(const NoCopyKey&) { throw std::runtime_error("copy"); }
+  NoCopyKey(NoCopyKey&&) noexcept = default;
+  NoCopyKey& operator=(NoCopyKey&&) noexcept = default;
+  bool operator<(const NoCopyKey& other) const { return name < other.name; }
+};
+
+// Оставшееся количество выделений LimitedAllocator, -1 — без ограничения.
+int allocation_budget = -1;
+
+// Аллокатор, бросающий std::bad_alloc, когда закончится бюджет выделений.
+template <typename T>
+struct LimitedAllocator {
+  using value_type = T;
+
+  LimitedAllocator() = default;
+  template <typename U>
+  LimitedAllocator(const LimitedAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (allocation_budget == 0) throw std::bad_alloc();
+    if (allocation_budget > 0) --allocation_budget;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    std::allocator<T>().deallocate(p, n);
+  }
+  bool operator==(const LimitedAllocator&) const noexcept { return true; }
+};
+
+}  // namespace
+
+TEST(BtreeSetTest, Basic) {
+  s21::btree_set<int> set = {5, 1, 4, 1, 3};
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_TRUE(set.contains(4));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_EQ(*set.lower_bound(2), 3);
+  EXPECT_EQ(*set.upper_bound(4), 5);
+  EXPECT_EQ(set.upper_bound(5), set.end());
+
+  auto [it, inserted] = set.insert(2);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(*it, 2);
+  EXPECT_FALSE(set.insert(2).second);
+  EXPECT_EQ(set.erase(1), 1);
+  EXPECT_EQ(set.erase(1), 0);
+  set.erase(set.find(5));
+  ExpectSameElements(set, std::set<int>{2, 3, 4});
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.begin(), set.end());
+}
+
+// Случайные вставки и удаления на глубоком дереве совпадают с std::set.
+TEST(BtreeSetTest, RandomOperations) {
+  std::mt19937 gen(18);
+  std::uniform_int_distribution<int> key(0, 2000);
+  small_btree_set<int> set;
+  std::set<int> expected;
+
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 3000; ++i) {
+      const int k = key(gen);
+      EXPECT_EQ(set.insert(k).second, expected.insert(k).second);
+    }
+    ExpectSameElements(set, expected);
+    // Удалений больше, чем вставок: ноды сливаются до одного листа.
+    for (int i = 0; i < 4000; ++i) {
+      const int k = key(gen);
+      EXPECT_EQ(set.erase(k), expected.erase(k));
+      if (i % 7 == 0 && !set.empty()) {
+        auto it = set.lower_bound(k);
+        if (it == set.end()) --it;
+        const int value = *it;
+        set.erase(it);
+        expected.erase(value);
+      }
+    }
+    ExpectSameElements(set, expected);
+    for (int k = 0; k <= 2000; k += 13) {
+      EXPECT_EQ(set.contains(k), expected.contains(k));
+      auto lower = set.lower_bound(k);
+      auto expected_lower = expected.lower_bound(k);
+      EXPECT_EQ(lower == set.end(), expected_lower == expected.end());
+      if (lower != set.end()) {
+        EXPECT_EQ(*lower, *expected_lower);
+      }
+    }
+  }
+  while (!set.empty()) set.erase(set.begin());
+  EXPECT_EQ(set.memory_usage().node_bytes, 0);
+}
+
+// Упорядоченная вставка с подсказкой end() заполняет ноды целиком.
+TEST(BtreeSetTest, Hints) {
+  small_btree_set<int> set;
+  for (int i = 0; i < 1000; i += 2) set.insert(set.end(), i);
+  for (int i = 1; i < 1000; i += 2) {
+    auto it = set.insert(set.lower_bound(i), i);
+    EXPECT_EQ(*it, i);
+  }
+  EXPECT_EQ(*set.insert(set.begin(), 500), 500);
+  EXPECT_EQ(*set.emplace_hint(set.end(), 1000), 1000);
+
+  std::vector<int> values(1001);
+  std::iota(values.begin(), values.end(), 0);
+  ExpectSameElements(set, values);
+
+  s21::btree_set<int> sorted(s21::sorted_range, values.begin(), values.end());
+  std::vector<int> shuffled = values;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(18));
+  s21::btree_set<int> unsorted(shuffled.begin(), shuffled.end());
+  ExpectSameElements(sorted, values);
+  ExpectSameElements(unsorted, values);
+  EXPECT_LT(sorted.memory_usage().node_bytes,
+            unsorted.memory_usage().node_bytes);
+}
+
+TEST(BtreeSetTest, CopyMoveSwapMerge) {
+  small_btree_set<std::string> set;
+  for (int i = 0; i < 300; ++i) set.insert(std::to_string(i));
+
+  small_btree_set<std::string> copy(set);
+  ExpectSameElements(copy, std::set<std::string>(set.begin(), set.end()));
+  small_btree_set<std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(moved.size(), 300);
+  copy = moved;
+  moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 300);
+
+  small_btree_set<std::string> other = {"1", "a", "b"};
+  other.swap(moved);
+  EXPECT_EQ(moved.size(), 3);
+  EXPECT_EQ(other.size(), 300);
+
+  other.merge(moved);
+  EXPECT_EQ(other.size(), 302);
+  ExpectSameElements(moved, std::set<std::string>{"1"});
+
+  auto res = other.insert_many(std::string("c"), "0", "d");
+  ASSERT_EQ(res.size(), 3);
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+  EXPECT_EQ(*res[1].first, "0");
+  EXPECT_EQ(*res[2].first, "d");
+  EXPECT_EQ(other.size(), 304);
+
+  std::vector<std::string> sorted = {"x", "y", "z"};
+  other.assign_sorted(sorted.begin(), sorted.end());
+  ExpectSameElements(other, sorted);
+}
+
+// Равные ключи хранятся в порядке вставки, как в std::multiset.
+TEST(BtreeMultisetTest, RandomOperations) {
+  std::mt19937 gen(180);
+  std::uniform_int_distribution<int> key(0, 60);
+  small_btree_multiset<Tagged> mset;
+  std::multiset<Tagged> expected;
+
+  for (int i = 0; i < 5000; ++i) {
+    const Tagged value{key(gen), i};
+    if (i % 3 == 2) {
+      mset.erase(Tagged{value.key, 0});
+      auto it = expected.find(Tagged{value.key, 0});
+      if (it != expected.end()) expected.erase(it);
+    } else if (i % 5 == 0) {
+      mset.insert(mset.upper_bound(value), value);
+      expected.insert(expected.upper_bound(value), value);
+    } else {
+      mset.insert(value);
+      expected.insert(value);
+    }
+  }
+  ExpectSameElements(mset, expected);
+  for (int k = 0; k <= 60; ++k) {
+    EXPECT_EQ(mset.count(Tagged{k, 0}), expected.count(Tagged{k, 0}));
+  }
+
+  auto range = mset.equal_range(Tagged{30, 0});
+  auto expected_range = expected.equal_range(Tagged{30, 0});
+  EXPECT_TRUE(std::equal(range.first, range.second, expected_range.first,
+                         expected_range.second));
+}
+
+TEST(BtreeMultisetTest, MergeAndInsertMany) {
+  s21::btree_multiset<int> mset = {1, 2, 2};
+  s21::btree_multiset<int> other = {2, 3};
+  mset.merge(other);
+  EXPECT_TRUE(other.empty());
+  ExpectSameElements(mset, std::multiset<int>{1, 2, 2, 2, 3});
+
+  auto res = mset.insert_many(3, 3, 4);
+  EXPECT_EQ(res.size(), 3);
+  EXPECT_TRUE(res[1].second);
+  EXPECT_EQ(*res[2].first, 4);
+  EXPECT_EQ(mset.count(3), 3);
+  EXPECT_EQ(mset.erase(2), 1);
+  EXPECT_EQ(mset.count(2), 2);
+}
+
+TEST(BtreeMapTest, Basic) {
+  s21::btree_map<int, std::string> map = {{2, "two"}, {1, "one"}};
+  map[3] = "three";
+  EXPECT_EQ(map.at(2), "two");
+  EXPECT_THROW(map.at(4), std::out_of_range);
+  EXPECT_FALSE(map.insert({1, "uno"}).second);
+  EXPECT_FALSE(map.try_emplace(2, "dos").second);
+  EXPECT_FALSE(map.insert_or_assign(3, "tres").second);
+  EXPECT_TRUE(map.insert(4, "four").second);
+  EXPECT_EQ(map.try_emplace(map.end(), 5, "five")->second, "five");
+
+  std::map<int, std::string> expected = {
+      {1, "one"}, {2, "two"}, {3, "tres"}, {4, "four"}, {5, "five"}};
+  ExpectSameElements(map, expected);
+
+  for (auto& [key, value] : map) value += "!";
+  EXPECT_EQ(map.find(4)->second, "four!");
+  map.erase(map.find(1));
+  EXPECT_EQ(map.erase(5), 1);
+  EXPECT_EQ(map.begin()->first, 2);
+  EXPECT_EQ(std::prev(map.end())->first, 4);
+}
+
+// Значения с нетривиальным перемещением переносятся между нодами без утечек.
+TEST(BtreeMapTest, RandomOperations) {
+  std::mt19937 gen(1800);
+  std::uniform_int_distribution<int> key(0, 3000);
+  s21::btree_map<int, std::string, std::less<int>,
+                 std::allocator<std::pair<const int, std::string>>, 64>
+      map;
+  std::map<int, std::string> expected;
+
+  for (int i = 0; i < 20000; ++i) {
+    const int k = key(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(map.erase(k), expected.erase(k));
+    } else {
+      std::string value = std::to_string(i) + std::string(20, 'x');
+      map.insert_or_assign(k, value);
+      expected.insert_or_assign(k, value);
+    }
+  }
+  ExpectSameElements(map, expected);
+
+  auto copy = map;
+  for (int k = 0; k < 3000; k += 2) copy.erase(k);
+  EXPECT_EQ(map.size(), expected.size());
+  for (const auto& [k, value] : copy) EXPECT_EQ(expected.at(k), value);
+}
+
+// Строковые ключи перемещаются между нодами, а не копируются.
+TEST(BtreeMapTest, StringKeys) {
+  std::mt19937 gen(1801);
+  std::uniform_int_distribution<int> key(0, 2000);
+  s21::btree_map<std::string, int, std::less<>,
+                 std::allocator<std::pair<const std::string, int>>, 128>
+      map;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 10000; ++i) {
+    const std::string k = "key-" + std::to_string(key(gen));
+    if (i % 3 == 0) {
+      EXPECT_EQ(map.erase(k), expected.erase(k));
+    } else {
+      map[k] = i;
+      expected[k] = i;
+    }
+  }
+  ExpectSameElements(map, expected);
+  EXPECT_TRUE(map.contains(std::string_view(expected.begin()->first)));
+
+  s21::btree_map<NoCopyKey, int, std::less<NoCopyKey>,
+                 std::allocator<std::pair<const NoCopyKey, int>>, 64>
+      no_copy;
+  for (int i = 0; i < 500; ++i) {
+    no_copy.try_emplace(NoCopyKey(std::to_string(i * 7919 % 500)), i);
+  }
+  for (int i = 0; i < 500; i += 2) {
+    EXPECT_EQ(no_copy.erase(NoCopyKey(std::to_string(i))), 1);
+  }
+  EXPECT_EQ(no_copy.size(), 250);
+  EXPECT_TRUE(std::is_sorted(
+      no_copy.begin(), no_copy.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }));
+
+  decltype(no_copy) target;
+  target.try_emplace(NoCopyKey("1"), -1);
+  target.merge(no_copy);
+  EXPECT_EQ(target.size(), 250);
+  EXPECT_EQ(no_copy.size(), 1);
+  EXPECT_EQ(target.find(NoCopyKey("1"))->second, -1);
+}
+
+// Исключение при слиянии не оставляет в other перемещенных оболочек.
+TEST(BtreeSetTest, MergeException) {
+  using Set = s21::btree_set<std::string, std::less<std::string>,
+                             LimitedAllocator<std::string>, 64>;
+  Set target;
+  Set source;
+  std::set<std::string> all;
+  for (int i = 0; i < 400; ++i) {
+    const std::string value = std::string(24, 'v') + std::to_string(i);
+    (i % 2 == 0 ? target : source).insert(value);
+    if (i % 10 == 0) source.insert(value);
+    all.insert(value);
+  }
+
+  allocation_budget = 10;
+  EXPECT_THROW(target.merge(source), std::bad_alloc);
+  allocation_budget = -1;
+
+  EXPECT_GT(source.size(), 40);
+  EXPECT_GT(target.size(), 200);
+  EXPECT_TRUE(std::is_sorted(target.begin(), target.end()));
+  EXPECT_TRUE(std::is_sorted(source.begin(), source.end()));
+  std::set<std::string> merged(target.begin(), target.end());
+  for (const std::string& value : source) {
+    EXPECT_FALSE(value.empty());
+    if (!merged.insert(value).second) {
+      EXPECT_EQ(value.back(), '0');
+    }
+  }
+  EXPECT_EQ(merged, all);
+
+  target.merge(source);
+  EXPECT_EQ(target.size(), 400);
+  EXPECT_EQ(source.size(), 40);
+}
+
+TEST(BtreeAllocatorTest, PoolAllocator) {
+  s21::btree_set<int, std::less<int>, s21::pool_allocator<int>> set;
+  for (int i = 0; i < 10000; ++i) set.insert(i * 7 % 10000);
+  for (int i = 0; i < 10000; i += 2) set.erase(i);
+  EXPECT_EQ(set.size(), 5000);
+
+  auto copy = set;
+  ExpectSameElements(copy, std::set<int>(set.begin(), set.end()));
+  set.clear();
+  set.shrink_to_fit();
+  EXPECT_EQ(set.memory_usage().node_bytes, 0);
+  set = std::move(copy);
+  EXPECT_EQ(*set.begin(), 1);
+}
+
+TEST(BtreeAllocatorTest, MemoryResources) {
+  s21::pmr::pool_resource first;
+  s21::pmr::pool_resource second;
+  s21::pmr::btree_map<int, int> map(&first);
+  for (int i = 0; i < 1000; ++i) map[i] = i * i;
+
+  // Разные ресурсы: значения перемещаются в ноды второго ресурса.
+  s21::pmr::btree_map<int, int> moved(std::move(map), &second);
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(moved.size(), 1000);
+  EXPECT_EQ(moved.at(31), 961);
+  EXPECT_EQ(moved.get_allocator().resource(), &second);
+
+  s21::pmr::btree_map<int, int> same(std::move(moved), &second);
+  EXPECT_EQ(same.size(), 1000);
+
+  std::pmr::monotonic_buffer_resource arena;
+  s21::pmr::btree_multiset<int> mset(&arena);
+  for (int i = 0; i < 1000; ++i) mset.insert(i % 10);
+  EXPECT_EQ(mset.count(3), 100);
+}
+
+// В ноде помещается много ключей, поэтому на элемент уходит меньше памяти,
+// чем на ноду красно-черного дерева.
+TEST(BtreeAllocatorTest, MemoryUsage) {
+  std::vector<int> values(10000);
+  std::iota(values.begin(), values.end(), 0);
+  s21::btree_set<int> btree(values.begin(), values.end());
+  s21::set<int> rb_tree(values.begin(), values.end());
+  EXPECT_LT(btree.memory_usage().total() * 3, rb_tree.memory_usage().total());
+}
@@ -9,7 +9,12 @@
  */
 
 #include <chrono>
+#include <memory>
+#include <numeric>
 #include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_set>
 
 #include "testing.h"  // ваш класс set
 
@@ -122,3 +127,759 @@ TEST_F(PerformanceTest, MergePerformance) {
   std::cout << "Merge: s21_set = " << s21_duration
             << " ms, std::set = " << std_duration << " ms\n";
 }
+
+TEST_F(PerformanceTest, HintedInsertPerformance) {
+  std::vector<int> ascending(kNumElements);
+  for (size_t i = 0; i < kNumElements; ++i) ascending[i] = static_cast<int>(i);
+  std::vector<int> descending(ascending.rbegin(), ascending.rend());
+  // Почти упорядоченные данные: перемешивание внутри блоков по 8 элементов.
+  std::vector<int> local_shuffle = ascending;
+  std::mt19937 gen(std::random_device{}());
+  for (size_t i = 0; i + 8 <= kNumElements; i += 8) {
+    std::shuffle(local_shuffle.begin() + i, local_shuffle.begin() + i + 8, gen);
+  }
+
+  auto measure = [](auto action) {
+    auto start = high_resolution_clock::now();
+    action();
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  for (const auto& [name, values] :
+       {std::pair{"ascending", &ascending},
+        std::pair{"descending", &descending},
+        std::pair{"local shuffle", &local_shuffle}}) {
+    auto plain = measure([&values] {
+      Set_type s;
+      for (int v : *values) s.insert(v);
+    });
+    // Подсказкой служит последний вставленный элемент.
+    auto hinted = measure([&values] {
+      Set_type s;
+      auto hint = s.end();
+      for (int v : *values) hint = s.insert(hint, v);
+    });
+    auto std_hinted = measure([&values] {
+      Std_set_type s;
+      auto hint = s.end();
+      for (int v : *values) hint = s.insert(hint, v);
+    });
+    std::cout << "Insert " << name << ": s21_set = " << plain
+              << " ms, s21_set with hint = " << hinted
+              << " ms, std::set with hint = " << std_hinted << " ms\n";
+  }
+}
+
+TEST_F(PerformanceTest, SetAlgebraPerformance) {
+  auto values1 = GenerateRandomValues(kNumElements);
+  auto values2 = GenerateRandomValues(kNumElements);
+  const Set_type s21_set1(values1.begin(), values1.end());
+  const Set_type s21_set2(values2.begin(), values2.end());
+  const std::set<int> std_set1(values1.begin(), values1.end());
+  const std::set<int> std_set2(values2.begin(), values2.end());
+
+  auto measure = [](auto action) {
+    auto start = high_resolution_clock::now();
+    action();
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  // Копии создаются вне замера, операции получают их через std::move.
+  auto s21_op = [&](auto op) {
+    Set_type lhs(s21_set1);
+    Set_type rhs(s21_set2);
+    return measure([&] { op(std::move(lhs), std::move(rhs)); });
+  };
+  // Для std::set результат строится стандартными алгоритмами.
+  auto std_op = [&](auto algorithm) {
+    return measure([&] {
+      std::set<int> result;
+      algorithm(std_set1.begin(), std_set1.end(), std_set2.begin(),
+                std_set2.end(), std::inserter(result, result.end()));
+    });
+  };
+
+  std::cout << "Union: s21_set = "
+            << s21_op([](Set_type a, Set_type b) {
+                 set_union(std::move(a), std::move(b));
+               })
+            << " ms, s21_set parallel = "
+            << s21_op([](Set_type a, Set_type b) {
+                 set_union(s21::execution::par, std::move(a), std::move(b));
+               })
+            << " ms, std::set_union = "
+            << std_op([](auto... args) { std::set_union(args...); })
+            << " ms\n";
+  std::cout << "Intersection: s21_set = "
+            << s21_op([](Set_type a, const Set_type& b) {
+                 set_intersection(std::move(a), b);
+               })
+            << " ms, s21_set parallel = "
+            << s21_op([](Set_type a, const Set_type& b) {
+                 set_intersection(s21::execution::par, std::move(a), b);
+               })
+            << " ms, std::set_intersection = "
+            << std_op([](auto... args) { std::set_intersection(args...); })
+            << " ms\n";
+  std::cout << "Difference: s21_set = "
+            << s21_op([](Set_type a, const Set_type& b) {
+                 set_difference(std::move(a), b);
+               })
+            << " ms, s21_set parallel = "
+            << s21_op([](Set_type a, const Set_type& b) {
+                 set_difference(s21::execution::par, std::move(a), b);
+               })
+            << " ms, std::set_difference = "
+            << std_op([](auto... args) { std::set_difference(args...); })
+            << " ms\n";
+}
+
+TEST_F(PerformanceTest, CountDuplicatesPerformance) {
+  using Multiset_type = s21::multiset<int, std::less<int>, std::allocator<int>>;
+  using Ranked_multiset_type =
+      s21::multiset<int, std::less<int>, std::allocator<int>, s21::Sized_node>;
+  // Один ключ повторяется во всех элементах, кроме каждого сотого.
+  std::vector<int> values(kNumElements);
+  for (size_t i = 0; i < kNumElements; ++i) {
+    values[i] = i % 100 == 0 ? static_cast<int>(i) : 42;
+  }
+  Multiset_type plain(values.begin(), values.end());
+  Ranked_multiset_type ranked(values.begin(), values.end());
+  std::multiset<int> std_multiset(values.begin(), values.end());
+  constexpr int kQueries = 100;
+
+  auto measure = [](auto& container) {
+    size_t total = 0;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < kQueries; ++i) total += container.count(42);
+    auto end = high_resolution_clock::now();
+    EXPECT_EQ(total, kQueries * (kNumElements - kNumElements / 100));
+    return duration_cast<microseconds>(end - start).count();
+  };
+
+  std::cout << "Count " << kQueries << " x duplicates: s21::multiset = "
+            << measure(plain) << " us, with Sized_node = " << measure(ranked)
+            << " us, std::multiset = " << measure(std_multiset) << " us\n";
+}
+
+TEST_F(PerformanceTest, CompressedMultisetPerformance) {
+  // Один ключ повторяется во всех элементах, кроме каждого сотого.
+  std::vector<int> values(kNumElements);
+  for (size_t i = 0; i < kNumElements; ++i) {
+    values[i] = i % 100 == 0 ? static_cast<int>(i) : 42;
+  }
+
+  auto measure = [&values](auto container) {
+    auto start = high_resolution_clock::now();
+    for (int v : values) container.insert(v);
+    auto end = high_resolution_clock::now();
+    EXPECT_EQ(container.size(), kNumElements);
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  s21::compressed_multiset<int> compressed(values.begin(), values.end());
+  std::cout << "Insert duplicates: s21::multiset = "
+            << measure(s21::multiset<int>{}) << " ms, compressed_multiset = "
+            << measure(s21::compressed_multiset<int>{})
+            << " ms, std::multiset = " << measure(std::multiset<int>{})
+            << " ms\nNodes: s21::multiset = " << kNumElements
+            << ", compressed_multiset = " << compressed.distinct_size()
+            << "\n";
+}
+
+TEST_F(PerformanceTest, CompactNodePerformance) {
+  using Compact_set_type = s21::set<int, std::less<int>,
+                                    s21::pool_allocator<int>,
+                                    s21::Compact_node>;
+  using Long_set_type = s21::set<long, std::less<long>, std::allocator<long>>;
+  using Compact_long_set_type =
+      s21::set<long, std::less<long>, std::allocator<long>, s21::Compact_node>;
+  auto values = GenerateRandomValues(kNumElements);
+
+  auto measure = [&values](auto container) {
+    auto start = high_resolution_clock::now();
+    for (int v : values) container.insert(v);
+    size_t sum = 0;
+    for (auto v : container) sum += v;
+    auto end = high_resolution_clock::now();
+    EXPECT_GT(sum, 0);
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  // Байты на элемент — размер ноды, без учета служебных данных аллокатора.
+  std::cout << "Bytes per element: set<int> = "
+            << sizeof(Set_type::tree_node) << ", compact set<int> = "
+            << sizeof(Compact_set_type::tree_node) << ", set<long> = "
+            << sizeof(Long_set_type::tree_node) << ", compact set<long> = "
+            << sizeof(Compact_long_set_type::tree_node)
+            << ", map<int, int> = "
+            << sizeof(s21::Node<std::pair<const int, int>>)
+            << ", compact map<int, int> = "
+            << sizeof(s21::Compact_node<std::pair<const int, int>>) << "\n";
+  std::cout << "Insert and iterate: set<int> = " << measure(Set_type{})
+            << " ms, compact set<int> = " << measure(Compact_set_type{})
+            << " ms, set<long> = " << measure(Long_set_type{})
+            << " ms, compact set<long> = " << measure(Compact_long_set_type{})
+            << " ms\n";
+}
+
+TEST_F(PerformanceTest, ConcurrentAllocatorPerformance) {
+  using Std_alloc_set = s21::set<int, std::less<int>, std::allocator<int>>;
+  using Concurrent_set =
+      s21::set<int, std::less<int>, s21::concurrent_pool_allocator<int>>;
+  constexpr int kThreads = 4;
+  auto values = GenerateRandomValues(kNumElements);
+
+  // Каждый поток многократно заполняет и уничтожает свое множество.
+  auto per_thread = [&values]<typename Set>(Set*) {
+    auto start = high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+      workers.emplace_back([&values] {
+        for (int round = 0; round < 2; ++round) {
+          Set set;
+          for (int v : values) set.insert(v);
+        }
+      });
+    }
+    for (auto& worker : workers) worker.join();
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  // Один поток строит множества, другой их уничтожает.
+  auto cross_thread = [&values]<typename Set>(Set*) {
+    auto start = high_resolution_clock::now();
+    std::vector<Set> built(8);
+    std::thread producer([&] {
+      for (auto& set : built) {
+        for (int v : values) set.insert(v);
+      }
+    });
+    producer.join();
+    std::thread consumer([&] {
+      for (auto& set : built) set.clear();
+    });
+    consumer.join();
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  std::cout << kThreads << " threads: std::allocator = "
+            << per_thread(static_cast<Std_alloc_set*>(nullptr))
+            << " ms, pool_allocator per set = "
+            << per_thread(static_cast<Set_type*>(nullptr))
+            << " ms, concurrent_pool_allocator = "
+            << per_thread(static_cast<Concurrent_set*>(nullptr)) << " ms\n";
+  std::cout << "Cross-thread free: std::allocator = "
+            << cross_thread(static_cast<Std_alloc_set*>(nullptr))
+            << " ms, concurrent_pool_allocator = "
+            << cross_thread(static_cast<Concurrent_set*>(nullptr)) << " ms\n";
+}
+
+TEST_F(PerformanceTest, PoolChunkGrowthPerformance) {
+  using Pool_long_set =
+      s21::set<long, std::less<long>, s21::pool_allocator<long>>;
+  using Std_long_set = s21::set<long, std::less<long>, std::allocator<long>>;
+  constexpr long kLarge = 10 * kNumElements;
+  auto values = GenerateRandomValues(kNumElements);
+
+  // Большое дерево и случайные поиски по нему, где важны промахи TLB.
+  auto measure = [&values](auto&& container) {
+    auto start = high_resolution_clock::now();
+    for (long i = 0; i < kLarge; ++i) container.insert(i * 2);
+    size_t found = 0;
+    for (int round = 0; round < 4; ++round) {
+      for (int v : values) found += container.contains(v * 5L);
+    }
+    auto end = high_resolution_clock::now();
+    EXPECT_GT(found, 0);
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  std::cout << kLarge << " elements: std::allocator = "
+            << measure(Std_long_set{})
+            << " ms, pool_allocator = " << measure(Pool_long_set{})
+            << " ms, pool_allocator with huge pages = "
+            << measure(Pool_long_set(s21::pool_allocator<long>(1024, 0, true)))
+            << " ms\n";
+}
+
+TEST_F(PerformanceTest, MonotonicArenaPerformance) {
+  constexpr int kRequests = 20'000;
+  constexpr int kPerRequest = 64;
+  auto values = GenerateRandomValues(kPerRequest);
+
+  // Каждый запрос строит небольшое дерево и сразу его выбрасывает.
+  auto measure = [&values](auto make_map) {
+    auto start = high_resolution_clock::now();
+    size_t total = 0;
+    for (int request = 0; request < kRequests; ++request) {
+      auto request_map = make_map();
+      for (int v : values) request_map.insert({v, request});
+      total += request_map.size();
+    }
+    auto end = high_resolution_clock::now();
+    EXPECT_GT(total, 0);
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  std::pmr::monotonic_buffer_resource arena;
+  s21::pmr::pool_resource pool;
+  std::cout << kRequests << " requests: std::allocator = "
+            << measure([] { return s21::map<int, int>{}; })
+            << " ms, monotonic arena = " << measure([&arena] {
+                 arena.release();
+                 return s21::pmr::map<int, int>(&arena);
+               })
+            << " ms, pool_resource = "
+            << measure([&pool] { return s21::pmr::map<int, int>(&pool); })
+            << " ms\n";
+}
+
+// Значение с пользовательским деструктором: clear обходит дерево.
+struct Boxed_int {
+  Boxed_int(int v) : value(v) {}
+  ~Boxed_int() {}
+
+  int value;
+  bool operator<(const Boxed_int& other) const { return value < other.value; }
+};
+
+TEST_F(PerformanceTest, TeardownPerformance) {
+  constexpr int kTeardown = 10'000'000;
+  std::vector<int> keys(kTeardown);
+  std::iota(keys.begin(), keys.end(), 0);
+
+  // Время уничтожения множества из kTeardown элементов.
+  auto measure = [&keys](auto* tag) {
+    using Set = std::remove_pointer_t<decltype(tag)>;
+    auto set = std::make_unique<Set>(s21::sorted_range, keys.begin(),
+                                     keys.end());
+    EXPECT_EQ(set->size(), keys.size());
+    auto start = high_resolution_clock::now();
+    set.reset();
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  using Boxed_set = s21::set<Boxed_int, std::less<Boxed_int>,
+                             s21::pool_allocator<Boxed_int>>;
+  std::cout << kTeardown << " elements teardown: std::allocator = "
+            << measure(static_cast<s21::set<int>*>(nullptr))
+            << " ms, pool (walk) = "
+            << measure(static_cast<Boxed_set*>(nullptr))
+            << " ms, pool (bulk release) = "
+            << measure(static_cast<Set_type*>(nullptr)) << " ms\n";
+}
+
+TEST_F(PerformanceTest, NodeHandlePerformance) {
+  using Map = s21::map<int, std::string>;
+  constexpr int kRounds = 20;
+  auto values = GenerateRandomValues(kNumElements / 10);
+
+  // Все записи многократно переходят из pending в active и обратно.
+  auto measure = [&values](auto move_front) {
+    Map pending;
+    Map active;
+    for (int v : values) pending.insert({v, std::string(256, 'x')});
+    const size_t size = pending.size();
+    auto start = high_resolution_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+      while (!pending.empty()) move_front(pending, active);
+      std::swap(pending, active);
+    }
+    auto end = high_resolution_clock::now();
+    EXPECT_EQ(pending.size(), size);
+    return duration_cast<milliseconds>(end - start).count();
+  };
+
+  std::cout << kRounds << " moves of " << kNumElements / 10
+            << " entries: erase + insert = "
+            << measure([](Map& from, Map& to) {
+                 to.insert(to.end(), *from.begin());
+                 from.erase(from.begin());
+               })
+            << " ms, extract + insert = "
+            << measure([](Map& from, Map& to) {
+                 to.insert(to.end(), from.extract(from.begin()));
+               })
+            << " ms\n";
+}
+
+TEST_F(PerformanceTest, BtreePerformance) {
+  using Rb_set = s21::set<std::uint64_t>;
+  using Pool_rb_set = s21::set<std::uint64_t, std::less<std::uint64_t>,
+                               s21::pool_allocator<std::uint64_t>>;
+  using Btree_set = s21::btree_set<std::uint64_t>;
+  constexpr size_t kSize = kNumElements * 4;
+  std::vector<std::uint64_t> values(kSize);
+  std::mt19937_64 gen(std::random_device{}());
+  for (auto& v : values) v = gen();
+  std::vector<std::uint64_t> lookups = values;
+  std::shuffle(lookups.begin(), lookups.end(), gen);
+
+  // Время вставки, поиска, обхода и удаления половины элементов.
+  auto measure = [&](auto container, const char* name) {
+    auto start = high_resolution_clock::now();
+    for (auto v : values) container.insert(v);
+    auto inserted = high_resolution_clock::now();
+    size_t found = 0;
+    for (auto v : lookups) found += container.contains(v);
+    auto searched = high_resolution_clock::now();
+    std::uint64_t sum = 0;
+    for (auto v : container) sum += v;
+    auto iterated = high_resolution_clock::now();
+    for (size_t i = 0; i < kSize / 2; ++i) container.erase(lookups[i]);
+    auto erased = high_resolution_clock::now();
+    EXPECT_EQ(found, kSize);
+    EXPECT_NE(sum, 1);
+    std::cout << name << ": insert = "
+              << duration_cast<milliseconds>(inserted - start).count()
+              << " ms, find = "
+              << duration_cast<milliseconds>(searched - inserted).count()
+              << " ms, iterate = "
+              << duration_cast<milliseconds>(iterated - searched).count()
+              << " ms, erase = "
+              << duration_cast<milliseconds>(erased - iterated).count()
+              << " ms, bytes = " << container.memory_usage().total() << "\n";
+  };
+
+  std::cout << kSize << " uint64_t keys\n";
+  measure(Rb_set{}, "set");
+  measure(Pool_rb_set{}, "set with pool_allocator");
+  measure(Btree_set{}, "btree_set");
+}
+
+TEST_F(PerformanceTest, FlatPerformance) {
+  using Rb_set = s21::set<std::uint64_t>;
+  using Btree_set = s21::btree_set<std::uint64_t>;
+  using Flat_set = s21::flat_set<std::uint64_t>;
+  constexpr size_t kSize = kNumElements * 4;
+  std::vector<std::uint64_t> values(kSize);
+  std::mt19937_64 gen(std::random_device{}());
+  for (auto& v : values) v = gen();
+  std::vector<std::uint64_t> lookups = values;
+  std::shuffle(lookups.begin(), lookups.end(), gen);
+
+  // Таблица строится один раз из диапазона, затем только читается.
+  auto measure = [&]<typename Container>(Container*, const char* name) {
+    auto start = high_resolution_clock::now();
+    Container container(values.begin(), values.end());
+    auto built = high_resolution_clock::now();
+    size_t found = 0;
+    for (int round = 0; round < 4; ++round) {
+      for (auto v : lookups) found += container.contains(v);
+    }
+    auto searched = high_resolution_clock::now();
+    EXPECT_EQ(found, kSize * 4);
+    std::cout << name << ": build = "
+              << duration_cast<milliseconds>(built - start).count()
+              << " ms, find = "
+              << duration_cast<milliseconds>(searched - built).count()
+              << " ms, bytes = " << container.memory_usage().total() << "\n";
+  };
+
+  std::cout << kSize << " uint64_t keys, " << kSize * 4 << " lookups\n";
+  measure(static_cast<Rb_set*>(nullptr), "set");
+  measure(static_cast<Btree_set*>(nullptr), "btree_set");
+  measure(static_cast<Flat_set*>(nullptr), "flat_set");
+}
+
+TEST_F(PerformanceTest, UnorderedPerformance) {
+  using Rb_set = s21::set<std::uint64_t>;
+  using Btree_set = s21::btree_set<std::uint64_t>;
+  using Swiss_set = s21::unordered_set<std::uint64_t>;
+  using Std_set = std::unordered_set<std::uint64_t>;
+  constexpr size_t kSize = kNumElements * 4;
+  std::vector<std::uint64_t> values(kSize);
+  std::mt19937_64 gen(std::random_device{}());
+  for (auto& v : values) v = gen();
+  std::vector<std::uint64_t> lookups = values;
+  std::shuffle(lookups.begin(), lookups.end(), gen);
+  // Половина запросов ищет отсутствующие ключи.
+  for (size_t i = 0; i < kSize; i += 2) lookups[i] = gen();
+
+  auto measure = [&](auto container, const char* name) {
+    auto start = high_resolution_clock::now();
+    for (auto v : values) container.insert(v);
+    auto inserted = high_resolution_clock::now();
+    size_t found = 0;
+    for (auto v : lookups) found += container.contains(v);
+    auto searched = high_resolution_clock::now();
+    for (size_t i = 0; i < kSize / 2; ++i) container.erase(values[i]);
+    auto erased = high_resolution_clock::now();
+    EXPECT_GE(found, kSize / 2);
+    std::cout << name << ": insert = "
+              << duration_cast<milliseconds>(inserted - start).count()
+              << " ms, find = "
+              << duration_cast<milliseconds>(searched - inserted).count()
+              << " ms, erase = "
+              << duration_cast<milliseconds>(erased - searched).count()
+              << " ms\n";
+  };
+
+  std::cout << kSize << " uint64_t keys\n";
+  measure(Rb_set{}, "set");
+  measure(Btree_set{}, "btree_set");
+  measure(Std_set{}, "std::unordered_set");
+  measure(Swiss_set{}, "unordered_set");
+}
+
+TEST_F(PerformanceTest, ConcurrentMapPerformance) {
+  using Route_map = s21::map<int, int>;
+  constexpr int kRoutes = 10'000;
+  constexpr auto kDuration = milliseconds(200);
+  Route_map routes;
+  for (int i = 0; i < kRoutes; ++i) routes[i] = i;
+
+  struct Result {
+    long lookups_per_ms;
+    int updates;
+  };
+
+  // Читатели ищут случайные маршруты, пока писатель раз в ~3 мс меняет один
+  // из них. Все потоки останавливаются по общему сроку, даже если мьютекс
+  // не дает писателю дождаться своей очереди.
+  auto measure = [&](int readers, auto lookup, auto update) {
+    const auto deadline = high_resolution_clock::now() + kDuration;
+    std::atomic<long> lookups{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+      threads.emplace_back([&, t] {
+        std::mt19937 gen(t);
+        long local = 0;
+        long found = 0;
+        while (high_resolution_clock::now() < deadline) {
+          for (int i = 0; i < 256; ++i) found += lookup(gen() % kRoutes);
+          local += 256;
+        }
+        EXPECT_EQ(found, local);
+        lookups += local;
+      });
+    }
+    int updates = 0;
+    while (high_resolution_clock::now() < deadline) {
+      update(updates++ % kRoutes);
+      std::this_thread::sleep_for(milliseconds(3));
+    }
+    for (auto& thread : threads) thread.join();
+    return Result{lookups / kDuration.count(), updates};
+  };
+
+  auto print = [](const char* name, Result result) {
+    std::cout << ", " << name << " = " << result.lookups_per_ms << " ("
+              << result.updates << " updates)";
+  };
+
+  std::cout << kRoutes << " routes, writer every ~3 ms, "
+            << "lookups per ms over " << kDuration.count() << " ms:\n";
+  for (int readers : {1, 2, 4, 8}) {
+    Route_map locked = routes;
+    std::mutex mutex;
+    const auto with_mutex = measure(
+        readers,
+        [&](int key) {
+          std::lock_guard<std::mutex> lock(mutex);
+          return locked.contains(key);
+        },
+        [&](int key) {
+          std::lock_guard<std::mutex> lock(mutex);
+          ++locked[key];
+        });
+
+    Route_map shared = routes;
+    std::shared_mutex shared_mutex;
+    const auto with_shared_mutex = measure(
+        readers,
+        [&](int key) {
+          std::shared_lock<std::shared_mutex> lock(shared_mutex);
+          return shared.contains(key);
+        },
+        [&](int key) {
+          std::unique_lock<std::shared_mutex> lock(shared_mutex);
+          ++shared[key];
+        });
+
+    s21::concurrent_map<int, int> concurrent{Route_map(routes)};
+    const auto with_snapshots = measure(
+        readers, [&](int key) { return concurrent.read()->contains(key); },
+        [&](int key) {
+          concurrent.update([key](auto& next) { ++next[key]; });
+        });
+
+    std::cout << readers << " readers";
+    print("mutex", with_mutex);
+    print("shared_mutex", with_shared_mutex);
+    print("concurrent_map", with_snapshots);
+    std::cout << "\n";
+  }
+}
+
+TEST_F(PerformanceTest, PersistentSnapshotPerformance) {
+  using Map = s21::map<int, int>;
+  using Persistent_map = s21::persistent_map<int, int>;
+  constexpr int kSize = static_cast<int>(kNumElements);
+  constexpr int kSnapshots = 100;
+  constexpr int kUpdatesPerSnapshot = 100;
+  std::mt19937 gen(1);
+
+  // Между снимками для отчета меняется небольшая часть элементов.
+  auto measure = [&](auto map, const char* name) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < kSize; ++i) map[i] = i;
+    auto built = high_resolution_clock::now();
+    long checksum = 0;
+    for (int s = 0; s < kSnapshots; ++s) {
+      const auto snapshot = map;
+      for (int u = 0; u < kUpdatesPerSnapshot; ++u) ++map[gen() % kSize];
+      checksum += snapshot.size();
+    }
+    auto snapshots = high_resolution_clock::now();
+    size_t found = 0;
+    for (int i = 0; i < kSize; ++i) found += map.contains(gen() % kSize);
+    auto searched = high_resolution_clock::now();
+    EXPECT_EQ(checksum, static_cast<long>(kSize) * kSnapshots);
+    EXPECT_EQ(found, static_cast<size_t>(kSize));
+    std::cout << name << ": build = "
+              << duration_cast<milliseconds>(built - start).count()
+              << " ms, " << kSnapshots << " snapshots + updates = "
+              << duration_cast<milliseconds>(snapshots - built).count()
+              << " ms, find = "
+              << duration_cast<milliseconds>(searched - snapshots).count()
+              << " ms\n";
+  };
+
+  std::cout << kSize << " elements, " << kUpdatesPerSnapshot
+            << " updates between snapshots\n";
+  measure(Map{}, "map (copy)");
+  measure(Persistent_map{}, "persistent_map (snapshot)");
+}
+
+TEST_F(PerformanceTest, CowCopyPerformance) {
+  using Set = s21::set<int>;
+  using Cow_set = s21::cow_set<int>;
+  constexpr int kSize = static_cast<int>(kNumElements);
+  constexpr int kCopies = 100;
+  constexpr int kWritersEvery = 10;
+
+  // Множество передается по значению, и изменяет свою копию только каждый
+  // kWritersEvery-й получатель.
+  auto measure = [&](auto set, const char* name) {
+    for (int i = 0; i < kSize; ++i) set.insert(i);
+    std::mt19937 gen(1);
+    auto start = high_resolution_clock::now();
+    long checksum = 0;
+    for (int c = 0; c < kCopies; ++c) {
+      auto copy = set;
+      if (c % kWritersEvery == 0) copy.insert(kSize + c);
+      checksum += copy.size();
+    }
+    auto copied = high_resolution_clock::now();
+    size_t found = 0;
+    for (int i = 0; i < kSize; ++i) found += set.contains(gen() % kSize);
+    auto searched = high_resolution_clock::now();
+    EXPECT_EQ(checksum,
+              static_cast<long>(kSize) * kCopies + kCopies / kWritersEvery);
+    EXPECT_EQ(found, static_cast<size_t>(kSize));
+    std::cout << name << ": " << kCopies << " copies = "
+              << duration_cast<milliseconds>(copied - start).count()
+              << " ms, find = "
+              << duration_cast<milliseconds>(searched - copied).count()
+              << " ms\n";
+  };
+
+  std::cout << kSize << " elements, every " << kWritersEvery
+            << "th copy is modified\n";
+  measure(Set{}, "set (copy)");
+  measure(Cow_set{}, "cow_set (copy on write)");
+}
+
+TEST_F(PerformanceTest, ParallelCopyPerformance) {
+  constexpr int kSize = 4 * static_cast<int>(kNumElements);
+  constexpr int kRepeats = 3;
+
+  // Копирование одного и того же дерева с разным количеством потоков.
+  auto measure = [&](auto map, const char* name) {
+    for (int i = 0; i < kSize; ++i) map[i] = i;
+    std::cout << name << ":";
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+      auto start = high_resolution_clock::now();
+      size_t copied = 0;
+      for (int r = 0; r < kRepeats; ++r) {
+        const decltype(map) copy(s21::execution::par, map, threads);
+        copied += copy.size();
+      }
+      auto finish = high_resolution_clock::now();
+      EXPECT_EQ(copied, static_cast<size_t>(kSize) * kRepeats);
+      std::cout << " " << threads << " threads = "
+                << duration_cast<milliseconds>(finish - start).count() /
+                       kRepeats
+                << " ms;";
+    }
+    std::cout << "\n";
+  };
+
+  std::cout << kSize << " elements, "
+            << std::thread::hardware_concurrency() << " cores\n";
+  measure(s21::map<int, int>{}, "map");
+  measure(s21::map<int, int, std::less<int>,
+                   s21::concurrent_pool_allocator<std::pair<const int, int>>>{},
+          "map with concurrent_pool_allocator");
+}
+
+TEST_F(PerformanceTest, DeferredDestructionPerformance) {
+  using Map = s21::map<int, int>;
+  constexpr int kSize = 4 * static_cast<int>(kNumElements);
+  constexpr size_t kNodesPerCall = 10000;
+  auto build = [] {
+    Map map;
+    for (int i = 0; i < kSize; ++i) map[i] = i;
+    return map;
+  };
+  auto us = [](auto from, auto to) {
+    return duration_cast<microseconds>(to - from).count();
+  };
+
+  // Время, на которое блокируется вызывающий поток.
+  {
+    Map map = build();
+    auto start = high_resolution_clock::now();
+    map.clear();
+    auto finish = high_resolution_clock::now();
+    std::cout << "clear(): " << us(start, finish) << " us\n";
+  }
+  {
+    Map map = build();
+    s21::Reclaimer reclaimer;
+    auto start = high_resolution_clock::now();
+    reclaimer.retire(std::move(map));
+    auto retired = high_resolution_clock::now();
+    reclaimer.wait();
+    auto finish = high_resolution_clock::now();
+    EXPECT_TRUE(map.empty());
+    std::cout << "Reclaimer::retire(): " << us(start, retired)
+              << " us in caller, " << us(start, finish)
+              << " us until destroyed\n";
+  }
+  {
+    Map map = build();
+    long long longest = 0;
+    long long total = 0;
+    int calls = 0;
+    bool done = false;
+    while (!done) {
+      auto start = high_resolution_clock::now();
+      done = map.clear_some(kNodesPerCall);
+      auto finish = high_resolution_clock::now();
+      longest = std::max<long long>(longest, us(start, finish));
+      total += us(start, finish);
+      ++calls;
+    }
+    std::cout << "clear_some(" << kNodesPerCall << "): " << calls
+              << " calls, longest = " << longest << " us, total = " << total
+              << " us\n";
+  }
+}
@@ -0,0 +1,218 @@
+#include <sstream>
+
+#include "testing.h"
+
+class CompressedMultisetTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std_mset = {1, 2, 3, 3, 3, 5};
+    mset = {3, 1, 3, 5, 2, 3};
+  }
+
+  // Сравнивает содержимое с std::multiset в обоих направлениях обхода.
+  void ExpectEqual() {
+    EXPECT_EQ(mset.size(), std_mset.size());
+    EXPECT_TRUE(std::equal(std_mset.begin(), std_mset.end(), mset.begin(),
+                           mset.end()));
+    EXPECT_TRUE(std::equal(std_mset.rbegin(), std_mset.rend(),
+                           std::make_reverse_iterator(mset.end()),
+                           std::make_reverse_iterator(mset.begin())));
+  }
+
+  s21::compressed_multiset<int> mset;
+  std::multiset<int> std_mset;
+};
+
+// Конструкторы и присваивание.
+TEST_F(CompressedMultisetTest, Constructors) {
+  ExpectEqual();
+  EXPECT_EQ(mset.distinct_size(), 4);
+
+  s21::compressed_multiset<int> copy(mset);
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), mset.begin(), mset.end()));
+
+  s21::compressed_multiset<int> moved(std::move(copy));
+  EXPECT_EQ(moved.size(), 6);
+  EXPECT_TRUE(copy.empty());
+
+  copy = moved;
+  EXPECT_EQ(copy.count(3), 3);
+  moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 6);
+  EXPECT_EQ(copy.size(), 0);
+}
+
+// Повторяющиеся ключи не создают новых нод.
+TEST_F(CompressedMultisetTest, InsertDuplicates) {
+  s21::compressed_multiset<std::string> words;
+  for (int i = 0; i < 100000; ++i) words.insert(i % 1000 == 0 ? "rare" : "hot");
+
+  EXPECT_EQ(words.size(), 100000);
+  EXPECT_EQ(words.distinct_size(), 2);
+  EXPECT_EQ(words.count("hot"), 99900);
+  EXPECT_EQ(words.count("rare"), 100);
+  EXPECT_EQ(words.count("cold"), 0);
+
+  auto it = words.insert("hot", 10);
+  EXPECT_EQ(it.occurrence(), 99900);
+  EXPECT_EQ(words.count("hot"), 99910);
+  EXPECT_EQ(words.insert("cold", 0), words.lower_bound("cold"));
+  EXPECT_EQ(words.distinct_size(), 2);
+
+  it = words.insert(std::string("cold"));
+  EXPECT_EQ(*it, "cold");
+  EXPECT_EQ(*words.begin(), "cold");
+  it = words.emplace(3, 'x');
+  EXPECT_EQ(*it, "xxx");
+}
+
+// Итератор обходит каждое вхождение, вставленный элемент последний среди
+// равных.
+TEST_F(CompressedMultisetTest, Iteration) {
+  auto it = mset.insert(3);
+  std_mset.insert(3);
+  EXPECT_EQ(*it, 3);
+  EXPECT_EQ(*std::next(it), 5);
+  EXPECT_EQ(*std::prev(it), 3);
+  ExpectEqual();
+
+  it = mset.insert(mset.end(), 7);
+  std_mset.insert(7);
+  EXPECT_EQ(std::next(it), mset.end());
+  it = mset.insert(mset.find(3), 3);
+  std_mset.insert(3);
+  ExpectEqual();
+
+  EXPECT_EQ(std::distance(mset.begin(), mset.end()), 9);
+  EXPECT_EQ(*--mset.end(), 7);
+}
+
+// equal_range, lower_bound и upper_bound.
+TEST_F(CompressedMultisetTest, Lookup) {
+  auto [first, last] = mset.equal_range(3);
+  EXPECT_EQ(std::distance(first, last), 3);
+  EXPECT_EQ(first, mset.find(3));
+  EXPECT_EQ(*last, 5);
+  EXPECT_EQ(mset.lower_bound(4), mset.find(5));
+  EXPECT_EQ(mset.upper_bound(5), mset.end());
+  EXPECT_EQ(mset.find(4), mset.end());
+  EXPECT_TRUE(mset.contains(2));
+  EXPECT_FALSE(mset.contains(4));
+
+  s21::compressed_multiset<std::string, std::less<>> words{"a", "b", "b"};
+  EXPECT_EQ(words.count(std::string_view("b")), 2);
+  EXPECT_TRUE(words.contains("a"));
+  EXPECT_EQ(*words.find("a"), "a");
+}
+
+// Удаление по итератору и по ключу удаляет одно вхождение.
+TEST_F(CompressedMultisetTest, Erase) {
+  mset.erase(mset.find(3));
+  std_mset.erase(std_mset.find(3));
+  ExpectEqual();
+
+  EXPECT_EQ(mset.erase(3), 1);
+  std_mset.erase(std_mset.find(3));
+  EXPECT_EQ(mset.erase(3), 1);
+  std_mset.erase(std_mset.find(3));
+  EXPECT_EQ(mset.erase(3), 0);
+  ExpectEqual();
+  EXPECT_EQ(mset.distinct_size(), 3);
+
+  mset.erase(mset.end());
+  s21::compressed_multiset<int> other{1};
+  mset.erase(other.begin());
+  EXPECT_EQ(mset.size(), 3);
+  EXPECT_EQ(other.size(), 1);
+
+  mset.clear();
+  EXPECT_TRUE(mset.empty());
+  EXPECT_EQ(mset.begin(), mset.end());
+}
+
+// Удаление по итератору возвращает следующее вхождение, и обход
+// продолжается с него.
+TEST_F(CompressedMultisetTest, EraseThenIterate) {
+  auto it = std::next(mset.find(3));
+  EXPECT_EQ(it.occurrence(), 1);
+  it = mset.erase(it);
+  std_mset.erase(std::next(std_mset.find(3)));
+  EXPECT_EQ(*it, 3);
+  EXPECT_EQ(it.occurrence(), 1);
+  EXPECT_EQ(*++it, 5);
+  ExpectEqual();
+
+  // Удаление последнего вхождения переходит к следующему ключу.
+  it = mset.erase(std::prev(mset.find(5)));
+  std_mset.erase(std::prev(std_mset.find(5)));
+  EXPECT_EQ(*it, 5);
+  EXPECT_EQ(it.occurrence(), 0);
+  ExpectEqual();
+
+  mset.insert(3, 3);
+  it = mset.find(3);
+  while (it != mset.end() && *it == 3) it = mset.erase(it);
+  EXPECT_EQ(*it, 5);
+  EXPECT_FALSE(mset.contains(3));
+  EXPECT_EQ(mset.size(), 3);
+
+  // Итератор с номером вхождения за пределами счетчика не удаляет ничего.
+  it = mset.find(2);
+  ++it;
+  EXPECT_EQ(*it, 5);
+  auto stale = std::next(mset.insert(1, 2));
+  EXPECT_EQ(stale.occurrence(), 2);
+  mset.erase(mset.find(1));
+  EXPECT_EQ(mset.erase(stale), mset.end());
+  EXPECT_EQ(mset.count(1), 2);
+}
+
+// Конструктор из диапазона собирает дерево из упорядоченных ключей.
+TEST_F(CompressedMultisetTest, RangeConstructor) {
+  std::vector<int> sorted;
+  for (int i = 0; i < 1000; ++i) sorted.push_back(i / 10);
+  s21::compressed_multiset<int> from_sorted(sorted.begin(), sorted.end());
+  EXPECT_EQ(from_sorted.size(), 1000);
+  EXPECT_EQ(from_sorted.distinct_size(), 100);
+  EXPECT_EQ(from_sorted.count(42), 10);
+  EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), from_sorted.begin(),
+                         from_sorted.end()));
+
+  std::istringstream input("4 1 4 2 4");
+  s21::compressed_multiset<int> from_stream{std::istream_iterator<int>(input),
+                                            std::istream_iterator<int>()};
+  EXPECT_EQ(from_stream.size(), 5);
+  EXPECT_EQ(from_stream.count(4), 3);
+
+  std::reverse(sorted.begin(), sorted.end());
+  s21::compressed_multiset<int> reversed(sorted.begin(), sorted.end());
+  EXPECT_TRUE(std::equal(from_sorted.begin(), from_sorted.end(),
+                         reversed.begin(), reversed.end()));
+
+  // Сохраняется первый из равных объектов.
+  std::vector<std::pair<int, int>> tagged{{1, 0}, {0, 0}, {1, 1}};
+  auto by_first = [](auto lhs, auto rhs) { return lhs.first < rhs.first; };
+  s21::compressed_multiset<std::pair<int, int>, decltype(by_first)> first_kept(
+      tagged.begin(), tagged.end());
+  EXPECT_EQ(first_kept.count({1, 5}), 2);
+  EXPECT_EQ(first_kept.find({1, 5})->second, 0);
+}
+
+// Слияние складывает счетчики равных ключей.
+TEST_F(CompressedMultisetTest, MergeAndSwap) {
+  s21::compressed_multiset<int> other{3, 4, 4, 5};
+  std::multiset<int> std_other{3, 4, 4, 5};
+  mset.merge(other);
+  std_mset.merge(std_other);
+  ExpectEqual();
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(other.distinct_size(), 0);
+  EXPECT_EQ(mset.count(3), 4);
+
+  mset.merge(mset);
+  EXPECT_EQ(mset.size(), 10);
+
+  other.swap(mset);
+  EXPECT_EQ(other.size(), 10);
+  EXPECT_TRUE(mset.empty());
+}
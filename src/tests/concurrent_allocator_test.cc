@@ -0,0 +1,161 @@
+#include <random>
+#include <thread>
+
+#include "testing.h"
+
+using ConcurrentSet =
+    s21::set<int, std::less<int>, s21::concurrent_pool_allocator<int>>;
+
+TEST(ConcurrentPoolAllocatorTest, AllocateAndDeallocate) {
+  s21::concurrent_pool_allocator<long> alloc;
+  std::vector<long*> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(alloc.allocate(1));
+    *blocks.back() = i;
+  }
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(*blocks[i], i);
+  std::sort(blocks.begin(), blocks.end());
+  EXPECT_EQ(std::adjacent_find(blocks.begin(), blocks.end()), blocks.end());
+  for (long* block : blocks) alloc.deallocate(block, 1);
+
+  long* array = alloc.allocate(10);
+  array[9] = 9;
+  alloc.deallocate(array, 10);
+  EXPECT_EQ(alloc.allocate(0), nullptr);
+  EXPECT_THROW((void)alloc.allocate(alloc.max_size() + 1), std::bad_alloc);
+}
+
+TEST(ConcurrentPoolAllocatorTest, OverAlignedType) {
+  struct alignas(64) Line {
+    char bytes[64];
+  };
+  s21::concurrent_pool_allocator<Line> alloc;
+  Line* first = alloc.allocate(1);
+  Line* second = alloc.allocate(1);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % 64, 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % 64, 0);
+  alloc.deallocate(first, 1);
+  alloc.deallocate(second, 1);
+}
+
+TEST(ConcurrentPoolAllocatorTest, AllocatorsAreEqual) {
+  static_assert(std::allocator_traits<
+                s21::concurrent_pool_allocator<int>>::is_always_equal::value);
+  s21::concurrent_pool_allocator<int> first;
+  s21::concurrent_pool_allocator<int> second(
+      s21::concurrent_pool_allocator<double>{});
+  EXPECT_TRUE(first == second);
+}
+
+// Каждый поток заполняет и очищает свое множество, все они берут ноды из
+// одного пула.
+TEST(ConcurrentPoolAllocatorTest, IndependentSetsInThreads) {
+  constexpr int kThreads = 4;
+  std::vector<ConcurrentSet> sets(kThreads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < kThreads; ++t) {
+    workers.emplace_back([&set = sets[t], t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<int> dist(0, 5000);
+      for (int i = 0; i < 20000; ++i) {
+        if (i % 3 == 2) {
+          set.erase(dist(gen));
+        } else {
+          set.insert(dist(gen));
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  for (int t = 0; t < kThreads; ++t) {
+    std::mt19937 gen(t);
+    std::uniform_int_distribution<int> dist(0, 5000);
+    std::set<int> expected;
+    for (int i = 0; i < 20000; ++i) {
+      if (i % 3 == 2) {
+        expected.erase(dist(gen));
+      } else {
+        expected.insert(dist(gen));
+      }
+    }
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), sets[t].begin(),
+                           sets[t].end()));
+  }
+}
+
+// Ноды, выделенные в одном потоке, освобождаются в другом и повторно
+// используются третьим.
+TEST(ConcurrentPoolAllocatorTest, CrossThreadFree) {
+  std::vector<ConcurrentSet> produced(8);
+  std::thread producer([&produced] {
+    for (int s = 0; s < 8; ++s) {
+      for (int i = 0; i < 1000; ++i) produced[s].insert(s * 1000 + i);
+    }
+  });
+  producer.join();
+
+  std::thread consumer([&produced] {
+    for (auto& set : produced) set.clear();
+  });
+  consumer.join();
+
+  ConcurrentSet reused;
+  std::thread builder([&reused] {
+    for (int i = 0; i < 8000; ++i) reused.insert(i);
+  });
+  builder.join();
+  EXPECT_EQ(reused.size(), 8000);
+  EXPECT_EQ(*reused.begin(), 0);
+  EXPECT_EQ(*--reused.end(), 7999);
+}
+
+// Аллокаторы равны, поэтому merge переносит ноды, созданные в других
+// потоках, без копирования.
+TEST(ConcurrentPoolAllocatorTest, MergeSetsFromThreads) {
+  ConcurrentSet even;
+  ConcurrentSet odd;
+  std::thread first([&even] {
+    for (int i = 0; i < 2000; i += 2) even.insert(i);
+  });
+  std::thread second([&odd] {
+    for (int i = 1; i < 2000; i += 2) odd.insert(i);
+  });
+  first.join();
+  second.join();
+
+  const int* node_value = &*odd.find(1001);
+  even.merge(odd);
+  EXPECT_TRUE(odd.empty());
+  EXPECT_EQ(even.size(), 2000);
+  EXPECT_EQ(&*even.find(1001), node_value);
+  for (int i = 0; i < 2000; i += 3) even.erase(i);
+  EXPECT_EQ(even.size(), 2000 - 667);
+}
+
+// Множество уничтожается после кеша своего потока, и его ноды возвращаются
+// прямо в центральный пул.
+TEST(ConcurrentPoolAllocatorTest, ContainerOutlivesThreadCache) {
+  struct Holder {
+    ConcurrentSet set;
+    std::size_t* size;
+
+    ~Holder() {
+      for (int i = 1000; i < 1100; ++i) set.insert(i);
+      *size = set.size();
+    }
+  };
+
+  std::size_t size = 0;
+  std::thread worker([&size] {
+    // Holder создается раньше кеша, поэтому уничтожается после него.
+    thread_local Holder holder{{}, &size};
+    for (int i = 0; i < 1000; ++i) holder.set.insert(i);
+  });
+  worker.join();
+  EXPECT_EQ(size, 1100);
+
+  ConcurrentSet reused;
+  for (int i = 0; i < 2000; ++i) reused.insert(i);
+  EXPECT_EQ(reused.size(), 2000);
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <thread>
+
+#include "testing.h"
+
+namespace {
+
+// Значение, которое считает свои живые экземпляры.
+struct Counted {
+  static inline std::atomic<int> alive{0};
+
+  int value;
+
+  Counted(int v = 0) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  Counted& operator=(const Counted&) = default;
+  ~Counted() { --alive; }
+};
+
+}  // namespace
+
+TEST(ConcurrentMapTest, Basic) {
+  s21::concurrent_map<int, std::string> map = {{1, "one"}, {2, "two"}};
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.get(1), "one");
+  EXPECT_EQ(map.get(3), std::nullopt);
+  EXPECT_TRUE(map.insert({3, "three"}));
+  EXPECT_FALSE(map.insert({3, "tres"}));
+  EXPECT_FALSE(map.insert_or_assign(3, "tres"));
+  EXPECT_TRUE(map.insert_or_assign(4, "four"));
+  EXPECT_EQ(map.erase(1), 1);
+  EXPECT_EQ(map.erase(1), 0);
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_EQ(map.get(3), "tres");
+
+  const auto erased = map.update([](auto& next) {
+    next[5] = "five";
+    return next.erase(2);
+  });
+  EXPECT_EQ(erased, 1);
+
+  const auto snap = map.read();
+  std::vector<int> keys;
+  for (const auto& [key, value] : *snap) keys.push_back(key);
+  EXPECT_EQ(keys, (std::vector<int>{3, 4, 5}));
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  map.assign(s21::map<int, std::string>{{7, "seven"}});
+  EXPECT_EQ(map.copy().at(7), "seven");
+}
+
+// Снимок видит свою версию, пока существует, и удерживает её от
+// освобождения.
+TEST(ConcurrentMapTest, SnapshotsAndReclamation) {
+  {
+    s21::concurrent_map<int, Counted> map;
+    map.update([](auto& next) {
+      for (int i = 0; i < 100; ++i) next.insert(i, Counted(i));
+    });
+    {
+      const auto old = map.read();
+      for (int round = 1; round <= 10; ++round) {
+        map.update([round](auto& next) {
+          for (auto& [key, value] : next) value.value = key * round;
+        });
+      }
+      EXPECT_EQ(old->find(5)->second.value, 5);
+      EXPECT_EQ(map.get(5)->value, 50);
+      EXPECT_GE(map.retired_versions(), 1);
+    }
+    map.synchronize();
+    EXPECT_EQ(map.retired_versions(), 0);
+    EXPECT_EQ(Counted::alive, 100);
+    map.update([](auto& next) { next.clear(); });
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+// Писатель меняет все значения одной версии сразу: читатель никогда не
+// должен увидеть смесь двух версий.
+TEST(ConcurrentMapTest, ReadersSeeConsistentVersions) {
+  constexpr int kKeys = 64;
+  s21::concurrent_map<int, int> map;
+  map.update([](auto& next) {
+    for (int i = 0; i < kKeys; ++i) next[i] = 0;
+  });
+
+  std::atomic<bool> done{false};
+  std::atomic<int> inconsistent{0};
+  std::atomic<long> reads{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&] {
+      int last = 0;
+      while (!done.load()) {
+        const auto snap = map.read();
+        const int generation = snap->find(0)->second;
+        if (generation < last || snap->size() != kKeys) ++inconsistent;
+        for (const auto& [key, value] : *snap) {
+          if (value != generation) ++inconsistent;
+        }
+        last = generation;
+        ++reads;
+      }
+    });
+  }
+  for (int generation = 1; generation <= 300; ++generation) {
+    map.update([generation](auto& next) {
+      for (auto& [key, value] : next) value = generation;
+    });
+    if (generation % 50 == 0) std::this_thread::yield();
+  }
+  done = true;
+  for (auto& reader : readers) reader.join();
+  map.synchronize();
+
+  EXPECT_EQ(inconsistent, 0);
+  EXPECT_GT(reads, 0);
+  EXPECT_EQ(map.get(kKeys - 1), 300);
+  EXPECT_EQ(map.retired_versions(), 0);
+}
+
+TEST(ConcurrentMapTest, NestedSnapshots) {
+  s21::concurrent_map<int, int> map = {{1, 1}};
+  const auto outer = map.read();
+  {
+    const auto inner = map.read();
+    map.insert_or_assign(1, 2);
+    EXPECT_EQ(inner->find(1)->second, 1);
+  }
+  map.reclaim();
+  EXPECT_EQ(outer->find(1)->second, 1);
+  EXPECT_EQ(map.get(1), 2);
+}
@@ -0,0 +1,190 @@
+#include <random>
+#include <thread>
+
+#include "testing.h"
+
+namespace {
+
+// Ресурс, считающий выделения нод.
+class Counting_resource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  int deallocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+TEST(CowSetTest, CopySharesUntilWrite) {
+  Counting_resource resource;
+  const std::pmr::polymorphic_allocator<int> alloc(&resource);
+  s21::pmr::cow_set<int> set(alloc);
+  for (int i = 0; i < 100; ++i) set.insert(i);
+  const int allocations = resource.allocations;
+
+  s21::pmr::cow_set<int> copy = set;
+  s21::pmr::cow_set<int> assigned;
+  assigned = set;
+  EXPECT_EQ(resource.allocations, allocations);
+  EXPECT_TRUE(copy.shares_with(set));
+  EXPECT_TRUE(assigned.shares_with(set));
+  EXPECT_TRUE(set.shared());
+
+  // Чтение и изменения, которые ничего не меняют, дерево не копируют.
+  EXPECT_TRUE(copy.contains(50));
+  EXPECT_EQ(*copy.find(7), 7);
+  EXPECT_EQ(*copy.lower_bound(10), 10);
+  EXPECT_EQ(std::distance(copy.begin(), copy.end()), 100);
+  EXPECT_FALSE(copy.insert(5).second);
+  EXPECT_EQ(copy.erase(1000), 0);
+  EXPECT_TRUE(copy.shares_with(set));
+  EXPECT_EQ(resource.allocations, allocations);
+
+  // Первая запись копирует дерево один раз и тем же ресурсом.
+  EXPECT_TRUE(copy.insert(100).second);
+  EXPECT_FALSE(copy.shares_with(set));
+  EXPECT_TRUE(assigned.shares_with(set));
+  EXPECT_EQ(resource.allocations, allocations + 101);
+  EXPECT_TRUE(copy.insert(101).second);
+  EXPECT_EQ(resource.allocations, allocations + 102);
+
+  EXPECT_EQ(set.size(), 100);
+  EXPECT_FALSE(set.contains(100));
+  EXPECT_EQ(copy.size(), 102);
+  EXPECT_EQ(copy.get_allocator().resource(), &resource);
+}
+
+TEST(CowSetTest, MatchesStdSet) {
+  std::mt19937 rng(23);
+  std::uniform_int_distribution<int> key(0, 300);
+  std::vector<s21::cow_set<int>> versions(1);
+  std::vector<std::set<int>> expected(1);
+
+  for (int round = 0; round < 400; ++round) {
+    std::size_t i = rng() % versions.size();
+    if (rng() % 4 == 0) {
+      versions.push_back(versions[i]);
+      expected.push_back(expected[i]);
+      i = versions.size() - 1;
+    }
+    for (int op = 0; op < 20; ++op) {
+      const int k = key(rng);
+      if (rng() % 3 == 0) {
+        EXPECT_EQ(versions[i].erase(k), expected[i].erase(k));
+      } else {
+        EXPECT_EQ(versions[i].insert(k).second, expected[i].insert(k).second);
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < versions.size(); ++i) {
+    ASSERT_EQ(versions[i].size(), expected[i].size());
+    EXPECT_TRUE(std::equal(versions[i].begin(), versions[i].end(),
+                           expected[i].begin()));
+  }
+}
+
+TEST(CowSetTest, EraseIteratorAndClearShared) {
+  s21::cow_set<std::string> set = {"a", "b", "c"};
+  s21::cow_set<std::string> copy = set;
+
+  copy.erase(copy.find("b"));
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_FALSE(copy.contains("b"));
+  EXPECT_TRUE(set.contains("b"));
+
+  s21::cow_set<std::string> other = set;
+  other.clear();
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(set.size(), 3);
+
+  other.insert("z");
+  other.swap(set);
+  EXPECT_EQ(set.size(), 1);
+  EXPECT_EQ(other.size(), 3);
+
+  s21::cow_set<std::string> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(CowMapTest, Basic) {
+  s21::cow_map<int, std::string> map = {{1, "one"}, {2, "two"}};
+  const s21::cow_map<int, std::string> copy = map;
+  EXPECT_TRUE(copy.shares_with(map));
+
+  EXPECT_EQ(copy.at(1), "one");
+  EXPECT_THROW(copy.at(3), std::out_of_range);
+  EXPECT_EQ(copy.find(2)->second, "two");
+  EXPECT_EQ(map.erase(5), 0);
+  EXPECT_TRUE(copy.shares_with(map));
+
+  map[1] = "uno";
+  EXPECT_FALSE(copy.shares_with(map));
+  EXPECT_EQ(copy.at(1), "one");
+  EXPECT_EQ(map.at(1), "uno");
+
+  map.insert_or_assign(3, "tres");
+  map.try_emplace(3, "three");
+  map.insert(4, "four");
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.at(3), "tres");
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_THROW(map.at(5), std::out_of_range);
+}
+
+TEST(CowMapTest, MutableAccessUnshares) {
+  s21::cow_map<int, int> map = {{1, 10}, {2, 20}, {3, 30}};
+  s21::cow_map<int, int> copy = map;
+
+  // Неконстантный итератор позволяет менять значения, поэтому копирует.
+  for (auto it = copy.begin(); it != copy.end(); ++it) it->second += 1;
+  EXPECT_FALSE(copy.shares_with(map));
+  EXPECT_EQ(map.at(2), 20);
+  EXPECT_EQ(copy.at(2), 21);
+
+  s21::cow_map<int, int> other = map;
+  other.at(3) = 0;
+  EXPECT_EQ(map.at(3), 30);
+
+  s21::cow_map<int, int> erased = map;
+  erased.erase(erased.find(1));
+  EXPECT_FALSE(erased.contains(1));
+  EXPECT_TRUE(map.contains(1));
+  EXPECT_EQ(map.size(), 3);
+}
+
+TEST(CowMapTest, CopiesAcrossThreads) {
+  s21::cow_map<int, int> map;
+  for (int i = 0; i < 1000; ++i) map[i] = i;
+
+  std::vector<std::thread> threads;
+  std::vector<long long> sums(4);
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([copy = map, &sums, t]() mutable {
+      long long sum = 0;
+      for (const auto& [key, value] : std::as_const(copy)) sum += value;
+      copy[t] = -1;
+      sums[t] = sum + copy.at(t);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int t = 0; t < 4; ++t) EXPECT_EQ(sums[t], 999 * 1000 / 2 - 1);
+  EXPECT_EQ(map.at(0), 0);
+  EXPECT_FALSE(map.shared());
+}
@@ -0,0 +1,270 @@
+#include <random>
+
+#include "testing.h"
+
+namespace {
+
+// Сравнивает содержимое с эталонным контейнером в обоих направлениях обхода.
+template <typename Container, typename Expected>
+void ExpectSameElements(const Container& actual, const Expected& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin(),
+                         actual.end()));
+  EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(),
+                         std::make_reverse_iterator(actual.end()),
+                         std::make_reverse_iterator(actual.begin())));
+}
+
+// Ключ с номером вставки: равные ключи различимы.
+struct Tagged {
+  int key;
+  int tag;
+  bool operator<(const Tagged& other) const { return key < other.key; }
+  bool operator==(const Tagged& other) const {
+    return key == other.key && tag == other.tag;
+  }
+};
+
+}  // namespace
+
+TEST(FlatSetTest, Basic) {
+  s21::flat_set<int> set = {5, 1, 4, 1, 3};
+  ExpectSameElements(set, std::set<int>{1, 3, 4, 5});
+  EXPECT_TRUE(set.contains(4));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_EQ(*set.lower_bound(2), 3);
+  EXPECT_EQ(*set.upper_bound(4), 5);
+  EXPECT_EQ(set.upper_bound(5), set.end());
+  EXPECT_EQ(set.lower_bound(0), set.begin());
+
+  EXPECT_TRUE(set.insert(2).second);
+  EXPECT_FALSE(set.insert(2).second);
+  EXPECT_EQ(*set.insert(set.find(3), 2), 2);
+  EXPECT_EQ(*set.insert(set.end(), 6), 6);
+  EXPECT_EQ(set.erase(1), 1);
+  EXPECT_EQ(set.erase(1), 0);
+  set.erase(set.find(5));
+  ExpectSameElements(set, std::set<int>{2, 3, 4, 6});
+
+  // Итератор другого контейнера игнорируется.
+  s21::flat_set<int> other = {3};
+  set.erase(other.begin());
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_EQ(*set.insert(other.begin(), 7), 7);
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.find(3), set.end());
+}
+
+// Пакетная вставка совпадает с поэлементной: из равных ключей остается
+// первый, уже существующий или встретившийся раньше.
+TEST(FlatSetTest, BatchInsert) {
+  std::mt19937 gen(19);
+  std::uniform_int_distribution<int> key(0, 5000);
+  s21::flat_set<Tagged> set;
+  std::set<Tagged> expected;
+  for (int round = 0; round < 5; ++round) {
+    std::vector<Tagged> batch;
+    for (int i = 0; i < 2000; ++i) {
+      batch.push_back({key(gen), round * 2000 + i});
+    }
+    set.insert(batch.begin(), batch.end());
+    expected.insert(batch.begin(), batch.end());
+    ExpectSameElements(set, expected);
+  }
+  for (int k = 0; k <= 5000; k += 7) {
+    EXPECT_EQ(set.contains(Tagged{k, 0}), expected.contains(Tagged{k, 0}));
+  }
+
+  set.insert({{1, -1}, {5001, -1}});
+  EXPECT_EQ(set.find(Tagged{5001, 0})->tag, -1);
+}
+
+TEST(FlatSetTest, RandomOperations) {
+  std::mt19937 gen(190);
+  std::uniform_int_distribution<int> key(0, 1000);
+  s21::flat_set<int> set;
+  std::set<int> expected;
+  for (int i = 0; i < 6000; ++i) {
+    const int k = key(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(set.erase(k), expected.erase(k));
+    } else if (i % 3 == 1) {
+      EXPECT_EQ(set.insert(k).second, expected.insert(k).second);
+    } else {
+      auto hint = set.lower_bound(key(gen));
+      EXPECT_EQ(*set.insert(hint, k), k);
+      expected.insert(k);
+    }
+  }
+  ExpectSameElements(set, expected);
+}
+
+TEST(FlatSetTest, ReplaceAndReserve) {
+  s21::flat_set<int> set;
+  set.reserve(100);
+  EXPECT_GE(set.capacity(), 100);
+  EXPECT_EQ(set.memory_usage().node_bytes, 0);
+
+  std::vector<int> sorted(1000);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  set.replace(std::vector<int>(sorted));
+  ExpectSameElements(set, sorted);
+  EXPECT_EQ(set.memory_usage().node_bytes, 1000 * sizeof(int));
+
+  s21::flat_set<int> from_sorted(s21::sorted_range, sorted.begin() + 500,
+                                 sorted.end());
+  EXPECT_EQ(*from_sorted.begin(), 500);
+  set.assign_sorted(sorted.begin(), sorted.begin() + 10);
+  set.shrink_to_fit();
+  EXPECT_EQ(set.memory_usage().overhead_bytes, sizeof(set));
+
+  auto res = set.insert_many(3, 20, 30);
+  EXPECT_FALSE(res[0].second);
+  EXPECT_TRUE(res[1].second);
+  EXPECT_EQ(*res[2].first, 30);
+  EXPECT_EQ(set.size(), 12);
+}
+
+TEST(FlatSetTest, CopyMoveSwapMerge) {
+  s21::flat_set<std::string> set;
+  for (int i = 0; i < 300; ++i) set.insert(std::to_string(i));
+
+  s21::flat_set<std::string> copy(set);
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), set.begin(), set.end()));
+  s21::flat_set<std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  copy = moved;
+  moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 300);
+
+  s21::flat_set<std::string> other = {"1", "a", "b"};
+  other.swap(moved);
+  EXPECT_EQ(moved.size(), 3);
+
+  other.merge(moved);
+  EXPECT_EQ(other.size(), 302);
+  ExpectSameElements(moved, std::set<std::string>{"1"});
+}
+
+TEST(FlatMultisetTest, RandomOperations) {
+  std::mt19937 gen(1900);
+  std::uniform_int_distribution<int> key(0, 60);
+  s21::flat_multiset<Tagged> mset;
+  std::multiset<Tagged> expected;
+
+  for (int i = 0; i < 3000; ++i) {
+    const Tagged value{key(gen), i};
+    if (i % 3 == 2) {
+      mset.erase(Tagged{value.key, 0});
+      auto it = expected.find(Tagged{value.key, 0});
+      if (it != expected.end()) expected.erase(it);
+    } else if (i % 5 == 0) {
+      mset.insert(mset.upper_bound(value), value);
+      expected.insert(expected.upper_bound(value), value);
+    } else {
+      mset.insert(value);
+      expected.insert(value);
+    }
+  }
+  ExpectSameElements(mset, expected);
+
+  std::vector<Tagged> batch;
+  for (int i = 0; i < 500; ++i) batch.push_back({key(gen), 10000 + i});
+  mset.insert(batch.begin(), batch.end());
+  expected.insert(batch.begin(), batch.end());
+  ExpectSameElements(mset, expected);
+  for (int k = 0; k <= 60; ++k) {
+    EXPECT_EQ(mset.count(Tagged{k, 0}), expected.count(Tagged{k, 0}));
+  }
+
+  s21::flat_multiset<Tagged> other = {{1, -1}, {1, -2}};
+  mset.merge(other);
+  EXPECT_TRUE(other.empty());
+  expected.insert({{1, -1}, {1, -2}});
+  ExpectSameElements(mset, expected);
+}
+
+TEST(FlatMapTest, Basic) {
+  s21::flat_map<int, std::string> map = {{2, "two"}, {1, "one"}, {2, "dos"}};
+  map[3] = "three";
+  EXPECT_EQ(map.at(2), "two");
+  EXPECT_THROW(map.at(4), std::out_of_range);
+  EXPECT_FALSE(map.insert({1, "uno"}).second);
+  EXPECT_FALSE(map.try_emplace(2, "dos").second);
+  EXPECT_FALSE(map.insert_or_assign(3, "tres").second);
+  EXPECT_TRUE(map.insert(4, "four").second);
+  EXPECT_EQ(map.try_emplace(map.end(), 5, "five")->second, "five");
+  map.insert({{6, "six"}, {0, "zero"}, {1, "ein"}});
+
+  std::map<int, std::string> expected = {{0, "zero"}, {1, "one"},
+                                         {2, "two"},  {3, "tres"},
+                                         {4, "four"}, {5, "five"},
+                                         {6, "six"}};
+  EXPECT_TRUE(std::equal(map.begin(), map.end(), expected.begin(),
+                         expected.end(), [](const auto& lhs, const auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  lhs.second == rhs.second;
+                         }));
+
+  for (auto&& [key, value] : map) value += "!";
+  EXPECT_EQ(map.find(4)->second, "four!");
+  map.erase(map.find(1));
+  EXPECT_EQ(map.erase(5), 1);
+  EXPECT_EQ(map.begin()->first, 0);
+  EXPECT_EQ(std::prev(map.end())->first, 6);
+}
+
+// Ключ нельзя изменить через итератор, значение — можно.
+template <typename It>
+concept KeyAssignable = requires(It it) {
+  it->first = it->first;
+} || requires(It it) { (*it).first = (*it).first; };
+
+template <typename It>
+concept MappedAssignable = requires(It it) { it->second = it->second; };
+
+TEST(FlatMapTest, ConstKeyIterators) {
+  using Map = s21::flat_map<int, std::string>;
+  static_assert(!KeyAssignable<Map::iterator>);
+  static_assert(!KeyAssignable<Map::const_iterator>);
+  static_assert(MappedAssignable<Map::iterator>);
+  static_assert(!MappedAssignable<Map::const_iterator>);
+
+  Map map = {{1, "one"}, {2, "two"}, {3, "three"}};
+  map.begin()->second = "uno";
+  (*std::next(map.begin())).second += "!";
+  EXPECT_EQ(map.at(1), "uno");
+  EXPECT_EQ(map.at(2), "two!");
+  EXPECT_TRUE(map.contains(1));
+
+  const Map& cmap = map;
+  Map::const_iterator it = map.find(3);
+  EXPECT_EQ(it, cmap.find(3));
+  EXPECT_EQ(it - cmap.begin(), 2);
+  EXPECT_EQ(cmap.begin()[2].second, "three");
+  EXPECT_TRUE(cmap.begin() < it);
+  std::pair<int, std::string> copy = *it;
+  EXPECT_EQ(copy.first, 3);
+  auto hint = map.insert(map.lower_bound(2), {0, "zero"});
+  EXPECT_EQ(hint, map.begin());
+  map.erase(map.find(0));
+  EXPECT_EQ(map.size(), 3);
+}
+
+TEST(FlatMapTest, MemoryResource) {
+  s21::pmr::pool_resource resource;
+  s21::pmr::flat_map<int, int> map(&resource);
+  std::vector<std::pair<int, int>> batch;
+  for (int i = 0; i < 1000; ++i) batch.emplace_back(i * 7 % 1000, i);
+  map.insert(batch.begin(), batch.end());
+  EXPECT_EQ(map.size(), 1000);
+  EXPECT_EQ(map.at(7), 1);
+  EXPECT_EQ(map.get_allocator().resource(), &resource);
+
+  std::pmr::monotonic_buffer_resource arena;
+  s21::pmr::flat_map<int, int> moved(std::move(map), &arena);
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(moved.at(14), 2);
+}
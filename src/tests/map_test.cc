@@ -20,6 +20,18 @@ TEST(MapTest, CopyConstructor) {
   EXPECT_EQ(copy.size(), 2);
   EXPECT_EQ(copy[1], "one");
   EXPECT_EQ(copy[2], "two");
+  EXPECT_EQ(m[1], "one");
+  EXPECT_EQ(m[2], "two");
+}
+
+TEST(MapTest, ParallelCopyConstructor) {
+  s21::map<int, std::string> m;
+  for (int i = 0; i < 100000; ++i) m[i] = std::to_string(i);
+  s21::map<int, std::string> copy(s21::execution::par, m, 4);
+  EXPECT_EQ(copy.size(), m.size());
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), copy.begin(), copy.end()));
+  copy[7] = "seven";
+  EXPECT_EQ(m[7], "7");
 }
 
 TEST(MapTest, MoveConstructor) {
@@ -190,3 +202,320 @@ TEST(MapTest, InsertMany_Empty) {
 
   EXPECT_TRUE(my_results.empty());
 }
+
+TEST(MapTest, RangeConstructor) {
+  std::vector<std::pair<int, std::string>> values = {
+      {3, "three"}, {1, "one"}, {2, "two"}, {1, "uno"}};
+  s21::map<int, std::string> m(values.begin(), values.end());
+  std::map<int, std::string> std_map(values.begin(), values.end());
+
+  EXPECT_EQ(m.size(), std_map.size());
+  EXPECT_EQ(m[1], std_map[1]);
+  EXPECT_TRUE(std::equal(std_map.begin(), std_map.end(), m.begin()));
+}
+
+TEST(MapTest, SortedRangeConstructor) {
+  std::vector<std::pair<int, std::string>> values = {
+      {1, "one"}, {2, "two"}, {3, "three"}};
+  s21::map<int, std::string> m(s21::sorted_range, values.begin(),
+                               values.end());
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(m.at(2), "two");
+
+  m.assign_sorted(values.begin(), values.begin() + 1);
+  EXPECT_EQ(m.size(), 1);
+  EXPECT_FALSE(m.contains(3));
+}
+
+TEST(MapTest, TransparentLookup) {
+  s21::map<std::string, int, std::less<>> m{{"alpha", 1}, {"beta", 2}};
+  std::string_view key = "beta";
+
+  EXPECT_TRUE(m.contains(key));
+  EXPECT_TRUE(m.contains("alpha"));
+  EXPECT_FALSE(m.contains("gamma"));
+  EXPECT_EQ((*m.find(key)).second, 2);
+  EXPECT_EQ(m.count("alpha"), 1);
+  EXPECT_EQ((*m.lower_bound("b")).first, "beta");
+  EXPECT_EQ(m.upper_bound("beta"), m.end());
+
+  // Поиск границ доступен и через константную ссылку.
+  const auto& cm = m;
+  s21::map<std::string, int, std::less<>>::const_iterator it =
+      cm.lower_bound(key);
+  EXPECT_EQ(it->second, 2);
+  EXPECT_EQ(cm.lower_bound(std::string("alpha"))->second, 1);
+  EXPECT_EQ(cm.upper_bound("alpha"), cm.find(key));
+  EXPECT_EQ(cm.upper_bound(std::string("beta")), cm.end());
+  auto range = cm.equal_range(key);
+  EXPECT_EQ(range.first->first, "beta");
+  EXPECT_EQ(range.second, cm.end());
+  range = cm.equal_range(std::string("b"));
+  EXPECT_EQ(range.first, range.second);
+  auto mutable_range = m.equal_range("alpha");
+  mutable_range.first->second = 10;
+  EXPECT_EQ(mutable_range.second->first, "beta");
+  EXPECT_EQ(m.at("alpha"), 10);
+
+  EXPECT_EQ(m.erase(std::string_view("alpha")), 1);
+  EXPECT_EQ(m.erase("alpha"), 0);
+  EXPECT_EQ(m.size(), 1);
+}
+
+// Ключ, считающий свои копирования.
+struct CopyCountingKey {
+  static inline int copies = 0;
+  int value;
+
+  explicit CopyCountingKey(int v = 0) : value(v) {}
+  CopyCountingKey(const CopyCountingKey& other) : value(other.value) {
+    ++copies;
+  }
+  bool operator<(const CopyCountingKey& other) const {
+    return value < other.value;
+  }
+};
+
+TEST(MapTest, LookupDoesNotCopyKeys) {
+  s21::map<CopyCountingKey, int> m;
+  for (int i = 0; i < 100; ++i) m.insert(CopyCountingKey(i), i);
+
+  CopyCountingKey key(42);
+  CopyCountingKey missing(1000);
+  CopyCountingKey::copies = 0;
+
+  EXPECT_TRUE(m.contains(key));
+  EXPECT_EQ((*m.find(key)).second, 42);
+  EXPECT_EQ((*m.lower_bound(key)).second, 42);
+  EXPECT_EQ(m.find(missing), m.end());
+  EXPECT_EQ(m.at(key), 42);
+  EXPECT_EQ(CopyCountingKey::copies, 0);
+}
+
+// Значение, считающее копирования и перемещения.
+struct MoveTracked {
+  static inline int copies = 0;
+  static inline int moves = 0;
+  std::string data;
+
+  MoveTracked() = default;
+  explicit MoveTracked(std::string s) : data(std::move(s)) {}
+  MoveTracked(const MoveTracked& other) : data(other.data) { ++copies; }
+  MoveTracked(MoveTracked&& other) noexcept : data(std::move(other.data)) {
+    ++moves;
+  }
+  MoveTracked& operator=(const MoveTracked& other) {
+    data = other.data;
+    ++copies;
+    return *this;
+  }
+  MoveTracked& operator=(MoveTracked&& other) noexcept {
+    data = std::move(other.data);
+    ++moves;
+    return *this;
+  }
+
+  static void Reset() { copies = moves = 0; }
+};
+
+TEST(MapTest, TryEmplace) {
+  s21::map<int, MoveTracked> m;
+  MoveTracked::Reset();
+
+  auto res = m.try_emplace(1, "one");
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(res.first->second.data, "one");
+  EXPECT_EQ(MoveTracked::copies + MoveTracked::moves, 0);
+
+  MoveTracked value("uno");
+  res = m.try_emplace(1, std::move(value));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(value.data, "uno");  // Значение не было перемещено.
+  EXPECT_EQ(m[1].data, "one");
+}
+
+TEST(MapTest, EmplaceAndRvalueInsert) {
+  s21::map<std::string, MoveTracked> m;
+  MoveTracked::Reset();
+
+  auto res = m.emplace(std::piecewise_construct, std::forward_as_tuple("a"),
+                       std::forward_as_tuple("alpha"));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(MoveTracked::copies, 0);
+
+  res = m.insert({"b", MoveTracked("beta")});
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(MoveTracked::copies, 0);
+
+  res = m.emplace("a", MoveTracked("again"));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(m.at("a").data, "alpha");
+
+  auto it = m.emplace_hint(m.end(), "c", MoveTracked("gamma"));
+  EXPECT_EQ(it->second.data, "gamma");
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(MoveTracked::copies, 0);
+}
+
+TEST(MapTest, MoveInsertOrAssign) {
+  s21::map<int, MoveTracked> m;
+  MoveTracked::Reset();
+
+  m.insert_or_assign(1, MoveTracked("one"));
+  m.insert_or_assign(1, MoveTracked("uno"));
+  EXPECT_EQ(m[1].data, "uno");
+  EXPECT_EQ(MoveTracked::copies, 0);
+
+  std::string key = "ignored";
+  s21::map<std::string, int> words;
+  words[std::move(key)] = 5;
+  words.insert_or_assign(std::string("two"), 2);
+  EXPECT_EQ(words["ignored"], 5);
+  EXPECT_EQ(words.at("two"), 2);
+}
+
+TEST(MapTest, HintedInsert) {
+  s21::map<int, std::string> m;
+  for (int i = 0; i < 10; ++i) m.insert(m.end(), {i, std::to_string(i)});
+
+  auto it = m.insert(m.find(5), {5, "five"});
+  EXPECT_EQ(it->second, "5");
+
+  std::pair<const int, std::string> value{-1, "minus"};
+  it = m.insert(m.begin(), std::move(value));
+  EXPECT_EQ(it, m.begin());
+  EXPECT_TRUE(value.second.empty());
+
+  it = m.emplace_hint(m.end(), 20, "twenty");
+  EXPECT_EQ(it->second, "twenty");
+
+  std::string str = "x";
+  it = m.try_emplace(m.find(20), 15, std::move(str));
+  EXPECT_EQ(it->second, "x");
+  EXPECT_TRUE(str.empty());
+
+  str = "y";
+  it = m.try_emplace(m.end(), 15, std::move(str));
+  EXPECT_EQ(it->second, "x");
+  EXPECT_EQ(str, "y");  // Ключ уже есть, аргументы не используются.
+
+  EXPECT_EQ(m.size(), 13);
+  EXPECT_TRUE(std::is_sorted(
+      m.begin(), m.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; }));
+}
+
+TEST(MapTest, OrderStatistics) {
+  s21::map<int, std::string, std::less<int>,
+           std::allocator<std::pair<const int, std::string>>, s21::Sized_node>
+      ranked{{3, "three"}, {1, "one"}, {2, "two"}};
+
+  EXPECT_EQ(ranked.nth(1)->second, "two");
+  ranked.nth(2)->second = "THREE";
+  EXPECT_EQ(ranked[3], "THREE");
+  EXPECT_EQ(ranked.rank(3), 2);
+  EXPECT_EQ(ranked.index_of(ranked.find(1)), 0);
+
+  ranked.insert_or_assign(0, "zero");
+  EXPECT_EQ(ranked.rank(3), 3);
+  EXPECT_EQ(ranked.end() - ranked.begin(), 4);
+}
+
+// Концевая нода не хранит значение, поэтому тип значения может не иметь
+// конструктора по умолчанию.
+TEST(MapTest, NonDefaultConstructibleValue) {
+  struct Weight {
+    explicit Weight(int grams) : grams(grams) {}
+    int grams;
+  };
+  static_assert(!std::is_default_constructible_v<Weight>);
+
+  s21::map<std::string, Weight> weights;
+  weights.emplace("apple", Weight(150));
+  weights.insert({"plum", Weight(30)});
+  weights.insert_or_assign("apple", Weight(160));
+  EXPECT_EQ(weights.at("apple").grams, 160);
+  EXPECT_EQ(weights.size(), 2);
+
+  auto copy = weights;
+  weights.erase(weights.begin());
+  EXPECT_EQ(copy.at("apple").grams, 160);
+  EXPECT_EQ(weights.begin()->second.grams, 30);
+}
+
+TEST(MapTest, MemoryUsage) {
+  s21::map<int, int> plain;
+  EXPECT_EQ(plain.memory_usage().node_bytes, 0);
+  EXPECT_EQ(plain.memory_usage().total(), sizeof(plain));
+  for (int i = 0; i < 10; ++i) plain[i] = i;
+  EXPECT_EQ(plain.memory_usage().node_bytes,
+            10 * sizeof(s21::Node<std::pair<const int, int>>));
+
+  using Pool = s21::pool_allocator<std::pair<const int, int>>;
+  s21::map<int, int, std::less<int>, Pool> pooled(Pool(64));
+  for (int i = 0; i < 100; ++i) pooled[i] = i;
+  s21::memory_usage_info usage = pooled.memory_usage();
+  EXPECT_EQ(usage.node_bytes,
+            100 * sizeof(s21::Node<std::pair<const int, int>>));
+  // Фрагменты по 64 и 128 нод, из которых заняты 100.
+  EXPECT_GE(usage.total(),
+            192 * sizeof(s21::Node<std::pair<const int, int>>));
+  for (int i = 0; i < 90; ++i) pooled.erase(i);
+  EXPECT_GT(pooled.memory_usage().overhead_bytes, usage.overhead_bytes);
+  EXPECT_EQ(pooled.memory_usage().total(), usage.total());
+}
+
+// Перенос записей между картами и изменение ключа без перевыделения нод.
+TEST(MapTest, NodeHandles) {
+  s21::map<int, std::string> pending{{1, "one"}, {2, "two"}, {3, "three"}};
+  s21::map<int, std::string> active{{2, "active two"}};
+
+  auto nh = pending.extract(1);
+  ASSERT_FALSE(nh.empty());
+  const auto* address = &nh.mapped();
+  EXPECT_EQ(nh.key(), 1);
+  EXPECT_EQ(nh.mapped(), "one");
+  nh.key() = 10;
+  auto res = active.insert(std::move(nh));
+  EXPECT_TRUE(res.inserted);
+  EXPECT_EQ(res.position->first, 10);
+  EXPECT_EQ(&res.position->second, address);
+
+  res = active.insert(pending.extract(pending.find(2)));
+  EXPECT_FALSE(res.inserted);
+  EXPECT_EQ(res.position->second, "active two");
+  EXPECT_EQ(res.node.mapped(), "two");
+  res.node.key() = 20;
+  auto it = active.insert(active.end(), std::move(res.node));
+  EXPECT_EQ(it->first, 20);
+  EXPECT_EQ(it->second, "two");
+
+  EXPECT_EQ(pending.size(), 1);
+  EXPECT_EQ(active.size(), 3);
+  EXPECT_TRUE(pending.extract(5).empty());
+  EXPECT_EQ(active.at(10), "one");
+  std::vector<int> keys;
+  for (const auto& entry : active) keys.push_back(entry.first);
+  EXPECT_EQ(keys, (std::vector<int>{2, 10, 20}));
+}
+
+TEST(MapTest, IteratorsSurviveMoveAndSwap) {
+  s21::map<int, std::string> source{{1, "one"}, {2, "two"}, {3, "three"}};
+  auto it = source.find(2);
+  s21::map<int, std::string> moved(std::move(source));
+  moved.erase(it);
+  EXPECT_FALSE(moved.contains(2));
+  EXPECT_EQ(moved.size(), 2);
+
+  s21::map<int, std::string> other{{7, "seven"}};
+  it = moved.find(3);
+  auto hint = moved.find(1);
+  moved.swap(other);
+  auto nh = other.extract(it);
+  ASSERT_FALSE(nh.empty());
+  EXPECT_EQ(nh.mapped(), "three");
+  EXPECT_EQ(other.emplace_hint(hint, 0, "zero")->second, "zero");
+  std::vector<int> keys;
+  for (const auto& entry : other) keys.push_back(entry.first);
+  EXPECT_EQ(keys, (std::vector<int>{0, 1}));
+}
@@ -0,0 +1,184 @@
+#include <array>
+
+#include "testing.h"
+
+// Ресурс, считающий выделения и освобождения.
+class Counting_resource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  int deallocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Дерево запроса целиком живет в монотонной арене на стеке.
+TEST(MemoryResourceTest, MapInMonotonicArena) {
+  std::array<std::byte, 16 * 1024> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                            std::pmr::null_memory_resource());
+  s21::pmr::map<int, int> request_map(&arena);
+  for (int i = 0; i < 100; ++i) request_map.insert({i, i * i});
+  EXPECT_EQ(request_map.size(), 100);
+  EXPECT_EQ(request_map.at(9), 81);
+  EXPECT_EQ(request_map.get_allocator().resource(), &arena);
+
+  auto* first = reinterpret_cast<std::byte*>(&*request_map.find(0));
+  EXPECT_GE(first, buffer.data());
+  EXPECT_LT(first, buffer.data() + buffer.size());
+
+  request_map.erase(5);
+  EXPECT_FALSE(request_map.contains(5));
+}
+
+// В монотонной арене clear не обходит дерево, память арены не возвращается.
+TEST(MemoryResourceTest, ClearInMonotonicArena) {
+  Counting_resource upstream;
+  std::pmr::monotonic_buffer_resource arena(&upstream);
+  s21::pmr::set<int> s(&arena);
+  for (int i = 0; i < 1000; ++i) s.insert(i);
+  const int allocations = upstream.allocations;
+  s.clear();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(upstream.deallocations, 0);
+  for (int i = 0; i < 10; ++i) s.insert(i);
+  EXPECT_EQ(s.size(), 10);
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+  EXPECT_GE(upstream.allocations, allocations);
+}
+
+TEST(MemoryResourceTest, AllocatorIsNotPropagated) {
+  Counting_resource first_resource;
+  Counting_resource second_resource;
+  s21::pmr::set<int> first({1, 2, 3}, &first_resource);
+  s21::pmr::set<int> second({4, 5}, &second_resource);
+  EXPECT_EQ(first_resource.allocations, 3);
+
+  // Копия с другим аллокатором.
+  s21::pmr::set<int> copy(first, &second_resource);
+  EXPECT_EQ(copy.get_allocator().resource(), &second_resource);
+  EXPECT_EQ(second_resource.allocations, 5);
+
+  // Присваивание сохраняет ресурс получателя.
+  second = first;
+  EXPECT_EQ(second.get_allocator().resource(), &second_resource);
+  EXPECT_EQ(second_resource.deallocations, 2);
+  EXPECT_EQ(second_resource.allocations, 8);
+
+  second = std::move(first);
+  EXPECT_EQ(second.get_allocator().resource(), &second_resource);
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(first_resource.deallocations, 3);
+  EXPECT_EQ(second_resource.allocations, 11);
+  EXPECT_EQ(std::vector<int>(second.begin(), second.end()),
+            std::vector<int>({1, 2, 3}));
+
+  // Перемещение в контейнер с тем же ресурсом не выделяет память.
+  s21::pmr::set<int> moved(std::move(copy), &second_resource);
+  EXPECT_EQ(second_resource.allocations, 11);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(moved.size(), 3);
+}
+
+TEST(MemoryResourceTest, MoveBetweenResources) {
+  Counting_resource first_resource;
+  Counting_resource second_resource;
+  s21::pmr::map<int, std::string> source(&first_resource);
+  source.insert({1, std::string(100, 'a')});
+  source.insert({2, std::string(100, 'b')});
+
+  s21::pmr::map<int, std::string> target(std::move(source), &second_resource);
+  EXPECT_TRUE(source.empty());
+  EXPECT_EQ(first_resource.deallocations, 2);
+  EXPECT_EQ(second_resource.allocations, 2);
+  EXPECT_EQ(target.at(2), std::string(100, 'b'));
+}
+
+TEST(MemoryResourceTest, MergeOnSharedResource) {
+  Counting_resource resource;
+  s21::pmr::multiset<int> first({1, 3, 5}, &resource);
+  s21::pmr::multiset<int> second({2, 3, 4}, &resource);
+  const int* node_value = &*second.find(4);
+  first.merge(second);
+  EXPECT_EQ(first.size(), 6);
+  EXPECT_EQ(&*first.find(4), node_value);
+  EXPECT_EQ(resource.allocations, 6);
+
+  s21::pmr::compressed_multiset<int> counted({1, 1, 2}, &resource);
+  EXPECT_EQ(counted.count(1), 2);
+  EXPECT_EQ(resource.allocations, 8);
+}
+
+TEST(MemoryResourceTest, PoolResource) {
+  Counting_resource upstream;
+  s21::pmr::pool_resource pool(64, &upstream);
+  EXPECT_EQ(pool.upstream_resource(), &upstream);
+  {
+    s21::pmr::set<int> first(&pool);
+    s21::pmr::map<int, std::string> second(&pool);
+    for (int i = 0; i < 1000; ++i) {
+      first.insert(i);
+      second.insert({i, "value"});
+    }
+    EXPECT_EQ(first.size(), 1000);
+    EXPECT_EQ(second.at(999), "value");
+    // Ноды меньше max_block_size не доходят до upstream.
+    EXPECT_EQ(upstream.allocations, 0);
+  }
+  EXPECT_GT(pool.release(), 0);
+
+  void* large = pool.allocate(1024);
+  EXPECT_EQ(upstream.allocations, 1);
+  pool.deallocate(large, 1024);
+  EXPECT_EQ(upstream.deallocations, 1);
+
+  void* small = pool.allocate(24, 8);
+  void* other = pool.allocate(24, 8);
+  EXPECT_NE(small, other);
+  pool.deallocate(small, 24, 8);
+  pool.deallocate(other, 24, 8);
+  EXPECT_TRUE(pool.is_equal(pool));
+}
+
+TEST(MemoryResourceTest, PoolAllocatorConstructors) {
+  using Pool = s21::pool_allocator<long>;
+  s21::set<long, std::less<long>, Pool> set({3, 1, 2}, Pool(16, 0, true));
+  EXPECT_TRUE(set.get_allocator().huge_pages());
+  EXPECT_EQ(set.get_allocator().chunk_size(), 16);
+  EXPECT_EQ(*set.begin(), 1);
+}
+
+// На общем ресурсе ноды переходят без выделений, между разными ресурсами
+// значение перемещается в новую ноду.
+TEST(MemoryResourceTest, NodeHandlesBetweenResources) {
+  Counting_resource shared;
+  s21::pmr::map<int, int> pending(&shared);
+  s21::pmr::map<int, int> active(&shared);
+  for (int i = 0; i < 100; ++i) pending.insert({i, i});
+  const int allocations = shared.allocations;
+  while (!pending.empty()) active.insert(pending.extract(pending.begin()));
+  EXPECT_EQ(shared.allocations, allocations);
+  EXPECT_EQ(shared.deallocations, 0);
+  EXPECT_EQ(active.size(), 100);
+
+  Counting_resource separate;
+  s21::pmr::map<int, int> archive(&separate);
+  auto nh = active.extract(7);
+  EXPECT_EQ(nh.get_allocator().resource(), &shared);
+  EXPECT_TRUE(archive.insert(std::move(nh)).inserted);
+  EXPECT_EQ(separate.allocations, 1);
+  EXPECT_EQ(shared.deallocations, 1);
+  EXPECT_EQ(archive.at(7), 7);
+}
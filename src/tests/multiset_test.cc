@@ -216,3 +216,147 @@ TEST_F(S21MultisetTest, InsertMany_MixedTypes) {
 
   EXPECT_EQ(std_mset.size(), mset1.size());
 }
+
+TEST_F(S21MultisetTest, RangeConstructor) {
+  std::vector<int> values = {4, 1, 4, 2, 1, 4};
+  s21::multiset<int> mset(values.begin(), values.end());
+  std::multiset<int> std_temp(values.begin(), values.end());
+
+  EXPECT_EQ(mset.size(), std_temp.size());
+  EXPECT_TRUE(std::equal(std_temp.begin(), std_temp.end(), mset.begin()));
+  EXPECT_EQ(mset.count(4), 3);
+}
+
+TEST_F(S21MultisetTest, SortedRangeConstructor) {
+  std::vector<int> values = {1, 2, 2, 2, 7};
+  s21::multiset<int> mset(s21::sorted_range, values.begin(), values.end());
+
+  EXPECT_EQ(mset.size(), 5);
+  EXPECT_EQ(mset.count(2), 3);
+
+  mset.assign_sorted(values.begin() + 3, values.end());
+  EXPECT_EQ(mset.size(), 2);
+  EXPECT_EQ(*mset.begin(), 2);
+}
+
+TEST_F(S21MultisetTest, TransparentLookup) {
+  s21::multiset<std::string, std::less<>> words{"b", "a", "b", "c", "b"};
+  std::string_view key = "b";
+
+  EXPECT_EQ(words.count(key), 3);
+  EXPECT_TRUE(words.contains("c"));
+  EXPECT_EQ(*words.find(key), "b");
+
+  auto range = words.equal_range(key);
+  EXPECT_EQ(std::distance(range.first, range.second), 3);
+  EXPECT_EQ(*range.second, "c");
+  EXPECT_EQ(*words.lower_bound("b"), "b");
+  EXPECT_EQ(*words.upper_bound("a"), "b");
+
+  EXPECT_EQ(words.erase("b"), 1);
+  EXPECT_EQ(words.count("b"), 2);
+}
+
+TEST_F(S21MultisetTest, EmplaceAndRvalueInsert) {
+  s21::multiset<std::string> words;
+  std::string word = "a";
+
+  words.insert(std::move(word));
+  words.emplace(1, 'a');
+  auto it = words.emplace_hint(words.begin(), "b");
+
+  EXPECT_EQ(*it, "b");
+  EXPECT_EQ(words.count("a"), 2);
+  EXPECT_EQ(words.size(), 3);
+}
+
+TEST_F(S21MultisetTest, HintedInsert) {
+  s21::multiset<int> my_set;
+  std::multiset<int> std_set;
+
+  for (int i = 0; i < 50; ++i) {
+    my_set.insert(my_set.end(), i / 5);
+    std_set.insert(std_set.end(), i / 5);
+  }
+  // Равный ключ вставляется непосредственно перед подсказкой.
+  auto hint = my_set.find(3);
+  auto it = my_set.insert(hint, 3);
+  EXPECT_EQ(std::next(it), hint);
+  std_set.insert(3);
+
+  // Неверная подсказка.
+  my_set.insert(my_set.begin(), 7);
+  std_set.insert(7);
+  my_set.emplace_hint(my_set.end(), 0);
+  std_set.insert(0);
+
+  EXPECT_EQ(my_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(std_set.begin(), std_set.end(), my_set.begin()));
+  EXPECT_EQ(my_set.count(3), 6);
+}
+
+TEST_F(S21MultisetTest, OrderStatistics) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::Sized_node>
+      ranked;
+  for (int i = 0; i < 20000; ++i) ranked.insert(i % 100 == 0 ? i : 42);
+
+  EXPECT_EQ(ranked.count(42), 19800);
+  EXPECT_EQ(ranked.count(0), 1);
+  EXPECT_EQ(ranked.count(41), 0);
+  EXPECT_EQ(ranked.rank(42), 1);
+  EXPECT_EQ(ranked.rank(100), 19801);
+  EXPECT_EQ(*ranked.nth(0), 0);
+  EXPECT_EQ(*ranked.nth(19800), 42);
+  EXPECT_EQ(*ranked.nth(19801), 100);
+  EXPECT_EQ(ranked.nth(ranked.size()), ranked.end());
+
+  auto range = ranked.equal_range(42);
+  EXPECT_EQ(range.second - range.first, 19800);
+  EXPECT_EQ(ranked.index_of(range.second), 19801);
+  EXPECT_EQ(ranked.index_of(ranked.end()), ranked.size());
+
+  ranked.erase(ranked.find(42));
+  EXPECT_EQ(ranked.count(42), 19799);
+}
+
+TEST_F(S21MultisetTest, NodeHandles) {
+  using Ranked = s21::multiset<int, std::less<int>, std::allocator<int>,
+                               s21::Compact_sized_node>;
+  Ranked pending;
+  Ranked active;
+  for (int i = 0; i < 1000; ++i) pending.insert(i % 10);
+  while (!pending.empty()) {
+    active.insert(active.end(), pending.extract(pending.begin()));
+  }
+  EXPECT_EQ(active.size(), 1000);
+  EXPECT_EQ(active.count(7), 100);
+  EXPECT_EQ(active.rank(5), 500);
+  EXPECT_TRUE(std::is_sorted(active.begin(), active.end()));
+
+  for (int i = 0; i < 500; ++i) pending.insert(active.extract(i % 10));
+  EXPECT_EQ(active.size(), 500);
+  EXPECT_EQ(pending.size(), 500);
+  EXPECT_EQ(*pending.nth(499), 9);
+  EXPECT_EQ(pending.count(3), 50);
+  EXPECT_EQ(active.count(3), 50);
+  EXPECT_EQ(pending.insert(Ranked::node_type{}), pending.end());
+}
+
+TEST_F(S21MultisetTest, IteratorsSurviveMoveAndSwap) {
+  s21::multiset<int> source{1, 2, 2, 3};
+  auto it = source.find(2);
+  s21::multiset<int> moved(std::move(source));
+  moved.erase(it);
+  EXPECT_EQ(moved.count(2), 1);
+  EXPECT_EQ(moved.size(), 3);
+
+  s21::multiset<int> other{9};
+  it = moved.find(3);
+  auto hint = moved.find(1);
+  moved.swap(other);
+  EXPECT_EQ(other.extract(it).value(), 3);
+  other.insert(hint, 1);
+  EXPECT_EQ(other.count(1), 2);
+  EXPECT_EQ(other.size(), 3);
+  EXPECT_TRUE(std::is_sorted(other.begin(), other.end()));
+}
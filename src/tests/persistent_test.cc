@@ -0,0 +1,265 @@
+#include <random>
+#include <thread>
+
+#include "testing.h"
+
+namespace {
+
+// Ресурс, считающий выделения нод.
+class Counting_resource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  int deallocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Значение, копирование которого бросает исключение по команде.
+struct Fragile {
+  static inline int copies_left = -1;
+
+  int value;
+
+  Fragile(int v = 0) : value(v) {}
+  Fragile(const Fragile& other) : value(other.value) {
+    if (copies_left >= 0 && copies_left-- == 0) throw std::runtime_error("");
+  }
+  Fragile& operator=(const Fragile&) = default;
+};
+
+template <typename Map, typename Expected>
+void ExpectSameMap(const Map& actual, const Expected& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  auto it = expected.begin();
+  for (const auto& [key, value] : actual) {
+    EXPECT_EQ(key, it->first);
+    EXPECT_EQ(value, it->second);
+    ++it;
+  }
+}
+
+}  // namespace
+
+TEST(PersistentMapTest, Basic) {
+  s21::persistent_map<int, std::string> map = {{2, "two"}, {1, "one"}};
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.at(1), "one");
+  EXPECT_THROW(map.at(3), std::out_of_range);
+  EXPECT_TRUE(map.insert({3, "three"}).second);
+  EXPECT_FALSE(map.insert(3, "tres").second);
+  EXPECT_FALSE(map.insert_or_assign(3, "tres").second);
+  EXPECT_EQ(map.find(3)->second, "tres");
+  EXPECT_TRUE(map.try_emplace(4, 3, 'x').second);
+  EXPECT_EQ(map[4], "xxx");
+  map[5] = "five";
+  map.at(1) = "uno";
+  EXPECT_EQ(map.emplace(6, "six").first->first, 6);
+  EXPECT_EQ(map.erase(2), 1);
+  EXPECT_EQ(map.erase(2), 0);
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(map.count(5), 1);
+
+  std::vector<int> keys;
+  for (const auto& [key, value] : map) keys.push_back(key);
+  EXPECT_EQ(keys, (std::vector<int>{1, 3, 4, 5, 6}));
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(PersistentMapTest, Iterators) {
+  s21::persistent_map<int, int> map;
+  for (int i = 0; i < 1000; i += 2) map[i] = i;
+  EXPECT_EQ(map.lower_bound(10)->first, 10);
+  EXPECT_EQ(map.lower_bound(11)->first, 12);
+  EXPECT_EQ(map.upper_bound(10)->first, 12);
+  EXPECT_EQ(map.lower_bound(999), map.end());
+  EXPECT_EQ(std::prev(map.end())->first, 998);
+  EXPECT_EQ(std::distance(map.begin(), map.end()), 500);
+
+  int expected = 998;
+  for (auto it = map.end(); it != map.begin();) {
+    --it;
+    EXPECT_EQ(it->first, expected);
+    expected -= 2;
+  }
+  EXPECT_EQ(expected, -2);
+
+  auto it = map.find(500);
+  auto copy = it;
+  EXPECT_EQ((++copy)->first, 502);
+  EXPECT_EQ((--it)->first, 498);
+  EXPECT_EQ(map.find(501), map.end());
+}
+
+// Изменения оригинала и снимков не видны друг другу.
+TEST(PersistentMapTest, SnapshotsAreIndependent) {
+  std::mt19937 gen(42);
+  s21::persistent_map<int, int> map;
+  std::map<int, int> expected;
+  std::vector<std::pair<s21::persistent_map<int, int>, std::map<int, int>>>
+      snapshots;
+  for (int op = 0; op < 20000; ++op) {
+    const int key = static_cast<int>(gen() % 500);
+    switch (gen() % 5) {
+      case 0:
+      case 1:
+        map[key] = op;
+        expected[key] = op;
+        break;
+      case 2:
+      case 3:
+        EXPECT_EQ(map.erase(key), expected.erase(key));
+        break;
+      default:
+        if (snapshots.size() < 16) {
+          snapshots.emplace_back(map.snapshot(), expected);
+        } else {
+          snapshots[gen() % 16] = {map.snapshot(), expected};
+        }
+    }
+    // Снимки тоже меняются и не должны задевать оригинал.
+    if (op % 97 == 0 && !snapshots.empty()) {
+      auto& [snapshot, snapshot_expected] = snapshots[gen() % snapshots.size()];
+      snapshot.erase(key);
+      snapshot_expected.erase(key);
+      snapshot.insert_or_assign(key + 1, -op);
+      snapshot_expected.insert_or_assign(key + 1, -op);
+    }
+  }
+  ExpectSameMap(map, expected);
+  for (const auto& [snapshot, snapshot_expected] : snapshots) {
+    ExpectSameMap(snapshot, snapshot_expected);
+  }
+}
+
+// Снимок не выделяет память, а изменение после него копирует только путь.
+TEST(PersistentMapTest, SnapshotCopiesOnlyPath) {
+  Counting_resource resource;
+  {
+    s21::pmr::persistent_map<int, int> map(&resource);
+    constexpr int kSize = 1 << 16;
+    for (int i = 0; i < kSize; ++i) map[i] = i;
+    const int built = resource.allocations;
+
+    const auto snapshot = map.snapshot();
+    EXPECT_EQ(resource.allocations, built);
+    EXPECT_TRUE(map.shares_nodes_with(snapshot));
+
+    map[kSize / 2] = -1;
+    // Высота красно-черного дерева не больше 2 log2(n + 1) = 34.
+    EXPECT_LE(resource.allocations - built, 34);
+    EXPECT_GT(resource.allocations - built, 0);
+    EXPECT_FALSE(map.shares_nodes_with(snapshot));
+
+    const int before_erase = resource.allocations;
+    map.erase(kSize / 4);
+    EXPECT_LE(resource.allocations - before_erase, 2 * 34);
+    EXPECT_EQ(snapshot.at(kSize / 2), kSize / 2);
+    EXPECT_EQ(snapshot.at(kSize / 4), kSize / 4);
+    EXPECT_EQ(snapshot.size(), kSize);
+    EXPECT_EQ(map.size(), kSize - 1);
+
+    // Без снимков изменения выполняются на месте.
+    s21::pmr::persistent_map<int, int> alone(&resource);
+    for (int i = 0; i < 100; ++i) alone[i] = i;
+    const int before_update = resource.allocations;
+    alone[50] = -1;
+    alone.erase(10);
+    EXPECT_EQ(resource.allocations, before_update);
+  }
+  EXPECT_EQ(resource.allocations, resource.deallocations);
+}
+
+// Исключение при копировании разделяемых нод оставляет контейнер и снимки
+// прежними.
+TEST(PersistentMapTest, StrongExceptionGuarantee) {
+  std::mt19937 gen(7);
+  s21::persistent_map<int, Fragile> map;
+  std::map<int, int> expected;
+  for (int i = 0; i < 300; ++i) {
+    const int key = static_cast<int>(gen() % 600);
+    map.insert_or_assign(key, Fragile(i));
+    expected[key] = i;
+  }
+  int thrown = 0;
+  for (int op = 0; op < 2000; ++op) {
+    const auto snapshot = map.snapshot();
+    const int key = static_cast<int>(gen() % 600);
+    Fragile::copies_left = static_cast<int>(gen() % 8);
+    try {
+      if (op % 2 == 0) {
+        map.insert_or_assign(key, Fragile(op));
+        expected[key] = op;
+      } else {
+        map.erase(key);
+        expected.erase(key);
+      }
+    } catch (const std::runtime_error&) {
+      ++thrown;
+    }
+    Fragile::copies_left = -1;
+    ASSERT_EQ(map.size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& [map_key, value] : map) {
+      EXPECT_EQ(map_key, it->first);
+      EXPECT_EQ(value.value, it->second);
+      ++it;
+    }
+  }
+  EXPECT_GT(thrown, 0);
+}
+
+// Снимок читается и уничтожается в другом потоке, пока оригинал меняется.
+TEST(PersistentMapTest, SnapshotInAnotherThread) {
+  s21::persistent_map<int, int> map;
+  for (int i = 0; i < 10000; ++i) map[i] = i;
+  for (int round = 0; round < 4; ++round) {
+    auto snapshot = map.snapshot();
+    std::thread reader([snapshot = std::move(snapshot), round]() mutable {
+      long sum = 0;
+      for (const auto& [key, value] : snapshot) sum += value - key;
+      EXPECT_EQ(sum, 10000L * round);
+      snapshot.clear();
+    });
+    for (int i = 0; i < 10000; ++i) ++map[i];
+    reader.join();
+  }
+  EXPECT_EQ(map.at(9999), 9999 + 4);
+}
+
+TEST(PersistentSetTest, Basic) {
+  s21::persistent_set<std::string> set = {"b", "a", "c", "a"};
+  EXPECT_EQ(set.size(), 3);
+  auto snapshot = set.snapshot();
+  EXPECT_TRUE(set.insert("d").second);
+  EXPECT_FALSE(set.emplace("a").second);
+  EXPECT_EQ(set.erase("b"), 1);
+  EXPECT_EQ(std::vector<std::string>(set.begin(), set.end()),
+            (std::vector<std::string>{"a", "c", "d"}));
+  EXPECT_EQ(std::vector<std::string>(snapshot.begin(), snapshot.end()),
+            (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(*set.lower_bound("b"), "c");
+
+  s21::persistent_set<int, std::less<int>, s21::pool_allocator<int>> pooled;
+  for (int i = 0; i < 1000; ++i) pooled.insert(i);
+  auto pooled_snapshot = pooled;
+  for (int i = 0; i < 1000; i += 2) pooled.erase(i);
+  EXPECT_EQ(pooled.size(), 500);
+  EXPECT_EQ(pooled_snapshot.size(), 1000);
+  EXPECT_TRUE(pooled_snapshot.contains(0));
+}
@@ -1,5 +1,9 @@
 #include <cstdio>  // Для rand().
 
+#include <mutex>
+#include <random>
+#include <thread>
+
 #include "testing.h"
 
 // Проверка инициализации пустого дерева.
@@ -88,13 +92,34 @@ TEST(RbTreeTest, ConstIterationBeginEnd) {
   EXPECT_TRUE(typeid(c_end) == typeid(decltype(tree)::const_iterator));
 }
 
+// Цвет ноды с отдельным полем или с цветом в указателе на родителя
+template <typename NodeType>
+s21::Node_color ColorOf(const NodeType* node) {
+  if constexpr (requires { node->parent(); }) {
+    return node->color();
+  } else {
+    return node->color;
+  }
+}
+
+// Родитель ноды с отдельным полем или с цветом в указателе на родителя
+template <typename NodeType>
+const NodeType* ParentOf(const NodeType* node) {
+  if constexpr (requires { node->parent(); }) {
+    return node->parent();
+  } else {
+    return node->p;
+  }
+}
+
 // Вспомогательная функция для проверки отсутствия двух красных узлов подряд
-void CheckNoDoubleRed(s21::Node<int>* node, const s21::Node<int>* nil) {
+template <typename NodeType>
+void CheckNoDoubleRed(NodeType* node, const NodeType* nil) {
   if (node == nil) return;
 
-  if (node->color == s21::Red) {
-    EXPECT_EQ(node->left->color, s21::Black);
-    EXPECT_EQ(node->right->color, s21::Black);
+  if (ColorOf(node) == s21::Red) {
+    EXPECT_EQ(ColorOf(node->left), s21::Black);
+    EXPECT_EQ(ColorOf(node->right), s21::Black);
   }
 
   CheckNoDoubleRed(node->left, nil);
@@ -102,7 +127,8 @@ void CheckNoDoubleRed(s21::Node<int>* node, const s21::Node<int>* nil) {
 }
 
 // Вспомогательная функция для проверки чёрной высоты
-int CheckBlackHeight(s21::Node<int>* node, const s21::Node<int>* nil) {
+template <typename NodeType>
+int CheckBlackHeight(NodeType* node, const NodeType* nil) {
   if (node == nil) return 1;
 
   int left_height = CheckBlackHeight(node->left, nil);
@@ -110,7 +136,33 @@ int CheckBlackHeight(s21::Node<int>* node, const s21::Node<int>* nil) {
 
   EXPECT_EQ(left_height, right_height);
 
-  return (node->color == s21::Black) ? left_height + 1 : left_height;
+  return (ColorOf(node) == s21::Black) ? left_height + 1 : left_height;
+}
+
+// Вспомогательная функция для проверки ссылок на родителей
+template <typename NodeType>
+void CheckParents(const NodeType* node, const NodeType* nil) {
+  if (node == nil) return;
+
+  if (node->left != nil) {
+    EXPECT_EQ(ParentOf(node->left), node);
+  }
+  if (node->right != nil) {
+    EXPECT_EQ(ParentOf(node->right), node);
+  }
+  CheckParents(node->left, nil);
+  CheckParents(node->right, nil);
+}
+
+// Вспомогательная функция для проверки размеров поддеревьев
+template <typename NodeType>
+std::size_t CheckSizes(const NodeType* node, const NodeType* nil) {
+  if (node == nil) return 0;
+
+  std::size_t size =
+      CheckSizes(node->left, nil) + CheckSizes(node->right, nil) + 1;
+  EXPECT_EQ(node->size, size);
+  return size;
 }
 
 #include <cstdio>
@@ -514,4 +566,582 @@ TEST(RbTreeTest, MoveConstructorOperator) {
   tree22 = std::move(tree11);
   EXPECT_EQ(tree11.size(), 0);
   EXPECT_EQ(tree22.size(), 2);
-}
\ No newline at end of file
+}
+// Проверка сборки дерева из упорядоченного диапазона.
+TEST(RbTreeTest, AssignSortedProperties) {
+  for (int n = 0; n <= 70; ++n) {
+    std::vector<int> values(n);
+    for (int i = 0; i < n; ++i) values[i] = i;
+
+    s21::Rb_tree<int, int> tree;
+    tree.insert(100, 100);
+    tree.assign_sorted(values.begin(), values.end(), true);
+
+    EXPECT_EQ(tree.size(), static_cast<size_t>(n));
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), tree.begin()));
+    EXPECT_EQ(tree.get_root()->color, s21::Black);
+    CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+    CheckBlackHeight(tree.get_root(), tree.get_nil());
+
+    // Дерево остается рабочим после сборки.
+    tree.insert(-1, -1);
+    if (n > 0) tree.delete_node(tree.search(n / 2));
+    CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+    CheckBlackHeight(tree.get_root(), tree.get_nil());
+  }
+}
+
+// Проверка сборки дерева из неупорядоченного диапазона с дубликатами.
+TEST(RbTreeTest, AssignRangeUnsorted) {
+  std::vector<int> values = {5, 3, 9, 3, 1, 7, 5, 2};
+
+  s21::Rb_tree<int, int> unique_tree(values.begin(), values.end(), true);
+  std::set<int> std_set(values.begin(), values.end());
+  EXPECT_EQ(unique_tree.size(), std_set.size());
+  EXPECT_TRUE(std::equal(std_set.begin(), std_set.end(), unique_tree.begin()));
+  CheckBlackHeight(unique_tree.get_root(), unique_tree.get_nil());
+
+  s21::Rb_tree<int, int> multi_tree(values.begin(), values.end(), false);
+  std::multiset<int> std_mset(values.begin(), values.end());
+  EXPECT_EQ(multi_tree.size(), std_mset.size());
+  EXPECT_TRUE(std::equal(std_mset.begin(), std_mset.end(), multi_tree.begin()));
+  CheckNoDoubleRed(multi_tree.get_root(), multi_tree.get_nil());
+}
+
+// Проверка вставки с подсказкой: верные, неверные и пустые подсказки.
+TEST(RbTreeTest, EmplaceHintProperties) {
+  s21::Rb_tree<int, int> tree;
+  std::set<int> std_set;
+
+  // Возрастающая последовательность с подсказкой end().
+  for (int i = 0; i < 64; i += 2) {
+    tree.emplace_hint(tree.get_nil(), true, i);
+    std_set.insert(i);
+  }
+  // Нечетные ключи вставляются перед следующим четным.
+  for (int i = 1; i < 64; i += 2) {
+    auto res = tree.emplace_hint(tree.search(i + 1), true, i);
+    EXPECT_TRUE(res.second);
+    std_set.insert(i);
+  }
+  // Неверная подсказка и дубликат.
+  tree.emplace_hint(tree.search(0), true, 100);
+  std_set.insert(100);
+  auto dup = tree.emplace_hint(tree.search(10), true, 10);
+  EXPECT_FALSE(dup.second);
+  EXPECT_EQ(dup.first, tree.search(10));
+
+  EXPECT_EQ(tree.size(), std_set.size());
+  EXPECT_TRUE(std::equal(std_set.begin(), std_set.end(), tree.begin()));
+  EXPECT_EQ(*tree.begin(), 0);
+  EXPECT_EQ(*--tree.end(), 100);
+  CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+  CheckBlackHeight(tree.get_root(), tree.get_nil());
+
+  // Повторяющиеся ключи вставляются перед подсказкой.
+  s21::Rb_tree<int, int> multi_tree;
+  for (int i = 0; i < 20; ++i) {
+    multi_tree.emplace_hint(multi_tree.begin().get_current(), false, i % 3);
+  }
+  EXPECT_EQ(multi_tree.size(), 20u);
+  EXPECT_TRUE(std::is_sorted(multi_tree.begin(), multi_tree.end()));
+  CheckNoDoubleRed(multi_tree.get_root(), multi_tree.get_nil());
+  CheckBlackHeight(multi_tree.get_root(), multi_tree.get_nil());
+}
+
+// Проверка линейного слияния и слияния вставкой по одной ноде для деревьев
+// разного размера и аллокаторов, которые не позволяют переносить ноды.
+template <typename Tree>
+void CheckMerge(int first_size, int second_size, bool unique_keys) {
+  Tree tree1;
+  Tree tree2;
+  std::multiset<int> expected1;
+  std::multiset<int> expected2;
+  for (int i = 0; i < first_size; ++i) {
+    tree1.insert(i * 3, i * 3, unique_keys);
+    expected1.insert(i * 3);
+  }
+  for (int i = 0; i < second_size; ++i) {
+    tree2.insert(i * 2, i * 2, unique_keys);
+    if (unique_keys && expected1.count(i * 2)) {
+      expected2.insert(i * 2);
+    } else {
+      expected1.insert(i * 2);
+    }
+  }
+
+  tree1.merge(&tree2, unique_keys);
+
+  EXPECT_EQ(tree1.size(), expected1.size());
+  EXPECT_EQ(tree2.size(), expected2.size());
+  EXPECT_TRUE(std::equal(expected1.begin(), expected1.end(), tree1.begin()));
+  EXPECT_TRUE(std::equal(expected2.begin(), expected2.end(), tree2.begin()));
+  for (Tree* tree : {&tree1, &tree2}) {
+    EXPECT_EQ(ColorOf(tree->get_root()), s21::Black);
+    CheckParents(tree->get_root(), tree->get_nil());
+    CheckNoDoubleRed(tree->get_root(), tree->get_nil());
+    CheckBlackHeight(tree->get_root(), tree->get_nil());
+    if constexpr (Tree::sized_nodes) {
+      EXPECT_EQ(CheckSizes(tree->get_root(), tree->get_nil()), tree->size());
+    }
+  }
+
+  // Деревья остаются рабочими после слияния.
+  tree1.insert(-1, -1, unique_keys);
+  tree2.insert(-1, -1, unique_keys);
+  EXPECT_EQ(*tree1.begin(), -1);
+  EXPECT_EQ(*tree2.begin(), -1);
+}
+
+TEST(RbTreeTest, MergeLinearAndByNodes) {
+  using Tree = s21::Rb_tree<int, int>;
+  using PoolTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                s21::pool_allocator<int>>;
+  for (bool unique_keys : {true, false}) {
+    // Линейное слияние.
+    CheckMerge<Tree>(300, 200, unique_keys);
+    CheckMerge<Tree>(0, 50, unique_keys);
+    CheckMerge<PoolTree>(300, 200, unique_keys);
+    // Вставка по одной ноде.
+    CheckMerge<Tree>(2000, 3, unique_keys);
+    CheckMerge<PoolTree>(2000, 3, unique_keys);
+    // Размеры поддеревьев после обоих способов слияния.
+    using SizedTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                   std::allocator<int>, s21::Sized_node>;
+    CheckMerge<SizedTree>(300, 200, unique_keys);
+    CheckMerge<SizedTree>(2000, 3, unique_keys);
+    // Цвет в указателе на родителя.
+    using CompactTree =
+        s21::Rb_tree<int, int, std::identity, std::less<int>,
+                     std::allocator<int>, s21::Compact_sized_node>;
+    CheckMerge<CompactTree>(300, 200, unique_keys);
+    CheckMerge<CompactTree>(2000, 3, unique_keys);
+  }
+}
+
+// Проверка операций над множествами на основе split/join.
+template <typename Tree>
+void CheckSetAlgebra(int first_size, int second_size, bool parallel) {
+  std::mt19937 gen(first_size * 31 + second_size);
+  std::uniform_int_distribution<int> dist(0, 2 * (first_size + second_size));
+  std::set<int> first;
+  std::set<int> second;
+  while (static_cast<int>(first.size()) < first_size) first.insert(dist(gen));
+  while (static_cast<int>(second.size()) < second_size) {
+    second.insert(dist(gen));
+  }
+
+  auto fill = [](Tree& tree, const std::set<int>& values) {
+    tree.assign_range(values.begin(), values.end(), true);
+  };
+  auto check = [](Tree& tree, const std::vector<int>& expected) {
+    EXPECT_EQ(tree.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(),
+                           tree.end()));
+    EXPECT_EQ(ColorOf(tree.get_root()), s21::Black);
+    CheckParents(tree.get_root(), tree.get_nil());
+    CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+    CheckBlackHeight(tree.get_root(), tree.get_nil());
+    if constexpr (Tree::sized_nodes) {
+      EXPECT_EQ(CheckSizes(tree.get_root(), tree.get_nil()), tree.size());
+    }
+    // Крайние ноды пересчитаны.
+    if (!expected.empty()) {
+      EXPECT_EQ(*tree.begin(), expected.front());
+      EXPECT_EQ(*--tree.end(), expected.back());
+    }
+  };
+
+  std::vector<int> expected;
+  Tree tree;
+  Tree other;
+  fill(tree, first);
+  fill(other, second);
+  tree.unite(other, parallel);
+  std::set_union(first.begin(), first.end(), second.begin(), second.end(),
+                 std::back_inserter(expected));
+  check(tree, expected);
+  EXPECT_TRUE(other.empty());
+
+  expected.clear();
+  fill(tree, first);
+  fill(other, second);
+  tree.intersect(other, parallel);
+  std::set_intersection(first.begin(), first.end(), second.begin(),
+                        second.end(), std::back_inserter(expected));
+  check(tree, expected);
+  EXPECT_EQ(other.size(), second.size());
+
+  expected.clear();
+  fill(tree, first);
+  tree.subtract(other, parallel);
+  std::set_difference(first.begin(), first.end(), second.begin(),
+                      second.end(), std::back_inserter(expected));
+  check(tree, expected);
+
+  expected.clear();
+  fill(tree, first);
+  tree.symmetric_subtract(other, parallel);
+  std::set_symmetric_difference(first.begin(), first.end(), second.begin(),
+                                second.end(), std::back_inserter(expected));
+  check(tree, expected);
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(RbTreeTest, SetAlgebraProperties) {
+  using Tree = s21::Rb_tree<int, int>;
+  using PoolTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                s21::pool_allocator<int>>;
+  for (auto [first_size, second_size] :
+       {std::pair{0, 0}, std::pair{0, 10}, std::pair{10, 0}, std::pair{1, 1},
+        std::pair{100, 100}, std::pair{1000, 7}, std::pair{7, 1000}}) {
+    CheckSetAlgebra<Tree>(first_size, second_size, false);
+    CheckSetAlgebra<PoolTree>(first_size, second_size, false);
+  }
+  CheckSetAlgebra<Tree>(30000, 20000, true);
+  CheckSetAlgebra<PoolTree>(30000, 20000, true);
+
+  using SizedTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                 std::allocator<int>, s21::Sized_node>;
+  CheckSetAlgebra<SizedTree>(100, 100, false);
+  CheckSetAlgebra<SizedTree>(1000, 7, false);
+  CheckSetAlgebra<SizedTree>(30000, 20000, true);
+
+  using CompactTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                   s21::pool_allocator<int>, s21::Compact_node>;
+  CheckSetAlgebra<CompactTree>(100, 100, false);
+  CheckSetAlgebra<CompactTree>(1000, 7, false);
+  CheckSetAlgebra<CompactTree>(30000, 20000, true);
+}
+
+// Проверка порядковой статистики при вставках, удалениях и копировании.
+TEST(RbTreeTest, OrderStatistics) {
+  using SizedTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                 std::allocator<int>, s21::Sized_node>;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(0, 300);
+  SizedTree tree;
+  std::multiset<int> expected;
+  auto check = [&expected](const SizedTree& checked) {
+    EXPECT_EQ(CheckSizes(checked.get_root(), checked.get_nil()),
+              expected.size());
+    std::size_t index = 0;
+    for (auto it = expected.begin(); it != expected.end(); ++it, ++index) {
+      EXPECT_EQ(checked.select(index)->val, *it);
+    }
+    EXPECT_EQ(checked.select(expected.size()), checked.get_nil());
+    for (int key = -1; key <= 301; key += 5) {
+      auto lower = std::distance(expected.begin(), expected.lower_bound(key));
+      auto upper = std::distance(expected.begin(), expected.upper_bound(key));
+      EXPECT_EQ(checked.rank(key), static_cast<std::size_t>(lower));
+      EXPECT_EQ(checked.upper_rank(key), static_cast<std::size_t>(upper));
+      EXPECT_EQ(checked.position(checked.lower_bound(key)),
+                static_cast<std::size_t>(lower));
+    }
+    EXPECT_EQ(checked.end() - checked.begin(),
+              static_cast<std::ptrdiff_t>(expected.size()));
+  };
+
+  for (int i = 0; i < 2000; ++i) {
+    int value = dist(gen);
+    if (i % 3 == 2) {
+      auto* node = tree.search(value);
+      if (node != tree.get_nil()) {
+        tree.delete_node(node);
+        expected.erase(expected.find(value));
+      }
+    } else {
+      tree.insert(value, value, false);
+      expected.insert(value);
+    }
+  }
+  check(tree);
+
+  SizedTree copy(tree);
+  check(copy);
+
+  std::vector<int> sorted(expected.begin(), expected.end());
+  tree.assign_sorted(sorted.begin(), sorted.end(), false);
+  check(tree);
+
+  auto it = tree.begin();
+  std::advance(it, 10);
+  EXPECT_EQ(it - tree.begin(), 10);
+  EXPECT_EQ(tree.begin() - it, -10);
+}
+
+// Компактные ноды не хранят цвет отдельным полем.
+TEST(RbTreeTest, CompactNodeLayout) {
+  static_assert(sizeof(s21::Compact_node<long>) == 4 * sizeof(void*));
+  static_assert(sizeof(s21::Compact_node<long>) < sizeof(s21::Node<long>));
+  static_assert(sizeof(s21::Compact_sized_node<long>) <
+                sizeof(s21::Sized_node<long>));
+  static_assert(sizeof(s21::Compact_node<std::pair<const int, int>>) <
+                sizeof(s21::Node<std::pair<const int, int>>));
+
+  s21::Compact_node<long> node(std::in_place, 5);
+  s21::Compact_node<long> parent(std::in_place, 7);
+  EXPECT_EQ(node.color(), s21::Red);
+  EXPECT_EQ(node.parent(), nullptr);
+  node.set_parent(&parent);
+  node.set_color(s21::Black);
+  EXPECT_EQ(node.parent(), &parent);
+  EXPECT_EQ(node.color(), s21::Black);
+  node.set_parent(nullptr);
+  EXPECT_EQ(node.color(), s21::Black);
+  node.set_color(s21::Red);
+  EXPECT_EQ(node.parent(), nullptr);
+}
+
+// Вставки и удаления в дереве с компактными нодами.
+TEST(RbTreeTest, CompactNodeProperties) {
+  using CompactTree = s21::Rb_tree<long, long, std::identity, std::less<long>,
+                                   std::allocator<long>, s21::Compact_node>;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<long> dist(0, 500);
+  CompactTree tree;
+  std::multiset<long> expected;
+  for (int i = 0; i < 3000; ++i) {
+    long value = dist(gen);
+    if (i % 3 == 2) {
+      auto* node = tree.search(value);
+      if (node != tree.get_nil()) {
+        tree.delete_node(node);
+        expected.erase(expected.find(value));
+      }
+    } else {
+      tree.insert(value, value, false);
+      expected.insert(value);
+    }
+  }
+  EXPECT_EQ(tree.size(), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(),
+                         tree.end()));
+  EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(),
+                         std::make_reverse_iterator(tree.end()),
+                         std::make_reverse_iterator(tree.begin())));
+  EXPECT_EQ(ColorOf(tree.get_root()), s21::Black);
+  CheckParents(tree.get_root(), tree.get_nil());
+  CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+  CheckBlackHeight(tree.get_root(), tree.get_nil());
+
+  CompactTree copy(tree);
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), copy.begin(), copy.end()));
+  CheckParents(copy.get_root(), copy.get_nil());
+  CheckBlackHeight(copy.get_root(), copy.get_nil());
+}
+
+// Все деревья одного типа разделяют концевую ноду, которая никогда не
+// изменяется, поэтому независимые деревья можно менять из разных потоков.
+TEST(RbTreeTest, SharedSentinel) {
+  using Tree = s21::Rb_tree<int, int, std::identity, std::less<int>>;
+  static_assert(std::is_nothrow_default_constructible_v<Tree>);
+  static_assert(std::is_nothrow_move_constructible_v<Tree>);
+
+  Tree first;
+  Tree second;
+  EXPECT_EQ(first.get_nil(), second.get_nil());
+  EXPECT_EQ(first.get_root(), first.get_nil());
+
+  std::vector<Tree> trees(4);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&tree = trees[t], t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<int> dist(0, 300);
+      for (int i = 0; i < 2000; ++i) {
+        int value = dist(gen);
+        if (i % 2 == 1) {
+          auto* node = tree.search(value);
+          if (node != tree.get_nil()) tree.delete_node(node);
+        } else {
+          tree.insert(value, value, false);
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  for (auto& tree : trees) {
+    EXPECT_TRUE(std::is_sorted(tree.begin(), tree.end()));
+    EXPECT_EQ(ColorOf(tree.get_root()), s21::Black);
+    CheckParents(tree.get_root(), tree.get_nil());
+    CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+    CheckBlackHeight(tree.get_root(), tree.get_nil());
+  }
+  EXPECT_EQ(ColorOf(first.get_nil()), s21::Black);
+}
+
+// Параллельная копия совпадает с исходным деревом и сохраняет его свойства.
+template <typename Tree>
+void CheckParallelCopy(unsigned threads) {
+  std::mt19937 gen(threads);
+  std::uniform_int_distribution<int> dist(0, 1 << 20);
+  Tree tree;
+  for (int i = 0; i < 300000; ++i) {
+    const int value = dist(gen);
+    tree.insert(value, value, false);
+  }
+
+  Tree copy(s21::execution::par, tree, threads);
+  EXPECT_EQ(copy.size(), tree.size());
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), copy.begin(), copy.end()));
+  EXPECT_EQ(*std::prev(copy.end()), *std::prev(tree.end()));
+  EXPECT_EQ(ColorOf(copy.get_root()), s21::Black);
+  CheckParents(copy.get_root(), copy.get_nil());
+  CheckNoDoubleRed(copy.get_root(), copy.get_nil());
+  CheckBlackHeight(copy.get_root(), copy.get_nil());
+  if constexpr (requires { copy.get_root()->size; }) {
+    EXPECT_EQ(CheckSizes(copy.get_root(), copy.get_nil()), copy.size());
+  }
+
+  // Копия независима от исходного дерева.
+  copy.clear();
+  EXPECT_EQ(tree.size(), 300000u);
+}
+
+// Аллокатор, запоминающий потоки, в которых выделялись ноды.
+template <typename T, bool AlwaysEqual>
+struct ThreadRecordingAllocator {
+  using value_type = T;
+  using is_always_equal = std::bool_constant<AlwaysEqual>;
+  template <typename U>
+  struct rebind {
+    using other = ThreadRecordingAllocator<U, AlwaysEqual>;
+  };
+
+  static inline std::mutex mutex;
+  static inline std::set<std::thread::id> threads;
+
+  ThreadRecordingAllocator() = default;
+  template <typename U>
+  ThreadRecordingAllocator(
+      const ThreadRecordingAllocator<U, AlwaysEqual>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ThreadRecordingAllocator<char, AlwaysEqual>::threads.insert(
+          std::this_thread::get_id());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    std::allocator<T>().deallocate(p, n);
+  }
+  bool operator==(const ThreadRecordingAllocator&) const noexcept {
+    return true;
+  }
+};
+
+// Возвращает количество потоков, выделявших ноды при параллельной копии.
+template <bool AlwaysEqual>
+std::size_t ParallelCopyThreads() {
+  using Alloc = ThreadRecordingAllocator<int, AlwaysEqual>;
+  using Tree = s21::Rb_tree<int, int, std::identity, std::less<int>, Alloc>;
+  Tree tree;
+  for (int i = 0; i < 200000; ++i) tree.insert(i, i, true);
+  ThreadRecordingAllocator<char, AlwaysEqual>::threads.clear();
+  Tree copy(s21::execution::par, tree, 4);
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), copy.begin(), copy.end()));
+  return ThreadRecordingAllocator<char, AlwaysEqual>::threads.size();
+}
+
+// Параллельно копируются только деревья с is_always_equal аллокатором.
+TEST(RbTreeTest, ParallelCopyPath) {
+  static_assert(s21::Rb_tree<int, int>::parallel_copy);
+  static_assert(
+      s21::Rb_tree<int, int, std::identity, std::less<int>,
+                   s21::concurrent_pool_allocator<int>>::parallel_copy);
+  static_assert(!s21::Rb_tree<int, int, std::identity, std::less<int>,
+                              s21::pool_allocator<int>>::parallel_copy);
+  static_assert(
+      !s21::Rb_tree<int, int, std::identity, std::less<int>,
+                    std::pmr::polymorphic_allocator<int>>::parallel_copy);
+
+  EXPECT_GT(ParallelCopyThreads<true>(), 1u);
+  EXPECT_EQ(ParallelCopyThreads<false>(), 1u);
+}
+
+TEST(RbTreeTest, ParallelCopy) {
+  CheckParallelCopy<s21::Rb_tree<int, int>>(4);
+  CheckParallelCopy<s21::Rb_tree<int, int>>(0);
+  CheckParallelCopy<
+      s21::Rb_tree<int, int, std::identity, std::less<int>,
+                   s21::concurrent_pool_allocator<int>, s21::Compact_node>>(3);
+  CheckParallelCopy<s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                 std::allocator<int>, s21::Sized_node>>(8);
+  // pool_allocator не разделяет пул между копиями, дерево копируется
+  // последовательно.
+  CheckParallelCopy<s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                 s21::pool_allocator<int>>>(4);
+}
+
+namespace {
+
+// Значение, копирование которого бросает исключение по команде из любого
+// потока.
+struct Throwing_copy {
+  static inline std::atomic<int> copies_left{-1};
+
+  int value;
+
+  Throwing_copy(int v) : value(v) {}
+  Throwing_copy(const Throwing_copy& other) : value(other.value) {
+    if (copies_left.fetch_sub(1) == 0) throw std::runtime_error("copy");
+  }
+  Throwing_copy& operator=(const Throwing_copy&) = default;
+  bool operator<(const Throwing_copy& other) const {
+    return value < other.value;
+  }
+};
+
+}  // namespace
+
+// Исключение в одном из потоков освобождает все скопированные ноды.
+TEST(RbTreeTest, ParallelCopyThrows) {
+  using Tree = s21::Rb_tree<Throwing_copy, Throwing_copy>;
+  Tree tree;
+  std::vector<int> values(200000);
+  std::iota(values.begin(), values.end(), 0);
+  tree.assign_sorted(values.begin(), values.end(), true);
+
+  for (int copies : {0, 5, 1000, 150000}) {
+    Throwing_copy::copies_left = copies;
+    EXPECT_THROW(Tree(s21::execution::par, tree, 4), std::runtime_error);
+  }
+  Throwing_copy::copies_left = -1;
+  EXPECT_EQ(tree.size(), values.size());
+  EXPECT_EQ(Tree(s21::execution::par, tree, 4).size(), values.size());
+}
+
+// Частичная очистка удаляет наименьшие элементы и сохраняет свойства дерева.
+TEST(RbTreeTest, ClearSome) {
+  using SizedTree = s21::Rb_tree<int, int, std::identity, std::less<int>,
+                                 std::allocator<int>, s21::Sized_node>;
+  std::mt19937 gen(25);
+  std::uniform_int_distribution<int> dist(0, 5000);
+  SizedTree tree;
+  std::multiset<int> expected;
+  for (int i = 0; i < 10000; ++i) {
+    const int value = dist(gen);
+    tree.insert(value, value, false);
+    expected.insert(value);
+  }
+
+  while (!tree.clear_some(700)) {
+    for (int i = 0; i < 700; ++i) expected.erase(expected.begin());
+    ASSERT_EQ(tree.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(),
+                           tree.end()));
+    EXPECT_EQ(ColorOf(tree.get_root()), s21::Black);
+    CheckParents(tree.get_root(), tree.get_nil());
+    CheckNoDoubleRed(tree.get_root(), tree.get_nil());
+    CheckBlackHeight(tree.get_root(), tree.get_nil());
+    EXPECT_EQ(CheckSizes(tree.get_root(), tree.get_nil()), tree.size());
+  }
+  EXPECT_LE(expected.size(), 700u);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+  EXPECT_TRUE(tree.clear_some(0));
+}
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <thread>
+
+#include "testing.h"
+
+namespace {
+
+// Значение, запоминающее количество уничтожений и поток последнего из них.
+struct Tracked {
+  static inline std::atomic<int> destroyed{0};
+  static inline std::atomic<std::thread::id> last_thread{};
+
+  int value;
+
+  Tracked(int v = 0) noexcept : value(v) {}
+  Tracked(const Tracked&) = default;
+  ~Tracked() {
+    destroyed.fetch_add(1);
+    last_thread.store(std::this_thread::get_id());
+  }
+};
+
+}  // namespace
+
+static_assert(s21::Reclaimable<s21::map<int, int>>);
+static_assert(s21::Reclaimable<s21::unordered_set<int>>);
+static_assert(s21::Reclaimable<
+              s21::set<int, std::less<int>,
+                       s21::concurrent_pool_allocator<int>>>);
+// Владелец и поток удаления не могут одновременно пользоваться пулом или
+// ресурсом pmr, а lvalue передается только через std::move.
+static_assert(!s21::Reclaimable<
+              s21::set<int, std::less<int>, s21::pool_allocator<int>>>);
+static_assert(!s21::Reclaimable<s21::pmr::map<int, int>>);
+static_assert(!s21::Reclaimable<s21::map<int, int>&>);
+
+TEST(ReclaimerTest, DestroysOnReclaimerThread) {
+  s21::Reclaimer reclaimer;
+  s21::map<int, Tracked> map;
+  for (int i = 0; i < 10000; ++i) map.emplace(i, i);
+  Tracked::destroyed = 0;
+
+  reclaimer.retire(std::move(map));
+  EXPECT_TRUE(map.empty());
+  map.emplace(1, 1);
+  EXPECT_EQ(map.size(), 1);
+
+  reclaimer.wait();
+  EXPECT_EQ(reclaimer.pending(), 0);
+  EXPECT_EQ(Tracked::destroyed, 10000);
+  EXPECT_NE(Tracked::last_thread.load(), std::this_thread::get_id());
+}
+
+TEST(ReclaimerTest, ManyContainersFromManyThreads) {
+  std::atomic<int> retired{0};
+  {
+    s21::Reclaimer reclaimer;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&reclaimer, &retired, t] {
+        for (int round = 0; round < 50; ++round) {
+          s21::set<int, std::less<int>, s21::concurrent_pool_allocator<int>>
+              set;
+          for (int i = 0; i < 200; ++i) set.insert(t * 1000 + i);
+          reclaimer.retire(std::move(set));
+          s21::unordered_map<int, std::string> table;
+          table[round] = "value";
+          reclaimer.retire(std::move(table));
+          retired += 2;
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    // Деструктор дожидается уничтожения оставшихся контейнеров.
+  }
+  EXPECT_EQ(retired, 400);
+}
+
+TEST(ReclaimerTest, GlobalReclaimer) {
+  s21::multiset<std::string> strings;
+  for (int i = 0; i < 1000; ++i) strings.insert(std::to_string(i % 10));
+  s21::destroy_in_background(std::move(strings));
+  EXPECT_TRUE(strings.empty());
+  s21::Reclaimer::global().wait();
+  EXPECT_EQ(s21::Reclaimer::global().pending(), 0);
+}
+
+TEST(ReclaimerTest, ClearSome) {
+  s21::map<int, std::string> map;
+  for (int i = 0; i < 2500; ++i) map[i] = std::to_string(i);
+
+  EXPECT_FALSE(map.clear_some(1000));
+  EXPECT_EQ(map.size(), 1500);
+  EXPECT_EQ(map.begin()->first, 1000);
+  // Между вызовами контейнером можно пользоваться.
+  map[-1] = "new";
+  EXPECT_EQ(map.at(2000), "2000");
+  EXPECT_FALSE(map.clear_some(1000));
+  EXPECT_EQ(map.size(), 501);
+  EXPECT_TRUE(map.clear_some(1000));
+  EXPECT_TRUE(map.empty());
+
+  s21::set<int> set = {1, 2, 3};
+  EXPECT_FALSE(set.clear_some(2));
+  EXPECT_EQ(*set.begin(), 3);
+  EXPECT_TRUE(set.clear_some(1));
+}
@@ -210,3 +210,278 @@ TEST_F(SetTest, InsertMany_MixedTypes) {
 
   EXPECT_EQ(std_set.size(), my_set.size());
 }
+
+TEST_F(SetTest, RangeConstructor) {
+  std::vector<int> sorted = {1, 2, 2, 3, 5, 8};
+  std::vector<int> unsorted = {8, 3, 1, 5, 2, 3};
+
+  s21::set<int> my_sorted(sorted.begin(), sorted.end());
+  std::set<int> std_sorted(sorted.begin(), sorted.end());
+  EXPECT_EQ(my_sorted.size(), std_sorted.size());
+  EXPECT_TRUE(std::equal(std_sorted.begin(), std_sorted.end(),
+                         my_sorted.begin()));
+
+  s21::set<int> my_unsorted(unsorted.begin(), unsorted.end());
+  std::set<int> std_unsorted(unsorted.begin(), unsorted.end());
+  EXPECT_EQ(my_unsorted.size(), std_unsorted.size());
+  EXPECT_TRUE(std::equal(std_unsorted.begin(), std_unsorted.end(),
+                         my_unsorted.begin()));
+}
+
+TEST_F(SetTest, SortedRangeConstructor) {
+  std::vector<int> values = {1, 1, 2, 4, 4, 9};
+  s21::set<int> my_temp(s21::sorted_range, values.begin(), values.end());
+  std::set<int> std_temp(values.begin(), values.end());
+
+  EXPECT_EQ(my_temp.size(), std_temp.size());
+  EXPECT_TRUE(std::equal(std_temp.begin(), std_temp.end(), my_temp.begin()));
+  EXPECT_TRUE(my_temp.insert(3).second);
+  EXPECT_FALSE(my_temp.insert(4).second);
+}
+
+TEST_F(SetTest, AssignSorted) {
+  std::vector<int> values = {10, 20, 30};
+  my_set.assign_sorted(values.begin(), values.end());
+
+  EXPECT_EQ(my_set.size(), 3);
+  EXPECT_FALSE(my_set.contains(1));
+  EXPECT_TRUE(my_set.contains(20));
+  EXPECT_EQ(*my_set.begin(), 10);
+}
+
+TEST_F(SetTest, TransparentLookup) {
+  s21::set<std::string, std::less<>> words{"apple", "banana", "cherry"};
+  std::string_view key = "banana";
+
+  EXPECT_TRUE(words.contains(key));
+  EXPECT_EQ(*words.find(key), "banana");
+  EXPECT_EQ(words.count("cherry"), 1);
+  EXPECT_EQ(*words.lower_bound("b"), "banana");
+  EXPECT_EQ(*words.upper_bound(key), "cherry");
+
+  EXPECT_EQ(words.erase("apple"), 1);
+  EXPECT_EQ(words.erase(std::string_view("apple")), 0);
+  EXPECT_EQ(words.size(), 2);
+}
+
+TEST_F(SetTest, BoundsAndCount) {
+  EXPECT_EQ(*my_set.lower_bound(3), *std_set.lower_bound(3));
+  EXPECT_EQ(*my_set.upper_bound(3), *std_set.upper_bound(3));
+  EXPECT_EQ(my_set.upper_bound(5), my_set.end());
+  EXPECT_EQ(my_set.count(1), std_set.count(1));
+  EXPECT_EQ(my_set.count(42), std_set.count(42));
+  EXPECT_EQ(my_set.erase(42), std_set.erase(42));
+  EXPECT_EQ(my_set.erase(1), std_set.erase(1));
+}
+
+TEST_F(SetTest, EmplaceAndRvalueInsert) {
+  s21::set<std::string> words;
+  std::string word = "hello";
+
+  auto res = words.insert(std::move(word));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*res.first, "hello");
+
+  std::string duplicate = "hello";
+  res = words.insert(std::move(duplicate));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(duplicate, "hello");  // Дубликат не перемещается.
+
+  res = words.emplace(3, 'x');
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*res.first, "xxx");
+  EXPECT_FALSE(words.emplace("xxx").second);
+
+  auto it = words.emplace_hint(words.end(), "zzz");
+  EXPECT_EQ(*it, "zzz");
+  EXPECT_EQ(words.size(), 3);
+}
+
+TEST_F(SetTest, HintedInsert) {
+  s21::set<int> my_set;
+  std::set<int> std_set;
+
+  // Возрастающая вставка с подсказкой end().
+  for (int i = 0; i < 100; i += 2) my_set.insert(my_set.end(), i);
+  // Убывающая вставка с подсказкой на только что вставленный элемент.
+  auto hint = my_set.end();
+  for (int i = 199; i > 100; i -= 2) hint = my_set.insert(hint, i);
+  // Неверные подсказки.
+  my_set.insert(my_set.begin(), 150);
+  my_set.insert(my_set.end(), 1);
+  for (int v : my_set) std_set.insert(v);
+
+  EXPECT_EQ(my_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(std_set.begin(), std_set.end(), my_set.begin()));
+
+  // Дубликат не вставляется и возвращается существующий элемент.
+  auto it = my_set.insert(my_set.find(10), 10);
+  EXPECT_EQ(it, my_set.find(10));
+  EXPECT_EQ(my_set.size(), std_set.size());
+
+  // Итератор другого контейнера игнорируется.
+  s21::set<int> other{5};
+  it = my_set.insert(other.begin(), 3);
+  EXPECT_EQ(*it, 3);
+  EXPECT_TRUE(my_set.contains(3));
+
+  std::string word = "word";
+  s21::set<std::string> words;
+  words.insert(words.end(), std::move(word));
+  EXPECT_TRUE(word.empty());
+  EXPECT_EQ(*words.emplace_hint(words.begin(), 2, 'a'), "aa");
+  EXPECT_EQ(*words.begin(), "aa");
+}
+
+TEST_F(SetTest, SetAlgebra) {
+  s21::set<int> first{1, 2, 3, 4, 5, 8};
+  s21::set<int> second{4, 5, 6, 7, 8, 9};
+
+  auto to_vector = [](const s21::set<int>& s) {
+    return std::vector<int>(s.begin(), s.end());
+  };
+
+  EXPECT_EQ(to_vector(set_union(first, second)),
+            std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  EXPECT_EQ(to_vector(set_intersection(first, second)),
+            std::vector<int>({4, 5, 8}));
+  EXPECT_EQ(to_vector(set_difference(first, second)),
+            std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(to_vector(symmetric_difference(first, second)),
+            std::vector<int>({1, 2, 3, 6, 7, 9}));
+  // Переданные по ссылке множества не меняются.
+  EXPECT_EQ(first.size(), 6);
+  EXPECT_EQ(second.size(), 6);
+
+  auto united = set_union(s21::execution::par, std::move(first), second);
+  EXPECT_EQ(united.size(), 9);
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(to_vector(set_difference(s21::execution::par, united, second)),
+            std::vector<int>({1, 2, 3}));
+  EXPECT_TRUE(set_intersection(s21::set<int>{}, second).empty());
+  EXPECT_EQ(to_vector(symmetric_difference(s21::execution::par, second,
+                                           s21::set<int>{})),
+            to_vector(second));
+}
+
+TEST_F(SetTest, OrderStatistics) {
+  s21::set<int, std::less<int>, std::allocator<int>, s21::Sized_node> ranked{
+      50, 10, 40, 20, 30};
+
+  EXPECT_EQ(ranked.rank(30), 2);
+  EXPECT_EQ(ranked.rank(35), 3);
+  EXPECT_EQ(ranked.rank(0), 0);
+  EXPECT_EQ(*ranked.nth(3), 40);
+  EXPECT_EQ(ranked.index_of(ranked.find(50)), 4);
+  EXPECT_EQ(ranked.end() - ranked.begin(), 5);
+
+  ranked.erase(20);
+  EXPECT_EQ(*ranked.nth(1), 30);
+  EXPECT_EQ(ranked.rank(30), 1);
+}
+
+// Создание и перемещение пустого множества не выделяют память.
+TEST_F(SetTest, NoexceptConstruction) {
+  static_assert(std::is_nothrow_default_constructible_v<s21::set<int>>);
+  static_assert(std::is_nothrow_move_constructible_v<s21::set<int>>);
+  static_assert(std::is_nothrow_move_assignable_v<s21::set<int>>);
+  static_assert(std::is_nothrow_default_constructible_v<s21::multiset<int>>);
+  static_assert(std::is_nothrow_default_constructible_v<s21::map<int, int>>);
+
+  s21::set<int> moved(std::move(my_set));
+  EXPECT_TRUE(my_set.empty());
+  EXPECT_EQ(my_set.begin(), my_set.end());
+  my_set.insert(10);
+  EXPECT_EQ(*my_set.begin(), 10);
+  EXPECT_EQ(moved.size(), 5);
+}
+
+// Нода переходит между множествами без перевыделения.
+TEST_F(SetTest, NodeHandles) {
+  const int* address = &*my_set.find(3);
+  s21::set<int>::node_type nh = my_set.extract(3);
+  ASSERT_FALSE(nh.empty());
+  EXPECT_EQ(nh.value(), 3);
+  EXPECT_EQ(my_set.size(), 4);
+  EXPECT_FALSE(my_set.contains(3));
+
+  s21::set<int> other{1, 10};
+  auto res = other.insert(std::move(nh));
+  EXPECT_TRUE(res.inserted);
+  EXPECT_TRUE(res.node.empty());
+  EXPECT_TRUE(nh.empty());
+  EXPECT_EQ(&*res.position, address);
+  EXPECT_EQ(other.size(), 3);
+
+  // Ключ уже есть: нода возвращается в результате.
+  res = other.insert(my_set.extract(my_set.begin()));
+  EXPECT_FALSE(res.inserted);
+  EXPECT_EQ(*res.position, 1);
+  ASSERT_FALSE(res.node.empty());
+  EXPECT_EQ(res.node.value(), 1);
+  res.node.value() = 0;
+  EXPECT_EQ(*other.insert(other.begin(), std::move(res.node)), 0);
+  EXPECT_TRUE(std::is_sorted(other.begin(), other.end()));
+  EXPECT_EQ(other.size(), 4);
+
+  EXPECT_TRUE(my_set.extract(42).empty());
+  EXPECT_TRUE(my_set.extract(my_set.end()).empty());
+  res = my_set.insert(s21::set<int>::node_type{});
+  EXPECT_FALSE(res.inserted);
+  EXPECT_EQ(res.position, my_set.end());
+  EXPECT_EQ(my_set.size(), 3);
+
+  // Невставленная нода уничтожается вместе с дескриптором.
+  s21::set<std::string> words{std::string(64, 'a'), "b"};
+  auto word = words.extract(words.begin());
+  EXPECT_EQ(word.value().size(), 64);
+  auto moved = std::move(word);
+  EXPECT_TRUE(word.empty());
+  EXPECT_FALSE(moved.empty());
+  swap(word, moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(words.size(), 1);
+}
+
+// Сравнитель, считающий вызовы, чтобы отличить учтенную подсказку от поиска.
+struct CountingLess {
+  static inline int calls = 0;
+  bool operator()(int a, int b) const {
+    ++calls;
+    return a < b;
+  }
+};
+
+// Итераторы следуют за нодами при перемещении и обмене контейнеров.
+TEST_F(SetTest, IteratorsSurviveMoveAndSwap) {
+  auto it = my_set.find(2);
+  s21::set<int> moved(std::move(my_set));
+  moved.erase(it);
+  EXPECT_FALSE(moved.contains(2));
+  EXPECT_EQ(moved.size(), 4);
+
+  s21::set<int> other{7, 8};
+  it = moved.find(3);
+  moved.swap(other);
+  EXPECT_EQ(other.extract(it).value(), 3);
+  EXPECT_EQ(other.size(), 3);
+  other.erase(moved.begin());
+  EXPECT_EQ(other.size(), 3);
+
+  s21::set<int, CountingLess> big;
+  for (int i = 0; i < 2048; i += 2) big.insert(big.end(), i);
+  auto hint = big.find(1000);
+  s21::set<int, CountingLess> target(std::move(big));
+  CountingLess::calls = 0;
+  EXPECT_EQ(*target.insert(hint, 999), 999);
+  EXPECT_LT(CountingLess::calls, 5);
+
+  s21::set<int, CountingLess> empty;
+  hint = target.find(1002);
+  empty.swap(target);
+  CountingLess::calls = 0;
+  EXPECT_EQ(*empty.insert(hint, 1001), 1001);
+  EXPECT_LT(CountingLess::calls, 5);
+  EXPECT_EQ(empty.size(), 1026);
+  EXPECT_TRUE(std::is_sorted(empty.begin(), empty.end()));
+}
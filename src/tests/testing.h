@@ -6,15 +6,33 @@
 #include <valgrind/valgrind.h>
 
 #include <map>
+#include <numeric>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "../lib/s21_allocator.h"
+#include "../lib/s21_btree_map.h"
+#include "../lib/s21_btree_multiset.h"
+#include "../lib/s21_btree_set.h"
+#include "../lib/s21_compressed_multiset.h"
+#include "../lib/s21_concurrent_allocator.h"
+#include "../lib/s21_concurrent_map.h"
+#include "../lib/s21_cow_map.h"
+#include "../lib/s21_cow_set.h"
+#include "../lib/s21_flat_map.h"
+#include "../lib/s21_flat_multiset.h"
+#include "../lib/s21_flat_set.h"
 #include "../lib/s21_helpers.h"
 #include "../lib/s21_map.h"
+#include "../lib/s21_memory_resource.h"
 #include "../lib/s21_multiset.h"
+#include "../lib/s21_persistent_map.h"
+#include "../lib/s21_persistent_set.h"
+#include "../lib/s21_reclaimer.h"
 #include "../lib/s21_red_black_tree.h"
 #include "../lib/s21_set.h"
+#include "../lib/s21_unordered_map.h"
+#include "../lib/s21_unordered_set.h"
 
 #endif  // TESTING_H
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "testing.h"
+
+namespace {
+
+template <typename Container, typename Expected>
+void ExpectSameSet(const Container& actual, const Expected& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  std::size_t visited = 0;
+  for (const auto& value : actual) {
+    EXPECT_TRUE(expected.contains(value));
+    ++visited;
+  }
+  EXPECT_EQ(visited, expected.size());
+}
+
+// Хеш с коллизиями: ключи попадают в несколько длинных цепочек проб.
+struct CollidingHash {
+  std::size_t operator()(int key) const {
+    return static_cast<std::size_t>(key % 4);
+  }
+};
+
+// Прозрачный хеш строк для гетерогенного поиска.
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view key) const {
+    return std::hash<std::string_view>()(key);
+  }
+};
+
+template <typename Mask>
+std::vector<std::size_t> Indices(Mask mask) {
+  std::vector<std::size_t> indices;
+  for (; mask; mask.remove_lowest()) indices.push_back(mask.lowest());
+  return indices;
+}
+
+template <typename Group>
+void CheckGroup(const std::vector<std::int8_t>& ctrl) {
+  const Group group(ctrl.data());
+  std::vector<std::size_t> empty;
+  std::vector<std::size_t> free;
+  for (std::size_t i = 0; i < Group::width; ++i) {
+    if (ctrl[i] == s21::Swiss_ctrl::empty) empty.push_back(i);
+    if (ctrl[i] < s21::Swiss_ctrl::sentinel) free.push_back(i);
+  }
+  EXPECT_EQ(Indices(group.match_empty()), empty);
+  EXPECT_EQ(Indices(group.match_empty_or_deleted()), free);
+  std::size_t leading = 0;
+  while (leading < free.size() && free[leading] == leading) ++leading;
+  EXPECT_EQ(group.count_leading_empty_or_deleted(), leading);
+
+  for (std::int8_t h2 : {0, 5, 127}) {
+    const auto matched = Indices(group.match(h2));
+    for (std::size_t i = 0; i < Group::width; ++i) {
+      const bool found =
+          std::find(matched.begin(), matched.end(), i) != matched.end();
+      // Ложные совпадения допустимы только на занятых местах.
+      if (ctrl[i] == h2 || ctrl[i] < 0) {
+        EXPECT_EQ(found, ctrl[i] == h2);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(SwissGroupTest, MatchesScalarReference) {
+  std::mt19937 gen(20);
+  const std::int8_t states[] = {s21::Swiss_ctrl::empty,
+                                s21::Swiss_ctrl::deleted,
+                                s21::Swiss_ctrl::sentinel, 0, 1, 4, 5, 127};
+  std::uniform_int_distribution<int> pick(0, 7);
+  for (int round = 0; round < 2000; ++round) {
+    std::vector<std::int8_t> ctrl(16);
+    for (auto& c : ctrl) c = states[pick(gen)];
+    CheckGroup<s21::Swiss_group_portable>(ctrl);
+#if defined(__SSE2__)
+    CheckGroup<s21::Swiss_group_sse2>(ctrl);
+#endif
+  }
+}
+
+TEST(UnorderedSetTest, Basic) {
+  s21::unordered_set<int> set = {5, 1, 4, 1, 3};
+  ExpectSameSet(set, std::unordered_set<int>{1, 3, 4, 5});
+  EXPECT_TRUE(set.contains(4));
+  EXPECT_FALSE(set.contains(2));
+  EXPECT_EQ(set.count(5), 1);
+  EXPECT_TRUE(set.insert(2).second);
+  EXPECT_FALSE(set.insert(2).second);
+  EXPECT_EQ(*set.insert(set.begin(), 6), 6);
+  EXPECT_EQ(*set.emplace_hint(set.end(), 7), 7);
+  EXPECT_EQ(set.erase(1), 1);
+  EXPECT_EQ(set.erase(1), 0);
+  set.erase(set.find(5));
+  ExpectSameSet(set, std::unordered_set<int>{2, 3, 4, 6, 7});
+
+  // Итератор другого контейнера и end() игнорируются.
+  s21::unordered_set<int> other = {3};
+  set.erase(other.begin());
+  set.erase(set.end());
+  EXPECT_EQ(set.size(), 5);
+
+  const std::size_t buckets = set.bucket_count();
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.begin(), set.end());
+  EXPECT_EQ(set.bucket_count(), buckets);
+  EXPECT_EQ(set.find(3), set.end());
+
+  s21::unordered_set<int> empty;
+  EXPECT_EQ(empty.bucket_count(), 0);
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_FALSE(empty.contains(0));
+  EXPECT_EQ(empty.erase(0), 0);
+}
+
+TEST(UnorderedSetTest, RandomOperations) {
+  std::mt19937 gen(2020);
+  std::uniform_int_distribution<int> key(0, 3000);
+  s21::unordered_set<int> set;
+  s21::Hash_table<int, int, std::identity, std::hash<int>, std::equal_to<int>,
+                  std::allocator<int>, s21::Swiss_group_portable>
+      portable;
+  std::unordered_set<int> expected;
+  for (int i = 0; i < 30000; ++i) {
+    const int k = key(gen);
+    if (i % 3 == 0) {
+      const auto erased = expected.erase(k);
+      EXPECT_EQ(set.erase(k), erased);
+      EXPECT_EQ(portable.erase_key(k), erased);
+    } else {
+      const bool inserted = expected.insert(k).second;
+      EXPECT_EQ(set.insert(k).second, inserted);
+      EXPECT_EQ(portable.emplace(k).second, inserted);
+    }
+  }
+  ExpectSameSet(set, expected);
+  ExpectSameSet(portable, expected);
+  for (int k = 0; k <= 3000; ++k) {
+    EXPECT_EQ(set.contains(k), expected.contains(k));
+    EXPECT_EQ(portable.find(k) != portable.end(), expected.contains(k));
+  }
+  EXPECT_LE(set.load_factor(), 7.0f / 8);
+}
+
+// Длинные цепочки проб: удаление оставляет метки, которые не должны
+// прерывать поиск, а перестройка их убирает.
+TEST(UnorderedSetTest, CollidingKeys) {
+  s21::unordered_set<int, CollidingHash> set;
+  std::unordered_set<int> expected;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 200; ++i) {
+      set.insert(round * 1000 + i);
+      expected.insert(round * 1000 + i);
+    }
+    for (int i = 0; i < 200; i += 3) {
+      set.erase(round * 1000 + i);
+      expected.erase(round * 1000 + i);
+    }
+    ExpectSameSet(set, expected);
+    for (int i = 0; i < 200; ++i) {
+      EXPECT_EQ(set.contains(round * 1000 + i),
+                expected.contains(round * 1000 + i));
+    }
+  }
+  set.shrink_to_fit();
+  ExpectSameSet(set, expected);
+}
+
+TEST(UnorderedSetTest, EraseKeepsOtherIterators) {
+  s21::unordered_set<int> set;
+  for (int i = 0; i < 1000; ++i) set.insert(i);
+  std::vector<const int*> kept;
+  for (auto it = set.begin(); it != set.end();) {
+    auto next = std::next(it);
+    if (*it % 2 == 0) {
+      set.erase(it);
+    } else {
+      kept.push_back(&*it);
+    }
+    it = next;
+  }
+  EXPECT_EQ(set.size(), 500);
+  for (const int* value : kept) EXPECT_EQ(&*set.find(*value), value);
+}
+
+TEST(UnorderedSetTest, ReserveAndMemory) {
+  s21::unordered_set<std::uint64_t> set;
+  set.reserve(1000);
+  const std::size_t buckets = set.bucket_count();
+  EXPECT_GE(buckets * 7 / 8, 1000);
+  for (std::uint64_t i = 0; i < 1000; ++i) set.insert(i * 7919);
+  EXPECT_EQ(set.bucket_count(), buckets);
+  const auto usage = set.memory_usage();
+  EXPECT_EQ(usage.node_bytes, 1000 * sizeof(std::uint64_t));
+  EXPECT_EQ(usage.total(),
+            buckets * (sizeof(std::uint64_t) + 1) + s21::Swiss_group::width +
+                sizeof(set));
+
+  for (std::uint64_t i = 0; i < 990; ++i) set.erase(i * 7919);
+  set.shrink_to_fit();
+  EXPECT_LT(set.bucket_count(), buckets);
+  EXPECT_TRUE(set.contains(995 * 7919));
+  set.clear();
+  set.shrink_to_fit();
+  EXPECT_EQ(set.bucket_count(), 0);
+  EXPECT_EQ(set.memory_usage().total(), sizeof(set));
+
+  auto res = set.insert_many(1, 2, 1);
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[2].second);
+  EXPECT_EQ(res[0].first, res[2].first);
+}
+
+TEST(UnorderedSetTest, CopyMoveSwapMerge) {
+  s21::unordered_set<std::string> set;
+  for (int i = 0; i < 300; ++i) set.insert(std::to_string(i));
+  set.erase("7");
+
+  s21::unordered_set<std::string> copy(set);
+  ExpectSameSet(copy, std::unordered_set<std::string>(set.begin(), set.end()));
+  s21::unordered_set<std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  copy = moved;
+  moved = std::move(copy);
+  EXPECT_EQ(moved.size(), 299);
+  EXPECT_FALSE(moved.contains("7"));
+
+  s21::unordered_set<std::string> other = {"1", "a", "b"};
+  other.swap(moved);
+  EXPECT_EQ(moved.size(), 3);
+
+  other.merge(moved);
+  EXPECT_EQ(other.size(), 301);
+  ExpectSameSet(moved, std::unordered_set<std::string>{"1"});
+}
+
+TEST(UnorderedSetTest, TransparentLookup) {
+  s21::unordered_set<std::string, StringHash, std::equal_to<>> set = {
+      "alpha", "beta"};
+  EXPECT_TRUE(set.contains(std::string_view("alpha")));
+  EXPECT_TRUE(set.contains("beta"));
+  EXPECT_EQ(set.erase(std::string_view("beta")), 1);
+  EXPECT_FALSE(set.contains("beta"));
+}
+
+TEST(UnorderedMapTest, Basic) {
+  s21::unordered_map<int, std::string> map = {
+      {2, "two"}, {1, "one"}, {2, "dos"}};
+  map[3] = "three";
+  EXPECT_EQ(map.at(2), "two");
+  EXPECT_THROW(map.at(4), std::out_of_range);
+  EXPECT_FALSE(map.insert({1, "uno"}).second);
+  EXPECT_FALSE(map.try_emplace(2, "dos").second);
+  EXPECT_FALSE(map.insert_or_assign(3, "tres").second);
+  EXPECT_TRUE(map.insert(4, "four").second);
+  EXPECT_EQ(map.try_emplace(map.end(), 5, "five")->second, "five");
+  map.insert({{6, "six"}, {0, "zero"}, {1, "ein"}});
+
+  std::unordered_map<int, std::string> expected = {
+      {0, "zero"}, {1, "one"},  {2, "two"}, {3, "tres"},
+      {4, "four"}, {5, "five"}, {6, "six"}};
+  EXPECT_EQ(map.size(), expected.size());
+  for (const auto& [key, value] : map) EXPECT_EQ(expected.at(key), value);
+
+  for (auto& [key, value] : map) value += "!";
+  EXPECT_EQ(map.find(4)->second, "four!");
+  map.erase(map.find(1));
+  EXPECT_EQ(map.erase(5), 1);
+  EXPECT_EQ(map.size(), 5);
+  EXPECT_FALSE(map.contains(1));
+
+  const auto res = map.insert_many(std::pair<const int, std::string>{7, "x"},
+                                   std::pair<const int, std::string>{0, "y"});
+  EXPECT_TRUE(res[0].second);
+  EXPECT_FALSE(res[1].second);
+  EXPECT_EQ(res[1].first->second, "zero!");
+}
+
+// Аргументы вставки ссылаются на элементы, которые перемещает перестройка.
+TEST(UnorderedMapTest, ArgumentsReferToElements) {
+  s21::unordered_map<int, std::string> map;
+  map[0] = std::string(40, 'x');
+  for (int i = 1; i < 2000; ++i) {
+    EXPECT_TRUE(map.try_emplace(i, map.at(i - 1)).second);
+  }
+  EXPECT_EQ(map.at(1999), std::string(40, 'x'));
+
+  s21::unordered_set<std::string> set = {std::string(40, 'a')};
+  for (int i = 1; i < 500; ++i) {
+    set.emplace(*set.begin() + std::to_string(i));
+  }
+  EXPECT_EQ(set.size(), 500);
+}
+
+TEST(UnorderedMapTest, Allocators) {
+  s21::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                     s21::pool_allocator<std::pair<const int, int>>>
+      pooled;
+  for (int i = 0; i < 1000; ++i) pooled[i] = i * 2;
+  auto pooled_copy = pooled;
+  EXPECT_EQ(pooled_copy.at(999), 1998);
+  pooled_copy = std::move(pooled);
+  EXPECT_EQ(pooled_copy.size(), 1000);
+
+  s21::pmr::pool_resource resource;
+  s21::pmr::unordered_map<int, int> map(&resource);
+  std::vector<std::pair<const int, int>> batch;
+  for (int i = 0; i < 1000; ++i) batch.emplace_back(i * 7 % 1000, i);
+  map.insert(batch.begin(), batch.end());
+  EXPECT_EQ(map.size(), 1000);
+  EXPECT_EQ(map.at(7), 1);
+  EXPECT_EQ(map.get_allocator().resource(), &resource);
+
+  std::pmr::monotonic_buffer_resource arena;
+  s21::pmr::unordered_map<int, int> moved(std::move(map), &arena);
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(moved.at(14), 2);
+  EXPECT_EQ(moved.get_allocator().resource(), &arena);
+
+  s21::pmr::unordered_set<std::pmr::string> strings(&resource);
+  strings.insert(std::pmr::string(50, 's'));
+  EXPECT_EQ(strings.begin()->get_allocator().resource(), &resource);
+}